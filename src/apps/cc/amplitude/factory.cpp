@@ -10,6 +10,7 @@
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../def.h"
@@ -28,6 +29,16 @@ namespace Seiscomp {
 namespace detect {
 namespace amplitude {
 namespace factory {
+namespace {
+
+using StreamConfigs = std::unordered_map<std::string, processing::StreamConfig>;
+// prevent the static order initialization problem
+StreamConfigs &streamConfigs() {
+  static StreamConfigs *ret{new StreamConfigs{}};
+  return *ret;
+}
+
+}  // namespace
 
 std::unique_ptr<amplitude::MLx> createMLx(
     const binding::Bindings &bindings, const DataModel::OriginCPtr &origin,
@@ -101,6 +112,23 @@ const binding::SensorLocationConfig &loadSensorLocationConfig(
   }
 }
 
+const processing::StreamConfig &loadStreamConfig(
+    const std::string &waveformStreamId, const DataModel::Stream *stream) {
+  assert(stream);
+  // identify the stream epoch
+  auto key{waveformStreamId + settings::kProcessorIdSep +
+           stream->start().iso()};
+
+  auto &cache{streamConfigs()};
+  auto it{cache.find(key)};
+  if (it == cache.end()) {
+    processing::StreamConfig streamConfig;
+    streamConfig.init(stream);
+    it = cache.emplace(std::move(key), std::move(streamConfig)).first;
+  }
+  return it->second;
+}
+
 std::unique_ptr<RMSAmplitude> createRMSAmplitude(
     const binding::Bindings &bindings, const DataModel::OriginCPtr &origin,
     const SensorLocationDetectionInfo::Pick &pickInfo, const TimeInfo &timeInfo,
@@ -164,6 +192,9 @@ std::unique_ptr<RMSAmplitude> createRMSAmplitude(
                                 logging::to_string(msg).c_str());
 
       ret->setFilter(processing::createFilter(*filter), initTime);
+      // the initialization time affects the filtered data, too
+      ret->setFilterId(*filter + settings::kProcessorIdSep +
+                       std::to_string(initTime));
       filterConfigured = true;
     }
   }
@@ -251,14 +282,12 @@ std::unique_ptr<AmplitudeProcessor> Factory::createMLx(
             ->second.pick->time()
             .value()};
     for (const auto &s : horizontalComponents) {
-      processing::StreamConfig streamConfig;
-      streamConfig.init(s);
-
       auto authorativeWaveformStreamId{util::join(
           sensorLocationStreamIdTokens[0], sensorLocationStreamIdTokens[1],
           sensorLocationStreamIdTokens[2], s->code())};
-      sensorLocationStreamConfigs.emplace(authorativeWaveformStreamId,
-                                          streamConfig);
+      sensorLocationStreamConfigs.emplace(
+          authorativeWaveformStreamId,
+          factory::detail::loadStreamConfig(authorativeWaveformStreamId, s));
     }
   } catch (const Exception &e) {
     logging::TaggedMessage msg{
@@ -332,7 +361,10 @@ std::unique_ptr<AmplitudeProcessor> Factory::createMLx(
                             amplitudeProcessorConfig);
 }
 
-void Factory::reset() { resetCallbacks(); }
+void Factory::reset() {
+  resetCallbacks();
+  factory::streamConfigs().clear();
+}
 
 std::unique_ptr<AmplitudeProcessor> Factory::createRatioAmplitude(
     const binding::Bindings &bindings,
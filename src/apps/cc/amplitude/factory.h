@@ -5,6 +5,7 @@
 #include <seiscomp/core/timewindow.h>
 #include <seiscomp/datamodel/origin.h>
 #include <seiscomp/datamodel/pick.h>
+#include <seiscomp/datamodel/stream.h>
 
 #include <memory>
 #include <string>
@@ -78,6 +79,14 @@ const binding::SensorLocationConfig& loadSensorLocationConfig(
     const std::string& staCode, const std::string& locCode,
     const std::string& chaCode);
 
+// Returns the stream configuration of the stream epoch `stream` identified by
+// `waveformStreamId`
+//
+// - configurations are cached until the factory is reset, i.e. amplitude
+// processors operating on the same stream share the sensor response
+const processing::StreamConfig& loadStreamConfig(
+    const std::string& waveformStreamId, const DataModel::Stream* stream);
+
 std::unique_ptr<RMSAmplitude> createRMSAmplitude(
     const binding::Bindings& bindings, const DataModel::OriginCPtr& origin,
     const SensorLocationDetectionInfo::Pick& pickInfo, const TimeInfo& timeInfo,
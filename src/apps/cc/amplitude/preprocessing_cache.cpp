@@ -0,0 +1,123 @@
+#include "preprocessing_cache.h"
+
+#include <boost/functional/hash.hpp>
+#include <utility>
+
+#include "../settings.h"
+#include "../util/memory.h"
+#include "../util/memory_usage.h"
+
+namespace std {
+
+std::size_t
+hash<Seiscomp::detect::amplitude::preprocessing_cache_detail::CacheKey>::
+operator()(
+    const Seiscomp::detect::amplitude::preprocessing_cache_detail::CacheKey
+        &key) const noexcept {
+  std::size_t ret{0};
+  boost::hash_combine(ret, std::hash<std::string>{}(key.waveformStreamId));
+  boost::hash_combine(ret, key.timeWindow.startTime().seconds());
+  boost::hash_combine(ret, key.timeWindow.startTime().microseconds());
+  boost::hash_combine(ret, key.timeWindow.endTime().seconds());
+  boost::hash_combine(ret, key.timeWindow.endTime().microseconds());
+  boost::hash_combine(ret, key.filterWarmUp.seconds());
+  boost::hash_combine(ret, key.filterWarmUp.microseconds());
+  boost::hash_combine(ret, std::hash<double>{}(key.samplingFrequency));
+  boost::hash_combine(ret, std::hash<std::string>{}(key.filterId));
+  boost::hash_combine(ret, std::hash<double>{}(key.gain));
+  boost::hash_combine(ret, std::hash<const void *>{}(key.response));
+  boost::hash_combine(ret, std::hash<std::string>{}(key.unit));
+  return ret;
+}
+
+}  // namespace std
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+
+namespace preprocessing_cache_detail {
+
+bool operator==(const CacheKey &lhs, const CacheKey &rhs) {
+  const auto &lhsDeconvolution{lhs.deconvolutionConfig};
+  const auto &rhsDeconvolution{rhs.deconvolutionConfig};
+  return (lhs.waveformStreamId == rhs.waveformStreamId &&
+          lhs.timeWindow == rhs.timeWindow &&
+          lhs.filterWarmUp == rhs.filterWarmUp &&
+          lhs.samplingFrequency == rhs.samplingFrequency &&
+          lhs.filterId == rhs.filterId && lhs.gain == rhs.gain &&
+          lhs.response == rhs.response && lhs.unit == rhs.unit &&
+          lhsDeconvolution.enabled == rhsDeconvolution.enabled &&
+          lhsDeconvolution.responseTaperLength ==
+              rhsDeconvolution.responseTaperLength &&
+          lhsDeconvolution.minimumResponseTaperFrequency ==
+              rhsDeconvolution.minimumResponseTaperFrequency &&
+          lhsDeconvolution.maximumResponseTaperFrequency ==
+              rhsDeconvolution.maximumResponseTaperFrequency);
+}
+
+bool operator!=(const CacheKey &lhs, const CacheKey &rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace preprocessing_cache_detail
+
+PreprocessingCache::PreprocessingCache()
+    : _cache{settings::kAmplitudePreprocessingCacheCapacity} {}
+
+PreprocessingCache &PreprocessingCache::Instance() {
+  // guaranteed to be destroyed; instantiated on first use
+  static PreprocessingCache instance;
+  return instance;
+}
+
+void PreprocessingCache::reset() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.clear();
+}
+
+void PreprocessingCache::setCapacity(std::size_t capacity) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.setCapacity(capacity);
+}
+
+std::size_t PreprocessingCache::capacity() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _cache.capacity();
+}
+
+bool PreprocessingCache::get(const Key &key, DoubleArray &data) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto *cached{_cache.get(key)};
+  if (!cached) {
+    return false;
+  }
+
+  data.setData((*cached)->size(), (*cached)->typedData());
+  return true;
+}
+
+void PreprocessingCache::put(const Key &key, const DoubleArray &data) {
+  auto copy{detect::util::make_smart<DoubleArray>(data.size(),
+                                                  data.typedData())};
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.put(key, std::move(copy));
+}
+
+std::size_t PreprocessingCache::size() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _cache.size();
+}
+
+std::size_t PreprocessingCache::memoryUsage() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  std::size_t ret{0};
+  for (const auto &entry : _cache) {
+    ret += detect::util::byteSize(entry.second.get());
+  }
+  return ret;
+}
+
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
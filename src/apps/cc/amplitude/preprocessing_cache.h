@@ -0,0 +1,113 @@
+#ifndef SCDETECT_APPS_CC_AMPLITUDE_PREPROCESSINGCACHE_H_
+#define SCDETECT_APPS_CC_AMPLITUDE_PREPROCESSINGCACHE_H_
+
+#include <seiscomp/core/timewindow.h>
+#include <seiscomp/core/typedarray.h>
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "../amplitude_processor.h"
+#include "../util/lru_cache.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+namespace preprocessing_cache_detail {
+
+struct CacheKey {
+  std::string waveformStreamId;
+  // The time window of the preprocessed data
+  Core::TimeWindow timeWindow;
+  // The time span the filter was applied to the data preceding the time
+  // window (i.e. the filter's warm-up)
+  Core::TimeSpan filterWarmUp;
+  double samplingFrequency;
+  // Identifies the filter applied (an empty string refers to unfiltered data)
+  std::string filterId;
+  double gain;
+  // Identifies the sensor response (the responses are owned by the stream
+  // configurations, which are cached per stream epoch; see also
+  // `amplitude::factory::detail::loadStreamConfig()`)
+  const void *response;
+  // The sensor's signal unit
+  std::string unit;
+  AmplitudeProcessor::DeconvolutionConfig deconvolutionConfig;
+
+  friend bool operator==(const CacheKey &lhs, const CacheKey &rhs);
+  friend bool operator!=(const CacheKey &lhs, const CacheKey &rhs);
+};
+
+}  // namespace preprocessing_cache_detail
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
+
+namespace std {
+
+template <>
+struct hash<Seiscomp::detect::amplitude::preprocessing_cache_detail::CacheKey> {
+  std::size_t operator()(
+      const Seiscomp::detect::amplitude::preprocessing_cache_detail::CacheKey
+          &key) const noexcept;
+};
+
+}  // namespace std
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+
+// A global cache for preprocessed (i.e. filtered, deconvolved and gain
+// corrected) amplitude processor data
+//
+// - allows amplitude processors operating on the same stream and time window
+// with an identical preprocessing configuration (including both the sensor
+// response and the filter warm-up) to preprocess the data only once
+// - the cache must be reset whenever the stream configurations are reset
+// (since the sensor responses are identified by address)
+// - least recently used entries are evicted if the capacity is exceeded
+// - thread-safe; data is copied when cached or looked up, i.e. no (reference
+// counted) data is shared between threads
+// - implements the Singleton Design Pattern
+class PreprocessingCache {
+ public:
+  using Key = preprocessing_cache_detail::CacheKey;
+
+  static PreprocessingCache &Instance();
+
+  PreprocessingCache(const PreprocessingCache &) = delete;
+  PreprocessingCache &operator=(const PreprocessingCache &) = delete;
+
+  // Reset the cache
+  void reset();
+
+  // Sets the maximum number of cached entries
+  void setCapacity(std::size_t capacity);
+  std::size_t capacity() const;
+
+  // Copies the preprocessed data cached for `key` to `data`. Returns `false`
+  // if there is no data cached (`data` is left untouched, then).
+  bool get(const Key &key, DoubleArray &data);
+  // Caches `data` for `key`
+  void put(const Key &key, const DoubleArray &data);
+
+  // Returns the number of cached entries
+  std::size_t size() const;
+  // Returns the approximate number of bytes allocated for cached data
+  std::size_t memoryUsage() const;
+
+ private:
+  PreprocessingCache();
+
+  mutable std::mutex _mutex;
+  detect::util::LRUCache<Key, DoubleArrayCPtr> _cache;
+};
+
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_AMPLITUDE_PREPROCESSINGCACHE_H_
@@ -3,8 +3,10 @@
 #include <boost/variant2/variant.hpp>
 #include <cassert>
 #include <cstddef>
+#include <memory>
 
 #include "../util/memory.h"
+#include "../util/memory_usage.h"
 #include "../util/util.h"
 #include "../util/waveform_stream_id.h"
 #include "../waveform.h"
@@ -25,7 +27,8 @@ RatioAmplitude::RatioAmplitude(TemplateWaveform templateWaveform)
 
 void RatioAmplitude::reset() {
   processing::TimeWindowProcessor::reset();
-  _templateWaveform.reset();
+  // the processed template waveform depends on the configuration, only. It is
+  // reset when reconfigured.
   _buffer.clear();
 }
 
@@ -40,6 +43,7 @@ void RatioAmplitude::setFilter(std::unique_ptr<DoubleFilter> filter,
   processingConfig.filter = std::move(filter);
   processingConfig.initTime = initTime;
   _templateWaveform.setProcessingConfig(processingConfig);
+  prepareTemplateWaveform();
 
   _initTime = initTime;
 
@@ -56,6 +60,10 @@ void RatioAmplitude::setTemplateWaveform(
   initTemplateWaveform();
 }
 
+std::size_t RatioAmplitude::memoryUsage() const {
+  return util::byteSize(&_buffer);
+}
+
 processing::WaveformProcessor::StreamState *RatioAmplitude::streamState(
     const Record *record)  // NOLINT(misc-unused-parameters)
 {
@@ -143,9 +151,12 @@ void RatioAmplitude::preprocess() {
   assert((_streamState.samplingFrequency));
   // filter
   try {
-    if (!waveform::filter(
-            _buffer, boost::variant2::get<0>(processingConfig.filter).get(),
-            _streamState.samplingFrequency)) {
+    // the filter was applied to the template waveform, already; use a filter
+    // with an initial state
+    std::unique_ptr<DoubleFilter> filter{
+        boost::variant2::get<0>(processingConfig.filter)->clone()};
+    if (!waveform::filter(_buffer, filter.get(),
+                          _streamState.samplingFrequency)) {
       throw BaseException{"failed to filter buffered waveform data"};
     }
   } catch (const boost::variant2::bad_variant_access &) {
@@ -203,6 +214,14 @@ void RatioAmplitude::initTemplateWaveform() {
   processingConfig.demean = true;
 
   _templateWaveform.setProcessingConfig(processingConfig);
+  prepareTemplateWaveform();
+}
+
+void RatioAmplitude::prepareTemplateWaveform() {
+  // process the template waveform when configured rather than when processing
+  // data, i.e. the raw template waveform (shared with the detector) is not
+  // accessed if the processor is fed by an amplitude worker
+  _templateWaveform.waveform();
 }
 
 }  // namespace amplitude
@@ -35,6 +35,8 @@ class RatioAmplitude : public AmplitudeProcessor {
 
   void setTemplateWaveform(const TemplateWaveform &templateWaveform);
 
+  std::size_t memoryUsage() const override;
+
  protected:
   StreamState *streamState(const Record *record) override;
 
@@ -61,6 +63,8 @@ class RatioAmplitude : public AmplitudeProcessor {
   IndexRange computeIndexRange(const Core::TimeWindow &tw) const;
 
   void initTemplateWaveform();
+  // Processes the template waveform
+  void prepareTemplateWaveform();
 
   TemplateWaveform _templateWaveform;
 
@@ -0,0 +1,233 @@
+#include "response_spectrum_cache.h"
+
+#include <seiscomp/math/restitution/transferfunction.h>
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <cmath>
+
+#include "../settings.h"
+#include "transfer_function_cache.h"
+
+namespace std {
+
+std::size_t
+hash<Seiscomp::detect::amplitude::response_spectrum_cache_detail::CacheKey>::
+operator()(const Seiscomp::detect::amplitude::response_spectrum_cache_detail::
+               CacheKey &key) const noexcept {
+  std::size_t ret{0};
+  boost::hash_combine(
+      ret, std::hash<const Seiscomp::Processing::Response *>{}(key.response));
+  boost::hash_combine(ret, std::hash<int>{}(key.numberOfIntegrations));
+  boost::hash_combine(ret, std::hash<int>{}(key.sampleCount));
+  boost::hash_combine(ret, std::hash<double>{}(key.samplingFrequency));
+  boost::hash_combine(ret, std::hash<double>{}(key.responseTaperLength));
+  boost::hash_combine(
+      ret, std::hash<double>{}(key.minimumResponseTaperFrequency));
+  boost::hash_combine(
+      ret, std::hash<double>{}(key.maximumResponseTaperFrequency));
+  return ret;
+}
+
+}  // namespace std
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+
+namespace response_spectrum_cache_detail {
+
+bool operator==(const CacheKey &lhs, const CacheKey &rhs) {
+  return (lhs.response == rhs.response &&
+          lhs.numberOfIntegrations == rhs.numberOfIntegrations &&
+          lhs.sampleCount == rhs.sampleCount &&
+          lhs.samplingFrequency == rhs.samplingFrequency &&
+          lhs.responseTaperLength == rhs.responseTaperLength &&
+          lhs.minimumResponseTaperFrequency ==
+              rhs.minimumResponseTaperFrequency &&
+          lhs.maximumResponseTaperFrequency ==
+              rhs.maximumResponseTaperFrequency);
+}
+
+bool operator!=(const CacheKey &lhs, const CacheKey &rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace response_spectrum_cache_detail
+
+void ResponseSpectrumCache::Deconvolution::apply(double *data) const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  for (std::size_t i{0}; i < _n; ++i) {
+    _samples[i] = data[i] * _taper[i];
+  }
+  std::fill(std::begin(_samples) + _n, std::end(_samples), 0);
+
+  _fft.forward(_samples.data(), _spectrum.data());
+  for (std::size_t i{0}; i < _spectrum.size(); ++i) {
+    _spectrum[i] *= _coefficients[i];
+  }
+  _fft.inverse(_spectrum.data(), _samples.data());
+
+  std::copy(std::begin(_samples), std::begin(_samples) + _n, data);
+}
+
+std::size_t ResponseSpectrumCache::Deconvolution::size() const { return _n; }
+
+std::size_t ResponseSpectrumCache::Deconvolution::memoryUsage() const {
+  return _taper.capacity() * sizeof(double) +
+         _coefficients.capacity() * sizeof(std::complex<double>) +
+         _fft.memoryUsage() + _samples.capacity() * sizeof(double) +
+         _spectrum.capacity() * sizeof(std::complex<double>);
+}
+
+ResponseSpectrumCache::ResponseSpectrumCache()
+    : _cache{settings::kResponseSpectrumCacheCapacity} {}
+
+ResponseSpectrumCache &ResponseSpectrumCache::Instance() {
+  // guaranteed to be destroyed; instantiated on first use
+  static ResponseSpectrumCache instance;
+  return instance;
+}
+
+void ResponseSpectrumCache::reset() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.clear();
+  _statistics = Statistics{};
+}
+
+void ResponseSpectrumCache::setCapacity(std::size_t capacity) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.setCapacity(capacity);
+}
+
+std::size_t ResponseSpectrumCache::capacity() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _cache.capacity();
+}
+
+ResponseSpectrumCache::DeconvolutionCPtr ResponseSpectrumCache::get(
+    Processing::Response *response, int numberOfIntegrations, int sampleCount,
+    double samplingFrequency, const TaperConfig &taper) {
+  if (!response || sampleCount <= 0 || samplingFrequency <= 0) {
+    return nullptr;
+  }
+
+  Key key{response,
+          numberOfIntegrations,
+          sampleCount,
+          samplingFrequency,
+          taper.length,
+          taper.minimumFrequency,
+          taper.maximumFrequency};
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto *cached{_cache.get(key)};
+    if (cached) {
+      ++_statistics.hits;
+      return cached->deconvolution;
+    }
+    ++_statistics.misses;
+  }
+
+  // compute without holding the lock; if computed concurrently, the most
+  // recently computed operator is cached
+  auto ret{compute(response, numberOfIntegrations, sampleCount,
+                   samplingFrequency, taper)};
+  if (ret) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _cache.put(key, Entry{response, ret});
+  }
+  return ret;
+}
+
+std::size_t ResponseSpectrumCache::size() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _cache.size();
+}
+
+std::size_t ResponseSpectrumCache::memoryUsage() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  std::size_t ret{0};
+  for (const auto &entry : _cache) {
+    ret += entry.second.deconvolution->memoryUsage();
+  }
+  return ret;
+}
+
+ResponseSpectrumCache::Statistics ResponseSpectrumCache::statistics() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _statistics;
+}
+
+ResponseSpectrumCache::DeconvolutionCPtr ResponseSpectrumCache::compute(
+    Processing::Response *response, int numberOfIntegrations, int sampleCount,
+    double samplingFrequency, const TaperConfig &taper) {
+  const auto transferFunction{
+      TransferFunctionCache::Instance().get(response, numberOfIntegrations)};
+  if (!transferFunction) {
+    return nullptr;
+  }
+
+  auto ret{std::make_shared<Deconvolution>()};
+
+  // cosine taper applied to both ends of the data
+  const auto n{static_cast<std::size_t>(sampleCount)};
+  ret->_n = n;
+  ret->_taper.assign(n, 1.0);
+  const auto taperLength{std::min(
+      n / 2, static_cast<std::size_t>(std::max(
+                 0L, std::lround(taper.length * samplingFrequency))))};
+  for (std::size_t i{0}; i < taperLength; ++i) {
+    const auto w{0.5 * (1 - std::cos(M_PI * static_cast<double>(i) /
+                                     static_cast<double>(taperLength)))};
+    ret->_taper[i] = w;
+    ret->_taper[n - 1 - i] = w;
+  }
+
+  // the data is zero padded, i.e. the FFT plan is reused for all the data of
+  // the same length
+  const auto fftSize{std::max(std::size_t{4}, filter::fft::nextPowerOfTwo(n))};
+  ret->_fft = filter::fft::RealFFT{fftSize};
+  ret->_samples.resize(fftSize);
+
+  // evaluate the transfer function at the frequencies of the data's spectrum
+  const auto numberOfFrequencies{fftSize / 2 + 1};
+  ret->_spectrum.resize(numberOfFrequencies);
+  const auto df{samplingFrequency / static_cast<double>(fftSize)};
+  const auto nyquist{samplingFrequency * 0.5};
+  std::vector<double> frequencies(numberOfFrequencies);
+  for (std::size_t i{0}; i < numberOfFrequencies; ++i) {
+    frequencies[i] = static_cast<double>(i) * df;
+  }
+  std::vector<Math::Complex> values(numberOfFrequencies);
+  transferFunction->evaluate(values.data(),
+                             static_cast<int>(numberOfFrequencies),
+                             frequencies.data());
+
+  const auto minFrequency{taper.minimumFrequency};
+  const auto maxFrequency{taper.maximumFrequency};
+  ret->_coefficients.resize(numberOfFrequencies);
+  for (std::size_t i{0}; i < numberOfFrequencies; ++i) {
+    if (std::abs(values[i]) == 0) {
+      ret->_coefficients[i] = 0;
+      continue;
+    }
+
+    const auto f{frequencies[i]};
+    double w{1};
+    if (minFrequency > 0 && f < minFrequency) {
+      w *= 0.5 * (1 - std::cos(M_PI * f / minFrequency));
+    }
+    if (maxFrequency > 0 && maxFrequency < nyquist && f > maxFrequency) {
+      w *= 0.5 * (1 + std::cos(M_PI * (f - maxFrequency) /
+                               (nyquist - maxFrequency)));
+    }
+    ret->_coefficients[i] = w / values[i];
+  }
+
+  return ret;
+}
+
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,174 @@
+#ifndef SCDETECT_APPS_CC_AMPLITUDE_RESPONSESPECTRUMCACHE_H_
+#define SCDETECT_APPS_CC_AMPLITUDE_RESPONSESPECTRUMCACHE_H_
+
+#include <seiscomp/processing/response.h>
+
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../filter/fft.h"
+#include "../util/lru_cache.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+namespace response_spectrum_cache_detail {
+
+struct CacheKey {
+  const Processing::Response *response;
+  int numberOfIntegrations;
+  int sampleCount;
+  double samplingFrequency;
+  double responseTaperLength;
+  double minimumResponseTaperFrequency;
+  double maximumResponseTaperFrequency;
+
+  friend bool operator==(const CacheKey &lhs, const CacheKey &rhs);
+  friend bool operator!=(const CacheKey &lhs, const CacheKey &rhs);
+};
+
+}  // namespace response_spectrum_cache_detail
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
+
+namespace std {
+
+template <>
+struct hash<
+    Seiscomp::detect::amplitude::response_spectrum_cache_detail::CacheKey> {
+  std::size_t operator()(
+      const Seiscomp::detect::amplitude::response_spectrum_cache_detail::
+          CacheKey &key) const noexcept;
+};
+
+}  // namespace std
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+
+// A global cache for the operators used for deconvolving data by means of
+// the sensor response, i.e. both the evaluated response spectrum and the FFT
+// plan
+//
+// - operators are specific to the sensor response, the number of
+// integrations, the number of samples, the sampling frequency and the taper
+// configuration
+// - the transfer functions evaluated are taken from the
+// `TransferFunctionCache`
+// - least recently used entries are evicted if the capacity is exceeded
+// - thread-safe; the operators cached are shared between threads
+// - implements the Singleton Design Pattern
+class ResponseSpectrumCache {
+ public:
+  using Key = response_spectrum_cache_detail::CacheKey;
+
+  struct TaperConfig {
+    // Taper length in seconds applied to both ends of the data
+    double length;
+    // The end of the left-hand side cosine-taper in Hz applied to the
+    // spectrum (disabled if less than or equal to zero)
+    double minimumFrequency;
+    // The beginning of the right-hand side cosine-taper in Hz applied to the
+    // spectrum (disabled if less than or equal to zero)
+    double maximumFrequency;
+  };
+
+  // The deconvolution operator
+  class Deconvolution {
+   public:
+    // Deconvolves the `size()` samples `data` in place
+    //
+    // - the data is zero padded to the FFT length
+    // - serialized w.r.t. other threads applying the same operator
+    void apply(double *data) const;
+
+    // Returns the number of samples deconvolved
+    std::size_t size() const;
+    // Returns the approximate number of bytes allocated
+    std::size_t memoryUsage() const;
+
+   private:
+    friend class ResponseSpectrumCache;
+
+    std::size_t _n{0};
+    // The cosine taper applied to the data in the time domain
+    std::vector<double> _taper;
+    // The inverse transfer function (including the cosine taper applied in
+    // the frequency domain) evaluated at the frequencies of the data's
+    // spectrum
+    std::vector<std::complex<double>> _coefficients;
+
+    // Guards both the FFT plan and the buffers
+    mutable std::mutex _mutex;
+    mutable filter::fft::RealFFT _fft;
+    mutable std::vector<double> _samples;
+    mutable std::vector<std::complex<double>> _spectrum;
+  };
+  using DeconvolutionCPtr = std::shared_ptr<const Deconvolution>;
+
+  struct Statistics {
+    std::size_t hits{0};
+    std::size_t misses{0};
+  };
+
+  static ResponseSpectrumCache &Instance();
+
+  ResponseSpectrumCache(const ResponseSpectrumCache &) = delete;
+  ResponseSpectrumCache &operator=(const ResponseSpectrumCache &) = delete;
+
+  // Reset the cache (including the statistics)
+  void reset();
+
+  // Sets the maximum number of cached operators
+  void setCapacity(std::size_t capacity);
+  std::size_t capacity() const;
+
+  // Returns the operator required for deconvolving `sampleCount` samples
+  // sampled at `samplingFrequency` using `response` (including
+  // `numberOfIntegrations` integrations). The operator is computed if not
+  // cached, yet. Returns `nullptr` if the operator cannot be computed.
+  DeconvolutionCPtr get(Processing::Response *response,
+                        int numberOfIntegrations, int sampleCount,
+                        double samplingFrequency, const TaperConfig &taper);
+
+  // Returns the number of cached operators
+  std::size_t size() const;
+  // Returns the approximate number of bytes allocated for cached operators
+  std::size_t memoryUsage() const;
+  // Returns the cache statistics
+  Statistics statistics() const;
+
+ private:
+  struct Entry {
+    // Keeps the response alive, i.e. its address (used for identification)
+    // is not reused while the operator is cached
+    //
+    // - the response is referenced (and released) while holding the lock,
+    // only
+    Processing::ResponseCPtr response;
+    DeconvolutionCPtr deconvolution;
+  };
+
+  ResponseSpectrumCache();
+
+  static DeconvolutionCPtr compute(Processing::Response *response,
+                                   int numberOfIntegrations, int sampleCount,
+                                   double samplingFrequency,
+                                   const TaperConfig &taper);
+
+  mutable std::mutex _mutex;
+  detect::util::LRUCache<Key, Entry> _cache;
+  Statistics _statistics;
+};
+
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_AMPLITUDE_RESPONSESPECTRUMCACHE_H_
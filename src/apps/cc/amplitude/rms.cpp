@@ -9,10 +9,12 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../settings.h"
 #include "../util/memory.h"
+#include "../util/memory_usage.h"
 #include "../util/util.h"
 #include "../util/waveform_stream_id.h"
 #include "factory.h"
@@ -56,6 +58,10 @@ void RMSAmplitude::setFilter(std::unique_ptr<DoubleFilter> filter,
   reset();
 }
 
+void RMSAmplitude::setFilterId(std::string filterId) {
+  _filterId = std::move(filterId);
+}
+
 void RMSAmplitude::setDeconvolutionConfig(const DeconvolutionConfig &config) {
   _deconvolutionConfig = config;
 }
@@ -74,6 +80,10 @@ const processing::StreamConfig &RMSAmplitude::streamConfig() const {
   return _streamConfig;
 }
 
+std::size_t RMSAmplitude::memoryUsage() const {
+  return util::byteSize(&_buffer);
+}
+
 processing::WaveformProcessor::StreamState *RMSAmplitude::streamState(
     const Record *record)  // NOLINT(misc-unused-parameters)
 {
@@ -86,7 +96,18 @@ void RMSAmplitude::process(StreamState &streamState, const Record *record,
   setStatus(Status::kInProgress, 1);
 
   _bufferedTimeWindow = streamState.dataTimeWindow;
-  preprocessData(_streamState, _streamConfig, _deconvolutionConfig, _buffer);
+
+  auto &cache{PreprocessingCache::Instance()};
+  const auto cacheKey{preprocessingCacheKey(record)};
+  if (cacheKey && cache.get(*cacheKey, _buffer)) {
+    // share data preprocessed by another amplitude processor
+    _bufferedTimeWindow = timeWindow();
+  } else {
+    preprocessData(_streamState, _streamConfig, _deconvolutionConfig, _buffer);
+    if (cacheKey && status() == Status::kInProgress) {
+      cache.put(*cacheKey, _buffer);
+    }
+  }
 
   auto amplitude{util::make_smart<Amplitude>()};
   amplitude->value.value = _buffer.rms();
@@ -162,6 +183,34 @@ void RMSAmplitude::preprocessData(
   const_cast<Processing::Stream &>(streamConfig).applyGain(data);
 }
 
+boost::optional<PreprocessingCache::Key> RMSAmplitude::preprocessingCacheKey(
+    const Record *record) const {
+  if (_streamState.filter && _filterId.empty()) {
+    return boost::none;
+  }
+
+  const auto sensor{_streamConfig.sensor()};
+  if (!sensor || !sensor->response()) {
+    return boost::none;
+  }
+
+  // the filtered data depends on the data the filter was applied to before
+  // the time window
+  const auto filterWarmUp{
+      _streamState.filter
+          ? timeWindow().startTime() - _streamState.dataTimeWindow.startTime()
+          : Core::TimeSpan{0.0}};
+  return PreprocessingCache::Key{record->streamID(),
+                                 timeWindow(),
+                                 filterWarmUp,
+                                 _streamState.samplingFrequency,
+                                 _streamState.filter ? _filterId : "",
+                                 _streamConfig.gain,
+                                 sensor->response(),
+                                 sensor->unit(),
+                                 _deconvolutionConfig};
+}
+
 AmplitudeProcessor::IndexRange RMSAmplitude::computeIndexRange(
     const Core::TimeWindow &tw) const {
   assert((_streamState.samplingFrequency));
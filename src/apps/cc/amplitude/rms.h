@@ -3,10 +3,14 @@
 
 #include <seiscomp/core/timewindow.h>
 
+#include <boost/optional/optional.hpp>
+#include <cstddef>
 #include <memory>
+#include <string>
 
 #include "../amplitude_processor.h"
 #include "../processing/stream_config.h"
+#include "preprocessing_cache.h"
 #include "seiscomp/core/datetime.h"
 
 namespace Seiscomp {
@@ -43,6 +47,10 @@ class RMSAmplitude : public AmplitudeProcessor {
   // - implicitly resets the waveform processor
   void setFilter(std::unique_ptr<DoubleFilter> filter,
                  Core::TimeSpan initTime = Core::TimeSpan{0.0});
+  // Sets the identifier of the filter configured (e.g. the filter string).
+  // Preprocessed data is shared by means of the `PreprocessingCache` only if
+  // the filter is identified (or no filter is configured).
+  void setFilterId(std::string filterId);
 
   void setDeconvolutionConfig(const DeconvolutionConfig &config);
   const DeconvolutionConfig &deconvolutionConfig() const;
@@ -50,6 +58,8 @@ class RMSAmplitude : public AmplitudeProcessor {
   void setStreamConfig(const processing::StreamConfig &streamConfig);
   const processing::StreamConfig &streamConfig() const;
 
+  std::size_t memoryUsage() const override;
+
  protected:
   StreamState *streamState(const Record *record) override;
 
@@ -68,10 +78,18 @@ class RMSAmplitude : public AmplitudeProcessor {
   AmplitudeProcessor::IndexRange computeIndexRange(
       const Core::TimeWindow &tw) const;
 
+  // Returns the preprocessing cache key w.r.t. `record`; returns `boost::none`
+  // if the preprocessed data must not be shared
+  boost::optional<PreprocessingCache::Key> preprocessingCacheKey(
+      const Record *record) const;
+
   processing::WaveformProcessor::StreamState _streamState;
   processing::StreamConfig _streamConfig;
   DeconvolutionConfig _deconvolutionConfig;
 
+  // Identifies the filter configured
+  std::string _filterId;
+
   Buffer _buffer;
 
   Core::TimeWindow _bufferedTimeWindow;
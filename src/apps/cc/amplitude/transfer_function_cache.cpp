@@ -0,0 +1,95 @@
+#include "transfer_function_cache.h"
+
+#include <boost/functional/hash.hpp>
+
+#include "../settings.h"
+
+namespace std {
+
+std::size_t
+hash<Seiscomp::detect::amplitude::transfer_function_cache_detail::CacheKey>::
+operator()(const Seiscomp::detect::amplitude::transfer_function_cache_detail::
+               CacheKey &key) const noexcept {
+  std::size_t ret{0};
+  boost::hash_combine(
+      ret, std::hash<const Seiscomp::Processing::Response *>{}(key.response));
+  boost::hash_combine(ret, std::hash<int>{}(key.numberOfIntegrations));
+  return ret;
+}
+
+}  // namespace std
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+
+namespace transfer_function_cache_detail {
+
+bool operator==(const CacheKey &lhs, const CacheKey &rhs) {
+  return (lhs.response == rhs.response &&
+          lhs.numberOfIntegrations == rhs.numberOfIntegrations);
+}
+
+bool operator!=(const CacheKey &lhs, const CacheKey &rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace transfer_function_cache_detail
+
+TransferFunctionCache::TransferFunctionCache()
+    : _cache{settings::kTransferFunctionCacheCapacity} {}
+
+TransferFunctionCache &TransferFunctionCache::Instance() {
+  // guaranteed to be destroyed; instantiated on first use
+  static TransferFunctionCache instance;
+  return instance;
+}
+
+void TransferFunctionCache::reset() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.clear();
+}
+
+void TransferFunctionCache::setCapacity(std::size_t capacity) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.setCapacity(capacity);
+}
+
+std::size_t TransferFunctionCache::capacity() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _cache.capacity();
+}
+
+TransferFunctionCache::TransferFunctionCPtr TransferFunctionCache::get(
+    Processing::Response *response, int numberOfIntegrations) {
+  if (!response) {
+    return nullptr;
+  }
+
+  Key key{response, numberOfIntegrations};
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto *cached{_cache.get(key)};
+    if (cached) {
+      return cached->transferFunction;
+    }
+  }
+
+  // create without holding the lock; if created concurrently, the most
+  // recently created transfer function is cached
+  TransferFunctionCPtr ret{response->getTransferFunction(numberOfIntegrations)};
+  if (ret) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _cache.put(key, Entry{response, ret});
+  }
+  return ret;
+}
+
+std::size_t TransferFunctionCache::size() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _cache.size();
+}
+
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
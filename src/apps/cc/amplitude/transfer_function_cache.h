@@ -0,0 +1,104 @@
+#ifndef SCDETECT_APPS_CC_AMPLITUDE_TRANSFERFUNCTIONCACHE_H_
+#define SCDETECT_APPS_CC_AMPLITUDE_TRANSFERFUNCTIONCACHE_H_
+
+#include <seiscomp/math/restitution/transferfunction.h>
+#include <seiscomp/processing/response.h>
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+#include "../util/lru_cache.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+namespace transfer_function_cache_detail {
+
+struct CacheKey {
+  const Processing::Response *response;
+  int numberOfIntegrations;
+
+  friend bool operator==(const CacheKey &lhs, const CacheKey &rhs);
+  friend bool operator!=(const CacheKey &lhs, const CacheKey &rhs);
+};
+
+}  // namespace transfer_function_cache_detail
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
+
+namespace std {
+
+template <>
+struct hash<
+    Seiscomp::detect::amplitude::transfer_function_cache_detail::CacheKey> {
+  std::size_t operator()(
+      const Seiscomp::detect::amplitude::transfer_function_cache_detail::
+          CacheKey &key) const noexcept;
+};
+
+}  // namespace std
+
+namespace Seiscomp {
+namespace detect {
+namespace amplitude {
+
+// A global cache for sensor response transfer functions used for
+// deconvolution
+//
+// - transfer functions are specific to the sensor response and the number of
+// integrations
+// - least recently used entries are evicted if the capacity is exceeded
+// - thread-safe; the transfer functions cached are shared between threads
+// (evaluating a transfer function does not modify it)
+// - implements the Singleton Design Pattern
+class TransferFunctionCache {
+ public:
+  using Key = transfer_function_cache_detail::CacheKey;
+  using TransferFunctionCPtr = Math::Restitution::FFT::TransferFunctionCPtr;
+
+  static TransferFunctionCache &Instance();
+
+  TransferFunctionCache(const TransferFunctionCache &) = delete;
+  TransferFunctionCache &operator=(const TransferFunctionCache &) = delete;
+
+  // Reset the cache
+  void reset();
+
+  // Sets the maximum number of cached transfer functions
+  void setCapacity(std::size_t capacity);
+  std::size_t capacity() const;
+
+  // Returns the transfer function of `response` (including
+  // `numberOfIntegrations` integrations). The transfer function is created if
+  // not cached, yet. Returns `nullptr` if the transfer function cannot be
+  // created.
+  TransferFunctionCPtr get(Processing::Response *response,
+                           int numberOfIntegrations);
+
+  // Returns the number of cached transfer functions
+  std::size_t size() const;
+
+ private:
+  struct Entry {
+    // Keeps the response alive, i.e. its address (used for identification)
+    // is not reused while the transfer function is cached
+    //
+    // - the response is referenced (and released) while holding the lock,
+    // only
+    Processing::ResponseCPtr response;
+    TransferFunctionCPtr transferFunction;
+  };
+
+  TransferFunctionCache();
+
+  mutable std::mutex _mutex;
+  detect::util::LRUCache<Key, Entry> _cache;
+};
+
+}  // namespace amplitude
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_AMPLITUDE_TRANSFERFUNCTIONCACHE_H_
@@ -6,7 +6,9 @@
 #include <seiscomp/utils/files.h>
 
 #include <cmath>
+#include <cstddef>
 
+#include "amplitude/response_spectrum_cache.h"
 #include "waveform.h"
 
 namespace Seiscomp {
@@ -27,6 +29,11 @@ void AmplitudeProcessor::setResultCallback(
   _resultCallback = callback;
 }
 
+const AmplitudeProcessor::PublishAmplitudeCallback &
+AmplitudeProcessor::resultCallback() const {
+  return _resultCallback;
+}
+
 const std::string &AmplitudeProcessor::type() const { return _type; }
 
 const std::string &AmplitudeProcessor::unit() const { return _unit; }
@@ -51,6 +58,8 @@ const AmplitudeProcessor::Environment &AmplitudeProcessor::environment() const {
 
 void AmplitudeProcessor::finalize(DataModel::Amplitude *amplitude) const {}
 
+std::size_t AmplitudeProcessor::memoryUsage() const { return 0; }
+
 void AmplitudeProcessor::setType(std::string type) { _type = std::move(type); }
 
 void AmplitudeProcessor::setUnit(std::string unit) { _unit = std::move(unit); }
@@ -108,13 +117,19 @@ bool AmplitudeProcessor::deconvolveData(StreamState &streamState,
   // XXX(damb): integration is implemented by means of deconvolution i.e. by
   // means of adding an additional zero to the nominator of the rational
   // transfer function
-  if (!resp->deconvolveFFT(
-          data, streamState.samplingFrequency, config.responseTaperLength,
-          config.minimumResponseTaperFrequency,
-          config.maximumResponseTaperFrequency,
-          numberOfIntegrations < 0 ? 0 : numberOfIntegrations)) {
+  //
+  // - the deconvolution operator (i.e. the evaluated response spectrum, the
+  // tapers and the FFT plan) is shared between amplitude processors
+  const auto deconvolution{amplitude::ResponseSpectrumCache::Instance().get(
+      resp, numberOfIntegrations < 0 ? 0 : numberOfIntegrations, data.size(),
+      streamState.samplingFrequency,
+      amplitude::ResponseSpectrumCache::TaperConfig{
+          config.responseTaperLength, config.minimumResponseTaperFrequency,
+          config.maximumResponseTaperFrequency})};
+  if (!deconvolution) {
     return false;
   }
+  deconvolution->apply(data.typedData());
 
   if (numberOfIntegrations < 0) {
     if (!deriveData(streamState, abs(numberOfIntegrations), data)) {
@@ -14,6 +14,7 @@
 #include <seiscomp/processing/response.h>
 
 #include <boost/optional/optional.hpp>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -101,6 +102,8 @@ class AmplitudeProcessor : public processing::TimeWindowProcessor {
 
   // Sets the `callback` in order to publish detections
   void setResultCallback(const PublishAmplitudeCallback &callback);
+  // Returns the callback used in order to publish amplitudes
+  const PublishAmplitudeCallback &resultCallback() const;
 
   // Returns the amplitude type
   const std::string &type() const;
@@ -122,6 +125,11 @@ class AmplitudeProcessor : public processing::TimeWindowProcessor {
   // code
   virtual void finalize(DataModel::Amplitude *amplitude) const;
 
+  // Returns the approximate number of bytes allocated for buffering data
+  //
+  // - the default implementation returns `0`
+  virtual std::size_t memoryUsage() const;
+
  protected:
   struct NoiseInfo {
     // The noise offset
@@ -28,11 +28,15 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <exception>
 #include <ios>
 #include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -41,14 +45,22 @@
 #include <vector>
 
 #include "amplitude/factory.h"
+#include "amplitude/preprocessing_cache.h"
+#include "amplitude/response_spectrum_cache.h"
+#include "amplitude/transfer_function_cache.h"
 #include "amplitude_processor.h"
 #include "builder.h"
+#include "checkpoint.h"
 #include "config/detector.h"
 #include "config/exception.h"
+#include "config/template_config_reader.h"
 #include "config/validators.h"
+#include "correlation_tuner.h"
 #include "detector/arrival.h"
+#include "detector/correlation_group.h"
 #include "detector/detector.h"
 #include "eventstore.h"
+#include "filter/iir.h"
 #include "log.h"
 #include "magnitude/regression.h"
 #include "magnitude_processor.h"
@@ -58,6 +70,8 @@
 #include "resamplerstore.h"
 #include "util/horizontal_components.h"
 #include "util/memory.h"
+#include "util/memory_usage.h"
+#include "util/profiler.h"
 #include "util/util.h"
 #include "util/waveform_stream_id.h"
 #include "version.h"
@@ -83,6 +97,36 @@ bool requiresMagnitude(const binding::Bindings &bindings,
   return false;
 }
 
+// Returns the zero-lag Pearson correlation coefficient of the (equally sized)
+// template waveforms `a` and `b`
+double similarity(const TemplateWaveform &a, const TemplateWaveform &b) {
+  const auto *dataA{DoubleArray::ConstCast(a.waveform().data())};
+  const auto *dataB{DoubleArray::ConstCast(b.waveform().data())};
+  if (!dataA || !dataB || dataA->size() != dataB->size() ||
+      dataA->size() == 0) {
+    return 0;
+  }
+
+  const auto n{static_cast<double>(dataA->size())};
+  const auto *x{dataA->typedData()};
+  const auto *y{dataB->typedData()};
+  double sumX{0}, sumY{0}, sumXX{0}, sumYY{0}, sumXY{0};
+  for (int i = 0; i < dataA->size(); ++i) {
+    sumX += x[i];
+    sumY += y[i];
+    sumXX += x[i] * x[i];
+    sumYY += y[i] * y[i];
+    sumXY += x[i] * y[i];
+  }
+
+  const auto denominator{std::sqrt(n * sumXX - sumX * sumX) *
+                         std::sqrt(n * sumYY - sumY * sumY)};
+  if (!(denominator > 0)) {
+    return 0;
+  }
+  return (n * sumXY - sumX * sumY) / denominator;
+}
+
 }  // namespace
 
 Application::Application(int argc, char **argv)
@@ -104,6 +148,9 @@ Application::ConfigError::ConfigError()
 Application::DuplicatePublicObjectId::DuplicatePublicObjectId()
     : BaseException{"duplicate public object identifier"} {}
 
+Application::MemoryBudgetExceeded::MemoryBudgetExceeded()
+    : BaseException{"memory budget exceeded"} {}
+
 const char *Application::version() { return kVersion; }
 
 void Application::createCommandLineDescription() {
@@ -151,6 +198,31 @@ void Application::createCommandLineDescription() {
   commandline().addOption(
       "Mode", "templates-reload",
       "force reloading template waveform data and omit cached waveform data");
+  commandline().addOption(
+      "Mode", "templates-watch",
+      "interval in seconds for checking the template configuration file for "
+      "modifications; if modified, detectors are reloaded at runtime (only "
+      "added, removed or modified detectors are affected)",
+      &_config.templatesWatchInterval, false);
+  commandline().addOption(
+      "Mode", "checkpoint",
+      "path to a processor state checkpoint file; the file is written "
+      "periodically and restored at startup such that template processors "
+      "whose data resumes within the checkpoint tolerance continue "
+      "processing without initialization; pending linker candidates are "
+      "restored, too (requires both detectorId and templateId to be "
+      "configured)",
+      &_config.pathCheckpoint);
+  commandline().addOption(
+      "Mode", "checkpoint-interval",
+      "interval in seconds for writing the processor state checkpoint file",
+      &_config.checkpointInterval);
+  commandline().addOption(
+      "Mode", "checkpoint-tolerance",
+      "maximum number of samples missing between the data checkpointed and "
+      "the data received after a restart in order to restore the processor "
+      "state (overlapping data is rejected)",
+      &_config.checkpointTolerance);
   commandline().addOption(
       "Mode", "amplitudes-force",
       "enables/disables the calculation of amplitudes regardless of the "
@@ -161,6 +233,67 @@ void Application::createCommandLineDescription() {
       "enables/disables the calculation of magnitudes regardless of the "
       "configuration provided on detector configuration level granularity",
       &_config.magnitudesForceMode, false);
+  commandline().addOption(
+      "Mode", "amplitudes-workers",
+      "number of worker threads computing amplitudes asynchronously from "
+      "buffered waveform data; if 0, amplitudes are computed by the record "
+      "processing thread",
+      &_config.amplitudeWorkers);
+  commandline().addOption(
+      "Mode", "coarse-search-force",
+      "enables the coarse-to-fine template search with the given decimation "
+      "factor regardless of the configuration provided on detector "
+      "configuration level granularity; a value less or equal to 1 disables "
+      "the coarse-to-fine search",
+      &_config.coarseSearchForcedDecimation, false);
+  commandline().addOption(
+      "Mode", "prescreen-force",
+      "enables the quantized pre-screening with the given margin regardless "
+      "of the configuration provided on detector configuration level "
+      "granularity; a negative value disables the pre-screening",
+      &_config.prescreenForcedMargin, false);
+  commandline().addOption(
+      "Mode", "fuse-components-force",
+      "enables/disables fusing the components of a station into a single "
+      "multichannel cross-correlation regardless of the configuration "
+      "provided on detector configuration level granularity",
+      &_config.fuseComponentsForceMode, false);
+  commandline().addOption(
+      "Mode", "stacking-force",
+      "enables/disables the stacking detector mode regardless of the "
+      "configuration provided on detector configuration level granularity",
+      &_config.stackingForceMode, false);
+  commandline().addOption(
+      "Mode", "correlation-block-size-force",
+      "enables the uniformly partitioned frequency-domain cross-correlation "
+      "with the given block size (in samples) regardless of the configuration "
+      "provided on detector configuration level granularity; a value less "
+      "than or equal to 0 disables the partitioned cross-correlation",
+      &_config.correlationForcedBlockSize, false);
+  commandline().addOption(
+      "Mode", "correlation-sharing-force",
+      "shares the cross-correlations of template waveforms processing the "
+      "same stream with a similarity greater than or equal to the given "
+      "value regardless of the module configuration; a value less than or "
+      "equal to 0 disables correlation sharing",
+      &_config.correlationSharingForcedSimilarity, false);
+  commandline().addOption(
+      "Mode", "auto-tune-force",
+      "enables/disables selecting the cross-correlation kernel per template "
+      "waveform by means of micro-benchmarks at startup regardless of the "
+      "module configuration",
+      &_config.autoTuneForceMode, false);
+  commandline().addOption(
+      "Mode", "auto-tune-cache",
+      "path to the host specific auto-tuning cache file; defaults to a file "
+      "within the module's caching directory",
+      &_config.pathAutoTuneCache);
+  commandline().addOption(
+      "Mode", "native-filters-force",
+      "enables/disables filtering by means of the natively implemented "
+      "Butterworth filters (in place of the generic SeisComP implementation) "
+      "regardless of the module configuration",
+      &_config.nativeFiltersForceMode, false);
 
   commandline().addGroup("Monitor");
   commandline().addOption(
@@ -175,6 +308,20 @@ void Application::createCommandLineDescription() {
       "Monitor", "monitor-throughput-log-interval",
       "log message interval in seconds for object throughput monitoring",
       &_config.objectThroughputNofificationInterval, false);
+  commandline().addOption(
+      "Monitor", "startup-report",
+      "write a JSON formatted startup profiling report (wall and CPU time, "
+      "item counts and cache hit rates per initialization phase and "
+      "detector) to the given path; specifying the output path as '-' (a "
+      "single dash) will force the output to be redirected to stdout",
+      &_config.pathStartupReport);
+  commandline().addOption(
+      "Monitor", "memory-budget",
+      "global memory budget in MiB; if exceeded, detectors are rejected when "
+      "being created and amplitude calculation is disabled for running "
+      "detectors (starting with the detectors whose amplitude processors use "
+      "the most memory) until the memory usage drops below the budget",
+      &_config.memoryBudget, false);
 
   commandline().addGroup("Input");
   commandline().addOption(
@@ -275,6 +422,20 @@ bool Application::validateParameters() {
         _config.detectorConfig.minArrivals);
     return false;
   }
+  if (!config::validateXCorrThreshold(
+          _config.detectorConfig.coarseSearchThreshold)) {
+    SCDETECT_LOG_ERROR(
+        "Invalid configuration: 'coarseSearchThreshold': %f. Not in "
+        "interval [-1,1].",
+        _config.detectorConfig.coarseSearchThreshold);
+    return false;
+  }
+  if (_config.detectorConfig.subspaceDimension < 1) {
+    SCDETECT_LOG_ERROR(
+        "Invalid configuration: 'subspaceDimension': %d. Must be >= 1",
+        _config.detectorConfig.subspaceDimension);
+    return false;
+  }
   if (!config::validateLinkerMergingStrategy(
           _config.detectorConfig.mergingStrategy)) {
     SCDETECT_LOG_ERROR(
@@ -312,6 +473,46 @@ bool Application::validateParameters() {
         *_config.objectThroughputNofificationInterval);
     return false;
   }
+  if (_config.correlationSharingSimilarity > 1) {
+    SCDETECT_LOG_ERROR(
+        "Invalid configuration: 'correlationSharingSimilarity': %f. Must be "
+        "<= 1",
+        _config.correlationSharingSimilarity);
+    return false;
+  }
+  if (_config.correlationSharingForcedSimilarity &&
+      *_config.correlationSharingForcedSimilarity > 1) {
+    SCDETECT_LOG_ERROR(
+        "Invalid configuration: 'correlation-sharing-force': %f. Must be <= 1",
+        *_config.correlationSharingForcedSimilarity);
+    return false;
+  }
+  if (_config.fuseComponentsForceMode && *_config.fuseComponentsForceMode) {
+    if (!_config.pathCheckpoint.empty()) {
+      SCDETECT_LOG_ERROR(
+          "Invalid configuration: 'fuse-components-force' is incompatible "
+          "with checkpointing ('checkpoint')");
+      return false;
+    }
+    if (_config.correlationSharingForcedSimilarity.value_or(
+            _config.correlationSharingSimilarity) > 0) {
+      SCDETECT_LOG_ERROR(
+          "Invalid configuration: 'fuse-components-force' is incompatible "
+          "with correlation sharing");
+      return false;
+    }
+  }
+  if (_config.autoTuneMaxLatency < 0) {
+    SCDETECT_LOG_ERROR(
+        "Invalid configuration: 'autoTuneMaxLatency': %f. Must be >= 0",
+        _config.autoTuneMaxLatency);
+    return false;
+  }
+  if (_config.memoryBudget && *_config.memoryBudget < 1) {
+    SCDETECT_LOG_ERROR("Invalid configuration: 'memory-budget': %lu < 1",
+                       *_config.memoryBudget);
+    return false;
+  }
 
   return true;
 }
@@ -378,34 +579,28 @@ bool Application::init() {
     SCDETECT_LOG_INFO("Playback mode enabled");
   }
 
+  _startupProfiler.reset();
+  _waveformCaches.clear();
+
+  // must be configured before filters are created
+  if (_config.nativeFiltersForceMode.value_or(_config.nativeFilters)) {
+    SCDETECT_LOG_INFO("Using natively implemented Butterworth filters");
+    filter::iir::setNativeFilters(true);
+  }
+
   // load event related data
+  auto loadEventsPhase{_startupProfiler.measure("loadEvents")};
   if (!loadEvents(_config.urlEventDb, query())) {
     SCDETECT_LOG_ERROR("Failed to load events");
     return false;
   }
+  loadEventsPhase.setCount(EventStore::Instance().eventCount());
+  loadEventsPhase.stop();
 
-  // TODO(damb): Check if std::unique_ptr wouldn't be sufficient, here.
-  WaveformHandlerIfacePtr waveformHandler{
-      util::make_smart<WaveformHandler>(recordStreamURL())};
-  if (!_config.templatesNoCache) {
-    // cache template waveforms on filesystem
-    _config.pathFilesystemCache =
-        boost::filesystem::path(_config.pathFilesystemCache).string();
-    if (!Util::pathExists(_config.pathFilesystemCache) &&
-        !Util::createPath(_config.pathFilesystemCache)) {
-      SCDETECT_LOG_ERROR("Failed to create path (waveform cache): %s",
-                         _config.pathFilesystemCache.c_str());
-      return false;
-    }
-
-    waveformHandler = util::make_smart<FileSystemCache>(
-        waveformHandler, _config.pathFilesystemCache,
-        settings::kCacheRawWaveforms);
+  auto waveformHandler{createWaveformHandler()};
+  if (!waveformHandler) {
+    return false;
   }
-  // cache demeaned template waveform snippets in order to speed up the
-  // initialization procedure
-  waveformHandler =
-      util::make_smart<InMemoryCache>(waveformHandler, /*raw=*/false);
 
   // load template related data
   // TODO(damb):
@@ -419,6 +614,17 @@ bool Application::init() {
   TemplateConfigs templateConfigs;
   SCDETECT_LOG_INFO("Loading template configuration from %s",
                     _config.pathTemplateJson.c_str());
+  if (_config.templatesWatchInterval) {
+    _templateConfigModificationTime =
+        boost::filesystem::last_write_time(_config.pathTemplateJson);
+    _nextTemplateConfigCheck =
+        Core::Time::GMT() +
+        Core::TimeSpan{static_cast<double>(*_config.templatesWatchInterval)};
+  }
+  initSubspaceFamilies();
+
+  auto initDetectorsPhase{_startupProfiler.measure("initDetectors")};
+  const auto initDetectorsCacheStatistics{waveformCacheStatistics()};
   try {
     std::ifstream ifs{_config.pathTemplateJson};
     if (!initDetectors(ifs, waveformHandler.get(), templateConfigs) ||
@@ -431,18 +637,46 @@ bool Application::init() {
         _config.pathTemplateJson.c_str(), e.what());
     return false;
   }
+  initDetectorsPhase.setCount(_detectors.size());
+  setCacheStatistics(initDetectorsPhase, initDetectorsCacheStatistics);
+  initDetectorsPhase.stop();
+
+  if (_config.correlationSharingForcedSimilarity.value_or(
+          _config.correlationSharingSimilarity) > 0) {
+    auto phase{_startupProfiler.measure("initCorrelationGroups")};
+    phase.setCount(initCorrelationGroups());
+  }
+
+  if (!_config.templatesPrepare &&
+      _config.autoTuneForceMode.value_or(_config.autoTune)) {
+    auto phase{_startupProfiler.measure("initCorrelationKernels")};
+    phase.setCount(initCorrelationKernels());
+  }
+
+  if (!_config.pathCheckpoint.empty()) {
+    auto phase{_startupProfiler.measure("restoreCheckpoint")};
+    phase.setCount(restoreCheckpoint());
+    _nextCheckpoint =
+        Core::Time::GMT() +
+        Core::TimeSpan{static_cast<double>(_config.checkpointInterval)};
+  }
 
   // load bindings
   if (configModule()) {
+    auto loadBindingsPhase{_startupProfiler.measure("loadBindings")};
     _bindings.setDefault(_config.sensorLocationBindings);
 
     SCDETECT_LOG_DEBUG("Loading binding configuration");
     _bindings.load(&configuration(), configModule(), name());
   }
 
-  initAmplitudeProcessorFactory();
+  {
+    auto phase{_startupProfiler.measure("initAmplitudeProcessorFactory")};
+    initAmplitudeProcessorFactory();
+  }
 
   try {
+    auto phase{_startupProfiler.measure("initWaveformBuffer")};
     _waveformBuffer.setTimeSpan(
         computeWaveformBufferSize(templateConfigs, _bindings, _config));
   } catch (const ConfigError &e) {
@@ -454,13 +688,21 @@ bool Application::init() {
                                 !*_config.magnitudesForceMode};
   // optionally configure magnitude processors
   if (!magnitudesForcedDisabled) {
+    auto phase{_startupProfiler.measure("initMagnitudeProcessorFactory")};
+    const auto cacheStatistics{waveformCacheStatistics()};
     // TODO(damb): which `waveformHandler` to be used?
     initMagnitudeProcessorFactory(waveformHandler.get(), templateConfigs,
                                   _bindings, _config);
+    setCacheStatistics(phase, cacheStatistics);
   }
 
   // free memory after initialization
   EventStore::Instance().reset();
+  _waveformCaches.clear();
+
+  if (!_config.pathStartupReport.empty()) {
+    writeStartupReport(_config.pathStartupReport);
+  }
 
   return true;
 }
@@ -469,6 +711,7 @@ bool Application::run() {
   SCDETECT_LOG_DEBUG("Application initialized");
 
   if (_config.templatesPrepare) {
+    logMemoryUsage(true);
     SCDETECT_LOG_DEBUG(
         "Requested application exit after template initialization");
     return true;
@@ -483,7 +726,15 @@ bool Application::run() {
   }
 
   SCDETECT_LOG_DEBUG("Subscribing to streams required for processing");
-  subscribeToRecordStream(collectStreams());
+  _subscribedStreams = collectStreams();
+  subscribeToRecordStream(_subscribedStreams);
+
+  if (_config.amplitudeWorkers > 0) {
+    SCDETECT_LOG_DEBUG("Starting amplitude worker pool (workers=%lu)",
+                       _config.amplitudeWorkers);
+    _amplitudeWorkerPool =
+        util::make_unique<util::WorkerPool>(_config.amplitudeWorkers);
+  }
 
   if (!_config.playbackConfig.startTimeStr.empty()) {
     recordStream()->setStartTime(_config.playbackConfig.startTime);
@@ -498,17 +749,35 @@ bool Application::run() {
 }
 
 void Application::done() {
+  _templateConfigReload.reset();
+  closeAcquisitions();
+
   if (!_config.templatesPrepare) {
+    if (!_config.pathCheckpoint.empty()) {
+      writeCheckpoint();
+    }
+    if (_checkpointWriter.joinable()) {
+      _checkpointWriter.join();
+    }
+
     // terminate detectors
     for (const auto &detector : _detectors) {
       detector->terminate();
     }
 
+    // merge the amplitudes computed asynchronously
+    if (_amplitudeWorkerPool) {
+      _amplitudeWorkerPool->wait();
+    }
+
     // flush pending detections
-    for (const auto &detectionPair : _detections) {
-      publishDetection(detectionPair.second);
+    for (const auto &detection : _detections) {
+      publishDetection(detection);
     }
     _detections.clear();
+    _publicationQueue.clear();
+    _streamRoutes.clear();
+    _deferredTimeWindowProcessors.clear();
 
     if (_ep) {
       IO::XMLArchive ar;
@@ -521,8 +790,14 @@ void Application::done() {
     }
   }
 
+  // stop the workers before resetting the caches shared with them
+  _amplitudeWorkerPool.reset();
+
   EventStore::Instance().reset();
   RecordResamplerStore::Instance().reset();
+  amplitude::PreprocessingCache::Instance().reset();
+  amplitude::ResponseSpectrumCache::Instance().reset();
+  amplitude::TransferFunctionCache::Instance().reset();
   AmplitudeProcessor::Factory::reset();
   MagnitudeProcessor::Factory::reset();
 
@@ -537,6 +812,10 @@ bool Application::dispatch(Core::BaseObject *obj) {
 }
 
 void Application::handleTimeout() {
+  if (_amplitudeWorkerPool) {
+    _amplitudeWorkerPool->poll();
+  }
+
   auto runningMean{_averageObjectThroughputMonitor.value(Core::Time::GMT())};
   std::string msg{"Current object throughput per second (averaged): " +
                   std::to_string(runningMean)};
@@ -571,6 +850,8 @@ void Application::handleTimeout() {
       SCDETECT_LOG_DEBUG("%s", msg.c_str());
     }
   }
+
+  logMemoryUsage(false);
 }
 
 void Application::handleRecord(Record *rec) {
@@ -579,16 +860,48 @@ void Application::handleRecord(Record *rec) {
 
   if (!rec || !rec->data()) return;
 
+  // streams not required anymore (but still delivered by the record stream)
+  if (!_droppedStreams.empty() &&
+      _droppedStreams.find(rec->streamID()) != _droppedStreams.end() &&
+      _streamRoutes.find(rec->streamID()) == _streamRoutes.end()) {
+    return;
+  }
+
+  // merge the amplitudes computed asynchronously (never blocks)
+  if (_amplitudeWorkerPool) {
+    _amplitudeWorkerPool->poll();
+  }
+
+  if (_config.templatesWatchInterval) {
+    handleTemplateConfigReload();
+  }
+
+  if (!_config.pathCheckpoint.empty()) {
+    handleCheckpoint();
+  }
+
+  if (_config.memoryBudget) {
+    handleMemoryBudget();
+  }
+
   bool waveformBufferingEnabled{_config.forcedWaveformBufferSize.value_or(
                                     Core::TimeSpan{0.0}) > Core::TimeSpan{0.0}};
   if (waveformBufferingEnabled && !_waveformBuffer.feed(rec)) return;
 
-  auto detectorRange{_detectorIdx.equal_range(std::string{rec->streamID()})};
-  for (auto it = detectorRange.first; it != detectorRange.second; ++it) {
-    auto &detector{_detectors[it->second]};
+  auto routeIt{_streamRoutes.find(rec->streamID())};
+  if (routeIt == _streamRoutes.end()) {
+    return;
+  }
+  // references to the elements of an unordered map remain valid when inserting,
+  // i.e. the route may safely be referenced while records are dispatched
+  const auto &waveformStreamId{routeIt->first};
+  auto &route{routeIt->second};
+
+  for (const auto &detectorIdx : route.detectors) {
+    auto &detector{_detectors[detectorIdx]};
     if (detector->enabled()) {
       if (!detector->feed(rec)) {
-        logging::TaggedMessage msg{it->first,
+        logging::TaggedMessage msg{waveformStreamId,
                                    "Failed to feed record into detector (" +
                                        detector->id() + "). Resetting."};
         SCDETECT_LOG_WARNING("%s", logging::to_string(msg).c_str());
@@ -597,8 +910,8 @@ void Application::handleRecord(Record *rec) {
       }
     } else {
       logging::TaggedMessage msg{
-          it->first, "Skip feeding record to detector (id=" + detector->id() +
-                         "). Reason: Disabled."};
+          waveformStreamId, "Skip feeding record to detector (id=" +
+                                detector->id() + "). Reason: Disabled."};
       SCDETECT_LOG_WARNING("%s", logging::to_string(msg).c_str());
     }
   }
@@ -606,27 +919,36 @@ void Application::handleRecord(Record *rec) {
   {
     _timeWindowProcessorRegistrationBlocked = true;
 
-    auto range{_timeWindowProcessors.equal_range(rec->streamID())};
-    for (auto it = range.first; it != range.second; ++it) {
-      const auto &proc{it->second};
+    // while blocked, neither registration nor removal modifies the route
+    for (const auto &proc : route.timeWindowProcessors) {
       // the time window processor must not be already on the removal list
-      if (std::find_if(
-              std::begin(_timeWindowProcessorRemovalQueue),
-              std::end(_timeWindowProcessorRemovalQueue),
-              [&proc](
-                  const decltype(_timeWindowProcessorRemovalQueue)::value_type
-                      &item) { return item.timeWindowProcessor == proc; }) !=
-          _timeWindowProcessorRemovalQueue.end()) {
+      if (_timeWindowProcessorsScheduledForRemoval.find(proc.get()) !=
+          _timeWindowProcessorsScheduledForRemoval.end()) {
+        continue;
+      }
+
+      // schedule deferred processors for submission when their time window is
+      // buffered
+      if (_deferredTimeWindowProcessors.find(proc.get()) !=
+          _deferredTimeWindowProcessors.end()) {
+        const auto &waveformStreamIds{_timeWindowProcessorIdx.at(proc->id())};
+        const auto buffered{bufferedTimeWindow(waveformStreamIds)};
+        if (buffered &&
+            buffered->endTime() >= proc->safetyTimeWindow().endTime()) {
+          _deferredTimeWindowProcessors.erase(proc.get());
+          _timeWindowProcessorSubmissionQueue.emplace_back(
+              TimeWindowProcessorQueueItem{waveformStreamIds, proc});
+        }
         continue;
       }
 
       // schedule the time window processor for deletion when finished
-      if (it->second->finished()) {
-        removeTimeWindowProcessor(it->second);
+      if (proc->finished()) {
+        removeTimeWindowProcessor(proc);
       } else {
-        it->second->feed(rec);
-        if (it->second->finished()) {
-          removeTimeWindowProcessor(it->second);
+        proc->feed(rec);
+        if (proc->finished()) {
+          removeTimeWindowProcessor(proc);
         }
       }
     }
@@ -638,6 +960,7 @@ void Application::handleRecord(Record *rec) {
       const auto processor{
           _timeWindowProcessorRemovalQueue.front().timeWindowProcessor};
       _timeWindowProcessorRemovalQueue.pop_front();
+      _timeWindowProcessorsScheduledForRemoval.erase(processor.get());
       removeTimeWindowProcessor(processor);
     }
 
@@ -650,30 +973,29 @@ void Application::handleRecord(Record *rec) {
           timeWindowProcessorQueueItem.waveformStreamIds,
           timeWindowProcessorQueueItem.timeWindowProcessor);
     }
+
+    // submit deferred amplitude processors
+    while (!_timeWindowProcessorSubmissionQueue.empty()) {
+      const auto item{_timeWindowProcessorSubmissionQueue.front()};
+      _timeWindowProcessorSubmissionQueue.pop_front();
+      unrouteTimeWindowProcessor(item.waveformStreamIds,
+                                 item.timeWindowProcessor);
+      submitAmplitudeProcessor(
+          item.waveformStreamIds,
+          std::static_pointer_cast<AmplitudeProcessor>(
+              item.timeWindowProcessor));
+    }
   }
 
   {
     _detectionRegistrationBlocked = true;
 
-    auto range{_detections.equal_range(rec->streamID())};
-    for (auto it = range.first; it != range.second; ++it) {
-      auto &detection{it->second};
+    for (const auto &detection : route.detections) {
       // the detection must not be already in the removal list
-      if (std::find(std::begin(_detectionRemovalQueue),
-                    std::end(_detectionRemovalQueue),
-                    detection) != std::end(_detectionRemovalQueue)) {
+      if (detection->removalScheduled) {
         continue;
       }
 
-      for (const auto &amplitudePair : detection->amplitudes) {
-        bool amplitudeProcessorAlreadyRemoved{
-            _timeWindowProcessorIdx.find(amplitudePair.first) ==
-            std::end(_timeWindowProcessorIdx)};
-        if (amplitudeProcessorAlreadyRemoved && !amplitudePair.second) {
-          --detection->numberOfRequiredAmplitudes;
-        }
-      }
-
       // schedule the detection for deletion when finished
       if (detection->ready()) {
         publishAndRemoveDetection(detection);
@@ -923,29 +1245,68 @@ void Application::processDetection(
       (_config.amplitudesForceMode && !*_config.amplitudesForceMode) &&
       !magnitudeForcedEnabled};
 
-  if (amplitudeForcedEnabled ||
-      (!amplitudeForcedDisabled &&
-       detectionItem.detection->publishConfig.createAmplitudes)) {
+  // amplitudes might have been disabled due to the memory budget
+  auto amplitudeBudgetDisabled{_amplitudesDisabled.find(processor->id()) !=
+                               _amplitudesDisabled.end()};
+
+  auto detectionItemPtr{
+      std::make_shared<DetectionItem>(std::move(detectionItem))};
+  // amplitudes computed asynchronously finish in arbitrary order, i.e. make
+  // sure detections are published in the order they were issued
+  if (_amplitudeWorkerPool) {
+    _publicationQueue.push_back(detectionItemPtr);
+  }
+
+  if (!amplitudeBudgetDisabled &&
+      (amplitudeForcedEnabled ||
+       (!amplitudeForcedDisabled &&
+        detectionItemPtr->detection->publishConfig.createAmplitudes))) {
     // XXX(damb): as soon as either amplitudes or magnitudes need to be
     // computed, the detection is issued as a wholesale due to simplicity.
     // (Note that the amplitudes could be issued independently from the origin
     // while magnitudes need to be associated to the origin.)
-    auto detectionItemPtr{
-        std::make_shared<DetectionItem>(std::move(detectionItem))};
     registerDetection(detectionItemPtr);
 
     initAmplitudeProcessors(detectionItemPtr, *processor);
+    // amplitudes (and magnitudes) might have been computed from buffered data,
+    // already
+    if (detectionItemPtr->ready()) {
+      publishAndRemoveDetection(detectionItemPtr);
+    }
   } else {
-    publishDetection(detectionItem);
+    publishDetection(detectionItemPtr);
   }
 }
 
 void Application::publishDetection(
     const std::shared_ptr<DetectionItem> &detection) {
-  if (!detection->published) {
-    publishDetection(*detection);
+  if (detection->published) {
+    return;
+  }
+
+  if (_amplitudeWorkerPool) {
+    detection->released = true;
+    flushPublicationQueue();
+    return;
+  }
+
+  publishDetection(*detection);
+  detection->published = true;
+}
 
-    detection->published = true;
+void Application::flushPublicationQueue() {
+  while (!_publicationQueue.empty()) {
+    const auto detection{_publicationQueue.front()};
+    // detections expired are published regardless of pending amplitudes
+    if (!detection->released && !detection->ready()) {
+      break;
+    }
+
+    _publicationQueue.pop_front();
+    if (!detection->published) {
+      publishDetection(*detection);
+      detection->published = true;
+    }
   }
 }
 
@@ -1417,6 +1778,43 @@ bool Application::isEventDatabaseEnabled() const {
   return _config.urlEventDb.empty();
 }
 
+Cached::Statistics Application::waveformCacheStatistics() const {
+  Cached::Statistics ret;
+  if (_waveformCaches.empty()) {
+    return ret;
+  }
+
+  // caches are chained i.e. only misses of the innermost cache require fetching
+  // data from the recordstream
+  for (const auto &cache : _waveformCaches) {
+    ret.hits += cache->statistics().hits;
+  }
+  ret.misses = _waveformCaches.back()->statistics().misses;
+  return ret;
+}
+
+void Application::setCacheStatistics(util::Profiler::Scope &scope,
+                                     const Cached::Statistics &since) const {
+  const auto current{waveformCacheStatistics()};
+  scope.setCacheStatistics(current.hits - since.hits,
+                           current.misses - since.misses);
+}
+
+void Application::writeStartupReport(const std::string &path) const {
+  if (path == "-") {
+    _startupProfiler.write(std::cout);
+    return;
+  }
+
+  std::ofstream ofs{path};
+  if (!ofs) {
+    SCDETECT_LOG_WARNING("Failed to write startup report: %s", path.c_str());
+    return;
+  }
+  _startupProfiler.write(ofs);
+  SCDETECT_LOG_DEBUG("Wrote startup report: %s", path.c_str());
+}
+
 bool Application::loadEvents(const std::string &eventDb,
                              DataModel::DatabaseQueryPtr db) {
   bool loaded{false};
@@ -1481,12 +1879,22 @@ std::set<util::WaveformStreamID> Application::collectStreams() const {
           ? Core::Time::GMT()
           : _config.playbackConfig.startTime};
 
-  for (const auto &detectorIdxPair : _detectorIdx) {
-    util::WaveformStreamID waveformStreamId{detectorIdxPair.first};
+  for (const auto &routePair : _streamRoutes) {
+    const auto &detectorIdxs{routePair.second.detectors};
+    if (detectorIdxs.empty()) {
+      continue;
+    }
+
+    util::WaveformStreamID waveformStreamId{routePair.first};
 
     ret.emplace(waveformStreamId);
 
-    if (_detectors[detectorIdxPair.second]->publishConfig().createAmplitudes) {
+    bool createAmplitudes{std::any_of(
+        std::begin(detectorIdxs), std::end(detectorIdxs),
+        [this](std::size_t idx) {
+          return _detectors[idx]->publishConfig().createAmplitudes;
+        })};
+    if (createAmplitudes) {
       try {
         auto amplitudeProcessingConfig{
             _bindings
@@ -1536,129 +1944,1250 @@ bool Application::subscribeToRecordStream(
   return true;
 }
 
-bool Application::initDetectors(std::ifstream &ifs,
-                                WaveformHandlerIface *waveformHandler,
-                                TemplateConfigs &templateConfigs) {
-  try {
-    boost::property_tree::ptree pt;
-    boost::property_tree::read_json(ifs, pt);
+void Application::updateSubscriptions() {
+  const auto required{collectStreams()};
+
+  // close the supplementary acquisitions not required anymore
+  auto acquisitionIt{std::begin(_acquisitions)};
+  while (acquisitionIt != std::end(_acquisitions)) {
+    auto &acquisition{*acquisitionIt};
+    if (std::any_of(std::begin(acquisition->streams),
+                    std::end(acquisition->streams),
+                    [&required](const util::WaveformStreamID &id) {
+                      return required.find(id) != std::end(required);
+                    })) {
+      ++acquisitionIt;
+      continue;
+    }
 
-    for (const auto &templateSettingPt : pt) {
-      try {
-        config::TemplateConfig tc{templateSettingPt.second,
-                                  _config.detectorConfig, _config.streamConfig,
-                                  _config.publishConfig};
-        if (!config::hasUniqueTemplateIds(tc)) {
-          throw ConfigError{"failed to initialize detector (id=" +
-                            tc.detectorId() + "): template ids must be unique"};
+    SCDETECT_LOG_INFO(
+        "Closing acquisition of streams not required anymore (streams: %lu)",
+        acquisition->streams.size());
+    acquisition->recordStream->close();
+    if (acquisition->thread.joinable()) {
+      acquisition->thread.join();
+    }
+    for (const auto &waveformStreamId : acquisition->streams) {
+      _subscribedStreams.erase(waveformStreamId);
+    }
+    acquisitionIt = _acquisitions.erase(acquisitionIt);
+  }
+
+  // records of streams which cannot be unsubscribed are dropped
+  _droppedStreams.clear();
+  for (const auto &waveformStreamId : _subscribedStreams) {
+    if (required.find(waveformStreamId) == std::end(required)) {
+      _droppedStreams.emplace(util::to_string(waveformStreamId));
+    }
+  }
+
+  std::set<util::WaveformStreamID> streams;
+  for (const auto &waveformStreamId : required) {
+    if (_subscribedStreams.find(waveformStreamId) ==
+        std::end(_subscribedStreams)) {
+      streams.emplace(waveformStreamId);
+    }
+  }
+  if (streams.empty()) {
+    return;
+  }
+
+  if (_config.playbackConfig.enabled) {
+    // the data of the streams would not be in sync with the data played back
+    SCDETECT_LOG_WARNING(
+        "Streams required by reloaded detectors are not subscribed in "
+        "playback mode (streams: %lu)",
+        streams.size());
+    return;
+  }
+
+  auto acquisition{util::make_unique<Acquisition>()};
+  acquisition->recordStream = IO::RecordStream::Open(recordStreamURL().c_str());
+  if (!acquisition->recordStream) {
+    SCDETECT_LOG_ERROR("Failed to open record stream: %s",
+                       recordStreamURL().c_str());
+    return;
+  }
+  for (const auto &waveformStreamId : streams) {
+    SCDETECT_LOG_DEBUG("Subscribing to stream: %s",
+                       util::to_string(waveformStreamId).c_str());
+    if (!acquisition->recordStream->addStream(
+            waveformStreamId.netCode(), waveformStreamId.staCode(),
+            waveformStreamId.locCode(), waveformStreamId.chaCode())) {
+      SCDETECT_LOG_ERROR("Failed to subscribe to stream: %s",
+                         util::to_string(waveformStreamId).c_str());
+      return;
+    }
+  }
+  acquisition->recordStream->setStartTime(Core::Time::GMT());
+  acquisition->streams = std::move(streams);
+
+  SCDETECT_LOG_INFO(
+      "Starting acquisition of streams required by reloaded detectors "
+      "(streams: %lu)",
+      acquisition->streams.size());
+  // the records are handed over to the record processing thread by means of
+  // the application's event queue (i.e. the same way as the records of the
+  // record stream)
+  auto *recordStream{acquisition->recordStream.get()};
+  acquisition->thread = std::thread{[this, recordStream]() {
+    IO::RecordInput input{recordStream, Array::DOUBLE, Record::DATA_ONLY};
+    try {
+      while (Record *rec = input.next()) {
+        // the ownership of `rec` is transferred
+        if (!sendNotification(Client::Notification{rec})) {
+          delete rec;
+          return;
         }
+      }
+    } catch (std::exception &e) {
+      SCDETECT_LOG_WARNING("Supplementary acquisition failed: %s", e.what());
+    }
+  }};
 
-        SCDETECT_LOG_DEBUG("Creating detector processor (id=%s) ... ",
-                           tc.detectorId().c_str());
+  _subscribedStreams.insert(std::begin(acquisition->streams),
+                            std::end(acquisition->streams));
+  _acquisitions.emplace_back(std::move(acquisition));
+}
 
-        auto detectorBuilder{
-            std::move(detector::Detector::Create(tc.originId())
-                          .setId(tc.detectorId())
-                          .setConfig(tc.publishConfig(), tc.detectorConfig(),
-                                     _config.playbackConfig.enabled))};
+void Application::closeAcquisitions() {
+  for (auto &acquisition : _acquisitions) {
+    acquisition->recordStream->close();
+  }
+  for (auto &acquisition : _acquisitions) {
+    if (acquisition->thread.joinable()) {
+      acquisition->thread.join();
+    }
+  }
+  _acquisitions.clear();
+}
 
-        std::vector<WaveformStreamId> waveformStreamIds;
-        for (const auto &streamConfigPair : tc) {
-          try {
-            detectorBuilder.setStream(streamConfigPair.first,
-                                      streamConfigPair.second, waveformHandler);
-          } catch (builder::NoSensorLocation &e) {
-            if (_config.skipTemplateIfNoSensorLocationData) {
-              SCDETECT_LOG_WARNING(
-                  "%s. Skipping template waveform processor initialization.",
-                  e.what());
-              continue;
-            }
-            throw;
-          } catch (builder::NoStream &e) {
-            if (_config.skipTemplateIfNoStreamData) {
-              SCDETECT_LOG_WARNING(
-                  "%s. Skipping template waveform processor initialization.",
-                  e.what());
-              continue;
-            }
-            throw;
-          } catch (builder::NoPick &e) {
-            if (_config.skipTemplateIfNoPick) {
-              SCDETECT_LOG_WARNING(
-                  "%s. Skipping template waveform processor initialization.",
-                  e.what());
-              continue;
-            }
-            throw;
-          } catch (builder::NoWaveformData &e) {
-            if (_config.skipTemplateIfNoWaveformData) {
-              SCDETECT_LOG_WARNING(
-                  "%s. Skipping template waveform processor initialization.",
-                  e.what());
-              continue;
-            }
-            throw;
+void Application::initSubspaceFamilies() {
+  _subspaceFamilies.clear();
+  _subsumedDetectors.clear();
+  if (_config.pathTemplateFamilyJson.empty()) {
+    return;
+  }
+
+  try {
+    boost::property_tree::ptree templateFamiliesPt;
+    {
+      std::ifstream ifs{_config.pathTemplateFamilyJson};
+      boost::property_tree::read_json(ifs, templateFamiliesPt);
+    }
+
+    const auto isSubspaceFamily{
+        [](const boost::property_tree::ptree::value_type
+               &templateFamilyConfigPair) {
+          return templateFamilyConfigPair.second.count("subspaceDimension") >
+                 0;
+        }};
+    if (std::none_of(std::begin(templateFamiliesPt),
+                     std::end(templateFamiliesPt), isSubspaceFamily)) {
+      return;
+    }
+
+    // resolve the detector identifiers referenced (light pass)
+    std::unordered_map<DetectorId, std::string> originIds;
+    {
+      std::ifstream ifs{_config.pathTemplateJson};
+      config::TemplateConfigReader reader{ifs};
+      boost::property_tree::ptree templateSettingPt;
+      while (true) {
+        try {
+          if (!reader.next(templateSettingPt)) {
+            break;
           }
-          waveformStreamIds.push_back(streamConfigPair.first);
+        } catch (config::ValidationError &) {
+          continue;
         }
 
-        auto detector{detectorBuilder.build()};
-        detector->setResultCallback(
-            [this](const detector::Detector *processor, const Record *record,
-                   std::unique_ptr<const detector::Detector::Detection>
-                       detection) {
-              processDetection(processor, record, std::move(detection));
-            });
+        const auto detectorId{
+            templateSettingPt.get_optional<std::string>("detectorId")};
+        if (detectorId) {
+          originIds.emplace(*detectorId,
+                            templateSettingPt.get<std::string>("originId"));
+        }
+      }
+    }
+
+    for (const auto &templateFamilyConfigPair : templateFamiliesPt) {
+      if (!isSubspaceFamily(templateFamilyConfigPair)) {
+        continue;
+      }
 
-        _detectors.emplace_back(std::move(detector));
-        auto idx{_detectors.size() - 1};
+      const auto &templateFamilyPt{templateFamilyConfigPair.second};
+      SubspaceFamily subspaceFamily;
+      subspaceFamily.id = templateFamilyPt.get<std::string>("id", "");
+      subspaceFamily.dimension = templateFamilyPt.get<int>("subspaceDimension");
+      if (subspaceFamily.dimension < 1) {
+        SCDETECT_LOG_WARNING(
+            "Invalid subspace dimension of template family (id=%s): %d. "
+            "Skipping.",
+            subspaceFamily.id.c_str(), subspaceFamily.dimension);
+        continue;
+      }
 
-        for (const auto &waveformStreamId : waveformStreamIds) {
-          _detectorIdx.emplace(waveformStreamId, idx);
+      boost::optional<DetectorId> referenceDetectorId;
+      std::vector<DetectorId> subsumedDetectorIds;
+      for (const auto &referenceConfigPair :
+           templateFamilyPt.get_child("references")) {
+        const auto &referenceConfigPt{referenceConfigPair.second};
+        const auto detectorId{
+            referenceConfigPt.get_optional<std::string>("detectorId")};
+        if (!detectorId) {
+          const auto originId{
+              referenceConfigPt.get_optional<std::string>("originId")};
+          if (originId) {
+            subspaceFamily.originIds.push_back(*originId);
+          }
+          continue;
         }
 
-        templateConfigs.push_back(tc);
+        const auto it{originIds.find(*detectorId)};
+        if (it == std::end(originIds)) {
+          SCDETECT_LOG_WARNING(
+              "Template family (id=%s) references unknown detector (id=%s). "
+              "Skipping reference.",
+              subspaceFamily.id.c_str(), detectorId->c_str());
+          continue;
+        }
 
-      } catch (Exception &e) {
-        SCDETECT_LOG_WARNING("Failed to create detector: %s. Skipping.",
-                             e.what());
+        if (!referenceDetectorId) {
+          referenceDetectorId = *detectorId;
+          continue;
+        }
+        subsumedDetectorIds.push_back(*detectorId);
+        subspaceFamily.originIds.push_back(it->second);
+      }
+
+      if (!referenceDetectorId) {
+        SCDETECT_LOG_WARNING(
+            "Template family (id=%s) does not reference any detector. No "
+            "subspace detector created.",
+            subspaceFamily.id.c_str());
         continue;
       }
+
+      SCDETECT_LOG_INFO(
+          "Template family (id=%s): creating subspace detector (id=%s, "
+          "dimension=%d, members=%lu)",
+          subspaceFamily.id.c_str(), referenceDetectorId->c_str(),
+          subspaceFamily.dimension, subspaceFamily.originIds.size());
+      _subsumedDetectors.insert(std::begin(subsumedDetectorIds),
+                                std::end(subsumedDetectorIds));
+      _subspaceFamilies.emplace(*referenceDetectorId,
+                                std::move(subspaceFamily));
     }
-  } catch (boost::property_tree::json_parser::json_parser_error &e) {
-    SCDETECT_LOG_ERROR(
-        "Failed to parse JSON template configuration file (%s): %s",
-        _config.pathTemplateJson.c_str(), e.what());
-    return false;
-  } catch (std::ifstream::failure &e) {
-    SCDETECT_LOG_ERROR(
-        "Failed to parse JSON template configuration file (%s): %s",
-        _config.pathTemplateJson.c_str(), e.what());
-    return false;
   } catch (std::exception &e) {
-    SCDETECT_LOG_ERROR(
-        "Failed to parse JSON template configuration file (%s): %s",
-        _config.pathTemplateJson.c_str(), e.what());
-    return false;
-  } catch (...) {
-    SCDETECT_LOG_ERROR("Failed to parse JSON template configuration file (%s)",
-                       _config.pathTemplateJson.c_str());
-    return false;
+    SCDETECT_LOG_WARNING(
+        "Failed to load subspace detector configuration from template family "
+        "configuration file (%s): %s",
+        _config.pathTemplateFamilyJson.c_str(), e.what());
+    _subspaceFamilies.clear();
+    _subsumedDetectors.clear();
   }
-  return true;
 }
 
-bool Application::initAmplitudeProcessors(
-    std::shared_ptr<DetectionItem> &detectionItem,
-    const detector::Detector &detectorProcessor) {
-  using PickMap = std::pair<DetectionItem::ProcessorId, DetectionItem::Pick>;
-  using SensorLocationId = std::string;
-  using SensorLocationPickMap =
-      std::unordered_map<SensorLocationId, std::vector<PickMap>>;
-  SensorLocationPickMap sensorLocationPicksMap;
-  // gather unique sensor locations which have amplitude calculation enabled
-  // (requires bindings to be configured)
+std::size_t Application::initCorrelationGroups(std::size_t firstDetectorIdx) {
+  const auto minSimilarity{_config.correlationSharingForcedSimilarity.value_or(
+      _config.correlationSharingSimilarity)};
+
+  std::size_t ret{0};
+  for (const auto &streamRoutePair : _streamRoutes) {
+    const auto &waveformStreamId{streamRoutePair.first};
+
+    // processors with an identical processing configuration and equally
+    // sized template waveforms are sharing candidates
+    std::map<std::string, std::vector<detector::TemplateWaveformProcessor *>>
+        candidates;
+    std::size_t processorCount{0};
+    std::size_t totalSamples{0};
+    for (const auto &idx : streamRoutePair.second.detectors) {
+      if (idx < firstDetectorIdx) {
+        continue;
+      }
+      for (auto *processor : _detectors[idx]->processors(waveformStreamId)) {
+        const auto &templateWaveform{processor->templateWaveform()};
+        ++processorCount;
+        totalSamples += templateWaveform.size();
+        // the coefficient trace (e.g. used for stacking) must be exact
+        if (processor->processingId().empty() ||
+            processor->coefficientTrace()) {
+          continue;
+        }
+
+        candidates[processor->processingId() + settings::kProcessorIdSep +
+                   std::to_string(templateWaveform.size()) +
+                   settings::kProcessorIdSep +
+                   std::to_string(templateWaveform.samplingFrequency())]
+            .push_back(processor);
+      }
+    }
+
+    std::size_t groupCount{0};
+    std::size_t sharedCount{0};
+    std::size_t savedSamples{0};
+    for (auto &candidatesPair : candidates) {
+      auto &processors{candidatesPair.second};
+      // greedy clustering w.r.t. the first processor not grouped, yet
+      std::vector<bool> grouped(processors.size(), false);
+      for (std::size_t i{0}; i < processors.size(); ++i) {
+        if (grouped[i]) {
+          continue;
+        }
+
+        const auto &representative{processors[i]->templateWaveform()};
+        std::vector<std::pair<std::size_t, double>> members;
+        for (std::size_t j{i + 1}; j < processors.size(); ++j) {
+          if (grouped[j]) {
+            continue;
+          }
+          const auto s{
+              similarity(representative, processors[j]->templateWaveform())};
+          if (s >= minSimilarity) {
+            members.emplace_back(j, s);
+          }
+        }
+        if (members.empty()) {
+          continue;
+        }
+
+        auto group{
+            std::make_shared<detector::CorrelationGroup>(representative)};
+        // the representative's coefficients are exact
+        processors[i]->setCorrelationGroup(
+            group, std::numeric_limits<double>::infinity());
+        grouped[i] = true;
+        for (const auto &member : members) {
+          // the coefficients of demeaned and normalized template waveforms with
+          // similarity `s` differ by at most `sqrt(2 * (1 - s))`; hence, the
+          // member's detections are never missed
+          auto *processor{processors[member.first]};
+          processor->setCorrelationGroup(
+              group, processor->detectionThreshold() -
+                         std::sqrt(2 * std::max(0.0, 1 - member.second)));
+          grouped[member.first] = true;
+        }
+
+        ++groupCount;
+        sharedCount += members.size() + 1;
+        savedSamples += members.size() * representative.size();
+      }
+    }
+
+    if (groupCount == 0) {
+      continue;
+    }
+
+    ret += groupCount;
+    // the estimate neglects the exact coefficients computed by the members
+    SCDETECT_LOG_INFO(
+        "%s: sharing cross-correlations (processors=%lu, shared=%lu, "
+        "groups=%lu, estimated_cpu_saved=%.1f%%)",
+        waveformStreamId.c_str(), processorCount, sharedCount, groupCount,
+        totalSamples > 0 ? 100.0 * savedSamples / totalSamples : 0.0);
+  }
+  return ret;
+}
+
+std::size_t Application::initCorrelationKernels(
+    std::size_t firstDetectorIdx) {
+  // the decisions of the tuner are reused for the detectors added
+  if (!_correlationTuner) {
+    _pathCorrelationTuning =
+        _config.pathAutoTuneCache.empty()
+            ? (boost::filesystem::path{_config.pathFilesystemCache} /
+               ("correlation-tuning-" + CorrelationTuner::hostname()))
+                  .string()
+            : _config.pathAutoTuneCache;
+
+    _correlationTuner = std::make_shared<CorrelationTuner>();
+    _correlationTuner->setMaxLatency(_config.autoTuneMaxLatency);
+    if (Util::fileExists(_pathCorrelationTuning)) {
+      try {
+        _correlationTuner->load(_pathCorrelationTuning);
+      } catch (std::exception &e) {
+        SCDETECT_LOG_WARNING("Failed to load correlation tuning (%s): %s",
+                             _pathCorrelationTuning.c_str(), e.what());
+      }
+    }
+  }
+
+  std::size_t ret{0};
+  for (const auto &streamRoutePair : _streamRoutes) {
+    const auto &waveformStreamId{streamRoutePair.first};
+    for (const auto &idx : streamRoutePair.second.detectors) {
+      if (idx < firstDetectorIdx) {
+        continue;
+      }
+      for (auto *processor : _detectors[idx]->processors(waveformStreamId)) {
+        // approximate searches and other detector modes are configured
+        // explicitly
+        if (!processor->directCorrelation()) {
+          continue;
+        }
+
+        // benchmark w.r.t. the sampling frequency of the data correlated
+        // (i.e. the processors look the decisions up, only)
+        auto templateWaveform{processor->templateWaveform()};
+        const auto targetSamplingFrequency{
+            processor->targetSamplingFrequency()};
+        if (targetSamplingFrequency &&
+            *targetSamplingFrequency != templateWaveform.samplingFrequency()) {
+          templateWaveform.setSamplingFrequency(*targetSamplingFrequency);
+        }
+        _correlationTuner->tune(templateWaveform.size(),
+                                templateWaveform.samplingFrequency());
+
+        processor->setCorrelationTuner(_correlationTuner);
+        ++ret;
+      }
+    }
+  }
+
+  SCDETECT_LOG_INFO(
+      "Enabled cross-correlation kernel tuning (processors=%lu, "
+      "benchmarked=%lu, cached=%lu)",
+      ret, _correlationTuner->benchmarked(),
+      _correlationTuner->size() - _correlationTuner->benchmarked());
+  saveCorrelationTuning();
+  return ret;
+}
+
+void Application::saveCorrelationTuning() {
+  if (!_correlationTuner || _correlationTuner->benchmarked() == 0) {
+    return;
+  }
+
+  try {
+    if (!util::createDirectory(
+            boost::filesystem::path{_pathCorrelationTuning}.parent_path())) {
+      throw CorrelationTuner::BaseException{"failed to create path"};
+    }
+    _correlationTuner->save(_pathCorrelationTuning);
+  } catch (std::exception &e) {
+    SCDETECT_LOG_WARNING("Failed to save correlation tuning (%s): %s",
+                         _pathCorrelationTuning.c_str(), e.what());
+    return;
+  }
+
+  SCDETECT_LOG_INFO(
+      "Saved correlation tuning (%s): benchmarked=%lu, cached=%lu",
+      _pathCorrelationTuning.c_str(), _correlationTuner->benchmarked(),
+      _correlationTuner->size() - _correlationTuner->benchmarked());
+}
+
+bool Application::initDetectors(std::ifstream &ifs,
+                                WaveformHandlerIface *waveformHandler,
+                                TemplateConfigs &templateConfigs) {
+  try {
+    // parse the template configuration incrementally i.e. entry by entry
+    config::TemplateConfigReader reader{ifs};
+    boost::property_tree::ptree templateSettingPt;
+    while (true) {
+      try {
+        if (!reader.next(templateSettingPt)) {
+          break;
+        }
+      } catch (config::ValidationError &e) {
+        SCDETECT_LOG_WARNING("Failed to create detector: %s. Skipping.",
+                             e.what());
+        continue;
+      }
+
+      try {
+        config::TemplateConfig tc{templateSettingPt, _config.detectorConfig,
+                                  _config.streamConfig, _config.publishConfig};
+
+        // the template configuration of subsumed detectors is still required
+        // with regards to magnitudes
+        if (_subsumedDetectors.find(tc.detectorId()) !=
+            std::end(_subsumedDetectors)) {
+          SCDETECT_LOG_INFO(
+              "Detector (id=%s) subsumed by a subspace detector. Skipping.",
+              tc.detectorId().c_str());
+          templateConfigs.push_back(tc);
+          continue;
+        }
+
+        auto detectorScope{
+            _startupProfiler.measure(tc.detectorId(), "detector")};
+        const auto detectorCacheStatistics{waveformCacheStatistics()};
+
+        std::vector<WaveformStreamId> waveformStreamIds;
+        std::unique_ptr<detector::Detector> detector;
+        try {
+          detector = createDetector(tc, waveformHandler, waveformStreamIds);
+        } catch (...) {
+          // only detectors created successfully are accounted for
+          detectorScope.cancel();
+          throw;
+        }
+        addDetector(std::move(detector), waveformStreamIds);
+        _detectorFingerprints.emplace(
+            createTemplateConfigFingerprint(templateSettingPt),
+            tc.detectorId());
+
+        templateConfigs.push_back(tc);
+
+        detectorScope.setCount(waveformStreamIds.size());
+        setCacheStatistics(detectorScope, detectorCacheStatistics);
+      } catch (Exception &e) {
+        SCDETECT_LOG_WARNING("Failed to create detector: %s. Skipping.",
+                             e.what());
+        continue;
+      }
+    }
+  } catch (config::TemplateConfigReader::SyntaxError &e) {
+    SCDETECT_LOG_ERROR(
+        "Failed to parse JSON template configuration file (%s): %s",
+        _config.pathTemplateJson.c_str(), e.what());
+    return false;
+  } catch (std::ifstream::failure &e) {
+    SCDETECT_LOG_ERROR(
+        "Failed to parse JSON template configuration file (%s): %s",
+        _config.pathTemplateJson.c_str(), e.what());
+    return false;
+  } catch (std::exception &e) {
+    SCDETECT_LOG_ERROR(
+        "Failed to parse JSON template configuration file (%s): %s",
+        _config.pathTemplateJson.c_str(), e.what());
+    return false;
+  } catch (...) {
+    SCDETECT_LOG_ERROR("Failed to parse JSON template configuration file (%s)",
+                       _config.pathTemplateJson.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<detector::Detector> Application::createDetector(
+    const config::TemplateConfig &tc, WaveformHandlerIface *waveformHandler,
+    std::vector<WaveformStreamId> &waveformStreamIds) const {
+  if (!config::hasUniqueTemplateIds(tc)) {
+    throw ConfigError{"failed to initialize detector (id=" + tc.detectorId() +
+                      "): template ids must be unique"};
+  }
+
+  SCDETECT_LOG_DEBUG("Creating detector processor (id=%s) ... ",
+                     tc.detectorId().c_str());
+
+  auto detectorConfig{tc.detectorConfig()};
+  if (_config.coarseSearchForcedDecimation) {
+    detectorConfig.coarseSearchDecimation =
+        *_config.coarseSearchForcedDecimation;
+  }
+  if (_config.prescreenForcedMargin) {
+    detectorConfig.prescreenMargin = *_config.prescreenForcedMargin;
+  }
+  if (_config.fuseComponentsForceMode) {
+    detectorConfig.fuseComponents = *_config.fuseComponentsForceMode;
+  }
+  if (_config.stackingForceMode) {
+    detectorConfig.stacking = *_config.stackingForceMode;
+  }
+  if (_config.correlationForcedBlockSize) {
+    detectorConfig.correlationBlockSize = *_config.correlationForcedBlockSize;
+  }
+  const auto subspaceFamily{_subspaceFamilies.find(tc.detectorId())};
+  if (subspaceFamily != std::end(_subspaceFamilies)) {
+    auto &originIds{detectorConfig.subspaceOriginIds};
+    originIds.insert(std::end(originIds),
+                     std::begin(subspaceFamily->second.originIds),
+                     std::end(subspaceFamily->second.originIds));
+    detectorConfig.subspaceDimension = subspaceFamily->second.dimension;
+  }
+  // fused processors are neither checkpointed nor do they share
+  // cross-correlations
+  if (detectorConfig.fuseComponents &&
+      detectorConfig.subspaceOriginIds.empty()) {
+    if (!_config.pathCheckpoint.empty()) {
+      throw ConfigError{"failed to initialize detector (id=" +
+                        tc.detectorId() +
+                        "): fusing components is incompatible with "
+                        "checkpointing"};
+    }
+    if (_config.correlationSharingForcedSimilarity.value_or(
+            _config.correlationSharingSimilarity) > 0) {
+      throw ConfigError{"failed to initialize detector (id=" +
+                        tc.detectorId() +
+                        "): fusing components is incompatible with "
+                        "correlation sharing"};
+    }
+  }
+
+  auto detectorBuilder{
+      std::move(detector::Detector::Create(tc.originId())
+                    .setId(tc.detectorId())
+                    .setConfig(tc.publishConfig(), detectorConfig,
+                               _config.playbackConfig.enabled))};
+
+  for (const auto &streamConfigPair : tc) {
+    try {
+      detectorBuilder.setStream(streamConfigPair.first, streamConfigPair.second,
+                                waveformHandler);
+    } catch (builder::NoSensorLocation &e) {
+      if (_config.skipTemplateIfNoSensorLocationData) {
+        SCDETECT_LOG_WARNING(
+            "%s. Skipping template waveform processor initialization.",
+            e.what());
+        continue;
+      }
+      throw;
+    } catch (builder::NoStream &e) {
+      if (_config.skipTemplateIfNoStreamData) {
+        SCDETECT_LOG_WARNING(
+            "%s. Skipping template waveform processor initialization.",
+            e.what());
+        continue;
+      }
+      throw;
+    } catch (builder::NoPick &e) {
+      if (_config.skipTemplateIfNoPick) {
+        SCDETECT_LOG_WARNING(
+            "%s. Skipping template waveform processor initialization.",
+            e.what());
+        continue;
+      }
+      throw;
+    } catch (builder::NoWaveformData &e) {
+      if (_config.skipTemplateIfNoWaveformData) {
+        SCDETECT_LOG_WARNING(
+            "%s. Skipping template waveform processor initialization.",
+            e.what());
+        continue;
+      }
+      throw;
+    }
+    waveformStreamIds.push_back(streamConfigPair.first);
+  }
+
+  return detectorBuilder.build();
+}
+
+void Application::addDetector(
+    std::unique_ptr<detector::Detector> detector,
+    const std::vector<WaveformStreamId> &waveformStreamIds) {
+  // when preparing templates, the memory usage is reported, only
+  if (_config.memoryBudget && !_config.templatesPrepare) {
+    const std::size_t budget{*_config.memoryBudget * 1024 * 1024};
+    // the data buffers are sized when the first record is processed, i.e.
+    // estimate the memory usage from the template waveforms
+    const auto required{detector->estimatedMemoryUsage().total()};
+    const auto current{memoryUsage()};
+    if (current + required > budget) {
+      throw MemoryBudgetExceeded{
+          "memory budget exceeded (detector id=" + detector->id() +
+          ", required=" + util::formatBytes(required) +
+          ", current=" + util::formatBytes(current) +
+          ", budget=" + util::formatBytes(budget) + ")"};
+    }
+  }
+
+  detector->setResultCallback(
+      [this](const detector::Detector *processor, const Record *record,
+             std::unique_ptr<const detector::Detector::Detection> detection) {
+        processDetection(processor, record, std::move(detection));
+      });
+
+  if (!_config.pathCheckpoint.empty()) {
+    detector->setCheckpointing(true);
+  }
+
+  _detectors.emplace_back(std::move(detector));
+  auto idx{_detectors.size() - 1};
+
+  for (const auto &waveformStreamId : waveformStreamIds) {
+    _streamRoutes[waveformStreamId].detectors.push_back(idx);
+  }
+}
+
+std::string Application::createTemplateConfigFingerprint(
+    const boost::property_tree::ptree &pt) const {
+  std::ostringstream oss;
+  boost::property_tree::write_json(oss, pt, /*pretty=*/false);
+
+  const auto detectorId{pt.get_optional<std::string>("detectorId")};
+  if (detectorId) {
+    const auto it{_subspaceFamilies.find(*detectorId)};
+    if (it != std::end(_subspaceFamilies)) {
+      oss << "subspace:" << it->second.dimension;
+      for (const auto &originId : it->second.originIds) {
+        oss << "," << originId;
+      }
+    }
+  }
+  return oss.str();
+}
+
+WaveformHandlerIfacePtr Application::createWaveformHandler() {
+  // TODO(damb): Check if std::unique_ptr wouldn't be sufficient, here.
+  WaveformHandlerIfacePtr waveformHandler{
+      util::make_smart<WaveformHandler>(recordStreamURL())};
+  if (!_config.templatesNoCache) {
+    // cache template waveforms on filesystem
+    _config.pathFilesystemCache =
+        boost::filesystem::path(_config.pathFilesystemCache).string();
+    if (!Util::pathExists(_config.pathFilesystemCache) &&
+        !Util::createPath(_config.pathFilesystemCache)) {
+      SCDETECT_LOG_ERROR("Failed to create path (waveform cache): %s",
+                         _config.pathFilesystemCache.c_str());
+      return nullptr;
+    }
+
+    auto fileSystemCache{util::make_smart<FileSystemCache>(
+        waveformHandler, _config.pathFilesystemCache,
+        settings::kCacheRawWaveforms)};
+    _waveformCaches.push_back(fileSystemCache);
+    waveformHandler = fileSystemCache;
+  }
+  // cache demeaned template waveform snippets in order to speed up the
+  // initialization procedure
+  auto inMemoryCache{
+      util::make_smart<InMemoryCache>(waveformHandler, /*raw=*/false)};
+  _waveformCaches.insert(std::begin(_waveformCaches), inMemoryCache);
+  return inMemoryCache;
+}
+
+std::size_t Application::restoreCheckpoint(std::size_t firstDetectorIdx) {
+  if (!Util::fileExists(_config.pathCheckpoint)) {
+    SCDETECT_LOG_INFO("No checkpoint found (%s)",
+                      _config.pathCheckpoint.c_str());
+    return 0;
+  }
+
+  Checkpoint checkpoint;
+  try {
+    checkpoint.load(_config.pathCheckpoint);
+  } catch (std::exception &e) {
+    SCDETECT_LOG_WARNING("Failed to load checkpoint (%s): %s",
+                         _config.pathCheckpoint.c_str(), e.what());
+    return 0;
+  }
+
+  std::size_t ret{0};
+  std::size_t candidates{0};
+  for (std::size_t i{firstDetectorIdx}; i < _detectors.size(); ++i) {
+    auto &detector{_detectors[i]};
+    const auto *detectorCheckpoint{checkpoint.get(detector->id())};
+    if (detectorCheckpoint) {
+      ret += detector->restore(detectorCheckpoint->processors,
+                               _config.checkpointTolerance);
+      candidates += detector->restoreLinker(detectorCheckpoint->linker);
+    }
+  }
+
+  SCDETECT_LOG_INFO(
+      "Loaded checkpoint (%s): restoring %lu processors (%lu pending "
+      "candidates)",
+      _config.pathCheckpoint.c_str(), ret, candidates);
+  return ret;
+}
+
+void Application::handleCheckpoint() {
+  const auto now{Core::Time::GMT()};
+  if (now < _nextCheckpoint) {
+    return;
+  }
+  _nextCheckpoint =
+      now + Core::TimeSpan{static_cast<double>(_config.checkpointInterval)};
+
+  writeCheckpoint(/*async=*/true);
+}
+
+void Application::writeCheckpoint(bool async) {
+  // do not overwrite a previous checkpoint if initialization failed
+  if (_detectors.empty()) {
+    return;
+  }
+
+  // the state is collected by the record processing thread, while the file
+  // is written by the checkpoint writer thread
+  auto checkpoint{std::make_shared<Checkpoint>()};
+  for (const auto &detector : _detectors) {
+    Checkpoint::DetectorCheckpoint detectorCheckpoint{
+        detector->checkpoints(), detector->linkerCheckpoint()};
+    if (!detectorCheckpoint.processors.empty() ||
+        !detectorCheckpoint.linker.candidates.empty()) {
+      checkpoint->set(detector->id(), std::move(detectorCheckpoint));
+    }
+  }
+
+  // write a single checkpoint at a time
+  if (_checkpointWriter.joinable()) {
+    _checkpointWriter.join();
+  }
+
+  const auto path{_config.pathCheckpoint};
+  auto write = [checkpoint, path]() {
+    try {
+      checkpoint->save(path);
+    } catch (std::exception &e) {
+      SCDETECT_LOG_WARNING("Failed to write checkpoint (%s): %s",
+                           path.c_str(), e.what());
+      return;
+    }
+    SCDETECT_LOG_DEBUG("Wrote checkpoint (%s): %lu detectors", path.c_str(),
+                       checkpoint->size());
+  };
+
+  if (async) {
+    _checkpointWriter = std::thread{write};
+  } else {
+    write();
+  }
+}
+
+Application::DetectorMemoryUsage Application::amplitudeMemoryUsage() const {
+  DetectorMemoryUsage ret;
+  std::unordered_set<ProcessorId> visited;
+  for (const auto &routePair : _streamRoutes) {
+    for (const auto &processor : routePair.second.timeWindowProcessors) {
+      if (!visited.emplace(processor->id()).second) {
+        continue;
+      }
+
+      auto it{_amplitudeProcessorDetections.find(processor->id())};
+      if (it == _amplitudeProcessorDetections.end()) {
+        continue;
+      }
+
+      auto amplitudeProcessor{
+          std::dynamic_pointer_cast<const AmplitudeProcessor>(processor)};
+      if (amplitudeProcessor) {
+        ret[it->second->detectorId] += amplitudeProcessor->memoryUsage();
+      }
+    }
+  }
+  return ret;
+}
+
+std::size_t Application::memoryUsage() const {
+  std::size_t ret{_waveformBuffer.memoryUsage()};
+  for (const auto &detector : _detectors) {
+    ret += detector->estimatedMemoryUsage().total();
+  }
+  for (const auto &amplitudePair : amplitudeMemoryUsage()) {
+    ret += amplitudePair.second;
+  }
+  return ret;
+}
+
+void Application::logMemoryUsage(bool info) const {
+  const auto logMessage = [info](const std::string &msg) {
+    if (info) {
+      SCDETECT_LOG_INFO("%s", msg.c_str());
+    } else {
+      SCDETECT_LOG_DEBUG("%s", msg.c_str());
+    }
+  };
+
+  const auto amplitudeUsage{amplitudeMemoryUsage()};
+  util::MemoryUsage total;
+  for (const auto &detector : _detectors) {
+    auto usage{detector->memoryUsage()};
+    auto it{amplitudeUsage.find(detector->id())};
+    if (it != amplitudeUsage.end()) {
+      usage.amplitudes = it->second;
+    }
+    logMessage("Memory usage (detector id=" + detector->id() +
+        "): " + util::to_string(usage));
+    total += usage;
+  }
+
+  const auto waveformBufferUsage{_waveformBuffer.memoryUsage()};
+  const auto preprocessingCacheUsage{
+      amplitude::PreprocessingCache::Instance().memoryUsage()};
+  const auto responseSpectrumCacheUsage{
+      amplitude::ResponseSpectrumCache::Instance().memoryUsage()};
+  const auto totalBytes{total.total() + waveformBufferUsage +
+                        preprocessingCacheUsage + responseSpectrumCacheUsage};
+  logMessage("Memory usage (detectors: " + std::to_string(_detectors.size()) +
+      "): " + util::to_string(total) +
+      ", waveform buffer: " + util::formatBytes(waveformBufferUsage) +
+      ", amplitude preprocessing cache: " +
+      util::formatBytes(preprocessingCacheUsage) +
+      ", response spectrum cache: " +
+      util::formatBytes(responseSpectrumCacheUsage) +
+      ", total: " + util::formatBytes(totalBytes));
+
+  if (_config.memoryBudget) {
+    const std::size_t budget{*_config.memoryBudget * 1024 * 1024};
+    if (totalBytes > budget) {
+      SCDETECT_LOG_WARNING("Memory budget exceeded: %s > %s",
+                           util::formatBytes(totalBytes).c_str(),
+                           util::formatBytes(budget).c_str());
+    }
+  }
+}
+
+void Application::handleMemoryBudget() {
+  const auto now{Core::Time::GMT()};
+  if (now < _nextMemoryBudgetCheck) {
+    return;
+  }
+  _nextMemoryBudgetCheck =
+      now + Core::TimeSpan{settings::kMemoryBudgetCheckInterval};
+
+  const std::size_t budget{*_config.memoryBudget * 1024 * 1024};
+  const auto current{memoryUsage()};
+  if (current <= budget) {
+    if (_amplitudesDisabled.empty()) {
+      return;
+    }
+
+    // restore the detector which released the least memory, provided that it
+    // fits into the budget
+    auto restored{std::min_element(
+        std::begin(_amplitudesDisabled), std::end(_amplitudesDisabled),
+        [](const std::pair<const DetectorId, std::size_t> &lhs,
+           const std::pair<const DetectorId, std::size_t> &rhs) {
+          return lhs.second < rhs.second;
+        })};
+    if (current + restored->second <= budget) {
+      SCDETECT_LOG_WARNING(
+          "Memory usage below budget (%s <= %s): enabling amplitude "
+          "calculation for detector (id=%s)",
+          util::formatBytes(current).c_str(), util::formatBytes(budget).c_str(),
+          restored->first.c_str());
+      _amplitudesDisabled.erase(restored);
+    }
+    return;
+  }
+
+  // degrade the detector whose amplitude processors use the most memory; the
+  // memory usage is measured again with the next check, i.e. amplitude
+  // processors already running are not interrupted and memory is released
+  // as soon as they finished
+  using Candidate = std::pair<DetectorId, std::size_t>;
+  boost::optional<Candidate> degraded;
+  for (const auto &amplitudePair : amplitudeMemoryUsage()) {
+    if (amplitudePair.second > 0 &&
+        _amplitudesDisabled.find(amplitudePair.first) ==
+            _amplitudesDisabled.end() &&
+        (!degraded || amplitudePair.second > degraded->second)) {
+      degraded = amplitudePair;
+    }
+  }
+
+  if (!degraded) {
+    SCDETECT_LOG_WARNING(
+        "Memory budget exceeded (%s > %s): no further detectors to degrade",
+        util::formatBytes(current).c_str(), util::formatBytes(budget).c_str());
+    return;
+  }
+
+  SCDETECT_LOG_WARNING(
+      "Memory budget exceeded (%s > %s): disabling amplitude calculation for "
+      "detector (id=%s)",
+      util::formatBytes(current).c_str(), util::formatBytes(budget).c_str(),
+      degraded->first.c_str());
+  _amplitudesDisabled.emplace(degraded->first, degraded->second);
+}
+
+void Application::handleTemplateConfigReload() {
+  if (_templateConfigReload) {
+    continueTemplateConfigReload();
+    return;
+  }
+
+  const auto now{Core::Time::GMT()};
+  if (now < _nextTemplateConfigCheck) {
+    return;
+  }
+  _nextTemplateConfigCheck =
+      now +
+      Core::TimeSpan{static_cast<double>(*_config.templatesWatchInterval)};
+
+  try {
+    const auto modificationTime{
+        boost::filesystem::last_write_time(_config.pathTemplateJson)};
+    if (modificationTime == _templateConfigModificationTime) {
+      return;
+    }
+    _templateConfigModificationTime = modificationTime;
+  } catch (boost::filesystem::filesystem_error &e) {
+    SCDETECT_LOG_WARNING("Failed to check template configuration file: %s",
+                         e.what());
+    return;
+  }
+
+  SCDETECT_LOG_INFO("Template configuration modified. Reloading from %s",
+                    _config.pathTemplateJson.c_str());
+  startTemplateConfigReload();
+}
+
+void Application::startTemplateConfigReload() {
+  auto reload{util::make_unique<TemplateConfigReload>()};
+
+  // the template family configuration might have changed, too
+  initSubspaceFamilies();
+
+  // diff the template configuration against the running detectors
+  auto unclaimed{_detectorFingerprints};
+  try {
+    std::ifstream ifs{_config.pathTemplateJson};
+    config::TemplateConfigReader reader{ifs};
+    boost::property_tree::ptree templateSettingPt;
+    while (true) {
+      try {
+        if (!reader.next(templateSettingPt)) {
+          break;
+        }
+      } catch (config::ValidationError &e) {
+        SCDETECT_LOG_WARNING("Failed to reload detector: %s. Skipping.",
+                             e.what());
+        continue;
+      }
+
+      try {
+        // the template configuration of subsumed detectors is still required
+        // with regards to magnitudes (subsumed detectors are retired, if
+        // running)
+        const auto detectorId{
+            templateSettingPt.get_optional<std::string>("detectorId")};
+        if (detectorId && _subsumedDetectors.find(*detectorId) !=
+                              std::end(_subsumedDetectors)) {
+          reload->templateConfigs.push_back(config::TemplateConfig{
+              templateSettingPt, _config.detectorConfig, _config.streamConfig,
+              _config.publishConfig});
+          continue;
+        }
+
+        auto fingerprint{createTemplateConfigFingerprint(templateSettingPt)};
+        auto it{unclaimed.find(fingerprint)};
+        if (it != std::end(unclaimed)) {
+          // unmodified detector; the identifier of the running detector is
+          // used if the identifier is generated
+          if (!detectorId) {
+            templateSettingPt.put("detectorId", it->second);
+          }
+          reload->templateConfigs.push_back(config::TemplateConfig{
+              templateSettingPt, _config.detectorConfig, _config.streamConfig,
+              _config.publishConfig});
+          reload->retained.emplace(it->second, it->first);
+          unclaimed.erase(it);
+          continue;
+        }
+
+        reload->pending.emplace_back(TemplateConfigReload::PendingItem{
+            std::move(fingerprint),
+            config::TemplateConfig{templateSettingPt, _config.detectorConfig,
+                                   _config.streamConfig,
+                                   _config.publishConfig}});
+      } catch (Exception &e) {
+        SCDETECT_LOG_WARNING("Failed to reload detector: %s. Skipping.",
+                             e.what());
+      }
+    }
+  } catch (std::exception &e) {
+    SCDETECT_LOG_ERROR(
+        "Failed to parse JSON template configuration file (%s): %s. Keeping "
+        "current detectors.",
+        _config.pathTemplateJson.c_str(), e.what());
+    return;
+  }
+
+  // detector identifiers must be unique with regards to the retained
+  // detectors
+  std::unordered_set<DetectorId> detectorIds;
+  for (const auto &retainedPair : reload->retained) {
+    detectorIds.emplace(retainedPair.first);
+  }
+  auto pendingIt{std::begin(reload->pending)};
+  while (pendingIt != std::end(reload->pending)) {
+    const auto &detectorId{pendingIt->templateConfig.detectorId()};
+    if (!detectorIds.emplace(detectorId).second) {
+      SCDETECT_LOG_WARNING(
+          "Failed to reload detector (id=%s): detector identifier not unique. "
+          "Skipping.",
+          detectorId.c_str());
+      pendingIt = reload->pending.erase(pendingIt);
+      continue;
+    }
+    ++pendingIt;
+  }
+
+  if (reload->pending.empty() && unclaimed.empty()) {
+    SCDETECT_LOG_INFO("Template configuration unchanged");
+    return;
+  }
+
+  SCDETECT_LOG_INFO(
+      "Reloading template configuration: %lu detector(s) to be created, %lu "
+      "detector(s) to be retired, %lu detector(s) unchanged",
+      reload->pending.size(), unclaimed.size(), reload->retained.size());
+
+  // event related data is required both for creating the detectors and for
+  // initializing the magnitudes
+  if (!loadEvents(_config.urlEventDb, query())) {
+    EventStore::Instance().reset();
+    SCDETECT_LOG_ERROR("Failed to load events. Keeping current detectors.");
+    return;
+  }
+
+  reload->waveformHandler = createWaveformHandler();
+  if (!reload->waveformHandler) {
+    EventStore::Instance().reset();
+    _waveformCaches.clear();
+    SCDETECT_LOG_ERROR(
+        "Failed to create waveform handler. Keeping current detectors.");
+    return;
+  }
+
+  _templateConfigReload = std::move(reload);
+  if (_templateConfigReload->pending.empty()) {
+    finishTemplateConfigReload();
+  }
+}
+
+void Application::continueTemplateConfigReload() {
+  assert(_templateConfigReload);
+  auto &reload{*_templateConfigReload};
+  if (reload.pending.empty()) {
+    finishTemplateConfigReload();
+    return;
+  }
+
+  // create a single detector (including fetching the template waveforms) per
+  // record processed, i.e. record processing continues with the running
+  // detectors
+  auto item{std::move(reload.pending.front())};
+  reload.pending.pop_front();
+  try {
+    TemplateConfigReload::BuiltItem built{std::move(item.fingerprint),
+                                          item.templateConfig.detectorId(),
+                                          nullptr,
+                                          {},
+                                          item.templateConfig};
+    built.detector = createDetector(item.templateConfig,
+                                    reload.waveformHandler.get(),
+                                    built.waveformStreamIds);
+    reload.built.emplace_back(std::move(built));
+  } catch (std::exception &e) {
+    SCDETECT_LOG_WARNING("Failed to create detector: %s. Skipping.",
+                         e.what());
+  }
+}
+
+void Application::finishTemplateConfigReload() {
+  assert(_templateConfigReload);
+  auto reload{std::move(_templateConfigReload)};
+
+  // swap in detectors
+  Detectors detectors;
+  DetectorFingerprints detectorFingerprints;
+  std::unordered_map<std::size_t, std::size_t> retainedIdxMap;
+  for (std::size_t i{0}; i < _detectors.size(); ++i) {
+    auto &detector{_detectors[i]};
+    auto it{reload->retained.find(detector->id())};
+    if (it == std::end(reload->retained)) {
+      SCDETECT_LOG_INFO("Retiring detector (id=%s)", detector->id().c_str());
+      detector->terminate();
+      _amplitudesDisabled.erase(detector->id());
+      continue;
+    }
+
+    detectorFingerprints.emplace(it->second, it->first);
+    retainedIdxMap.emplace(i, detectors.size());
+    detectors.emplace_back(std::move(detector));
+  }
+
+  // remap the routes; routes not referenced anymore are pruned
+  auto routeIt{std::begin(_streamRoutes)};
+  while (routeIt != std::end(_streamRoutes)) {
+    std::vector<std::size_t> detectorIdxs;
+    for (const auto &idx : routeIt->second.detectors) {
+      auto it{retainedIdxMap.find(idx)};
+      if (it != std::end(retainedIdxMap)) {
+        detectorIdxs.push_back(it->second);
+      }
+    }
+    routeIt->second.detectors = std::move(detectorIdxs);
+
+    if (routeIt->second.empty()) {
+      routeIt = _streamRoutes.erase(routeIt);
+    } else {
+      ++routeIt;
+    }
+  }
+
+  _detectors = std::move(detectors);
+  _detectorFingerprints = std::move(detectorFingerprints);
+
+  const auto firstDetectorIdx{_detectors.size()};
+  auto &templateConfigs{reload->templateConfigs};
+  for (auto &built : reload->built) {
+    SCDETECT_LOG_INFO("Adding detector (id=%s)", built.detectorId.c_str());
+    try {
+      addDetector(std::move(built.detector), built.waveformStreamIds);
+    } catch (const MemoryBudgetExceeded &e) {
+      SCDETECT_LOG_WARNING("Failed to add detector: %s. Skipping.", e.what());
+      continue;
+    }
+    _detectorFingerprints.emplace(std::move(built.fingerprint),
+                                  built.detectorId);
+    templateConfigs.push_back(built.templateConfig);
+  }
+
+  // initialize the detectors added the same way as on startup
+  if (firstDetectorIdx < _detectors.size()) {
+    if (_config.correlationSharingForcedSimilarity.value_or(
+            _config.correlationSharingSimilarity) > 0) {
+      initCorrelationGroups(firstDetectorIdx);
+    }
+    if (!_config.templatesPrepare &&
+        _config.autoTuneForceMode.value_or(_config.autoTune)) {
+      initCorrelationKernels(firstDetectorIdx);
+    }
+    if (!_config.pathCheckpoint.empty()) {
+      restoreCheckpoint(firstDetectorIdx);
+    }
+  }
+
+  // the waveform buffer must cover the requirements of the detectors added,
+  // too (the data buffered already is kept)
+  try {
+    const auto timeSpan{
+        computeWaveformBufferSize(templateConfigs, _bindings, _config)};
+    if (timeSpan > _waveformBuffer.timeSpan()) {
+      _waveformBuffer.setTimeSpan(timeSpan);
+    }
+  } catch (const ConfigError &e) {
+    SCDETECT_LOG_WARNING("Failed to configure waveform buffer: %s", e.what());
+  }
+
+  // reinitialize the station magnitudes and template families w.r.t. the
+  // detectors running
+  bool magnitudesForcedDisabled{_config.magnitudesForceMode &&
+                                !*_config.magnitudesForceMode};
+  if (!magnitudesForcedDisabled) {
+    MagnitudeProcessor::Factory::reset();
+    initMagnitudeProcessorFactory(reload->waveformHandler.get(),
+                                  templateConfigs, _bindings, _config);
+  }
+
+  updateSubscriptions();
+
+  // free memory
+  EventStore::Instance().reset();
+  _waveformCaches.clear();
+
+  SCDETECT_LOG_INFO("Reloaded template configuration (detectors: %lu)",
+                    _detectors.size());
+}
+
+bool Application::initAmplitudeProcessors(
+    std::shared_ptr<DetectionItem> &detectionItem,
+    const detector::Detector &detectorProcessor) {
+  using PickMap = std::pair<DetectionItem::ProcessorId, DetectionItem::Pick>;
+  using SensorLocationId = std::string;
+  using SensorLocationPickMap =
+      std::unordered_map<SensorLocationId, std::vector<PickMap>>;
+  SensorLocationPickMap sensorLocationPicksMap;
+  // gather unique sensor locations which have amplitude calculation enabled
+  // (requires bindings to be configured)
   for (const auto &pickMapPair : detectionItem->amplitudePickMap) {
     const auto &processorId{pickMapPair.first};
     const auto &pick{pickMapPair.second};
@@ -1738,8 +3267,6 @@ bool Application::initAmplitudeProcessors(
                                   settings::kProcessorIdSep +
                                   util::createUUID()};
 
-        ++detectionItem->numberOfRequiredAmplitudes;
-
         amplitudeProcessor->setResultCallback([this, detectionItem,
                                                magnitudeType,
                                                magnitudeCalculationEnabled,
@@ -1756,17 +3283,17 @@ bool Application::initAmplitudeProcessors(
             amplitude = createAmplitude(processor, record, result, boost::none,
                                         magnitudeType);
           } catch (const Exception &e) {
-            --detectionItem->numberOfRequiredAmplitudes;
             SCDETECT_LOG_WARNING_PROCESSOR(
                 processor, "Failed to create amplitude: %s", e.what());
           }
 
           if (!amplitude) {
-            --detectionItem->numberOfRequiredAmplitudes;
+            releaseAmplitudeProcessor(processor->id());
             return;
           }
 
           detectionItem->amplitudes.at(processor->id()) = amplitude;
+          ++detectionItem->numberOfCreatedAmplitudes;
 
           if (magnitudeCalculationEnabled) {
             ++detectionItem->numberOfRequiredMagnitudes;
@@ -1813,7 +3340,7 @@ bool Application::initAmplitudeProcessors(
         });
 
         registerAmplitudeProcessor(std::move(amplitudeProcessor),
-                                   *detectionItem);
+                                   detectionItem);
       } catch (const AmplitudeProcessor::Factory::BaseException &e) {
         SCDETECT_LOG_WARNING(
             "Failed to create amplitude processor (type=\"%s\"): %s",
@@ -1823,9 +3350,6 @@ bool Application::initAmplitudeProcessors(
         SCDETECT_LOG_WARNING(
             "Failed to register amplitude processor (type=\"%s\"): %s",
             amplitudeType.c_str(), e.what());
-
-        --detectionItem->numberOfRequiredAmplitudes;
-
         continue;
       }
     }
@@ -1870,19 +3394,39 @@ DataModel::StationMagnitudePtr Application::createMagnitude(
 
 void Application::registerAmplitudeProcessor(
     const std::shared_ptr<AmplitudeProcessor> &processor,
-    DetectionItem &detection) {
-  detection.amplitudes[processor->id()];
+    const std::shared_ptr<DetectionItem> &detection) {
+  detection->amplitudes[processor->id()];
+  ++detection->numberOfRequiredAmplitudes;
+  _amplitudeProcessorDetections.emplace(processor->id(), detection);
 
   try {
     registerTimeWindowProcessor(processor->associatedWaveformStreamIds(),
                                 processor);
   } catch (const BaseException &e) {
-    detection.amplitudes.erase(processor->id());
+    // the processor might have been released, already
+    releaseAmplitudeProcessor(processor->id());
+    detection->amplitudes.erase(processor->id());
 
     throw;
   }
 }
 
+void Application::releaseAmplitudeProcessor(const std::string &processorId) {
+  auto it{_amplitudeProcessorDetections.find(processorId)};
+  if (it == _amplitudeProcessorDetections.end()) {
+    return;
+  }
+
+  auto &detection{it->second};
+  auto amplitudeIt{detection->amplitudes.find(processorId)};
+  if (amplitudeIt != detection->amplitudes.end() && !amplitudeIt->second) {
+    --detection->numberOfRequiredAmplitudes;
+    detection->amplitudes.erase(amplitudeIt);
+  }
+
+  _amplitudeProcessorDetections.erase(it);
+}
+
 std::vector<DataModel::MagnitudePtr> Application::createNetworkMagnitudes(
     const std::vector<DataModel::StationMagnitudeCPtr> &stationMagnitudes,
     NetworkMagnitudeComputationStrategy strategy, const std::string &methodId,
@@ -1937,54 +3481,58 @@ void Application::registerTimeWindowProcessor(
     return;
   }
 
-  for (const auto &waveformStreamId : waveformStreamIds) {
-    _timeWindowProcessors.emplace(waveformStreamId, processor);
-    SCDETECT_LOG_DEBUG("[%s] Added time window processor: id=%s",
-                       waveformStreamId.c_str(), processor->id().c_str());
-    SCDETECT_LOG_DEBUG("Current time window processor count: %lu",
-                       _timeWindowProcessors.size());
-  }
   _timeWindowProcessorIdx.emplace(processor->id(), waveformStreamIds);
 
+  if (_amplitudeWorkerPool) {
+    auto amplitudeProcessor{
+        std::dynamic_pointer_cast<AmplitudeProcessor>(processor)};
+    const auto buffered{bufferedTimeWindow(waveformStreamIds)};
+    const auto tw{processor->safetyTimeWindow()};
+    // only processors whose time window is (going to be) buffered entirely are
+    // computed asynchronously
+    if (amplitudeProcessor && buffered &&
+        buffered->startTime() <= tw.startTime()) {
+      if (buffered->endTime() >= tw.endTime()) {
+        submitAmplitudeProcessor(waveformStreamIds, amplitudeProcessor);
+        return;
+      }
+
+      // the processor waits for data not buffered, yet
+      _deferredTimeWindowProcessors.emplace(processor.get());
+      for (const auto &waveformStreamId : waveformStreamIds) {
+        _streamRoutes[waveformStreamId].timeWindowProcessors.push_back(
+            processor);
+        SCDETECT_LOG_DEBUG("[%s] Added deferred time window processor: id=%s",
+                           waveformStreamId.c_str(), processor->id().c_str());
+      }
+      return;
+    }
+  }
+
   std::vector<bool> bufferedDataAvailable(waveformStreamIds.size(), true);
   std::size_t idx{0};
   for (const auto &waveformStreamId : waveformStreamIds) {
     if (!processor->finished()) {
-      util::WaveformStreamID converted{waveformStreamId};
-      auto sequence{
-          _waveformBuffer.sequence(Processing::StreamBuffer::WaveformID{
-              converted.netCode(), converted.staCode(), converted.locCode(),
-              converted.chaCode()})};
-      if (!sequence || sequence->empty()) continue;
-
-      const auto tw{processor->safetyTimeWindow()};
-      if (tw.startTime() < sequence->timeWindow().startTime()) {
-        // TODO(damb):
-        // - fetch historical data
-
-        // actually feed as much data as possible
-        for (auto it = sequence->begin(); it != sequence->end(); ++it) {
-          if ((*it)->startTime() > tw.endTime()) {
-            if (it == sequence->begin()) {
-              bufferedDataAvailable[idx] = false;
+      const auto buffered{_waveformBuffer.timeWindow(waveformStreamId)};
+      if (buffered) {
+        const auto tw{processor->safetyTimeWindow()};
+        if (buffered->startTime() > tw.endTime()) {
+          // TODO(damb):
+          // - fetch historical data
+          bufferedDataAvailable[idx] = false;
+        } else {
+          // feed the buffered samples within the requested time window at
+          // once (i.e. a record per contiguous segment); if the time window
+          // is fully buffered, the processor finishes immediately. The
+          // processor filters the samples in place, i.e. they are copied
+          // rather than processed by means of the spans buffered.
+          for (const auto &record :
+               _waveformBuffer.records(waveformStreamId, tw)) {
+            if (processor->finished()) {
+              break;
             }
-            break;
+            processor->feed(record.get());
           }
-          processor->feed((*it).get());
-        }
-      } else {
-        // find the position in the record sequence to fill the requested
-        // time window
-        auto rit{sequence->rbegin()};
-        while (rit != sequence->rend()) {
-          if ((*rit)->endTime() < tw.startTime()) break;
-          ++rit;
-        }
-
-        RecordSequence::iterator it{rit.base()};
-        while (it != sequence->end() && (*it)->startTime() <= tw.endTime()) {
-          processor->feed((*it).get());
-          ++it;
         }
       }
     }
@@ -2002,40 +3550,46 @@ void Application::registerTimeWindowProcessor(
           "no buffered data available for time window processor: id=" +
           processor->id()};
     }
+    return;
+  }
+
+  // the processor waits for data not buffered, yet
+  for (const auto &waveformStreamId : waveformStreamIds) {
+    _streamRoutes[waveformStreamId].timeWindowProcessors.push_back(processor);
+    SCDETECT_LOG_DEBUG("[%s] Added time window processor: id=%s",
+                       waveformStreamId.c_str(), processor->id().c_str());
   }
+  SCDETECT_LOG_DEBUG("Current time window processor count: %lu",
+                     _timeWindowProcessorIdx.size());
 }
 
 void Application::removeTimeWindowProcessor(
     const std::shared_ptr<processing::TimeWindowProcessor> &processor) {
   if (_timeWindowProcessorRegistrationBlocked) {
-    _timeWindowProcessorRemovalQueue.emplace_back(
-        TimeWindowProcessorQueueItem{{}, processor});
+    if (_timeWindowProcessorsScheduledForRemoval.emplace(processor.get())
+            .second) {
+      _timeWindowProcessorRemovalQueue.emplace_back(
+          TimeWindowProcessorQueueItem{{}, processor});
+    }
     return;
   }
 
   const auto waveformStreamIds{_timeWindowProcessorIdx.at(processor->id())};
   for (const auto &waveformStreamId : waveformStreamIds) {
-    auto range{_timeWindowProcessors.equal_range(waveformStreamId)};
-    auto it{range.first};
-    while (it != range.second) {
-      if (it->second == processor) {
-        logging::TaggedMessage msg{
-            waveformStreamId,
-            "Removing time window processor: id=" + processor->id() +
-                ", status=" +
-                std::to_string(util::asInteger(processor->status())) +
-                ", status_value=" + std::to_string(processor->statusValue())};
-        SCDETECT_LOG_DEBUG("%s", logging::to_string(msg).c_str());
-        it = _timeWindowProcessors.erase(it);
-        SCDETECT_LOG_DEBUG("Current time window processor count: %lu",
-                           _timeWindowProcessors.size());
-      } else {
-        ++it;
-      }
-    }
+    logging::TaggedMessage msg{
+        waveformStreamId,
+        "Removing time window processor: id=" + processor->id() + ", status=" +
+            std::to_string(util::asInteger(processor->status())) +
+            ", status_value=" + std::to_string(processor->statusValue())};
+    SCDETECT_LOG_DEBUG("%s", logging::to_string(msg).c_str());
   }
+  unrouteTimeWindowProcessor(waveformStreamIds, processor);
+  _deferredTimeWindowProcessors.erase(processor.get());
 
   _timeWindowProcessorIdx.erase(processor->id());
+  SCDETECT_LOG_DEBUG("Current time window processor count: %lu",
+                     _timeWindowProcessorIdx.size());
+  releaseAmplitudeProcessor(processor->id());
 
   // check pending registration queue
   auto it{std::begin(_timeWindowProcessorRegistrationQueue)};
@@ -2048,6 +3602,129 @@ void Application::removeTimeWindowProcessor(
   }
 }
 
+void Application::unrouteTimeWindowProcessor(
+    const std::vector<WaveformStreamId> &waveformStreamIds,
+    const std::shared_ptr<processing::TimeWindowProcessor> &processor) {
+  for (const auto &waveformStreamId : waveformStreamIds) {
+    auto routeIt{_streamRoutes.find(waveformStreamId)};
+    if (routeIt == _streamRoutes.end()) {
+      continue;
+    }
+
+    auto &processors{routeIt->second.timeWindowProcessors};
+    processors.erase(
+        std::remove(std::begin(processors), std::end(processors), processor),
+        std::end(processors));
+  }
+}
+
+boost::optional<Core::TimeWindow> Application::bufferedTimeWindow(
+    const std::vector<WaveformStreamId> &waveformStreamIds) const {
+  boost::optional<Core::TimeWindow> ret;
+  for (const auto &waveformStreamId : waveformStreamIds) {
+    const auto buffered{_waveformBuffer.timeWindow(waveformStreamId)};
+    if (!buffered) {
+      return boost::none;
+    }
+
+    if (!ret) {
+      ret = *buffered;
+      continue;
+    }
+
+    if (!ret->overlaps(*buffered)) {
+      return boost::none;
+    }
+    ret = ret->overlap(*buffered);
+  }
+  return ret;
+}
+
+void Application::submitAmplitudeProcessor(
+    const std::vector<WaveformStreamId> &waveformStreamIds,
+    const std::shared_ptr<AmplitudeProcessor> &processor) {
+  assert(_amplitudeWorkerPool);
+
+  struct Result {
+    RecordCPtr record;
+    AmplitudeProcessor::AmplitudeCPtr amplitude;
+  };
+  struct Submission {
+    std::shared_ptr<AmplitudeProcessor> processor;
+    AmplitudeProcessor::PublishAmplitudeCallback callback;
+    // the records are referenced by the submission, only
+    std::vector<GenericRecordCPtr> records;
+    std::vector<Result> results;
+    std::string error;
+  };
+
+  // the waveform buffer is not thread-safe, i.e. copy the buffered data
+  auto submission{std::make_shared<Submission>()};
+  submission->processor = processor;
+  const auto tw{processor->safetyTimeWindow()};
+  for (const auto &waveformStreamId : waveformStreamIds) {
+    for (const auto &record : _waveformBuffer.records(waveformStreamId, tw)) {
+      submission->records.emplace_back(record);
+    }
+  }
+
+  // collect the amplitudes while computed asynchronously; both amplitudes and
+  // magnitudes are created by the record processing thread
+  submission->callback = processor->resultCallback();
+  auto *results{&submission->results};
+  processor->setResultCallback(
+      [results](const AmplitudeProcessor *, const Record *record,
+                AmplitudeProcessor::AmplitudeCPtr amplitude) {
+        results->emplace_back(Result{record, std::move(amplitude)});
+      });
+
+  SCDETECT_LOG_DEBUG_PROCESSOR(processor.get(),
+                               "Submitting amplitude processor (pending=%lu)",
+                               _amplitudeWorkerPool->pending());
+  _amplitudeWorkerPool->submit([this,
+                                submission]() -> util::WorkerPool::Continuation {
+    try {
+      for (const auto &record : submission->records) {
+        if (submission->processor->finished()) {
+          break;
+        }
+        submission->processor->feed(record.get());
+      }
+    } catch (const std::exception &e) {
+      submission->error = e.what();
+    }
+
+    return [this, submission]() {
+      const auto &processor{submission->processor};
+      processor->setResultCallback(submission->callback);
+      if (!submission->error.empty()) {
+        SCDETECT_LOG_WARNING_PROCESSOR(processor.get(),
+                                       "Failed to compute amplitude: %s",
+                                       submission->error.c_str());
+      } else if (submission->callback) {
+        for (const auto &result : submission->results) {
+          submission->callback(processor.get(), result.record.get(),
+                               result.amplitude);
+        }
+      }
+
+      std::shared_ptr<DetectionItem> detection;
+      auto it{_amplitudeProcessorDetections.find(processor->id())};
+      if (it != _amplitudeProcessorDetections.end()) {
+        detection = it->second;
+      }
+
+      removeTimeWindowProcessor(processor);
+
+      if (detection && !detection->removalScheduled &&
+          _detections.find(detection) != _detections.end() &&
+          detection->ready()) {
+        publishAndRemoveDetection(detection);
+      }
+    };
+  });
+}
+
 void Application::registerDetection(
     const std::shared_ptr<DetectionItem> &detection) {
   if (_detectionRegistrationBlocked) {
@@ -2058,36 +3735,44 @@ void Application::registerDetection(
   const auto &waveformStreamIds{
       util::map_keys(detection->detection->templateResults)};
 
+  if (!_detections.emplace(detection).second) {
+    return;
+  }
   for (const auto &waveformStreamId : waveformStreamIds) {
-    _detections.emplace(waveformStreamId, detection);
+    _streamRoutes[waveformStreamId].detections.push_back(detection);
     SCDETECT_LOG_DEBUG("[%s] Added detection: id=\"%s\"",
                        waveformStreamId.c_str(), detection->id().c_str());
-    SCDETECT_LOG_DEBUG("Current detection count: %lu", _detections.size());
   }
+  SCDETECT_LOG_DEBUG("Current detection count: %lu", _detections.size());
 }
 
 void Application::removeDetection(
     const std::shared_ptr<DetectionItem> &detection) {
   if (_detectionRegistrationBlocked) {
-    _detectionRemovalQueue.emplace_back(detection);
+    if (!detection->removalScheduled) {
+      detection->removalScheduled = true;
+      _detectionRemovalQueue.emplace_back(detection);
+    }
     return;
   }
 
   const auto waveformStreamIds{
       util::map_keys(detection->detection->templateResults)};
-  for (const auto &waveformStreamId : waveformStreamIds) {
-    auto range{_detections.equal_range(waveformStreamId)};
-    auto it{range.first};
-    while (it != range.second) {
-      if (it->second == detection) {
-        SCDETECT_LOG_DEBUG("[%s] Removed detection: id=\"%s\"",
-                           waveformStreamId.c_str(), detection->id().c_str());
-        it = _detections.erase(it);
-        SCDETECT_LOG_DEBUG("Current detection count: %lu", _detections.size());
-      } else {
-        ++it;
+  if (_detections.erase(detection) > 0) {
+    for (const auto &waveformStreamId : waveformStreamIds) {
+      auto routeIt{_streamRoutes.find(waveformStreamId)};
+      if (routeIt == _streamRoutes.end()) {
+        continue;
       }
+
+      auto &detections{routeIt->second.detections};
+      detections.erase(
+          std::remove(std::begin(detections), std::end(detections), detection),
+          std::end(detections));
+      SCDETECT_LOG_DEBUG("[%s] Removed detection: id=\"%s\"",
+                         waveformStreamId.c_str(), detection->id().c_str());
     }
+    SCDETECT_LOG_DEBUG("Current detection count: %lu", _detections.size());
   }
 
   // check pending registration queue
@@ -2206,6 +3891,23 @@ void Application::Config::init(const Client::Application *app) {
     streamConfig.initTime = app->configGetDouble("processing.initTime");
   } catch (...) {
   }
+  try {
+    correlationSharingSimilarity =
+        app->configGetDouble("processing.correlationSharingSimilarity");
+  } catch (...) {
+  }
+  try {
+    autoTune = app->configGetBool("processing.autoTune");
+  } catch (...) {
+  }
+  try {
+    autoTuneMaxLatency = app->configGetDouble("processing.autoTuneMaxLatency");
+  } catch (...) {
+  }
+  try {
+    nativeFilters = app->configGetBool("processing.nativeFilters");
+  } catch (...) {
+  }
   try {
     detectorConfig.gapInterpolation =
         app->configGetBool("processing.gapInterpolation");
@@ -2256,6 +3958,40 @@ void Application::Config::init(const Client::Application *app) {
         app->configGetString("detector.mergingStrategy");
   } catch (...) {
   }
+  try {
+    detectorConfig.coarseSearchDecimation =
+        app->configGetInt("detector.coarseSearchDecimation");
+  } catch (...) {
+  }
+  try {
+    detectorConfig.coarseSearchThreshold =
+        app->configGetDouble("detector.coarseSearchThreshold");
+  } catch (...) {
+  }
+  try {
+    detectorConfig.prescreenMargin =
+        app->configGetDouble("detector.prescreenMargin");
+  } catch (...) {
+  }
+  try {
+    detectorConfig.subspaceDimension =
+        app->configGetInt("detector.subspaceDimension");
+  } catch (...) {
+  }
+  try {
+    detectorConfig.fuseComponents =
+        app->configGetBool("detector.fuseComponents");
+  } catch (...) {
+  }
+  try {
+    detectorConfig.stacking = app->configGetBool("detector.stacking");
+  } catch (...) {
+  }
+  try {
+    detectorConfig.correlationBlockSize =
+        app->configGetInt("detector.correlationBlockSize");
+  } catch (...) {
+  }
 
   try {
     sensorLocationBindings.amplitudeProcessingConfig.mlx.filter =
@@ -2277,6 +4013,18 @@ void Application::Config::init(const System::CommandLine &commandline) {
   templatesPrepare = commandline.hasOption("templates-prepare");
   templatesNoCache = commandline.hasOption("templates-reload");
 
+  if (commandline.hasOption("checkpoint")) {
+    Environment *env{Environment::Instance()};
+    pathCheckpoint =
+        env->absolutePath(commandline.option<std::string>("checkpoint"));
+  }
+
+  if (commandline.hasOption("auto-tune-cache")) {
+    Environment *env{Environment::Instance()};
+    pathAutoTuneCache =
+        env->absolutePath(commandline.option<std::string>("auto-tune-cache"));
+  }
+
   if (commandline.hasOption("templates-json")) {
     Environment *env{Environment::Instance()};
     pathTemplateJson =
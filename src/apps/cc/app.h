@@ -14,31 +14,39 @@
 #include <seiscomp/datamodel/origin.h>
 #include <seiscomp/datamodel/pick.h>
 #include <seiscomp/datamodel/stationmagnitude.h>
-#include <seiscomp/processing/streambuffer.h>
+#include <seiscomp/io/recordstream.h>
 #include <seiscomp/system/commandline.h>
 
 #include <boost/optional/optional.hpp>
+#include <boost/property_tree/ptree.hpp>
 #include <cassert>
 #include <cstddef>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "amplitude_processor.h"
 #include "binding.h"
 #include "config/detector.h"
 #include "config/template_family.h"
+#include "correlation_tuner.h"
 #include "detector/detector.h"
 #include "exception.h"
 #include "processing/timewindow_processor.h"
 #include "settings.h"
+#include "util/profiler.h"
 #include "util/waveform_stream_id.h"
+#include "util/worker_pool.h"
 #include "waveform.h"
+#include "waveform_buffer.h"
 
 namespace Seiscomp {
 namespace detect {
@@ -65,6 +73,12 @@ class Application : public Client::StreamApplication {
     DuplicatePublicObjectId();
   };
 
+  class MemoryBudgetExceeded : public BaseException {
+   public:
+    using BaseException::BaseException;
+    MemoryBudgetExceeded();
+  };
+
   struct Config {
     Config();
 
@@ -76,6 +90,17 @@ class Application : public Client::StreamApplication {
 
     bool templatesPrepare{false};
     bool templatesNoCache{false};
+    // Interval in seconds for checking the template configuration file for
+    // modifications (hot reload); disabled if not set
+    boost::optional<std::size_t> templatesWatchInterval;
+    // Path to the processor state checkpoint file (disabled if empty)
+    std::string pathCheckpoint;
+    // Interval in seconds for writing the checkpoint file
+    std::size_t checkpointInterval{60};
+    // Maximum number of samples missing between the data checkpointed and the
+    // data received after a restart in order to continue processing without
+    // initialization
+    std::size_t checkpointTolerance{0};
     // Global flag indicating whether to enable `true` or disable `false`
     // calculating amplitudes (regardless of the configuration provided on
     // detector configuration level granularity).
@@ -84,6 +109,54 @@ class Application : public Client::StreamApplication {
     // calculating magnitudes (regardless of the configuration provided on
     // detector configuration level granularity.
     boost::optional<bool> magnitudesForceMode;
+    // Number of worker threads computing amplitudes asynchronously from
+    // buffered waveform data (if zero, amplitudes are computed by the record
+    // processing thread)
+    std::size_t amplitudeWorkers{0};
+    // Global coarse-to-fine template search decimation factor (regardless of
+    // the configuration provided on detector configuration level granularity)
+    boost::optional<int> coarseSearchForcedDecimation;
+    // Global quantized pre-screening margin (regardless of the configuration
+    // provided on detector configuration level granularity)
+    boost::optional<double> prescreenForcedMargin;
+    // Global flag indicating whether to enable `true` or disable `false`
+    // fusing the components of a station (regardless of the configuration
+    // provided on detector configuration level granularity)
+    boost::optional<bool> fuseComponentsForceMode;
+    // Global flag indicating whether to enable `true` or disable `false` the
+    // stacking detector mode (regardless of the configuration provided on
+    // detector configuration level granularity)
+    boost::optional<bool> stackingForceMode;
+    // Global block size of the partitioned cross-correlation (regardless of
+    // the configuration provided on detector configuration level granularity)
+    boost::optional<int> correlationForcedBlockSize;
+    // Minimum similarity of template waveforms processing the same stream in
+    // order to share their cross-correlations (disabled if less than or equal
+    // to zero)
+    double correlationSharingSimilarity{0};
+    // Global correlation sharing similarity (regardless of the module
+    // configuration)
+    boost::optional<double> correlationSharingForcedSimilarity;
+    // Flag indicating whether to select the cross-correlation kernel per
+    // template waveform by means of micro-benchmarks (once the sampling
+    // frequency of the data is known)
+    bool autoTune{false};
+    // Global flag indicating whether to enable `true` or disable `false`
+    // auto-tuning (regardless of the module configuration)
+    boost::optional<bool> autoTuneForceMode;
+    // Maximum latency in seconds of the cross-correlation kernels selected by
+    // auto-tuning
+    double autoTuneMaxLatency{3};
+    // Path to the host specific auto-tuning cache file (if empty, the file is
+    // located within the filesystem cache directory)
+    std::string pathAutoTuneCache;
+    // Flag indicating whether to use the natively implemented Butterworth
+    // filters (see `filter::iir::FilterBank`) in place of the generic SeisComP
+    // implementation
+    bool nativeFilters{false};
+    // Global flag indicating whether to enable `true` or disable `false` the
+    // natively implemented filters (regardless of the module configuration)
+    boost::optional<bool> nativeFiltersForceMode;
 
     // Flag with forces the waveform buffer size
     boost::optional<Core::TimeSpan> forcedWaveformBufferSize{
@@ -170,6 +243,14 @@ class Application : public Client::StreamApplication {
 
     boost::optional<std::size_t> objectThroughputNofificationInterval;
 
+    // Path to the startup profiling report (disabled if empty)
+    std::string pathStartupReport;
+
+    // Global memory budget in MiB (disabled if not set). If exceeded, newly
+    // created detectors are rejected and amplitude calculation is disabled
+    // for running detectors.
+    boost::optional<std::size_t> memoryBudget;
+
     // default configurations
     config::PublishConfig publishConfig;
 
@@ -210,6 +291,7 @@ class Application : public Client::StreamApplication {
  private:
   using Picks = std::vector<DataModel::PickCPtr>;
   using TemplateConfigs = std::vector<config::TemplateConfig>;
+  using WaveformStreamId = std::string;
 
   struct DetectionItem {
     explicit DetectionItem(const DataModel::OriginPtr &origin)
@@ -261,20 +343,20 @@ class Application : public Client::StreamApplication {
     std::shared_ptr<const detector::Detector::Detection> detection;
 
     std::size_t numberOfRequiredAmplitudes{};
+    std::size_t numberOfCreatedAmplitudes{};
     std::size_t numberOfRequiredMagnitudes{};
 
     bool published{false};
+    // Indicates whether the detection was released for publication (i.e. it
+    // is published as soon as the detections issued before were published)
+    bool released{false};
+    // Indicates whether the detection is scheduled for removal
+    bool removalScheduled{false};
 
     const std::string &id() const { return origin->publicID(); }
 
     bool amplitudesReady() const {
-      std::size_t count{};
-      for (const auto &amplitudePair : amplitudes) {
-        if (amplitudePair.second) {
-          ++count;
-        }
-      }
-      return numberOfRequiredAmplitudes == count;
+      return numberOfRequiredAmplitudes == numberOfCreatedAmplitudes;
     }
     bool magnitudesReady() const {
       return numberOfRequiredMagnitudes == magnitudes.size();
@@ -332,12 +414,128 @@ class Application : public Client::StreamApplication {
   // Register `waveformStreamIds` at the record stream
   bool subscribeToRecordStream(
       std::set<util::WaveformStreamID> waveformStreamIds);
-
+  // Subscribes to the streams required but not subscribed, yet, and stops
+  // delivering the streams not required anymore
+  //
+  // - streams are subscribed to by means of a supplementary acquisition, i.e.
+  // the acquisition of the streams subscribed to is not interrupted
+  void updateSubscriptions();
+  // Closes the supplementary acquisitions
+  void closeAcquisitions();
+
+  // Returns the accumulated statistics of the waveform caches used during
+  // initialization
+  Cached::Statistics waveformCacheStatistics() const;
+  // Sets the waveform cache statistics accumulated `since` on `scope`
+  void setCacheStatistics(util::Profiler::Scope &scope,
+                          const Cached::Statistics &since) const;
+  // Writes the startup profiling report to `path`
+  void writeStartupReport(const std::string &path) const;
+
+  // Loads the subspace detector configuration from the template family
+  // configuration, i.e. the first detector referenced by a template family
+  // configured with a `"subspaceDimension"` is turned into a subspace detector
+  // while the remaining detectors referenced are subsumed
+  void initSubspaceFamilies();
+  // Groups the template waveform processors of the detectors fed with the
+  // same stream by means of the similarity of their template waveforms (see
+  // `Config::correlationSharingSimilarity`) and shares the cross-correlations
+  // within the groups. Returns the number of groups created.
+  //
+  // - only the detectors starting from `firstDetectorIdx` are grouped, i.e.
+  // the groups of the detectors running already are not modified
+  std::size_t initCorrelationGroups(std::size_t firstDetectorIdx = 0);
+  // Enables selecting the fastest exact cross-correlation kernel for the
+  // template waveform processors computing the direct cross-correlation by
+  // means of micro-benchmarks (see `CorrelationTuner`). The kernels are
+  // benchmarked for each pair of template waveform length and (target)
+  // sampling frequency, while the processors look the decisions up when their
+  // streams are set up. Decisions are cached per host. Returns the number of
+  // processors tuned.
+  //
+  // - only the detectors starting from `firstDetectorIdx` are tuned
+  std::size_t initCorrelationKernels(std::size_t firstDetectorIdx = 0);
+  // Saves the correlation tuning decisions benchmarked
+  void saveCorrelationTuning();
   // Initialize detectors
   //
   // - `ifs` references a template configuration input file stream
   bool initDetectors(std::ifstream &ifs, WaveformHandlerIface *waveformHandler,
                      TemplateConfigs &templateConfigs);
+  // Creates a detector based on the template configuration `tc`
+  //
+  // - `waveformStreamIds` are filled with the waveform stream identifiers the
+  // detector must be fed with
+  std::unique_ptr<detector::Detector> createDetector(
+      const config::TemplateConfig &tc, WaveformHandlerIface *waveformHandler,
+      std::vector<WaveformStreamId> &waveformStreamIds) const;
+  // Adds `detector` to the running detectors
+  //
+  // - throws `MemoryBudgetExceeded` if adding `detector` would exceed the
+  // memory budget configured
+  void addDetector(std::unique_ptr<detector::Detector> detector,
+                   const std::vector<WaveformStreamId> &waveformStreamIds);
+  // Returns a canonical representation of a template configuration entry
+  // (including the subspace family configuration, if the entry refers to a
+  // subspace family's reference detector)
+  std::string createTemplateConfigFingerprint(
+      const boost::property_tree::ptree &pt) const;
+  // Creates the (cached) waveform handler used for loading template waveforms
+  //
+  // - returns `nullptr` on failure
+  WaveformHandlerIfacePtr createWaveformHandler();
+
+  // Restores the detectors from the checkpoint file. Returns the number of
+  // processors a checkpoint was found for.
+  //
+  // - only the detectors starting from `firstDetectorIdx` are restored
+  std::size_t restoreCheckpoint(std::size_t firstDetectorIdx = 0);
+  // Writes the checkpoint file, if required
+  void handleCheckpoint();
+  // Writes the checkpoint file
+  //
+  // - if `async` is `true` the file is written by a background thread (the
+  // processor state is collected synchronously, though)
+  void writeCheckpoint(bool async = false);
+
+  using DetectorId = std::string;
+  using DetectorMemoryUsage = std::unordered_map<DetectorId, std::size_t>;
+  // Returns the approximate number of bytes allocated by the running
+  // amplitude processors (grouped by detector)
+  DetectorMemoryUsage amplitudeMemoryUsage() const;
+  // Returns the approximate total memory usage in bytes (i.e. including the
+  // detectors, the amplitude processors and the waveform buffer)
+  //
+  // - the data buffers of detectors which did not receive any data, yet, are
+  // estimated (see `detector::Detector::estimatedMemoryUsage()`)
+  std::size_t memoryUsage() const;
+  // Logs the approximate memory usage both per detector and in total
+  //
+  // - uses the log level INFO if `info` is `true`, else DEBUG
+  void logMemoryUsage(bool info) const;
+  // Enforces the memory budget, if required
+  //
+  // - if the budget is exceeded, the amplitude calculation is disabled for a
+  // single detector per check (i.e. the memory usage is measured again
+  // before degrading further)
+  // - if the memory usage drops below the budget, the amplitude calculation is
+  // enabled again for a single detector per check, provided that the memory
+  // released when it was disabled fits into the budget
+  void handleMemoryBudget();
+
+  struct TemplateConfigReload;
+  // Checks the template configuration file for modifications and reloads the
+  // template configuration, if required
+  void handleTemplateConfigReload();
+  // Diffs the template configuration against the running detectors and
+  // loads the event related data required for creating the pending detectors
+  void startTemplateConfigReload();
+  // Creates the next pending detector of the ongoing template configuration
+  // reload, i.e. the detectors are created step by step in between records
+  // processed. Finishes the reload if there are no pending detectors left.
+  void continueTemplateConfigReload();
+  // Swaps in the detectors created and retires the removed ones
+  void finishTemplateConfigReload();
 
   // Initialize amplitude processors
   bool initAmplitudeProcessors(std::shared_ptr<DetectionItem> &detectionItem,
@@ -363,11 +561,13 @@ class Application : public Client::StreamApplication {
       NetworkMagnitudeComputationStrategy strategy,
       const std::string &methodId = "", const std::string &processorId = "");
 
-  using WaveformStreamId = std::string;
-  // Registers an amplitude `processor` for `waveformStreamIds`
+  // Registers an amplitude `processor` for `detection`
   void registerAmplitudeProcessor(
       const std::shared_ptr<AmplitudeProcessor> &processor,
-      DetectionItem &detection);
+      const std::shared_ptr<DetectionItem> &detection);
+  // Releases the amplitude processor identified by `processorId` from its
+  // detection, i.e. an amplitude not created, yet, is not required anymore
+  void releaseAmplitudeProcessor(const std::string &processorId);
   // Registers a time window `processor` for `waveformStreamIds`
   void registerTimeWindowProcessor(
       const std::vector<WaveformStreamId> &waveformStreamIds,
@@ -375,6 +575,23 @@ class Application : public Client::StreamApplication {
   // Unregisters time window `processor`
   void removeTimeWindowProcessor(
       const std::shared_ptr<processing::TimeWindowProcessor> &processor);
+  // Removes time window `processor` from the routes of `waveformStreamIds`
+  // (the processor remains registered)
+  void unrouteTimeWindowProcessor(
+      const std::vector<WaveformStreamId> &waveformStreamIds,
+      const std::shared_ptr<processing::TimeWindowProcessor> &processor);
+  // Returns the time window buffered for all `waveformStreamIds`
+  //
+  // - returns `boost::none` if there is no common time window buffered
+  boost::optional<Core::TimeWindow> bufferedTimeWindow(
+      const std::vector<WaveformStreamId> &waveformStreamIds) const;
+  // Submits the amplitude `processor` to the amplitude worker pool, i.e. the
+  // processor is fed asynchronously with the data buffered for
+  // `waveformStreamIds`. The amplitudes computed are merged back by the
+  // record processing thread.
+  void submitAmplitudeProcessor(
+      const std::vector<WaveformStreamId> &waveformStreamIds,
+      const std::shared_ptr<AmplitudeProcessor> &processor);
 
   // Registers a detection
   void registerDetection(const std::shared_ptr<DetectionItem> &detection);
@@ -385,8 +602,14 @@ class Application : public Client::StreamApplication {
       const detector::Detector *processor, const Record *record,
       std::unique_ptr<const detector::Detector::Detection> detection);
 
+  // Publishes `detection`; if amplitudes are computed asynchronously, the
+  // detection is released for publication, only (see
+  // `flushPublicationQueue()`)
   void publishDetection(const std::shared_ptr<DetectionItem> &detection);
   void publishDetection(const DetectionItem &detectionItem);
+  // Publishes the detections released in the order they were issued, i.e.
+  // publication stops at the first detection not released, yet
+  void flushPublicationQueue();
 
   void publishAndRemoveDetection(std::shared_ptr<DetectionItem> &detection);
 
@@ -403,14 +626,114 @@ class Application : public Client::StreamApplication {
 
   Detectors _detectors;
 
-  using DetectorIdx = std::unordered_multimap<WaveformStreamId, std::size_t>;
-  DetectorIdx _detectorIdx;
+  // Per-stream fan-out table used for dispatching records
+  //
+  // - updated incrementally when registering and removing consumers
+  struct StreamRoute {
+    // Indices of the detectors (w.r.t. `_detectors`) fed with the stream
+    std::vector<std::size_t> detectors;
+    // Time window processors fed with the stream
+    std::vector<std::shared_ptr<processing::TimeWindowProcessor>>
+        timeWindowProcessors;
+    // Detections waiting for data of the stream
+    std::vector<std::shared_ptr<DetectionItem>> detections;
+
+    bool empty() const {
+      return detectors.empty() && timeWindowProcessors.empty() &&
+             detections.empty();
+    }
+  };
+  using StreamRoutes = std::unordered_map<WaveformStreamId, StreamRoute>;
+  StreamRoutes _streamRoutes;
+
+  using TemplateConfigFingerprint = std::string;
+  using DetectorFingerprints =
+      std::unordered_multimap<TemplateConfigFingerprint, DetectorId>;
+  // Fingerprints of the template configuration entries the running detectors
+  // were created from
+  DetectorFingerprints _detectorFingerprints;
+
+  // State of an ongoing template configuration reload
+  struct TemplateConfigReload {
+    struct PendingItem {
+      TemplateConfigFingerprint fingerprint;
+      config::TemplateConfig templateConfig;
+    };
+    // Template configurations of detectors to be created
+    std::list<PendingItem> pending;
+
+    struct BuiltItem {
+      TemplateConfigFingerprint fingerprint;
+      DetectorId detectorId;
+      std::unique_ptr<detector::Detector> detector;
+      std::vector<WaveformStreamId> waveformStreamIds;
+      config::TemplateConfig templateConfig;
+    };
+    // Detectors created, but not swapped in, yet
+    std::vector<BuiltItem> built;
+
+    // Running detectors to be retained
+    std::unordered_map<DetectorId, TemplateConfigFingerprint> retained;
+    // Template configurations of both the retained and the subsumed detectors
+    // (i.e. the template configurations of the detectors created are added
+    // when swapped in)
+    TemplateConfigs templateConfigs;
+
+    WaveformHandlerIfacePtr waveformHandler;
+  };
+  std::unique_ptr<TemplateConfigReload> _templateConfigReload;
+  std::time_t _templateConfigModificationTime{};
+  Core::Time _nextTemplateConfigCheck;
+
+  Core::Time _nextCheckpoint;
+  // Writes the checkpoint file in the background
+  std::thread _checkpointWriter;
+
+  // Selects the cross-correlation kernels (disabled if not set)
+  std::shared_ptr<CorrelationTuner> _correlationTuner;
+  // The path the correlation tuning decisions are cached at
+  std::string _pathCorrelationTuning;
+
+  // Subspace detector configuration derived from a template family
+  struct SubspaceFamily {
+    // The template family identifier
+    std::string id;
+    // Origin identifiers of the subspace members
+    std::vector<std::string> originIds;
+    int dimension{1};
+  };
+  // Subspace families indexed by the identifier of the reference detector
+  std::unordered_map<DetectorId, SubspaceFamily> _subspaceFamilies;
+  // Detectors subsumed by a subspace family's reference detector
+  std::unordered_set<DetectorId> _subsumedDetectors;
+
+  // Detectors amplitude calculation was disabled for due to the memory budget
+  // (mapped to the amplitude processors' memory usage when disabled)
+  std::unordered_map<DetectorId, std::size_t> _amplitudesDisabled;
+  Core::Time _nextMemoryBudgetCheck;
+
+  // Streams subscribed to (including the streams of the supplementary
+  // acquisitions)
+  std::set<util::WaveformStreamID> _subscribedStreams;
+  // Streams subscribed to at the record stream which are not required
+  // anymore (i.e. the records are dropped)
+  std::unordered_set<WaveformStreamId> _droppedStreams;
+
+  // Acquisition of streams subscribed to while the application is running
+  // (i.e. without interrupting the acquisition of the record stream)
+  struct Acquisition {
+    IO::RecordStreamPtr recordStream;
+    std::set<util::WaveformStreamID> streams;
+    // Reads the records and hands them over to the record processing thread
+    std::thread thread;
+  };
+  std::list<std::unique_ptr<Acquisition>> _acquisitions;
 
   // Ringbuffer
-  Processing::StreamBuffer _waveformBuffer;
+  WaveformBuffer _waveformBuffer;
 
-  using Detections =
-      std::unordered_multimap<WaveformStreamId, std::shared_ptr<DetectionItem>>;
+  using Detections = std::unordered_set<std::shared_ptr<DetectionItem>>;
+  // The registered detections
   Detections _detections;
 
   using DetectionQueue = std::list<std::shared_ptr<DetectionItem>>;
@@ -418,12 +741,11 @@ class Application : public Client::StreamApplication {
   DetectionQueue _detectionQueue;
   // The queue used for detection removal
   DetectionQueue _detectionRemovalQueue;
+  // Detections not published, yet, in the order they were issued (used if
+  // amplitudes are computed asynchronously, only)
+  DetectionQueue _publicationQueue;
   bool _detectionRegistrationBlocked{false};
 
-  using TimeWindowProcessors =
-      std::unordered_multimap<WaveformStreamId,
-                              std::shared_ptr<processing::TimeWindowProcessor>>;
-  TimeWindowProcessors _timeWindowProcessors;
   using ProcessorId = std::string;
   using TimeWindowProcessorIdx =
       std::unordered_map<ProcessorId, std::vector<WaveformStreamId>>;
@@ -438,11 +760,36 @@ class Application : public Client::StreamApplication {
   TimeWindowProcessorQueue _timeWindowProcessorRegistrationQueue;
   // The queue used for time window processor removal
   TimeWindowProcessorQueue _timeWindowProcessorRemovalQueue;
+  // Time window processors enqueued for removal (allows for constant time
+  // lookups)
+  std::unordered_set<const processing::TimeWindowProcessor *>
+      _timeWindowProcessorsScheduledForRemoval;
+
+  // Amplitude processors waiting for their time window to be buffered in
+  // order to be submitted to the amplitude worker pool (i.e. the processors
+  // are not fed by the record processing thread)
+  std::unordered_set<const processing::TimeWindowProcessor *>
+      _deferredTimeWindowProcessors;
+  // The queue used for submitting deferred amplitude processors
+  TimeWindowProcessorQueue _timeWindowProcessorSubmissionQueue;
+  // Computes amplitudes asynchronously (disabled if not set)
+  std::unique_ptr<util::WorkerPool> _amplitudeWorkerPool;
+
+  using AmplitudeProcessorDetections =
+      std::unordered_map<ProcessorId, std::shared_ptr<DetectionItem>>;
+  // Maps registered amplitude processors to their detection
+  AmplitudeProcessorDetections _amplitudeProcessorDetections;
   bool _timeWindowProcessorRegistrationBlocked{false};
 
   // Used to monitor the average object throughput
   Client::RunningAverage _averageObjectThroughputMonitor{
       settings::kObjectThroughputAverageTimeSpan};
+
+  // Used to profile the initialization procedure
+  util::Profiler _startupProfiler;
+  // Waveform caches used during initialization (ordered from the outermost to
+  // the innermost cache)
+  std::vector<CachedPtr> _waveformCaches;
 };
 
 }  // namespace detect
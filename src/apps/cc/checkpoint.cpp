@@ -0,0 +1,255 @@
+#include "checkpoint.h"
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/timewindow.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+
+namespace {
+
+const char kMagic[]{'S', 'C', 'D', 'C', 'K', 'P', 'T', '\0'};
+const std::uint32_t kFormatVersion{3};
+
+template <typename T>
+void writeValue(std::ostream &os, const T &value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+T readValue(std::istream &is) {
+  T ret;
+  if (!is.read(reinterpret_cast<char *>(&ret), sizeof(ret))) {
+    throw Checkpoint::BaseException{"unexpected end of input"};
+  }
+  return ret;
+}
+
+void writeString(std::ostream &os, const std::string &str) {
+  writeValue<std::uint64_t>(os, str.size());
+  os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+std::string readString(std::istream &is) {
+  const auto size{readValue<std::uint64_t>(is)};
+  std::string ret(size, '\0');
+  if (!is.read(&ret[0], static_cast<std::streamsize>(size))) {
+    throw Checkpoint::BaseException{"unexpected end of input"};
+  }
+  return ret;
+}
+
+void writeSamples(std::ostream &os, const std::vector<double> &samples) {
+  writeValue<std::uint64_t>(os, samples.size());
+  os.write(reinterpret_cast<const char *>(samples.data()),
+           static_cast<std::streamsize>(samples.size() * sizeof(double)));
+}
+
+std::vector<double> readSamples(std::istream &is) {
+  const auto size{readValue<std::uint64_t>(is)};
+  std::vector<double> ret(size);
+  if (!is.read(reinterpret_cast<char *>(ret.data()),
+               static_cast<std::streamsize>(size * sizeof(double)))) {
+    throw Checkpoint::BaseException{"unexpected end of input"};
+  }
+  return ret;
+}
+
+void writeTime(std::ostream &os, const Core::Time &time) {
+  writeValue<std::int64_t>(os, time.seconds());
+  writeValue<std::int64_t>(os, time.microseconds());
+}
+
+Core::Time readTime(std::istream &is) {
+  const auto seconds{readValue<std::int64_t>(is)};
+  const auto microseconds{readValue<std::int64_t>(is)};
+  return Core::Time{static_cast<long>(seconds),
+                    static_cast<long>(microseconds)};
+}
+
+void writeTimeWindow(std::ostream &os, const Core::TimeWindow &timeWindow) {
+  writeTime(os, timeWindow.startTime());
+  writeTime(os, timeWindow.endTime());
+}
+
+Core::TimeWindow readTimeWindow(std::istream &is) {
+  const auto startTime{readTime(is)};
+  const auto endTime{readTime(is)};
+  return Core::TimeWindow{startTime, endTime};
+}
+
+void writeProcessorCheckpoint(
+    std::ostream &os,
+    const detector::TemplateWaveformProcessor::Checkpoint &checkpoint) {
+  writeValue(os, checkpoint.samplingFrequency);
+  writeTimeWindow(os, checkpoint.dataTimeWindow);
+  writeValue(os, checkpoint.lastSample);
+  writeSamples(os, checkpoint.filterInput);
+  writeSamples(os, checkpoint.crossCorrelation.buffer);
+  writeValue(os, checkpoint.crossCorrelation.sumData);
+  writeValue(os, checkpoint.crossCorrelation.sumSquaredData);
+  writeValue<std::uint64_t>(os, checkpoint.partitionBlockSize);
+}
+
+detector::TemplateWaveformProcessor::Checkpoint readProcessorCheckpoint(
+    std::istream &is) {
+  detector::TemplateWaveformProcessor::Checkpoint ret;
+  ret.samplingFrequency = readValue<double>(is);
+  ret.dataTimeWindow = readTimeWindow(is);
+  ret.lastSample = readValue<double>(is);
+  ret.filterInput = readSamples(is);
+  ret.crossCorrelation.buffer = readSamples(is);
+  ret.crossCorrelation.sumData = readValue<double>(is);
+  ret.crossCorrelation.sumSquaredData = readValue<double>(is);
+  ret.partitionBlockSize =
+      static_cast<std::size_t>(readValue<std::uint64_t>(is));
+  return ret;
+}
+
+void writeLinkerCheckpoint(std::ostream &os,
+                           const Checkpoint::LinkerCheckpoint &checkpoint) {
+  writeValue<std::uint64_t>(os, checkpoint.candidates.size());
+  for (const auto &candidate : checkpoint.candidates) {
+    writeValue<double>(os, static_cast<double>(candidate.onHold));
+    writeValue<std::uint64_t>(os, candidate.results.size());
+    for (const auto &result : candidate.results) {
+      writeString(os, result.processorId);
+      writeTime(os, result.pickTime);
+      writeTimeWindow(os, result.timeWindow);
+      writeValue<double>(os, static_cast<double>(result.value.lag));
+      writeValue(os, result.value.coefficient);
+    }
+  }
+}
+
+Checkpoint::LinkerCheckpoint readLinkerCheckpoint(std::istream &is) {
+  Checkpoint::LinkerCheckpoint ret;
+  const auto candidateCount{readValue<std::uint64_t>(is)};
+  for (std::uint64_t i{0}; i < candidateCount; ++i) {
+    Checkpoint::LinkerCheckpoint::Candidate candidate;
+    candidate.onHold = Core::TimeSpan{readValue<double>(is)};
+    const auto resultCount{readValue<std::uint64_t>(is)};
+    for (std::uint64_t j{0}; j < resultCount; ++j) {
+      Checkpoint::LinkerCheckpoint::Result result;
+      result.processorId = readString(is);
+      result.pickTime = readTime(is);
+      result.timeWindow = readTimeWindow(is);
+      result.value.lag = Core::TimeSpan{readValue<double>(is)};
+      result.value.coefficient = readValue<double>(is);
+      candidate.results.push_back(std::move(result));
+    }
+    ret.candidates.push_back(std::move(candidate));
+  }
+  return ret;
+}
+
+}  // namespace
+
+Checkpoint::BaseException::BaseException()
+    : Exception{"base checkpoint exception"} {}
+
+void Checkpoint::set(const DetectorId &detectorId,
+                     DetectorCheckpoint checkpoint) {
+  _detectors[detectorId] = std::move(checkpoint);
+}
+
+const Checkpoint::DetectorCheckpoint *Checkpoint::get(
+    const DetectorId &detectorId) const {
+  auto it{_detectors.find(detectorId)};
+  if (it == _detectors.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+std::size_t Checkpoint::size() const { return _detectors.size(); }
+
+bool Checkpoint::empty() const { return _detectors.empty(); }
+
+void Checkpoint::clear() { _detectors.clear(); }
+
+void Checkpoint::write(std::ostream &os) const {
+  os.write(kMagic, sizeof(kMagic));
+  writeValue(os, kFormatVersion);
+
+  writeValue<std::uint64_t>(os, _detectors.size());
+  for (const auto &detectorPair : _detectors) {
+    const auto &detectorCheckpoint{detectorPair.second};
+    writeString(os, detectorPair.first);
+    writeValue<std::uint64_t>(os, detectorCheckpoint.processors.size());
+    for (const auto &processorPair : detectorCheckpoint.processors) {
+      writeString(os, processorPair.first);
+      writeProcessorCheckpoint(os, processorPair.second);
+    }
+    writeLinkerCheckpoint(os, detectorCheckpoint.linker);
+  }
+
+  if (!os) {
+    throw BaseException{"failed to write checkpoint"};
+  }
+}
+
+void Checkpoint::read(std::istream &is) {
+  char magic[sizeof(kMagic)];
+  if (!is.read(magic, sizeof(magic)) ||
+      !std::equal(std::begin(magic), std::end(magic), std::begin(kMagic))) {
+    throw BaseException{"invalid checkpoint: magic mismatch"};
+  }
+  const auto version{readValue<std::uint32_t>(is)};
+  if (version != kFormatVersion) {
+    throw BaseException{"incompatible checkpoint version: " +
+                        std::to_string(version)};
+  }
+
+  Detectors detectors;
+  const auto detectorCount{readValue<std::uint64_t>(is)};
+  for (std::uint64_t i{0}; i < detectorCount; ++i) {
+    auto detectorId{readString(is)};
+    DetectorCheckpoint detectorCheckpoint;
+    const auto processorCount{readValue<std::uint64_t>(is)};
+    for (std::uint64_t j{0}; j < processorCount; ++j) {
+      auto processorId{readString(is)};
+      detectorCheckpoint.processors.emplace(std::move(processorId),
+                                            readProcessorCheckpoint(is));
+    }
+    detectorCheckpoint.linker = readLinkerCheckpoint(is);
+    detectors.emplace(std::move(detectorId), std::move(detectorCheckpoint));
+  }
+
+  _detectors = std::move(detectors);
+}
+
+void Checkpoint::save(const std::string &path) const {
+  const auto tmpPath{path + ".tmp"};
+  {
+    std::ofstream ofs{tmpPath, std::ios::binary | std::ios::trunc};
+    if (!ofs) {
+      throw BaseException{"failed to open file: " + tmpPath};
+    }
+    write(ofs);
+  }
+
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    throw BaseException{"failed to rename file: " + tmpPath + " -> " + path};
+  }
+}
+
+void Checkpoint::load(const std::string &path) {
+  std::ifstream ifs{path, std::ios::binary};
+  if (!ifs) {
+    throw BaseException{"failed to open file: " + path};
+  }
+  read(ifs);
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
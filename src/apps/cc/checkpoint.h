@@ -0,0 +1,81 @@
+#ifndef SCDETECT_APPS_CC_CHECKPOINT_H_
+#define SCDETECT_APPS_CC_CHECKPOINT_H_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "detector/linker.h"
+#include "detector/template_waveform_processor.h"
+#include "exception.h"
+
+namespace Seiscomp {
+namespace detect {
+
+// Collection of detector checkpoints (i.e. the template waveform processor
+// checkpoints and the linker's pending candidate associations) which may be
+// persisted to and restored from a local file
+//
+// - the binary file format is versioned, but host specific (i.e. it depends
+// on both the byte order and the floating point representation). That is,
+// checkpoints are meant to be restored on the host they were created, only.
+// - the state of the resampling operators is not checkpointed, i.e. the
+// resampler of a processor whose data is resampled restarts once the data
+// resumes
+class Checkpoint {
+ public:
+  class BaseException : public Exception {
+   public:
+    using Exception::Exception;
+    BaseException();
+  };
+
+  using DetectorId = std::string;
+  using ProcessorId = std::string;
+  using ProcessorCheckpoints =
+      std::unordered_map<ProcessorId,
+                         detector::TemplateWaveformProcessor::Checkpoint>;
+
+  using LinkerCheckpoint = detector::Linker::Checkpoint;
+
+  struct DetectorCheckpoint {
+    ProcessorCheckpoints processors;
+    LinkerCheckpoint linker;
+  };
+
+  // Sets the checkpoint of the detector identified by `detectorId`
+  void set(const DetectorId &detectorId, DetectorCheckpoint checkpoint);
+  // Returns the checkpoint of the detector identified by `detectorId`
+  //
+  // - returns `nullptr` if there is no checkpoint for `detectorId`
+  const DetectorCheckpoint *get(const DetectorId &detectorId) const;
+
+  // Returns the number of detectors checkpointed
+  std::size_t size() const;
+  bool empty() const;
+  void clear();
+
+  // Writes the checkpoint to `os`
+  void write(std::ostream &os) const;
+  // Reads the checkpoint from `is` (replacing the current content)
+  //
+  // - throws `BaseException` if the input is malformed or has been written
+  // with an incompatible version
+  void read(std::istream &is);
+
+  // Saves the checkpoint to `path`. The file is replaced atomically.
+  void save(const std::string &path) const;
+  // Loads the checkpoint from `path`
+  void load(const std::string &path);
+
+ private:
+  using Detectors = std::unordered_map<DetectorId, DetectorCheckpoint>;
+  Detectors _detectors;
+};
+
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_CHECKPOINT_H_
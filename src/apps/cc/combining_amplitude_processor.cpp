@@ -83,6 +83,14 @@ CombiningAmplitudeProcessor::associatedWaveformStreamIds() const {
   return std::vector<WaveformStreamId>{std::begin(unique), std::end(unique)};
 }
 
+std::size_t CombiningAmplitudeProcessor::memoryUsage() const {
+  std::size_t ret{0};
+  for (const auto &u : _underlying) {
+    ret += u.second.amplitudeProcessor->memoryUsage();
+  }
+  return ret;
+}
+
 bool CombiningAmplitudeProcessor::store(const Record *record) {
   if (allUnderlyingFinished() || finished()) {
     return false;
@@ -2,6 +2,7 @@
 #define SCDETECT_APPS_CC_COMBININGAMPLITUDEPROCESSOR_H_
 
 #include <boost/optional/optional.hpp>
+#include <cstddef>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -38,6 +39,8 @@ class CombiningAmplitudeProcessor : public detect::AmplitudeProcessor {
 
   std::vector<std::string> associatedWaveformStreamIds() const override;
 
+  std::size_t memoryUsage() const override;
+
  protected:
   processing::WaveformProcessor::StreamState *streamState(
       const Record *record) override;
@@ -109,7 +109,9 @@ bool DetectorConfig::isValid(size_t numStreamConfigs) const {
         util::isGeZero(gapTolerance) && gapThreshold < gapTolerance)) &&
       validateArrivalOffsetThreshold(arrivalOffsetThreshold) &&
       validateMinArrivals(minArrivals, static_cast<int>(numStreamConfigs)) &&
-      validateLinkerMergingStrategy(mergingStrategy));
+      validateLinkerMergingStrategy(mergingStrategy) &&
+      validateXCorrThreshold(coarseSearchThreshold) &&
+      subspaceDimension >= 1);
 }
 
 TemplateConfig::TemplateConfig(const boost::property_tree::ptree &pt,
@@ -152,6 +154,27 @@ TemplateConfig::TemplateConfig(const boost::property_tree::ptree &pt,
       pt.get<int>("minimumArrivals", detectorDefaults.minArrivals);
   _detectorConfig.mergingStrategy =
       pt.get<std::string>("mergingStrategy", detectorDefaults.mergingStrategy);
+  _detectorConfig.coarseSearchDecimation = pt.get<int>(
+      "coarseSearchDecimation", detectorDefaults.coarseSearchDecimation);
+  _detectorConfig.coarseSearchThreshold = pt.get<double>(
+      "coarseSearchThreshold", detectorDefaults.coarseSearchThreshold);
+  _detectorConfig.prescreenMargin =
+      pt.get<double>("prescreenMargin", detectorDefaults.prescreenMargin);
+  _detectorConfig.subspaceDimension =
+      pt.get<int>("subspaceDimension", detectorDefaults.subspaceDimension);
+  _detectorConfig.fuseComponents =
+      pt.get<bool>("fuseComponents", detectorDefaults.fuseComponents);
+  _detectorConfig.stacking =
+      pt.get<bool>("stacking", detectorDefaults.stacking);
+  _detectorConfig.correlationBlockSize = pt.get<int>(
+      "correlationBlockSize", detectorDefaults.correlationBlockSize);
+  const auto subspaceOriginIds{pt.get_child_optional("subspaceOriginIds")};
+  if (subspaceOriginIds) {
+    for (const auto &originIdPair : *subspaceOriginIds) {
+      _detectorConfig.subspaceOriginIds.push_back(
+          originIdPair.second.get_value<std::string>());
+    }
+  }
 
   // patch stream defaults with detector config globals
   auto patchedStreamDefaults{streamDefaults};
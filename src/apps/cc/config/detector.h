@@ -102,6 +102,61 @@ struct DetectorConfig {
   // criteria
   std::string mergingStrategy{"greaterEqualTriggerOnThreshold"};
 
+  // Decimation factor of the coarse-to-fine template search, i.e. exact
+  // cross-correlation coefficients are computed only around coarse
+  // coefficients (computed from decimated data) greater than or equal to
+  // `coarseSearchThreshold`
+  // - setting a value less than or equal to 1 disables the coarse-to-fine
+  // search (default)
+  int coarseSearchDecimation{1};
+  // The screening threshold of the coarse-to-fine template search
+  // - xcorr threshold [-1,1]
+  // - values greater than the lowest threshold relevant for detecting are
+  // lowered to that threshold
+  double coarseSearchThreshold{0.5};
+
+  // Margin below the lowest threshold relevant for detecting (i.e. usually
+  // `triggerOn`) of the quantized pre-screening, i.e. exact cross-correlation
+  // coefficients are computed only if the coefficients approximated by means of
+  // quantized data exceed the threshold minus the margin
+  // - setting a negative value disables the pre-screening (default)
+  double prescreenMargin{-1};
+
+  // Origin identifiers of the subspace members, i.e. the templates (extracted
+  // the same way as the detector's templates) which together with the
+  // detector's templates span the subspace; if non-empty, the projected energy
+  // (instead of the cross-correlation coefficient) is used as detection
+  // statistic
+  // - the trigger thresholds refer to the fraction of the data's energy
+  // projected onto the subspace [0,1]
+  std::vector<std::string> subspaceOriginIds;
+  // The dimension of the subspace (i.e. the number of basis vectors
+  // correlated)
+  int subspaceDimension{1};
+
+  // Flag indicating whether to fuse the streams of a sensor location (i.e. the
+  // components of a station) into a single multichannel cross-correlation
+  // processor; the mean cross-correlation coefficient of the components is
+  // used as detection statistic
+  bool fuseComponents{false};
+
+  // Flag indicating whether to stack the template waveform processors'
+  // cross-correlation coefficient traces w.r.t. the template moveout (i.e.
+  // network stacking) instead of linking the processors' local maxima
+  // - the trigger thresholds refer to the stacked (i.e. mean) coefficient
+  // - neither the arrival offset threshold nor the merging strategy apply
+  // - neither the coarse-to-fine search, the pre-screening nor correlation
+  // sharing may be combined with stacking
+  bool stacking{false};
+
+  // Block size (in samples) of the uniformly partitioned frequency-domain
+  // cross-correlation, i.e. the data is correlated block-wise by means of FFTs
+  // against the partitioned template waveforms; the coefficients are delayed
+  // by the block size (rounded up to the next power of two)
+  // - setting a value less than or equal to 0 disables the partitioned
+  // cross-correlation (default)
+  int correlationBlockSize{0};
+
   bool isValid(size_t numStreamConfigs) const;
 };
 
@@ -0,0 +1,501 @@
+#include "template_config_reader.h"
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <cassert>
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "validators.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace config {
+
+namespace {
+
+enum class JsonType { kNull, kBoolean, kNumber, kString, kArray, kObject };
+
+// The JSON types of a JSON value and (recursively) of its object members and
+// array items
+//
+// - `boost::property_tree` represents scalars by means of strings, only, i.e.
+// the JSON types are lost when parsing (e.g. the string `"true"` cannot be
+// distinguished from the literal `true`)
+struct JsonTypes {
+  JsonType type{JsonType::kNull};
+  boost::container::flat_map<std::string, JsonTypes> members;
+  boost::container::vector<JsonTypes> items;
+};
+
+void skipWhitespace(const std::string &text, std::size_t &pos) {
+  while (pos < text.size() && std::isspace(text[pos])) {
+    ++pos;
+  }
+}
+
+// Scans the JSON string starting at `pos` and returns its raw (i.e. still
+// escaped) content
+std::string scanString(const std::string &text, std::size_t &pos) {
+  assert(text[pos] == '"');
+  const auto begin{++pos};
+  bool escaped{false};
+  for (; pos < text.size(); ++pos) {
+    if (escaped) {
+      escaped = false;
+    } else if (text[pos] == '\\') {
+      escaped = true;
+    } else if (text[pos] == '"') {
+      break;
+    }
+  }
+  return text.substr(begin, pos++ - begin);
+}
+
+// Scans the JSON value starting at `pos` of the well-formed JSON document
+// `text`
+JsonTypes scanJsonTypes(const std::string &text, std::size_t &pos) {
+  JsonTypes ret;
+  skipWhitespace(text, pos);
+  if (pos >= text.size()) {
+    return ret;
+  }
+
+  switch (text[pos]) {
+    case '{':
+      ret.type = JsonType::kObject;
+      ++pos;
+      while (true) {
+        skipWhitespace(text, pos);
+        if (pos >= text.size() || text[pos] == '}') {
+          break;
+        }
+        if (text[pos] == ',') {
+          ++pos;
+          continue;
+        }
+        auto key{scanString(text, pos)};
+        skipWhitespace(text, pos);
+        ++pos;  // ':'
+        auto value{scanJsonTypes(text, pos)};
+        // in accordance with `boost::property_tree::ptree::get_child()` the
+        // first of duplicate members is used
+        ret.members.emplace(std::move(key), std::move(value));
+      }
+      ++pos;
+      break;
+    case '[':
+      ret.type = JsonType::kArray;
+      ++pos;
+      while (true) {
+        skipWhitespace(text, pos);
+        if (pos >= text.size() || text[pos] == ']') {
+          break;
+        }
+        if (text[pos] == ',') {
+          ++pos;
+          continue;
+        }
+        ret.items.push_back(scanJsonTypes(text, pos));
+      }
+      ++pos;
+      break;
+    case '"':
+      ret.type = JsonType::kString;
+      scanString(text, pos);
+      break;
+    case 't':
+    case 'f':
+      ret.type = JsonType::kBoolean;
+      pos += text[pos] == 't' ? 4 : 5;
+      break;
+    case 'n':
+      ret.type = JsonType::kNull;
+      pos += 4;
+      break;
+    default:
+      ret.type = JsonType::kNumber;
+      while (pos < text.size() &&
+             (std::isdigit(text[pos]) || text[pos] == '-' || text[pos] == '+' ||
+              text[pos] == '.' || text[pos] == 'e' || text[pos] == 'E')) {
+        ++pos;
+      }
+      break;
+  }
+  return ret;
+}
+
+// The properties of a JSON object, i.e. both their values and their JSON
+// types
+struct Properties {
+  const boost::property_tree::ptree &values;
+  const JsonTypes &types;
+};
+
+// Validates the JSON type of the optional property `key`. Returns `true` if
+// the property is defined, else `false`.
+bool validateType(const Properties &properties, const std::string &key,
+                  JsonType expected, const std::string &typeName) {
+  const auto it{properties.types.members.find(key)};
+  if (it == properties.types.members.end()) {
+    return false;
+  }
+  if (it->second.type != expected) {
+    throw ValidationError{"invalid property \"" + key +
+                          "\": expected type " + typeName};
+  }
+  return true;
+}
+
+// Returns the optional numeric property `key`
+boost::optional<double> getNumber(const Properties &properties,
+                                  const std::string &key) {
+  if (!validateType(properties, key, JsonType::kNumber, "number")) {
+    return boost::none;
+  }
+
+  auto value{properties.values.get_optional<double>(key)};
+  if (!value) {
+    throw ValidationError{"invalid property \"" + key +
+                          "\": expected type number"};
+  }
+  return value;
+}
+
+// Returns the optional integer property `key`
+boost::optional<int> getInteger(const Properties &properties,
+                                const std::string &key) {
+  if (!validateType(properties, key, JsonType::kNumber, "integer")) {
+    return boost::none;
+  }
+
+  auto value{properties.values.get_optional<int>(key)};
+  if (!value) {
+    throw ValidationError{"invalid property \"" + key +
+                          "\": expected type integer"};
+  }
+  return value;
+}
+
+void validateNumber(const Properties &properties, const std::string &key) {
+  getNumber(properties, key);
+}
+
+// Validates that the optional numeric property `key` is within the closed
+// interval `[min, max]`
+void validateRange(const Properties &properties, const std::string &key,
+                   double min, double max) {
+  const auto value{getNumber(properties, key)};
+  if (value && (*value < min || *value > max)) {
+    throw ValidationError{"invalid property \"" + key +
+                          "\": value out of range (value=" +
+                          std::to_string(*value) + ")"};
+  }
+}
+
+void validateGeZero(const Properties &properties, const std::string &key) {
+  validateRange(properties, key, 0, std::numeric_limits<double>::max());
+}
+
+// Validates that the optional integer property `key` is greater than or equal
+// to `min`
+void validateIntegerMinimum(const Properties &properties,
+                            const std::string &key, int min) {
+  const auto value{getInteger(properties, key)};
+  if (value && *value < min) {
+    throw ValidationError{"invalid property \"" + key +
+                          "\": value out of range (value=" +
+                          std::to_string(*value) + ")"};
+  }
+}
+
+void validateBoolean(const Properties &properties, const std::string &key) {
+  validateType(properties, key, JsonType::kBoolean, "boolean");
+}
+
+void validateString(const Properties &properties, const std::string &key) {
+  validateType(properties, key, JsonType::kString, "string");
+}
+
+void validateRequiredString(const Properties &properties,
+                            const std::string &key) {
+  validateString(properties, key);
+  auto value{properties.values.get_optional<std::string>(key)};
+  if (!value || value->empty()) {
+    throw ValidationError{"missing required property \"" + key + "\""};
+  }
+}
+
+// Validates that the optional property `key` is an array of strings
+void validateStringArray(const Properties &properties,
+                         const std::string &key) {
+  if (!validateType(properties, key, JsonType::kArray, "array of strings")) {
+    return;
+  }
+
+  for (const auto &item : properties.types.members.find(key)->second.items) {
+    if (item.type != JsonType::kString) {
+      throw ValidationError{"invalid property \"" + key +
+                            "\": expected type array of strings"};
+    }
+  }
+}
+
+void validateTargetSamplingFrequency(const Properties &properties) {
+  const auto value{getNumber(properties, "targetSamplingFrequency")};
+  if (value && !validateSamplingFrequency(*value)) {
+    throw ValidationError{
+        "invalid property \"targetSamplingFrequency\": value out of range "
+        "(value=" +
+        std::to_string(*value) + ")"};
+  }
+}
+
+// Validates the properties which are shared by both detector and stream
+// configurations
+void validateCommon(const Properties &properties) {
+  validateString(properties, "filter");
+  validateGeZero(properties, "initTime");
+  validateRange(properties, "mergingThreshold", -1, 1);
+  validateTargetSamplingFrequency(properties);
+  validateString(properties, "templatePhase");
+  validateNumber(properties, "templateWaveformStart");
+  validateNumber(properties, "templateWaveformEnd");
+}
+
+}  // namespace
+
+TemplateConfigReader::SyntaxError::SyntaxError()
+    : ParserException{"malformed JSON template configuration"} {}
+
+TemplateConfigReader::TemplateConfigReader(std::istream &is) : _is{is} {}
+
+bool TemplateConfigReader::next(boost::property_tree::ptree &pt) {
+  if (!readRaw()) {
+    return false;
+  }
+
+  pt.clear();
+  std::istringstream iss{_buffer};
+  try {
+    boost::property_tree::read_json(iss, pt);
+  } catch (boost::property_tree::json_parser::json_parser_error &e) {
+    _state = State::kFinished;
+    throw SyntaxError{errorMessage(e.message())};
+  }
+
+  try {
+    validate(pt);
+  } catch (ValidationError &e) {
+    throw ValidationError{"invalid detector configuration (index=" +
+                          std::to_string(index()) + "): " + e.what()};
+  }
+
+  return true;
+}
+
+std::size_t TemplateConfigReader::index() const {
+  return _count > 0 ? _count - 1 : 0;
+}
+
+std::size_t TemplateConfigReader::count() const { return _count; }
+
+bool TemplateConfigReader::readRaw() {
+  _buffer.clear();
+  if (_state == State::kFinished) {
+    return false;
+  }
+
+  auto *sb{_is.rdbuf()};
+  assert(sb);
+  if (_state == State::kInitial) {
+    if (peekNonWhitespace() != '[') {
+      _state = State::kFinished;
+      throw SyntaxError{errorMessage("expected '['")};
+    }
+    sb->sbumpc();
+    _state = State::kEntries;
+
+    if (peekNonWhitespace() == ']') {
+      sb->sbumpc();
+      _state = State::kFinished;
+      if (peekNonWhitespace() != std::char_traits<char>::eof()) {
+        throw SyntaxError{errorMessage("unexpected trailing characters")};
+      }
+      return false;
+    }
+  }
+
+  if (peekNonWhitespace() != '{') {
+    _state = State::kFinished;
+    throw SyntaxError{
+        errorMessage("expected detector configuration object")};
+  }
+
+  std::size_t depth{0};
+  do {
+    const auto c{sb->sbumpc()};
+    if (c == std::char_traits<char>::eof()) {
+      _state = State::kFinished;
+      throw SyntaxError{errorMessage("unexpected end of input")};
+    }
+
+    _buffer.push_back(static_cast<char>(c));
+    switch (c) {
+      case '"':
+        readString();
+        break;
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        --depth;
+        break;
+      case '\n':
+        ++_line;
+        break;
+      default:
+        break;
+    }
+  } while (depth > 0);
+
+  ++_count;
+
+  // consume the separator
+  const auto c{peekNonWhitespace()};
+  if (c == ',') {
+    sb->sbumpc();
+  } else if (c == ']') {
+    sb->sbumpc();
+    _state = State::kFinished;
+    if (peekNonWhitespace() != std::char_traits<char>::eof()) {
+      throw SyntaxError{errorMessage("unexpected trailing characters")};
+    }
+  } else {
+    _state = State::kFinished;
+    throw SyntaxError{errorMessage("expected ',' or ']'")};
+  }
+
+  return true;
+}
+
+void TemplateConfigReader::readString() {
+  auto *sb{_is.rdbuf()};
+  bool escaped{false};
+  while (true) {
+    const auto c{sb->sbumpc()};
+    if (c == std::char_traits<char>::eof()) {
+      _state = State::kFinished;
+      throw SyntaxError{errorMessage("unterminated string")};
+    }
+
+    _buffer.push_back(static_cast<char>(c));
+    if (escaped) {
+      escaped = false;
+    } else if (c == '\\') {
+      escaped = true;
+    } else if (c == '"') {
+      return;
+    } else if (c == '\n') {
+      ++_line;
+    }
+  }
+}
+
+int TemplateConfigReader::peekNonWhitespace() {
+  auto *sb{_is.rdbuf()};
+  auto c{sb->sgetc()};
+  while (c != std::char_traits<char>::eof() && std::isspace(c)) {
+    if (c == '\n') {
+      ++_line;
+    }
+    c = sb->snextc();
+  }
+  return c;
+}
+
+void TemplateConfigReader::validate(
+    const boost::property_tree::ptree &pt) const {
+  std::size_t pos{0};
+  const auto types{scanJsonTypes(_buffer, pos)};
+  const Properties properties{pt, types};
+
+  validateRequiredString(properties, "originId");
+
+  validateString(properties, "detectorId");
+  validateString(properties, "methodId");
+
+  validateRange(properties, "triggerOnThreshold", -1, 1);
+  validateRange(properties, "triggerOffThreshold", -1, 1);
+  validateNumber(properties, "triggerDuration");
+  validateNumber(properties, "timeCorrection");
+  validateNumber(properties, "arrivalOffsetThreshold");
+  validateGeZero(properties, "gapThreshold");
+  validateGeZero(properties, "gapTolerance");
+  validateBoolean(properties, "gapInterpolation");
+  validateGeZero(properties, "maximumLatency");
+  validateIntegerMinimum(properties, "minimumArrivals", 1);
+  validateBoolean(properties, "createArrivals");
+  validateBoolean(properties, "createTemplateArrivals");
+  validateBoolean(properties, "createAmplitudes");
+  validateBoolean(properties, "createMagnitudes");
+  validateIntegerMinimum(properties, "coarseSearchDecimation", 1);
+  validateRange(properties, "coarseSearchThreshold", -1, 1);
+  validateNumber(properties, "prescreenMargin");
+  validateIntegerMinimum(properties, "subspaceDimension", 1);
+  validateStringArray(properties, "subspaceOriginIds");
+  validateBoolean(properties, "fuseComponents");
+  validateBoolean(properties, "stacking");
+  validateIntegerMinimum(properties, "correlationBlockSize", 0);
+  validateCommon(properties);
+
+  validateString(properties, "mergingStrategy");
+  auto mergingStrategy{pt.get_optional<std::string>("mergingStrategy")};
+  if (mergingStrategy && !validateLinkerMergingStrategy(*mergingStrategy)) {
+    throw ValidationError{"invalid property \"mergingStrategy\": " +
+                          *mergingStrategy};
+  }
+
+  if (!validateType(properties, "streams", JsonType::kArray, "array")) {
+    throw ValidationError{"missing required property \"streams\""};
+  }
+  const auto &streamTypes{types.members.find("streams")->second.items};
+  if (streamTypes.empty()) {
+    throw ValidationError{
+        "invalid property \"streams\": at least a single stream configuration "
+        "required"};
+  }
+
+  const auto &streams{pt.get_child("streams")};
+  assert(streams.size() == streamTypes.size());
+  auto typesIt{streamTypes.begin()};
+  for (const auto &streamPair : streams) {
+    const auto &itemTypes{*typesIt++};
+    if (itemTypes.type != JsonType::kObject) {
+      throw ValidationError{
+          "invalid property \"streams\": expected type array of objects"};
+    }
+
+    const Properties streamProperties{streamPair.second, itemTypes};
+    validateRequiredString(streamProperties, "waveformId");
+    validateString(streamProperties, "templateFilter");
+    validateString(streamProperties, "templateId");
+    validateString(streamProperties, "templateWaveformId");
+    validateCommon(streamProperties);
+  }
+}
+
+std::string TemplateConfigReader::errorMessage(const std::string &what) const {
+  return "line " + std::to_string(_line) + ": " + what;
+}
+
+}  // namespace config
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,81 @@
+#ifndef SCDETECT_APPS_CC_CONFIG_TEMPLATECONFIGREADER_H_
+#define SCDETECT_APPS_CC_CONFIG_TEMPLATECONFIGREADER_H_
+
+#include <boost/property_tree/ptree.hpp>
+#include <cstddef>
+#include <istream>
+#include <string>
+
+#include "exception.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace config {
+
+// Incrementally reads a JSON template configuration (i.e. a top-level JSON
+// array of detector configuration objects) from an input stream
+//
+// - in contrast to parsing the entire document at once, only a single detector
+// configuration entry is kept in memory at a time
+// - parsing is linear with regards to the size of the input stream
+class TemplateConfigReader {
+ public:
+  // Indicates a malformed JSON template configuration document
+  class SyntaxError : public ParserException {
+   public:
+    using ParserException::ParserException;
+    SyntaxError();
+  };
+
+  explicit TemplateConfigReader(std::istream &is);
+
+  // Reads the next detector configuration entry into `pt`. Returns `true` if
+  // an entry was read, else `false` if the end of the top-level array was
+  // reached.
+  //
+  // - throws `SyntaxError` if the document is malformed. The reader must not
+  // be used anymore, afterwards.
+  // - throws `ValidationError` if the entry does not fulfill the semantics
+  // defined by `json-schema/templates.schema.json`. Reading may continue with
+  // the next entry. Note that in contrast to the schema an empty top-level
+  // array is accepted (i.e. no detectors are configured).
+  bool next(boost::property_tree::ptree &pt);
+
+  // Returns the zero-based index of the entry most recently read
+  std::size_t index() const;
+  // Returns the number of entries read so far (including invalid ones)
+  std::size_t count() const;
+
+ private:
+  enum class State { kInitial, kEntries, kFinished };
+
+  // Reads the raw JSON object text of the next entry into `_buffer`. Returns
+  // `false` if the end of the top-level array was reached.
+  bool readRaw();
+  // Reads a JSON string (including the delimiting quotes) into `_buffer`
+  void readString();
+  // Skips whitespace and returns the next (not consumed) character
+  int peekNonWhitespace();
+
+  // Validates `pt` with regards to the JSON template configuration schema
+  void validate(const boost::property_tree::ptree &pt) const;
+
+  std::string errorMessage(const std::string &what) const;
+
+  std::istream &_is;
+
+  State _state{State::kInitial};
+
+  // Buffer for the raw text of the current entry
+  std::string _buffer;
+
+  std::size_t _count{0};
+  // The current line number (used for error reporting)
+  std::size_t _line{1};
+};
+
+}  // namespace config
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_CONFIG_TEMPLATECONFIGREADER_H_
@@ -0,0 +1,270 @@
+#include "correlation_tuner.h"
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "filter/crosscorrelation.h"
+#include "filter/fft.h"
+#include "log.h"
+#include "util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+
+namespace {
+
+const std::string kMagic{"scdetect-cc-correlation-tuning"};
+const int kVersion{1};
+
+// The smallest block size of the partitioned cross-correlation benchmarked
+constexpr std::size_t kMinBlockSize{16};
+// The minimum number of samples correlated per benchmark run
+constexpr std::size_t kMinSamples{8192};
+// The number of samples correlated at once (i.e. a typical record length)
+constexpr std::size_t kChunkSize{512};
+// The number of benchmark runs per kernel (the fastest run is used)
+constexpr int kRuns{3};
+// The minimum relative gain of the partitioned cross-correlation w.r.t. the
+// direct cross-correlation (since it adds latency)
+constexpr double kMinGain{0.1};
+
+struct Run {
+  // The costs in nanoseconds per sample
+  double costPerSample{std::numeric_limits<double>::infinity()};
+  std::vector<double> coefficients;
+};
+
+// Correlates `data` against `templateWaveform` by means of the kernel
+// identified by `blockSize`
+Run run(const GenericRecordCPtr &templateWaveform, std::size_t blockSize,
+        const std::vector<double> &data) {
+  filter::CrossCorrelation<double> xcorr{templateWaveform};
+  xcorr.setPartitionedConvolution(blockSize);
+
+  Run ret;
+  for (int i{0}; i < kRuns; ++i) {
+    xcorr.reset();
+    auto coefficients{data};
+    const auto start{std::chrono::steady_clock::now()};
+    for (std::size_t offset{0}; offset < coefficients.size();
+         offset += kChunkSize) {
+      xcorr.apply(std::min(kChunkSize, coefficients.size() - offset),
+                  coefficients.data() + offset);
+    }
+    const std::chrono::duration<double, std::nano> elapsed{
+        std::chrono::steady_clock::now() - start};
+
+    const auto costPerSample{elapsed.count() / coefficients.size()};
+    if (costPerSample < ret.costPerSample) {
+      ret.costPerSample = costPerSample;
+      ret.coefficients = std::move(coefficients);
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+CorrelationTuner::BaseException::BaseException()
+    : Exception{"base correlation tuner exception"} {}
+
+void CorrelationTuner::setMaxLatency(double maxLatency) {
+  _maxLatency = maxLatency;
+}
+
+double CorrelationTuner::maxLatency() const { return _maxLatency; }
+
+void CorrelationTuner::setTolerance(double tolerance) {
+  _tolerance = tolerance;
+}
+
+double CorrelationTuner::tolerance() const { return _tolerance; }
+
+const CorrelationTuner::Decision &CorrelationTuner::tune(
+    std::size_t size, double samplingFrequency) {
+  const Key key{size, samplingFrequency};
+  auto it{_decisions.find(key)};
+  if (it != _decisions.end() &&
+      static_cast<double>(it->second.blockSize) <=
+          _maxLatency * samplingFrequency) {
+    return it->second;
+  }
+
+  ++_benchmarked;
+  return _decisions[key] = benchmark(size, samplingFrequency);
+}
+
+boost::optional<CorrelationTuner::Decision> CorrelationTuner::lookup(
+    std::size_t size, double samplingFrequency) const {
+  auto it{_decisions.find(Key{size, samplingFrequency})};
+  if (it == _decisions.end() || static_cast<double>(it->second.blockSize) >
+                                    _maxLatency * samplingFrequency) {
+    return boost::none;
+  }
+  return it->second;
+}
+
+std::vector<std::size_t> CorrelationTuner::blockSizes(
+    std::size_t size, double samplingFrequency) const {
+  // larger blocks than the template waveform do not reduce the costs
+  std::vector<std::size_t> ret{0};
+  for (auto blockSize{kMinBlockSize};
+       static_cast<double>(blockSize) <= _maxLatency * samplingFrequency &&
+       blockSize <= filter::fft::nextPowerOfTwo(size);
+       blockSize <<= 1) {
+    ret.push_back(blockSize);
+  }
+  return ret;
+}
+
+std::size_t CorrelationTuner::size() const { return _decisions.size(); }
+
+std::size_t CorrelationTuner::benchmarked() const { return _benchmarked; }
+
+void CorrelationTuner::write(std::ostream &os) const {
+  os << kMagic << " " << kVersion << "\n";
+  os << "host " << hostname() << "\n";
+  os.precision(std::numeric_limits<double>::max_digits10);
+  for (const auto &decisionPair : _decisions) {
+    const auto &key{decisionPair.first};
+    const auto &decision{decisionPair.second};
+    os << key.first << " " << key.second << " " << decision.blockSize << " "
+       << decision.costPerSample << "\n";
+  }
+}
+
+void CorrelationTuner::read(std::istream &is) {
+  std::string magic;
+  int version{0};
+  if (!(is >> magic >> version) || magic != kMagic) {
+    throw BaseException{"invalid correlation tuning: magic mismatch"};
+  }
+  if (version != kVersion) {
+    throw BaseException{"incompatible correlation tuning version: " +
+                        std::to_string(version)};
+  }
+
+  std::string tag;
+  std::string host;
+  if (!(is >> tag >> host) || tag != "host") {
+    throw BaseException{"invalid correlation tuning: missing host"};
+  }
+  if (host != hostname()) {
+    throw BaseException{"correlation tuning refers to a different host: " +
+                        host};
+  }
+
+  std::map<Key, Decision> decisions;
+  std::size_t size;
+  double samplingFrequency;
+  Decision decision;
+  while (is >> size >> samplingFrequency >> decision.blockSize >>
+         decision.costPerSample) {
+    decisions[Key{size, samplingFrequency}] = decision;
+  }
+  if (!is.eof()) {
+    throw BaseException{"invalid correlation tuning: malformed decision"};
+  }
+
+  _decisions = std::move(decisions);
+  _benchmarked = 0;
+}
+
+void CorrelationTuner::save(const std::string &path) const {
+  const auto tmpPath{path + ".tmp"};
+  {
+    std::ofstream ofs{tmpPath, std::ios::trunc};
+    if (!ofs) {
+      throw BaseException{"failed to open file: " + tmpPath};
+    }
+    write(ofs);
+  }
+
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    throw BaseException{"failed to rename file: " + tmpPath + " -> " + path};
+  }
+}
+
+void CorrelationTuner::load(const std::string &path) {
+  std::ifstream ifs{path};
+  if (!ifs) {
+    throw BaseException{"failed to open file: " + path};
+  }
+  read(ifs);
+}
+
+std::string CorrelationTuner::hostname() {
+  char buf[256]{};
+  if (gethostname(buf, sizeof(buf) - 1) != 0 || buf[0] == '\0') {
+    return "localhost";
+  }
+  return buf;
+}
+
+CorrelationTuner::Decision CorrelationTuner::benchmark(
+    std::size_t size, double samplingFrequency) const {
+  const auto candidates{blockSizes(size, samplingFrequency)};
+
+  // synthetic data, i.e. white noise (reproducible)
+  std::mt19937 generator{static_cast<std::mt19937::result_type>(size)};
+  std::normal_distribution<double> distribution;
+  std::vector<double> templateSamples(size);
+  for (auto &sample : templateSamples) {
+    sample = distribution(generator);
+  }
+  const auto maxBlockSize{candidates.back()};
+  std::vector<double> data(std::max({kMinSamples, 4 * size, 8 * maxBlockSize}));
+  for (auto &sample : data) {
+    sample = distribution(generator);
+  }
+
+  auto templateWaveform{util::make_smart<GenericRecord>(
+      "", "", "", "", Core::Time::GMT(), samplingFrequency)};
+  templateWaveform->setData(static_cast<int>(templateSamples.size()),
+                            templateSamples.data(), Array::DOUBLE);
+
+  const auto reference{run(templateWaveform, 0, data)};
+  Decision ret{0, reference.costPerSample};
+  for (std::size_t i{1}; i < candidates.size(); ++i) {
+    const auto blockSize{candidates[i]};
+    const auto candidate{run(templateWaveform, blockSize, data)};
+
+    // the coefficients are delayed by the block size
+    double deviation{0};
+    for (auto j{size + blockSize}; j < data.size(); ++j) {
+      deviation = std::max(
+          deviation, std::abs(candidate.coefficients[j] -
+                              reference.coefficients[j - blockSize]));
+    }
+    SCDETECT_LOG_DEBUG(
+        "Benchmarked cross-correlation kernel (samples=%zu, "
+        "sampling_frequency=%f, block_size=%zu): %.1f ns/sample "
+        "(direct: %.1f ns/sample), deviation=%g",
+        size, samplingFrequency, blockSize, candidate.costPerSample,
+        reference.costPerSample, deviation);
+    if (deviation > _tolerance) {
+      continue;
+    }
+
+    if (candidate.costPerSample <=
+            (1 - kMinGain) * reference.costPerSample &&
+        candidate.costPerSample < ret.costPerSample) {
+      ret = Decision{blockSize, candidate.costPerSample};
+    }
+  }
+  return ret;
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
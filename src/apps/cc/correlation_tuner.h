@@ -0,0 +1,114 @@
+#ifndef SCDETECT_APPS_CC_CORRELATION_TUNER_H_
+#define SCDETECT_APPS_CC_CORRELATION_TUNER_H_
+
+#include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exception.h"
+
+namespace Seiscomp {
+namespace detect {
+
+// Selects the fastest exact cross-correlation kernel for template waveforms of
+// a given length and sampling frequency by means of micro-benchmarks on
+// synthetic data
+//
+// - the kernels benchmarked are the direct (i.e. time-domain)
+// cross-correlation and the uniformly partitioned cross-correlation with all
+// block sizes of powers of two (see `blockSizes()`). The costs are not
+// monotonic in the block size: small blocks add FFT overhead per sample while
+// large blocks add overhead per partition, i.e. the block sizes are swept
+// rather than extrapolated from a single block size.
+// - kernels whose coefficients deviate from the direct cross-correlation's
+// coefficients by more than the tolerance are rejected
+// - decisions are host specific (i.e. they depend on the CPU). They may be
+// persisted to and restored from a local file such that subsequent starts skip
+// benchmarking.
+class CorrelationTuner {
+ public:
+  class BaseException : public Exception {
+   public:
+    using Exception::Exception;
+    BaseException();
+  };
+
+  struct Decision {
+    // The block size of the partitioned cross-correlation (`0` refers to the
+    // direct cross-correlation)
+    std::size_t blockSize;
+    // The benchmarked costs in nanoseconds per sample
+    double costPerSample;
+  };
+
+  // Sets the maximum latency (in seconds) of the partitioned cross-correlation
+  void setMaxLatency(double maxLatency);
+  double maxLatency() const;
+  // Sets the maximum absolute deviation of a kernel's coefficients from the
+  // direct cross-correlation's coefficients
+  void setTolerance(double tolerance);
+  double tolerance() const;
+
+  // Returns the decision for template waveforms of `size` samples with the
+  // sampling frequency `samplingFrequency`
+  //
+  // - benchmarks the kernels if not decided, yet (or if the decision exceeds
+  // the maximum latency)
+  const Decision &tune(std::size_t size, double samplingFrequency);
+  // Returns the decision for template waveforms of `size` samples with the
+  // sampling frequency `samplingFrequency` without benchmarking, i.e.
+  // returns `boost::none` if not decided, yet (or if the decision exceeds the
+  // maximum latency)
+  boost::optional<Decision> lookup(std::size_t size,
+                                   double samplingFrequency) const;
+  // Returns the block sizes benchmarked for template waveforms of `size`
+  // samples with the sampling frequency `samplingFrequency` (`0` refers to the
+  // direct cross-correlation), i.e. the powers of two starting from 16 bounded
+  // by both the maximum latency and the template waveform length
+  std::vector<std::size_t> blockSizes(std::size_t size,
+                                      double samplingFrequency) const;
+
+  // Returns the number of decisions
+  std::size_t size() const;
+  // Returns the number of decisions benchmarked (i.e. neither read nor
+  // loaded)
+  std::size_t benchmarked() const;
+
+  // Writes the decisions to `os`
+  void write(std::ostream &os) const;
+  // Reads the decisions from `is` (replacing the current decisions)
+  //
+  // - throws `BaseException` if the input is malformed, has been written with
+  // an incompatible version or on a different host
+  void read(std::istream &is);
+
+  // Saves the decisions to `path`. The file is replaced atomically.
+  void save(const std::string &path) const;
+  // Loads the decisions from `path`
+  void load(const std::string &path);
+
+  // Returns the name of the host decisions refer to
+  static std::string hostname();
+
+ private:
+  // Benchmarks the kernels for template waveforms of `size` samples with the
+  // sampling frequency `samplingFrequency`
+  Decision benchmark(std::size_t size, double samplingFrequency) const;
+
+  using Key = std::pair<std::size_t, double>;
+  std::map<Key, Decision> _decisions;
+  std::size_t _benchmarked{0};
+
+  double _maxLatency{3};
+  double _tolerance{1e-6};
+};
+
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_CORRELATION_TUNER_H_
@@ -0,0 +1,88 @@
+#include "correlation_group.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../filter.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace detector {
+
+CorrelationGroup::CorrelationGroup(TemplateWaveform representative)
+    : _crossCorrelation{std::move(representative)} {}
+
+const double *CorrelationGroup::screen(
+    const filter::CrossCorrelation<double> &member, const Core::Time &startTime,
+    const double *data, std::size_t n) {
+  if (_valid && startTime == _startTime && n == _data.size() &&
+      std::equal(data, data + n, _data.begin()) &&
+      (inSync(member, _chunk - 1) || matches(member, _previous))) {
+    apply(member);
+    ++_sharedCount;
+    return _coefficients.data();
+  }
+
+  _valid = false;
+  if (member.samplingFrequency() != _samplingFrequency) {
+    _samplingFrequency = member.samplingFrequency();
+    _crossCorrelation.setSamplingFrequency(_samplingFrequency);
+    _applied.clear();
+  }
+
+  _previous = _crossCorrelation.state();
+  // e.g. after a gap or if the member was (re-)initialized independently, the
+  // representative adopts the member's state
+  if (!inSync(member, _chunk) && !matches(member, _previous)) {
+    _applied.clear();
+    _previous = member.state();
+    try {
+      _crossCorrelation.restore(_previous);
+    } catch (filter::BaseException &) {
+      return nullptr;
+    }
+  }
+
+  _startTime = startTime;
+  _data.assign(data, data + n);
+  _coefficients.assign(data, data + n);
+  _crossCorrelation.apply(n, _coefficients.data());
+  _valid = true;
+  ++_chunk;
+  apply(member);
+
+  ++_correlatedCount;
+  return _coefficients.data();
+}
+
+const TemplateWaveform &CorrelationGroup::representative() const {
+  return _crossCorrelation.templateWaveform();
+}
+
+std::size_t CorrelationGroup::correlatedCount() const {
+  return _correlatedCount;
+}
+
+std::size_t CorrelationGroup::sharedCount() const { return _sharedCount; }
+
+std::size_t CorrelationGroup::comparedCount() const { return _comparedCount; }
+
+bool CorrelationGroup::inSync(const Member &member, std::size_t chunk) const {
+  auto it{_applied.find(&member)};
+  return it != _applied.end() && it->second.chunk == chunk &&
+         it->second.revision == member.revision();
+}
+
+bool CorrelationGroup::matches(const Member &member,
+                               const Member::State &state) {
+  ++_comparedCount;
+  return member.matches(state);
+}
+
+void CorrelationGroup::apply(const Member &member) {
+  _applied[&member] = Applied{_chunk, member.revision() + 1};
+}
+
+}  // namespace detector
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,109 @@
+#ifndef SCDETECT_APPS_CC_DETECTOR_CORRELATIONGROUP_H_
+#define SCDETECT_APPS_CC_DETECTOR_CORRELATIONGROUP_H_
+
+#include <seiscomp/core/datetime.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../filter/crosscorrelation.h"
+#include "../template_waveform.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace detector {
+
+// Shares the cross-correlation of a representative template waveform between
+// the members of a group of similar template waveforms processing the same
+// data
+//
+// - the representative's coefficients are computed once per data chunk and
+// used by the members in order to screen their own coefficients (see
+// `filter::CrossCorrelation::apply()`)
+// - the coefficients are shared if and only if the member's buffered data
+// equals the buffered data the representative's coefficients were computed
+// with; else the representative adopts the member's state
+// - the buffered data is compared once per member, only; afterwards, members
+// are known to be in sync as long as their state was modified by applying the
+// chunks screened, exclusively (see `filter::CrossCorrelation::revision()`)
+class CorrelationGroup {
+ public:
+  // Creates a `CorrelationGroup` with the representative template waveform
+  // `representative`
+  explicit CorrelationGroup(TemplateWaveform representative);
+
+  // Returns the representative's coefficients w.r.t. the `n` (filtered)
+  // `data` samples starting at `startTime`, where `member` is the member's
+  // cross-correlation filter (before applying `data`)
+  //
+  // - returns `nullptr` if the coefficients cannot be shared with `member`
+  // - `member` is expected to apply the `n` samples of `data`, subsequently
+  // - the pointer returned is valid until the next call
+  const double *screen(const filter::CrossCorrelation<double> &member,
+                       const Core::Time &startTime, const double *data,
+                       std::size_t n);
+
+  // Returns the representative template waveform
+  const TemplateWaveform &representative() const;
+
+  // Returns the number of chunks correlated
+  std::size_t correlatedCount() const;
+  // Returns the number of chunks shared (i.e. the coefficients were reused)
+  std::size_t sharedCount() const;
+  // Returns the number of times the buffered data was compared
+  std::size_t comparedCount() const;
+
+ private:
+  using Member = filter::CrossCorrelation<double>;
+
+  // Describes the chunk most recently applied by a member
+  struct Applied {
+    // The chunk's sequence number
+    std::size_t chunk;
+    // The member's revision after applying the chunk
+    std::uint64_t revision;
+  };
+
+  // Returns `true` if `member`'s buffered data equals the representative's
+  // buffered data before applying the chunk with sequence number `chunk`,
+  // else `false`
+  bool inSync(const Member &member, std::size_t chunk) const;
+  // Returns `true` if `member`'s buffered data equals `state`'s buffered data,
+  // else `false`
+  bool matches(const Member &member, const Member::State &state);
+  // Registers `member` to apply the most recent chunk
+  void apply(const Member &member);
+
+  // The representative's cross-correlation filter
+  filter::CrossCorrelation<double> _crossCorrelation;
+  // The sampling frequency the representative's filter is set up with
+  double _samplingFrequency{0};
+
+  // The state of the representative's filter before correlating the most
+  // recent chunk
+  filter::CrossCorrelation<double>::State _previous;
+  // The most recent chunk
+  Core::Time _startTime;
+  std::vector<double> _data;
+  // The representative's coefficients w.r.t. the most recent chunk
+  std::vector<double> _coefficients;
+  bool _valid{false};
+  // The sequence number of the most recent chunk
+  std::size_t _chunk{0};
+
+  // The chunks most recently applied by the members
+  std::unordered_map<const Member *, Applied> _applied;
+
+  std::size_t _correlatedCount{0};
+  std::size_t _sharedCount{0};
+  std::size_t _comparedCount{0};
+};
+
+}  // namespace detector
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_DETECTOR_CORRELATIONGROUP_H_
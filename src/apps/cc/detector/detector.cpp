@@ -2,11 +2,19 @@
 
 #include <seiscomp/client/inventory.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <utility>
+
 #include "../eventstore.h"
 #include "../log.h"
 #include "../settings.h"
 #include "../util/memory.h"
 #include "../util/waveform_stream_id.h"
+#include "fused_template_waveform_processor.h"
 #include "linker/association.h"
 
 namespace Seiscomp {
@@ -38,6 +46,15 @@ Detector::Builder &Detector::Builder::setConfig(
     const config::DetectorConfig &detectorConfig, bool playback) {
   product()->_publishConfig = publishConfig;
 
+  // the stacker consumes the entire coefficient trace, i.e. approximate
+  // coefficients must not be stacked
+  if (detectorConfig.stacking && (detectorConfig.coarseSearchDecimation > 1 ||
+                                  detectorConfig.prescreenMargin >= 0)) {
+    throw builder::BaseException{
+        "invalid configuration: stacking requires exact coefficients (neither "
+        "the coarse-to-fine search nor the pre-screening may be enabled)"};
+  }
+
   product()->_config = detectorConfig;
 
   product()->_enabled = detectorConfig.enabled;
@@ -70,54 +87,10 @@ Detector::Builder &Detector::Builder::setStream(
   logging::TaggedMessage msg{streamId + " (" + templateStreamId + ")"};
   // configure pick from arrival
   DataModel::PickPtr pick;
-  DataModel::WaveformStreamID pickWaveformId;
   DataModel::ArrivalPtr arrival;
-  for (size_t i = 0; i < product()->_origin->arrivalCount(); ++i) {
-    arrival = product()->_origin->arrival(i);
-
-    if (arrival->phase().code() != streamConfig.templateConfig.phase) {
-      continue;
-    }
-
-    pick = EventStore::Instance().get<DataModel::Pick>(arrival->pickID());
-    if (!pick) {
-      SCDETECT_LOG_DEBUG("Failed to load pick with id: %s",
-                         arrival->pickID().c_str());
-      continue;
-    }
-    if (!isValidArrival(*arrival, *pick)) {
-      continue;
-    }
-
-    // compare sensor locations
-    try {
-      pick->time().value();
-    } catch (...) {
-      continue;
-    }
-    auto templateWfSensorLocation{
-        Client::Inventory::Instance()->getSensorLocation(
-            templateWfStreamId.netCode(), templateWfStreamId.staCode(),
-            templateWfStreamId.locCode(), pick->time().value())};
-    if (!templateWfSensorLocation) {
-      msg.setText("sensor location not found in inventory for time: " +
-                  pick->time().value().iso());
-      throw builder::NoSensorLocation{logging::to_string(msg)};
-    }
-    pickWaveformId = pick->waveformID();
-    auto pickWfSensorLocation{Client::Inventory::Instance()->getSensorLocation(
-        pickWaveformId.networkCode(), pickWaveformId.stationCode(),
-        pickWaveformId.locationCode(), pick->time().value())};
-    if (!pickWfSensorLocation ||
-        *templateWfSensorLocation != *pickWfSensorLocation) {
-      continue;
-    }
-
-    break;
-  }
-
+  std::tie(pick, arrival) =
+      findPick(*product()->_origin, streamId, streamConfig);
   if (!pick) {
-    arrival.reset();
     msg.setText("failed to load pick: origin=" + _originId +
                 ", phase=" + streamConfig.templateConfig.phase);
     throw builder::NoPick{logging::to_string(msg)};
@@ -126,7 +99,7 @@ Detector::Builder &Detector::Builder::setStream(
   msg.setText("using arrival pick: origin=" + _originId +
               ", time=" + pick->time().value().iso() +
               ", phase=" + streamConfig.templateConfig.phase + ", stream=" +
-              util::to_string(util::WaveformStreamID{pickWaveformId}));
+              util::to_string(util::WaveformStreamID{pick->waveformID()}));
   SCDETECT_LOG_DEBUG("%s", logging::to_string(msg).c_str());
 
   auto templateWaveformStartTime{
@@ -221,6 +194,37 @@ Detector::Builder &Detector::Builder::setStream(
         *streamConfig.targetSamplingFrequency);
   }
 
+  // subspace detector mode: the template waveform is the reference the
+  // members' template waveforms are aligned with
+  if (!product()->_config.subspaceOriginIds.empty()) {
+    auto members{loadSubspaceMembers(streamId, streamConfig, waveformHandler)};
+    msg.setText("configuring subspace detector: dimension=" +
+                std::to_string(product()->_config.subspaceDimension) +
+                ", members=" + std::to_string(members.size()));
+    SCDETECT_LOG_DEBUG_PROCESSOR(templateWaveformProcessor, "%s",
+                                 logging::to_string(msg).c_str());
+    templateWaveformProcessor->setSubspace(
+        std::move(members),
+        static_cast<std::size_t>(product()->_config.subspaceDimension));
+  } else if (product()->_config.correlationBlockSize > 0) {
+    // the coefficients of the partitioned cross-correlation are delayed, i.e.
+    // cross-correlations are not shared
+    templateWaveformProcessor->setPartitionedConvolution(
+        static_cast<std::size_t>(product()->_config.correlationBlockSize));
+  } else {
+    // processors with an identical processing configuration process
+    // identical data (e.g. allowing to share cross-correlations)
+    const auto &cfg{product()->_config};
+    templateWaveformProcessor->setProcessingId(
+        streamId + settings::kProcessorIdSep + rtFilterId +
+        settings::kProcessorIdSep + std::to_string(streamConfig.initTime) +
+        settings::kProcessorIdSep +
+        std::to_string(streamConfig.targetSamplingFrequency.value_or(0)) +
+        settings::kProcessorIdSep + std::to_string(cfg.gapInterpolation) +
+        settings::kProcessorIdSep + std::to_string(cfg.gapThreshold) +
+        settings::kProcessorIdSep + std::to_string(cfg.gapTolerance));
+  }
+
   std::string text{"filters configured: filter=\"" + rtFilterId + "\""};
   if (rtFilterId != templateWfFilterId) {
     text += " (template_filter=\"" + templateWfFilterId + "\")";
@@ -238,6 +242,261 @@ Detector::Builder &Detector::Builder::setStream(
   return *this;
 }
 
+std::pair<DataModel::PickPtr, DataModel::ArrivalPtr>
+Detector::Builder::findPick(const DataModel::Origin &origin,
+                            const std::string &streamId,
+                            const config::StreamConfig &streamConfig) {
+  const auto &templateStreamId{streamConfig.templateConfig.wfStreamId};
+  util::WaveformStreamID templateWfStreamId{templateStreamId};
+
+  logging::TaggedMessage msg{streamId + " (" + templateStreamId + ")"};
+  DataModel::PickPtr pick;
+  DataModel::WaveformStreamID pickWaveformId;
+  DataModel::ArrivalPtr arrival;
+  for (size_t i = 0; i < origin.arrivalCount(); ++i) {
+    arrival = origin.arrival(i);
+
+    if (arrival->phase().code() != streamConfig.templateConfig.phase) {
+      continue;
+    }
+
+    pick = EventStore::Instance().get<DataModel::Pick>(arrival->pickID());
+    if (!pick) {
+      SCDETECT_LOG_DEBUG("Failed to load pick with id: %s",
+                         arrival->pickID().c_str());
+      continue;
+    }
+    if (!isValidArrival(*arrival, *pick)) {
+      continue;
+    }
+
+    // compare sensor locations
+    try {
+      pick->time().value();
+    } catch (...) {
+      continue;
+    }
+    auto templateWfSensorLocation{
+        Client::Inventory::Instance()->getSensorLocation(
+            templateWfStreamId.netCode(), templateWfStreamId.staCode(),
+            templateWfStreamId.locCode(), pick->time().value())};
+    if (!templateWfSensorLocation) {
+      msg.setText("sensor location not found in inventory for time: " +
+                  pick->time().value().iso());
+      throw builder::NoSensorLocation{logging::to_string(msg)};
+    }
+    pickWaveformId = pick->waveformID();
+    auto pickWfSensorLocation{Client::Inventory::Instance()->getSensorLocation(
+        pickWaveformId.networkCode(), pickWaveformId.stationCode(),
+        pickWaveformId.locationCode(), pick->time().value())};
+    if (!pickWfSensorLocation ||
+        *templateWfSensorLocation != *pickWfSensorLocation) {
+      continue;
+    }
+
+    break;
+  }
+
+  if (!pick) {
+    arrival.reset();
+  }
+  return std::make_pair(pick, arrival);
+}
+
+std::vector<TemplateWaveform> Detector::Builder::loadSubspaceMembers(
+    const std::string &streamId, const config::StreamConfig &streamConfig,
+    WaveformHandlerIface *waveformHandler) {
+  const auto &templateStreamId{streamConfig.templateConfig.wfStreamId};
+  util::WaveformStreamID templateWfStreamId{templateStreamId};
+
+  logging::TaggedMessage msg{streamId + " (" + templateStreamId + ")"};
+  std::vector<TemplateWaveform> ret;
+  for (const auto &originId : product()->_config.subspaceOriginIds) {
+    if (originId == _originId) {
+      continue;
+    }
+
+    DataModel::OriginCPtr origin{
+        EventStore::Instance().getWithChildren<DataModel::Origin>(originId)};
+    if (!origin) {
+      msg.setText("skipping subspace member: origin not found: " + originId);
+      SCDETECT_LOG_WARNING("%s", logging::to_string(msg).c_str());
+      continue;
+    }
+
+    try {
+      const auto pick{findPick(*origin, streamId, streamConfig).first};
+      if (!pick) {
+        msg.setText("skipping subspace member: failed to load pick: origin=" +
+                    originId + ", phase=" + streamConfig.templateConfig.phase);
+        SCDETECT_LOG_WARNING("%s", logging::to_string(msg).c_str());
+        continue;
+      }
+
+      // the member's template waveform is processed the same way as the
+      // reference template waveform
+      TemplateWaveform::ProcessingConfig processingConfig;
+      processingConfig.templateStartTime =
+          pick->time().value() +
+          Core::TimeSpan{streamConfig.templateConfig.wfStart};
+      processingConfig.templateEndTime =
+          pick->time().value() +
+          Core::TimeSpan{streamConfig.templateConfig.wfEnd};
+      processingConfig.safetyMargin = settings::kTemplateWaveformResampleMargin;
+      processingConfig.detrend = false;
+      processingConfig.demean = true;
+
+      auto templateWfFilterId{
+          streamConfig.templateConfig.filter.value_or(pick->filterID())};
+      if (!templateWfFilterId.empty()) {
+        util::replaceEscapedXMLFilterIdChars(templateWfFilterId);
+        processingConfig.filter = templateWfFilterId;
+        processingConfig.initTime = Core::TimeSpan{streamConfig.initTime};
+      }
+
+      auto templateWaveform{TemplateWaveform::load(
+          waveformHandler, templateWfStreamId.netCode(),
+          templateWfStreamId.staCode(), templateWfStreamId.locCode(),
+          templateWfStreamId.chaCode(), processingConfig)};
+      templateWaveform.setReferenceTime(pick->time().value());
+      ret.push_back(std::move(templateWaveform));
+
+      msg.setText("loaded subspace member: origin=" + originId +
+                  ", time=" + pick->time().value().iso());
+      SCDETECT_LOG_DEBUG("%s", logging::to_string(msg).c_str());
+    } catch (WaveformHandler::NoData &e) {
+      msg.setText("skipping subspace member: origin=" + originId +
+                  ": failed to load template waveform: " +
+                  std::string{e.what()});
+      SCDETECT_LOG_WARNING("%s", logging::to_string(msg).c_str());
+    } catch (builder::BaseException &e) {
+      msg.setText("skipping subspace member: origin=" + originId + ": " +
+                  std::string{e.what()});
+      SCDETECT_LOG_WARNING("%s", logging::to_string(msg).c_str());
+    }
+  }
+  return ret;
+}
+
+void Detector::Builder::fuseComponents() {
+  // group the streams by sensor location
+  std::map<std::string, std::vector<std::string>> sensorLocations;
+  for (const auto &procConfigPair : _processorConfigs) {
+    sensorLocations[util::getSensorLocationStreamId(procConfigPair.first,
+                                                    true)]
+        .push_back(procConfigPair.first);
+  }
+
+  for (auto &sensorLocationPair : sensorLocations) {
+    auto &streamIds{sensorLocationPair.second};
+    if (streamIds.size() < 2) {
+      continue;
+    }
+
+    // the vertical component (if available) is the primary component
+    std::sort(std::begin(streamIds), std::end(streamIds));
+    auto primaryIt{std::find_if(std::begin(streamIds), std::end(streamIds),
+                                [](const std::string &streamId) {
+                                  return streamId.back() == 'Z';
+                                })};
+    if (primaryIt == std::end(streamIds)) {
+      primaryIt = std::begin(streamIds);
+    }
+    const auto primaryStreamId{*primaryIt};
+    auto &primary{_processorConfigs.at(primaryStreamId).processor};
+    const auto &primaryTemplateWaveform{primary->templateWaveform()};
+    const auto samplingFrequency{primaryTemplateWaveform.samplingFrequency()};
+
+    // the primary component is located at index 0
+    std::vector<FusedTemplateWaveformProcessor::Component> components;
+    std::unique_ptr<TemplateWaveformProcessor::Filter> primaryFilter;
+    if (primary->filter()) {
+      primaryFilter.reset(primary->filter()->clone());
+    }
+    components.push_back(FusedTemplateWaveformProcessor::Component{
+        primaryStreamId, primaryTemplateWaveform, std::move(primaryFilter)});
+    for (const auto &streamId : streamIds) {
+      if (streamId == primaryStreamId) {
+        continue;
+      }
+
+      auto &procConfig{_processorConfigs.at(streamId)};
+      const auto &templateWaveform{procConfig.processor->templateWaveform()};
+      // the template waveforms must be time-aligned
+      if (templateWaveform.samplingFrequency() != samplingFrequency ||
+          templateWaveform.size() != primaryTemplateWaveform.size() ||
+          std::fabs(static_cast<double>(templateWaveform.startTime() -
+                                        primaryTemplateWaveform.startTime())) *
+                  samplingFrequency >
+              0.5) {
+        SCDETECT_LOG_DEBUG_PROCESSOR(
+            procConfig.processor,
+            "%s: template waveform not aligned with the primary component "
+            "(%s); not fused",
+            streamId.c_str(), primaryStreamId.c_str());
+        continue;
+      }
+      // the data of all components is correlated w.r.t. the same sampling
+      // frequency
+      if (procConfig.processor->targetSamplingFrequency() !=
+          primary->targetSamplingFrequency()) {
+        SCDETECT_LOG_DEBUG_PROCESSOR(
+            procConfig.processor,
+            "%s: target sampling frequency differs from the primary "
+            "component's target sampling frequency (%s); not fused",
+            streamId.c_str(), primaryStreamId.c_str());
+        continue;
+      }
+
+      std::unique_ptr<TemplateWaveformProcessor::Filter> filter;
+      if (procConfig.processor->filter()) {
+        filter.reset(procConfig.processor->filter()->clone());
+      }
+      components.push_back(FusedTemplateWaveformProcessor::Component{
+          streamId, templateWaveform, std::move(filter)});
+      _fusedPickIds.push_back(procConfig.metadata.pick->publicID());
+      _processorConfigs.erase(streamId);
+    }
+
+    if (components.size() < 2) {
+      continue;
+    }
+
+    SCDETECT_LOG_DEBUG_PROCESSOR(primary, "%s: fusing %zu components",
+                                 primaryStreamId.c_str(), components.size());
+    auto fused{util::make_unique<FusedTemplateWaveformProcessor>(
+        std::move(components), primary->initTime())};
+    fused->setId(primary->id());
+    const auto targetSamplingFrequency{primary->targetSamplingFrequency()};
+    if (targetSamplingFrequency) {
+      fused->setTargetSamplingFrequency(*targetSamplingFrequency);
+    }
+    primary = std::move(fused);
+  }
+}
+
+std::size_t Detector::Builder::processorMinArrivals(
+    std::size_t minArrivals) const {
+  std::vector<std::size_t> streamCounts;
+  for (const auto &procConfigPair : _processorConfigs) {
+    streamCounts.push_back(
+        1 + procConfigPair.second.processor->componentStreamIds().size());
+  }
+  std::sort(std::begin(streamCounts), std::end(streamCounts),
+            std::greater<std::size_t>());
+
+  std::size_t ret{0};
+  std::size_t streamCount{0};
+  for (const auto &count : streamCounts) {
+    if (streamCount >= minArrivals) {
+      break;
+    }
+    streamCount += count;
+    ++ret;
+  }
+  return ret;
+}
+
 void Detector::Builder::finalize() {
   auto hasNoChildren{_processorConfigs.empty()};
   if (hasNoChildren) {
@@ -264,13 +523,37 @@ void Detector::Builder::finalize() {
         Core::TimeSpan{cfg.arrivalOffsetThreshold});
   }
 
+  // must be configured before registering processors
+  product()->_detectorImpl.setStacking(cfg.stacking);
+
+  if (cfg.fuseComponents && cfg.subspaceOriginIds.empty()) {
+    fuseComponents();
+  }
+
   if (cfg.minArrivals < 0) {
     product()->_detectorImpl.setMinArrivals(boost::none);
   } else {
-    product()->_detectorImpl.setMinArrivals(cfg.minArrivals);
+    auto minArrivals{static_cast<std::size_t>(cfg.minArrivals)};
+    if (!_fusedPickIds.empty()) {
+      // the minimum number of arrivals refers to streams while fused
+      // processors process several streams
+      const auto fusedMinArrivals{processorMinArrivals(minArrivals)};
+      if (fusedMinArrivals != minArrivals) {
+        SCDETECT_LOG_INFO_PROCESSOR(
+            product(),
+            "Rescaled minimum number of arrivals due to fused components: "
+            "%zu -> %zu",
+            minArrivals, fusedMinArrivals);
+      }
+      minArrivals = fusedMinArrivals;
+    }
+    product()->_detectorImpl.setMinArrivals(minArrivals);
   }
 
   std::unordered_set<std::string> usedPicks;
+  for (const auto &pickId : _fusedPickIds) {
+    usedPicks.emplace(pickId);
+  }
   for (auto &procConfigPair : _processorConfigs) {
     const auto &streamId{procConfigPair.first};
     auto &procConfig{procConfigPair.second};
@@ -288,6 +571,28 @@ void Detector::Builder::finalize() {
         Core::TimeSpan{product()->_config.gapTolerance});
     procConfig.processor->setGapInterpolation(
         product()->_config.gapInterpolation);
+    // the lowest threshold results are used with
+    auto threshold{product()->_config.triggerOn};
+    if (product()->_config.triggerDuration > 0) {
+      threshold = std::min(threshold, product()->_config.triggerOff);
+    }
+    if (product()->_config.mergingStrategy == "greaterEqualMergingThreshold" &&
+        procConfig.mergingThreshold) {
+      threshold = std::min(threshold, *procConfig.mergingThreshold);
+    }
+    procConfig.processor->setDetectionThreshold(threshold);
+    if (product()->_config.coarseSearchDecimation > 1) {
+      // coefficients of lags not refined are below the screening threshold,
+      // i.e. the screening threshold must not exceed the lowest threshold
+      // results are used with
+      procConfig.processor->setCoarseSearch(
+          static_cast<std::size_t>(product()->_config.coarseSearchDecimation),
+          std::min(product()->_config.coarseSearchThreshold, threshold));
+    }
+    if (product()->_config.prescreenMargin >= 0) {
+      procConfig.processor->setPrescreen(threshold -
+                                         product()->_config.prescreenMargin);
+    }
 
     // initialize detection processing
     product()->_detectorImpl.add(
@@ -453,6 +758,40 @@ const TemplateWaveformProcessor *Detector::processor(
   return _detectorImpl.processor(processorId);
 }
 
+std::vector<TemplateWaveformProcessor *> Detector::processors(
+    const std::string &waveformStreamId) {
+  return _detectorImpl.processors(waveformStreamId);
+}
+
+void Detector::setCheckpointing(bool enable) {
+  _detectorImpl.setCheckpointing(enable);
+}
+
+Detector::Checkpoints Detector::checkpoints() const {
+  return _detectorImpl.checkpoints();
+}
+
+std::size_t Detector::restore(const Checkpoints &checkpoints,
+                              std::size_t tolerance) {
+  return _detectorImpl.restore(checkpoints, tolerance);
+}
+
+Detector::LinkerCheckpoint Detector::linkerCheckpoint() const {
+  return _detectorImpl.linkerCheckpoint();
+}
+
+std::size_t Detector::restoreLinker(const LinkerCheckpoint &checkpoint) {
+  return _detectorImpl.restoreLinker(checkpoint);
+}
+
+util::MemoryUsage Detector::memoryUsage() const {
+  return _detectorImpl.memoryUsage();
+}
+
+util::MemoryUsage Detector::estimatedMemoryUsage() const {
+  return _detectorImpl.estimatedMemoryUsage();
+}
+
 processing::WaveformProcessor::StreamState *Detector::streamState(
     const Record *record) {
   return &_streamStates.at(record->streamID());
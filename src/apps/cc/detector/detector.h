@@ -14,10 +14,13 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../builder.h"
 #include "../config/detector.h"
 #include "../processing/waveform_processor.h"
+#include "../util/memory_usage.h"
 #include "../waveform.h"
 #include "detector_impl.h"
 #include "seiscomp/core/typedarray.h"
@@ -80,6 +83,27 @@ class Detector : public processing::WaveformProcessor {
 
     static bool isValidArrival(const DataModel::Arrival &arrival,
                                const DataModel::Pick &pick);
+    // Returns the pick (and the corresponding arrival) of `origin` which the
+    // template waveform configured by `streamConfig` refers to
+    //
+    // - the pick returned is `nullptr` if no matching arrival was found
+    static std::pair<DataModel::PickPtr, DataModel::ArrivalPtr> findPick(
+        const DataModel::Origin &origin, const std::string &streamId,
+        const config::StreamConfig &streamConfig);
+    // Loads the subspace members' template waveforms (i.e. w.r.t. the origins
+    // configured by `config::DetectorConfig::subspaceOriginIds`); members
+    // which cannot be loaded are skipped
+    std::vector<TemplateWaveform> loadSubspaceMembers(
+        const std::string &streamId, const config::StreamConfig &streamConfig,
+        WaveformHandlerIface *waveformHandler);
+    // Fuses the processors of streams sharing a sensor location (i.e. the
+    // components of a station) into a single processor (see
+    // `FusedTemplateWaveformProcessor`)
+    void fuseComponents();
+    // Returns the minimum number of processors corresponding to `minArrivals`
+    // streams, i.e. the smallest number of processors (including fused
+    // processors) which may process `minArrivals` streams
+    std::size_t processorMinArrivals(std::size_t minArrivals) const;
 
     struct TemplateProcessorConfig {
       // Template matching processor
@@ -102,6 +126,8 @@ class Detector : public processing::WaveformProcessor {
     using TemplateProcessorConfigs =
         std::unordered_map<std::string, TemplateProcessorConfig>;
     TemplateProcessorConfigs _processorConfigs;
+    // The pick identifiers of fused components
+    std::vector<std::string> _fusedPickIds;
   };
 
   friend class Builder;
@@ -125,6 +151,10 @@ class Detector : public processing::WaveformProcessor {
   // - returns a `nullptr` if no processor is identified by `processorId`
   const TemplateWaveformProcessor *processor(
       const std::string &processorId) const;
+  // Returns the underlying template waveform processors fed with records
+  // identified by `waveformStreamId`
+  std::vector<TemplateWaveformProcessor *> processors(
+      const std::string &waveformStreamId);
 
   using const_iterator = DetectorImpl::const_iterator;
   const_iterator begin() const { return _detectorImpl.begin(); }
@@ -132,6 +162,32 @@ class Detector : public processing::WaveformProcessor {
   const_iterator cbegin() const { return _detectorImpl.cbegin(); }
   const_iterator cend() const { return _detectorImpl.cend(); }
 
+  // Enables/disables checkpointing facilities of the underlying template
+  // waveform processors
+  void setCheckpointing(bool enable);
+  using Checkpoints = DetectorImpl::Checkpoints;
+  // Returns the checkpoints of the initialized template waveform processors
+  // (identified by the processor identifier)
+  Checkpoints checkpoints() const;
+  // Restores the underlying template waveform processors from `checkpoints`.
+  // Returns the number of processors a checkpoint was found for.
+  std::size_t restore(const Checkpoints &checkpoints, std::size_t tolerance);
+  using LinkerCheckpoint = Linker::Checkpoint;
+  // Returns the linker's pending candidate associations
+  LinkerCheckpoint linkerCheckpoint() const;
+  // Restores the linker's pending candidate associations from `checkpoint`.
+  // Returns the number of candidates restored.
+  std::size_t restoreLinker(const LinkerCheckpoint &checkpoint);
+
+  // Returns the detector's approximate memory usage (excluding the memory
+  // used by amplitude processors)
+  util::MemoryUsage memoryUsage() const;
+  // Returns the detector's approximate memory usage once the data buffers are
+  // sized, i.e. the data buffers of processors which did not receive any
+  // data, yet, are estimated from the template waveforms (excluding the
+  // memory used by amplitude processors)
+  util::MemoryUsage estimatedMemoryUsage() const;
+
  protected:
   WaveformProcessor::StreamState *streamState(const Record *record) override;
 
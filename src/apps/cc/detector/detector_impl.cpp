@@ -47,6 +47,9 @@ DetectorImpl::DetectorImpl(const DataModel::OriginCPtr &origin)
   _linker.setResultCallback([this](const linker::Association &res) {
     return storeLinkerResult(res);
   });
+  _stacker.setResultCallback([this](const linker::Association &res) {
+    return storeLinkerResult(res);
+  });
 }
 
 DetectorImpl::BaseException::BaseException()
@@ -76,8 +79,6 @@ void DetectorImpl::setGapTolerance(const Core::TimeSpan &duration) {
   }
 }
 
-const Core::TimeWindow &DetectorImpl::processed() const { return _processed; }
-
 bool DetectorImpl::triggered() const { return static_cast<bool>(_triggerEnd); }
 
 void DetectorImpl::enableTrigger(const Core::TimeSpan &duration) {
@@ -89,6 +90,7 @@ void DetectorImpl::disableTrigger() { _triggerDuration = boost::none; }
 void DetectorImpl::setTriggerThresholds(double triggerOn, double triggerOff) {
   _thresTriggerOn = triggerOn;
   _linker.setThresAssociation(_thresTriggerOn);
+  _stacker.setThresAssociation(_thresTriggerOn);
 
   if (_thresTriggerOn && config::validateXCorrThreshold(triggerOff)) {
     _thresTriggerOff = triggerOff;
@@ -106,6 +108,7 @@ boost::optional<Core::TimeSpan> DetectorImpl::arrivalOffsetThreshold() const {
 
 void DetectorImpl::setMinArrivals(const boost::optional<size_t> &n) {
   _linker.setMinArrivals(n);
+  _stacker.setMinArrivals(n);
 }
 
 boost::optional<size_t> DetectorImpl::minArrivals() const {
@@ -116,6 +119,10 @@ void DetectorImpl::setMergingStrategy(Linker::MergingStrategy mergingStrategy) {
   _linker.setMergingStrategy(std::move(mergingStrategy));
 }
 
+void DetectorImpl::setStacking(bool enable) { _stacking = enable; }
+
+bool DetectorImpl::stacking() const { return _stacking; }
+
 void DetectorImpl::setMaxLatency(
     const boost::optional<Core::TimeSpan> &latency) {
   _maxLatency = latency;
@@ -136,6 +143,19 @@ const TemplateWaveformProcessor *DetectorImpl::processor(
   return nullptr;
 }
 
+std::vector<TemplateWaveformProcessor *> DetectorImpl::processors(
+    const std::string &waveformStreamId) {
+  std::vector<TemplateWaveformProcessor *> ret;
+  auto range{_processorIdx.equal_range(waveformStreamId)};
+  for (auto it{range.first}; it != range.second; ++it) {
+    auto pit{_processors.find(it->second)};
+    if (pit != std::end(_processors)) {
+      ret.push_back(pit->second.processor.get());
+    }
+  }
+  return ret;
+}
+
 void DetectorImpl::add(std::unique_ptr<TemplateWaveformProcessor> proc,
                        const std::string &waveformStreamId,
                        const Arrival &arrival,
@@ -143,10 +163,11 @@ void DetectorImpl::add(std::unique_ptr<TemplateWaveformProcessor> proc,
                        const boost::optional<double> &mergingThreshold) {
   proc->setResultCallback(
       [this](const TemplateWaveformProcessor *processor, const Record *record,
-             std::unique_ptr<const TemplateWaveformProcessor::MatchResult>
+             std::shared_ptr<const TemplateWaveformProcessor::MatchResult>
                  result) {
         storeTemplateResult(processor, record, std::move(result));
       });
+  proc->setMatchResultPool(_matchResultPool);
 
   // XXX(damb): Replace the arrival with a *pseudo arrival* i.e. an arrival
   // which is associated with the stream to be processed
@@ -154,28 +175,65 @@ void DetectorImpl::add(std::unique_ptr<TemplateWaveformProcessor> proc,
   pseudoArrival.pick.waveformStreamId = waveformStreamId;
 
   _linker.add(proc.get(), pseudoArrival, mergingThreshold);
+  if (_stacking) {
+    proc->setCoefficientTrace(true);
+    _stacker.add(proc.get(), pseudoArrival);
+  }
   const auto onHoldDuration{_maxLatency.value_or(0.0) + proc->initTime() +
                             _linkerSafetyMargin};
 
   if (_linker.onHold() < onHoldDuration) {
     _linker.setOnHold(onHoldDuration);
+    _stacker.setOnHold(onHoldDuration);
   }
 
   const auto procId{proc->id()};
+  // fused processors are fed with the data of all components
+  const auto componentStreamIds{proc->componentStreamIds()};
   detail::ProcessorState p{loc, Core::TimeWindow{}, arrival.pick.time,
                            std::move(proc)};
   _processors.emplace(procId, std::move(p));
+  ++_stationCounts[loc.stationId];
 
   _processorIdx.emplace(waveformStreamId, procId);
+  for (const auto &componentStreamId : componentStreamIds) {
+    _processorIdx.emplace(componentStreamId, procId);
+  }
 }
 
 void DetectorImpl::remove(const std::string &waveformStreamId) {
+  std::unordered_set<std::string> removed;
   auto range{_processorIdx.equal_range(waveformStreamId)};
-  for (auto &rit = range.first; rit != range.second; ++rit) {
-    _linker.remove(rit->first);
+  auto rit{range.first};
+  while (rit != range.second) {
+    const auto procId{rit->second};
+    removed.emplace(procId);
+    _linker.remove(procId);
+    _stacker.remove(procId);
+
+    auto it{_processors.find(procId)};
+    if (it != std::end(_processors)) {
+      const auto &stationId{it->second.sensorLocation.stationId};
+      auto sit{_stationCounts.find(stationId)};
+      if (sit != std::end(_stationCounts) && --sit->second == 0) {
+        _stationCounts.erase(sit);
+      }
+
+      _processors.erase(it);
+    }
+
+    rit = _processorIdx.erase(rit);
+  }
 
-    _processorIdx.erase(rit);
-    _processors.erase(rit->second);
+  // remove the index entries of fused components
+  if (!removed.empty()) {
+    for (auto it{std::begin(_processorIdx)}; it != std::end(_processorIdx);) {
+      if (removed.count(it->second) > 0) {
+        it = _processorIdx.erase(it);
+      } else {
+        ++it;
+      }
+    }
   }
 
   // update linker
@@ -194,9 +252,79 @@ void DetectorImpl::remove(const std::string &waveformStreamId) {
                                _maxLatency.value_or(0.0) + _linkerSafetyMargin};
   if (maxOnHoldDuration > _linker.onHold()) {
     _linker.setOnHold(maxOnHoldDuration);
+    _stacker.setOnHold(maxOnHoldDuration);
   }
 }
 
+void DetectorImpl::setCheckpointing(bool enable) {
+  for (auto &procPair : _processors) {
+    procPair.second.processor->setCheckpointing(enable);
+  }
+}
+
+DetectorImpl::Checkpoints DetectorImpl::checkpoints() const {
+  Checkpoints ret;
+  for (const auto &procPair : _processors) {
+    auto checkpoint{procPair.second.processor->checkpoint()};
+    if (checkpoint) {
+      ret.emplace(procPair.first, std::move(*checkpoint));
+    }
+  }
+  return ret;
+}
+
+std::size_t DetectorImpl::restore(const Checkpoints &checkpoints,
+                                  std::size_t tolerance) {
+  std::size_t ret{0};
+  for (auto &procPair : _processors) {
+    auto it{checkpoints.find(procPair.first)};
+    if (it == checkpoints.end()) {
+      continue;
+    }
+
+    procPair.second.processor->restore(it->second, tolerance);
+    ++ret;
+  }
+
+  return ret;
+}
+
+Linker::Checkpoint DetectorImpl::linkerCheckpoint() const {
+  return _linker.checkpoint();
+}
+
+std::size_t DetectorImpl::restoreLinker(const Linker::Checkpoint &checkpoint) {
+  // the linker is not used in stacking detector mode
+  if (_stacking) {
+    return 0;
+  }
+  return _linker.restore(checkpoint);
+}
+
+util::MemoryUsage DetectorImpl::memoryUsage() const {
+  util::MemoryUsage ret;
+  for (const auto &procPair : _processors) {
+    ret += procPair.second.processor->memoryUsage();
+  }
+
+  ret.linker += _linker.memoryUsage();
+  ret.linker += _stacker.memoryUsage();
+  ret.linker += _matchResultPool->size() *
+                sizeof(TemplateWaveformProcessor::MatchResult);
+  ret.linker += _resultQueue.size() * sizeof(linker::Association);
+  return ret;
+}
+
+util::MemoryUsage DetectorImpl::estimatedMemoryUsage() const {
+  auto ret{memoryUsage()};
+  for (const auto &procPair : _processors) {
+    const auto &processor{procPair.second.processor};
+    ret.crossCorrelation += processor->estimatedMemoryUsage().crossCorrelation -
+                            processor->memoryUsage().crossCorrelation;
+  }
+  return ret;
+}
+
 void DetectorImpl::feed(const Record *record) {
   if (!hasAcceptableLatency(record)) {
     logging::TaggedMessage msg{
@@ -219,23 +347,6 @@ void DetectorImpl::feed(const Record *record) {
 
   processResultQueue();
 
-  // overall processed endtime
-  Core::TimeWindow processed;
-  for (const auto &procPair : _processors) {
-    const auto procProcessed{procPair.second.processor->processed()};
-    if (!procProcessed) {
-      processed.setLength(0);
-      break;
-    }
-
-    if (_processed && _processed.endTime() < procProcessed.endTime()) {
-      processed = processed | procProcessed;
-    } else {
-      processed = procProcessed;
-    }
-  }
-  _processed = processed;
-
   if (!triggered()) {
     resetProcessing();
   }
@@ -243,12 +354,14 @@ void DetectorImpl::feed(const Record *record) {
 
 void DetectorImpl::reset() {
   _linker.reset();
+  _stacker.reset();
   resetProcessors();
   resetProcessing();
 }
 
 void DetectorImpl::flush() {
   _linker.flush();
+  _stacker.flush();
   processResultQueue();
   // emit pending result
   if (_currentResult) {
@@ -269,7 +382,8 @@ bool DetectorImpl::process(const Record *record) {
     const auto &procId{rit->second};
     auto &procState{_processors.at(procId)};
 
-    if (!procState.processor->feed(record)) {
+    const auto fed{procState.processor->feed(record)};
+    if (!fed) {
       const auto &status{procState.processor->status()};
       const auto &statusValue{procState.processor->statusValue()};
       logging::TaggedMessage msg{
@@ -409,6 +523,9 @@ void DetectorImpl::prepareResult(const linker::Association &linkerResult,
                                 proc.processor->templateWaveform().endTime(),
                                 proc.templateWaveformReferenceTime, procId});
     usedChas.emplace(templateResult.arrival.pick.waveformStreamId);
+    for (const auto &componentStreamId : proc.processor->componentStreamIds()) {
+      usedChas.emplace(componentStreamId);
+    }
     usedStas.emplace(proc.sensorLocation.stationId);
   }
 
@@ -424,12 +541,8 @@ void DetectorImpl::prepareResult(const linker::Association &linkerResult,
   // number of stations used
   result.numStationsUsed = usedStas.size();
   // number of channels/stations associated
-  std::unordered_set<std::string> associatedStations;
-  for (const auto &procPair : _processors) {
-    associatedStations.emplace(procPair.second.sensorLocation.stationId);
-  }
   result.numChannelsAssociated = _linker.channelCount();
-  result.numStationsAssociated = associatedStations.size();
+  result.numStationsAssociated = _stationCounts.size();
 }
 
 void DetectorImpl::emitResult(const DetectorImpl::Result &result) {
@@ -455,7 +568,7 @@ void DetectorImpl::resetProcessors() {
 
 void DetectorImpl::storeTemplateResult(
     const TemplateWaveformProcessor *processor, const Record *record,
-    std::unique_ptr<const TemplateWaveformProcessor::MatchResult> result) {
+    std::shared_ptr<const TemplateWaveformProcessor::MatchResult> result) {
   assert((processor && record && result));
 
   auto &p{_processors.at(processor->id())};
@@ -468,6 +581,11 @@ void DetectorImpl::storeTemplateResult(
     throw TemplateMatchingError{msg};
   }
 
+  if (_stacking) {
+    _stacker.feed(processor, std::move(result));
+    return;
+  }
+
   if (triggered()) {
     bool contributing{_currentResult.value().results.count(processor->id()) ==
                       1};
@@ -9,9 +9,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
 #include <cmath>
+#include <cstddef>
 #include <deque>
 #include <functional>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -19,10 +21,12 @@
 #include "../exception.h"
 #include "../processing/processor.h"
 #include "../processing/waveform_operator.h"
+#include "../util/memory_usage.h"
 #include "arrival.h"
 #include "detail.h"
 #include "linker.h"
 #include "linker/association.h"
+#include "stacker.h"
 #include "template_waveform_processor.h"
 
 namespace Seiscomp {
@@ -124,8 +128,6 @@ class DetectorImpl : public detect::processing::Processor {
   void setGapThreshold(const Core::TimeSpan &duration);
   void setGapTolerance(const Core::TimeSpan &duration);
 
-  // Returns the overall time window processed
-  const Core::TimeWindow &processed() const;
   // Returns `true` if the detector is currently triggered, else `false`
   bool triggered() const;
   // Enables trigger duration facilities with `duration`
@@ -146,6 +148,14 @@ class DetectorImpl : public detect::processing::Processor {
   boost::optional<size_t> minArrivals() const;
   // Sets the merging strategy applied while linking
   void setMergingStrategy(Linker::MergingStrategy mergingStrategy);
+  // Enables/disables the stacking detector mode, i.e. the processors'
+  // coefficient traces are stacked w.r.t. the template moveout (see
+  // `Stacker`) instead of linking the processors' local maxima
+  //
+  // - must be configured before registering processors
+  void setStacking(bool enable);
+  // Returns `true` if the stacking detector mode is enabled, else `false`
+  bool stacking() const;
   // Sets the maximum data latency w.r.t. `NOW`. If configured with
   // `boost::none` latency is not taken into account and thus not validated
   void setMaxLatency(const boost::optional<Core::TimeSpan> &latency);
@@ -159,6 +169,10 @@ class DetectorImpl : public detect::processing::Processor {
   // - returns `nullptr` if there is no processor with `processorId` registered
   const TemplateWaveformProcessor *processor(
       const std::string &processorId) const;
+  // Returns the template waveform processors fed with records identified by
+  // `waveformStreamId`
+  std::vector<TemplateWaveformProcessor *> processors(
+      const std::string &waveformStreamId);
 
   using const_iterator = detail::TemplateWaveformProcessorIterator;
   const_iterator begin() const { return const_iterator{_processors.begin()}; }
@@ -169,7 +183,8 @@ class DetectorImpl : public detect::processing::Processor {
   // Register the template waveform processor `proc`. Records are identified by
   // the waveform stream identifier `waveformStreamId`. `proc` is registered
   // together with the template arrival `arrival` and the sensor location
-  // `loc`.
+  // `loc`. Fused processors are additionally registered for the waveform
+  // stream identifiers of their components.
   void add(std::unique_ptr<TemplateWaveformProcessor> proc,
            const std::string &waveformStreamId, const Arrival &arrival,
            const DetectorImpl::SensorLocation &loc,
@@ -177,6 +192,30 @@ class DetectorImpl : public detect::processing::Processor {
   // Removes the processors processing streams identified by `waveformStreamId`
   void remove(const std::string &waveformStreamId);
 
+  // Enables/disables checkpointing facilities of the registered processors
+  void setCheckpointing(bool enable);
+  using Checkpoints =
+      std::unordered_map<detail::ProcessorIdType,
+                         TemplateWaveformProcessor::Checkpoint>;
+  // Returns the checkpoints of the initialized processors
+  Checkpoints checkpoints() const;
+  // Restores the registered processors from `checkpoints` (see also
+  // `TemplateWaveformProcessor::restore()`). Returns the number of processors
+  // a checkpoint was found for.
+  std::size_t restore(const Checkpoints &checkpoints, std::size_t tolerance);
+  // Returns the linker's pending candidate associations
+  Linker::Checkpoint linkerCheckpoint() const;
+  // Restores the linker's pending candidate associations from `checkpoint`
+  // (see also `Linker::restore()`). Returns the number of candidates
+  // restored.
+  std::size_t restoreLinker(const Linker::Checkpoint &checkpoint);
+
+  // Returns the detector's approximate memory usage
+  util::MemoryUsage memoryUsage() const;
+  // Returns the detector's approximate memory usage once the processors'
+  // data buffers are sized
+  util::MemoryUsage estimatedMemoryUsage() const;
+
   // Feeds `record` to the detector
   void feed(const Record *record);
   // Reset the detector
@@ -214,7 +253,7 @@ class DetectorImpl : public detect::processing::Processor {
   // Callback storing results from `TemplateWaveformProcessor`
   void storeTemplateResult(
       const TemplateWaveformProcessor *processor, const Record *record,
-      std::unique_ptr<const TemplateWaveformProcessor::MatchResult> result);
+      std::shared_ptr<const TemplateWaveformProcessor::MatchResult> result);
 
   // Callback storing results from the linker
   void storeLinkerResult(const linker::Association &linkerResult);
@@ -229,13 +268,18 @@ class DetectorImpl : public detect::processing::Processor {
   // Safety margin for linker on hold duration
   static const Core::TimeSpan _linkerSafetyMargin;
 
+  // Pool shared by the registered processors in order to recycle match
+  // results
+  std::shared_ptr<TemplateWaveformProcessor::MatchResultPool> _matchResultPool{
+      std::make_shared<TemplateWaveformProcessor::MatchResultPool>()};
+
   detail::ProcessorStatesType _processors;
   using ProcessorIdx =
       std::unordered_multimap<std::string, detail::ProcessorIdType>;
   ProcessorIdx _processorIdx;
 
-  // The overall time window processed
-  Core::TimeWindow _processed;
+  // Number of processors per station (identified by the station's id)
+  std::unordered_map<std::string, std::size_t> _stationCounts;
 
   // The current linker result
   boost::optional<linker::Association> _currentResult;
@@ -250,6 +294,9 @@ class DetectorImpl : public detect::processing::Processor {
 
   // The linker required for associating arrivals
   Linker _linker;
+  // The stacker (used instead of the linker in stacking detector mode)
+  Stacker _stacker;
+  bool _stacking{false};
   using ResultQueue = std::deque<linker::Association>;
   ResultQueue _resultQueue;
 
@@ -0,0 +1,429 @@
+#include "fused_template_waveform_processor.h"
+
+#include <seiscomp/core/record.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "../log.h"
+#include "../util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace detector {
+
+namespace {
+
+// Returns the configuration of `filter` if it is a Butterworth filter
+boost::optional<filter::iir::ButterworthConfig> butterworthConfig(
+    const TemplateWaveformProcessor::Filter *filter) {
+  const auto *butterworth{
+      dynamic_cast<const filter::iir::ButterworthFilter *>(filter)};
+  if (!butterworth) {
+    return boost::none;
+  }
+  return butterworth->config();
+}
+
+std::vector<TemplateWaveform> templateWaveforms(
+    const std::vector<FusedTemplateWaveformProcessor::Component> &components) {
+  std::vector<TemplateWaveform> ret;
+  for (const auto &component : components) {
+    ret.push_back(component.templateWaveform);
+  }
+  return ret;
+}
+
+}  // namespace
+
+FusedTemplateWaveformProcessor::FusedTemplateWaveformProcessor(
+    std::vector<Component> components, const Core::TimeSpan &initTime)
+    : TemplateWaveformProcessor{components.at(0).templateWaveform},
+      _multiChannelCrossCorrelation{templateWaveforms(components)} {
+  _initTime = initTime;
+
+  // the channels are filtered jointly if they share the same Butterworth
+  // filter
+  _filterConfig = butterworthConfig(components.front().filter.get());
+  for (const auto &component : components) {
+    if (_filterConfig &&
+        butterworthConfig(component.filter.get()) != _filterConfig) {
+      _filterConfig = boost::none;
+    }
+  }
+
+  for (auto &component : components) {
+    Channel channel;
+    channel.waveformStreamId = component.waveformStreamId;
+    channel.streamState.filter = std::move(component.filter);
+    _channels.push_back(std::move(channel));
+  }
+}
+
+const FusedTemplateWaveformProcessor::Filter *
+FusedTemplateWaveformProcessor::filter() const {
+  return _channels.front().streamState.filter.get();
+}
+
+const Core::TimeWindow &FusedTemplateWaveformProcessor::processed() const {
+  return _processed;
+}
+
+void FusedTemplateWaveformProcessor::reset() {
+  for (auto &channel : _channels) {
+    WaveformProcessor::reset(channel.streamState);
+    channel.resampler.reset();
+    channel.pending.clear();
+  }
+  _multiChannelCrossCorrelation.reset();
+  _samplingFrequency = 0;
+  _filterBank.reset();
+  _processed = Core::TimeWindow{};
+  _receivedSamples = 0;
+
+  TemplateWaveformProcessor::reset();
+}
+
+bool FusedTemplateWaveformProcessor::directCorrelation() const {
+  return false;
+}
+
+std::vector<std::string> FusedTemplateWaveformProcessor::componentStreamIds()
+    const {
+  std::vector<std::string> ret;
+  for (std::size_t i{1}; i < _channels.size(); ++i) {
+    ret.push_back(_channels[i].waveformStreamId);
+  }
+  return ret;
+}
+
+boost::optional<TemplateWaveformProcessor::Checkpoint>
+FusedTemplateWaveformProcessor::checkpoint() const {
+  return boost::none;
+}
+
+void FusedTemplateWaveformProcessor::restore(Checkpoint checkpoint,
+                                             std::size_t tolerance) {
+  reset();
+}
+
+util::MemoryUsage FusedTemplateWaveformProcessor::memoryUsage() const {
+  auto ret{TemplateWaveformProcessor::memoryUsage()};
+  // the primary component's template waveform is accounted for, already
+  const auto &templateWaveforms{
+      _multiChannelCrossCorrelation.templateWaveforms()};
+  for (std::size_t i{1}; i < templateWaveforms.size(); ++i) {
+    const auto &raw{templateWaveforms[i].raw()};
+    ret.templateWaveforms += util::byteSize(raw.data());
+    if (&templateWaveforms[i].waveform() != &raw) {
+      ret.templateWaveforms +=
+          util::byteSize(templateWaveforms[i].waveform().data());
+    }
+  }
+
+  ret.crossCorrelation += _multiChannelCrossCorrelation.memoryUsage();
+  for (const auto &channel : _channels) {
+    ret.crossCorrelation += channel.pending.capacity() * sizeof(double);
+  }
+  ret.crossCorrelation += _coefficients.capacity() * sizeof(double);
+  return ret;
+}
+
+util::MemoryUsage FusedTemplateWaveformProcessor::estimatedMemoryUsage()
+    const {
+  auto ret{memoryUsage()};
+  // the data buffers are sized as soon as the sampling frequency is known
+  ret.crossCorrelation += _multiChannelCrossCorrelation.estimatedMemoryUsage() -
+                          _multiChannelCrossCorrelation.memoryUsage();
+  return ret;
+}
+
+bool FusedTemplateWaveformProcessor::feed(const Record *record) {
+  if (record->sampleCount() == 0) {
+    return false;
+  }
+
+  const auto idx{channelIdx(record->streamID())};
+  if (idx == channels()) {
+    return false;
+  }
+  auto &channel{_channels[idx]};
+
+  // unless a target sampling frequency is configured, the data fed first
+  // determines the sampling frequency
+  const auto f{targetSamplingFrequency().value_or(
+      _samplingFrequency > 0 ? _samplingFrequency
+                             : record->samplingFrequency())};
+  if (record->samplingFrequency() == f) {
+    channel.resampler.reset();
+    return store(record);
+  }
+
+  if (!channel.resampler ||
+      channel.resampler->sourceFrequency() != record->samplingFrequency() ||
+      channel.resampler->targetFrequency() != f) {
+    SCDETECT_LOG_DEBUG_PROCESSOR(
+        this, "%s: resampling component: sampling_frequency=%f -> %f",
+        record->streamID().c_str(), record->samplingFrequency(), f);
+    channel.resampler = RecordResamplerStore::Instance().get(record, f);
+  }
+
+  RecordCPtr resampled{channel.resampler->feed(record)};
+  if (!resampled) {
+    // the record fed is buffered by the resampler
+    return true;
+  }
+  return store(resampled.get());
+}
+
+processing::WaveformProcessor::StreamState *
+FusedTemplateWaveformProcessor::streamState(const Record *record) {
+  const auto idx{channelIdx(record->streamID())};
+  assert((idx < channels()));
+  return &_channels[idx].streamState;
+}
+
+void FusedTemplateWaveformProcessor::process(StreamState &streamState,
+                                             const Record *record,
+                                             const DoubleArray &filteredData) {
+  // the channels are correlated as soon as data is available for all
+  // channels (see `correlate()`)
+}
+
+bool FusedTemplateWaveformProcessor::fill(processing::StreamState &streamState,
+                                          const Record *record,
+                                          DoubleArrayPtr &data) {
+  const auto idx{channelIdx(record->streamID())};
+  if (idx == channels()) {
+    return false;
+  }
+
+  if (_filterBank) {
+    // the time-aligned samples are filtered jointly (see `correlate()`)
+    auto &s{static_cast<StreamState &>(streamState)};
+    s.receivedSamples += static_cast<std::size_t>(data->size());
+    if (_saturationThreshold && checkIfSaturated(*data)) {
+      return false;
+    }
+    feedChannel(idx, record, *data);
+    return true;
+  }
+
+  if (WaveformProcessor::fill(streamState, record, data)) {
+    feedChannel(idx, record, *data);
+    return true;
+  }
+  return false;
+}
+
+void FusedTemplateWaveformProcessor::setupStream(StreamState &streamState,
+                                                 const Record *record) {
+  WaveformProcessor::setupStream(streamState, record);
+  const auto f{streamState.samplingFrequency};
+  SCDETECT_LOG_DEBUG_PROCESSOR(
+      this, "%s: Initialize stream: sampling_frequency=%f",
+      record->streamID().c_str(), f);
+
+  const auto idx{channelIdx(record->streamID())};
+  assert((idx < channels()));
+  _channels[idx].pending.clear();
+  if (_filterBank) {
+    _filterBank->reset(idx);
+  }
+
+  if (_samplingFrequency == f) {
+    return;
+  }
+
+  _samplingFrequency = f;
+  _multiChannelCrossCorrelation.setSamplingFrequency(f);
+  _neededSamples = static_cast<std::size_t>(std::lround(_initTime * f));
+  _receivedSamples = 0;
+
+  _filterBank.reset();
+  if (_filterConfig) {
+    auto biquads{filter::iir::butterworth(*_filterConfig, f)};
+    if (biquads) {
+      _filterBank = util::make_unique<filter::iir::FilterBank>(
+          std::move(biquads), channels());
+    }
+  }
+}
+
+std::size_t FusedTemplateWaveformProcessor::channelIdx(
+    const std::string &waveformStreamId) const {
+  const auto it{std::find_if(std::begin(_channels), std::end(_channels),
+                             [&waveformStreamId](const Channel &channel) {
+                               return channel.waveformStreamId ==
+                                      waveformStreamId;
+                             })};
+  return static_cast<std::size_t>(it - std::begin(_channels));
+}
+
+std::size_t FusedTemplateWaveformProcessor::channels() const {
+  return _channels.size();
+}
+
+void FusedTemplateWaveformProcessor::feedChannel(std::size_t channelIdx,
+                                                 const Record *record,
+                                                 const DoubleArray &data) {
+  const auto f{_samplingFrequency};
+  if (f != record->samplingFrequency()) {
+    return;
+  }
+
+  auto &channel{_channels[channelIdx]};
+  // discontinuous data invalidates the samples pending
+  if (!channel.pending.empty()) {
+    const auto expected{
+        channel.startTime +
+        Core::TimeSpan{static_cast<double>(channel.pending.size()) / f}};
+    if (std::fabs(static_cast<double>(record->startTime() - expected)) * f >
+        0.5) {
+      // keep the filter state consistent with the data fed
+      filterChannel(channelIdx, channel.pending.size());
+      channel.pending.clear();
+    }
+  }
+  if (channel.pending.empty()) {
+    channel.startTime = record->startTime();
+  }
+  channel.pending.insert(std::end(channel.pending), data.typedData(),
+                         data.typedData() + data.size());
+
+  // drop samples correlated, already
+  if (_processed) {
+    const auto correlated{
+        static_cast<double>(_processed.endTime() - channel.startTime) * f};
+    if (correlated > 0.5) {
+      const auto skip{std::min(
+          channel.pending.size(),
+          static_cast<std::size_t>(std::lround(correlated)))};
+      filterChannel(channelIdx, skip);
+      channel.pending.erase(std::begin(channel.pending),
+                            std::begin(channel.pending) + skip);
+      channel.startTime += Core::TimeSpan{static_cast<double>(skip) / f};
+    }
+  }
+  if (channel.pending.empty()) {
+    return;
+  }
+
+  correlate(record);
+}
+
+void FusedTemplateWaveformProcessor::correlate(const Record *record) {
+  const auto f{_samplingFrequency};
+
+  // align the channels w.r.t. the latest pending sample
+  for (const auto &channel : _channels) {
+    if (channel.pending.empty()) {
+      return;
+    }
+  }
+  auto startTime{_channels.front().startTime};
+  for (const auto &channel : _channels) {
+    startTime = std::max(startTime, channel.startTime);
+  }
+
+  auto n{std::numeric_limits<std::size_t>::max()};
+  for (std::size_t i{0}; i < _channels.size(); ++i) {
+    auto &channel{_channels[i]};
+    const auto offset{static_cast<std::size_t>(std::max(
+        0L,
+        std::lround(static_cast<double>(startTime - channel.startTime) * f)))};
+    if (offset > 0) {
+      const auto drop{std::min(offset, channel.pending.size())};
+      filterChannel(i, drop);
+      channel.pending.erase(std::begin(channel.pending),
+                            std::begin(channel.pending) + drop);
+      channel.startTime += Core::TimeSpan{static_cast<double>(drop) / f};
+    }
+    n = std::min(n, channel.pending.size());
+  }
+  if (n == 0) {
+    return;
+  }
+
+  std::vector<double *> data;
+  data.reserve(_channels.size());
+  for (auto &channel : _channels) {
+    data.push_back(channel.pending.data());
+  }
+  if (_filterBank) {
+    _filterBank->apply(n, data.data());
+  }
+  _coefficients.resize(n);
+  _multiChannelCrossCorrelation.apply(n, data.data(), _coefficients.data());
+
+  startTime = _channels.front().startTime;
+  const Core::TimeWindow tw{
+      startTime, startTime + Core::TimeSpan{static_cast<double>(n) / f}};
+  for (auto &channel : _channels) {
+    channel.pending.erase(std::begin(channel.pending),
+                          std::begin(channel.pending) + n);
+    channel.startTime = tw.endTime();
+  }
+  if (!_processed) {
+    _processed = tw;
+  } else {
+    _processed.setEndTime(tw.endTime());
+  }
+
+  // skip the coefficients computed while initializing
+  std::size_t startIdx{0};
+  if (_receivedSamples < _neededSamples) {
+    startIdx = std::min(n, _neededSamples - _receivedSamples);
+  }
+  _receivedSamples += n;
+  if (startIdx == n) {
+    return;
+  }
+
+  setStatus(Status::kInProgress, 1);
+
+  _maxima.clear();
+  for (auto i{startIdx}; i < n; ++i) {
+    _maxima.feed(_coefficients[i], i);
+  }
+
+  if (_maxima.values.empty() && !coefficientTrace()) {
+    return;
+  }
+
+  const auto templateSize{
+      static_cast<double>(_multiChannelCrossCorrelation.size())};
+  auto result{_matchResultPool->acquire()};
+  result->localMaxima.clear();
+  for (const auto &m : _maxima.values) {
+    // take cross-correlation filter delay into account
+    const auto matchIdx{static_cast<double>(m.lagIdx) - templateSize + 1};
+    result->localMaxima.push_back(
+        MatchResult::Value{Core::TimeSpan{matchIdx / f}, m.coefficient});
+  }
+
+  result->timeWindow = tw;
+
+  assignCoefficientTrace(
+      *result, _coefficients.data() + startIdx, n - startIdx,
+      startTime + Core::TimeSpan{
+                      (static_cast<double>(startIdx) - templateSize + 1) / f},
+      f);
+
+  emitResult(record, std::move(result));
+}
+
+void FusedTemplateWaveformProcessor::filterChannel(std::size_t channelIdx,
+                                                   std::size_t n) {
+  if (!_filterBank || n == 0) {
+    return;
+  }
+  _filterBank->apply(channelIdx, n, _channels[channelIdx].pending.data());
+}
+
+}  // namespace detector
+}  // namespace detect
+}  // namespace Seiscomp
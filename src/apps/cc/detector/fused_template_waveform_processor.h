@@ -0,0 +1,154 @@
+#ifndef SCDETECT_APPS_CC_DETECTOR_FUSEDTEMPLATEWAVEFORMPROCESSOR_H_
+#define SCDETECT_APPS_CC_DETECTOR_FUSEDTEMPLATEWAVEFORMPROCESSOR_H_
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/timewindow.h>
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../filter/iir.h"
+#include "../filter/multichannel_crosscorrelation.h"
+#include "../resamplerstore.h"
+#include "../template_waveform.h"
+#include "../util/memory_usage.h"
+#include "template_waveform_processor.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace detector {
+
+// Fused template waveform processor implementation
+//
+// - fuses the cross-correlation of several components (e.g. the components of
+// a sensor location) by means of `filter::MultiChannelCrossCorrelation`, i.e.
+// the processor is fed with the data of all components, keeps the components
+// time-aligned and emits a single match result with regards to the mean
+// coefficient
+// - the data is correlated with regards to the target sampling frequency (if
+// configured) or else the sampling frequency of the data fed first; the data
+// of components sampled differently is resampled per component
+// - if all components use the same natively implemented Butterworth filter
+// (see `filter::iir::setNativeFilters()`), the time-aligned samples of the
+// components are filtered jointly (see `filter::iir::FilterBank`)
+// - neither checkpointing, the coarse-to-fine search, the pre-screening, the
+// subspace detector mode, the partitioned convolution nor correlation sharing
+// apply
+class FusedTemplateWaveformProcessor : public TemplateWaveformProcessor {
+ public:
+  // A component fused
+  struct Component {
+    // The waveform stream identifier of the component's data
+    std::string waveformStreamId;
+    // The component's template waveform
+    TemplateWaveform templateWaveform;
+    // The component's filter (optional)
+    std::unique_ptr<Filter> filter;
+  };
+
+  // Creates a `FusedTemplateWaveformProcessor` from `components`. The first
+  // component is the primary component, i.e. the processor's template
+  // waveform refers to the primary component's template waveform.
+  //
+  // - `components` must not be empty; the components' template waveforms must
+  // refer to the same start time
+  // - `initTime` is the processor's initialization time (see `initTime()`)
+  FusedTemplateWaveformProcessor(std::vector<Component> components,
+                                 const Core::TimeSpan &initTime);
+
+  // Returns the primary component's filter or `nullptr` if no filter has been
+  // configured
+  const Filter *filter() const override;
+
+  const Core::TimeWindow &processed() const override;
+
+  void reset() override;
+
+  bool directCorrelation() const override;
+
+  // Returns the waveform stream identifiers of the components fused (i.e.
+  // excluding the primary component's waveform stream identifier)
+  std::vector<std::string> componentStreamIds() const override;
+
+  // Fused processors are not checkpointed, i.e. returns `boost::none`
+  boost::optional<Checkpoint> checkpoint() const override;
+  // Resets the processor (i.e. `checkpoint` is discarded)
+  void restore(Checkpoint checkpoint, std::size_t tolerance) override;
+
+  util::MemoryUsage memoryUsage() const override;
+  util::MemoryUsage estimatedMemoryUsage() const override;
+
+  bool feed(const Record *record) override;
+
+ protected:
+  WaveformProcessor::StreamState *streamState(const Record *record) override;
+
+  void process(StreamState &streamState, const Record *record,
+               const DoubleArray &filteredData) override;
+
+  bool fill(processing::StreamState &streamState, const Record *record,
+            DoubleArrayPtr &data) override;
+
+  void setupStream(StreamState &streamState, const Record *record) override;
+
+ private:
+  struct Channel {
+    std::string waveformStreamId;
+    StreamState streamState;
+    // Resamples the component's data if sampled differently (optional)
+    std::unique_ptr<RecordResamplerStore::RecordResampler> resampler;
+    // The samples not correlated, yet (unfiltered if the channels are
+    // filtered jointly)
+    std::vector<double> pending;
+    // The time of the first pending sample
+    Core::Time startTime;
+  };
+
+  // Returns the index of the channel corresponding to `waveformStreamId` or
+  // `channels()` if there is no such channel
+  std::size_t channelIdx(const std::string &waveformStreamId) const;
+  // Returns the number of channels
+  std::size_t channels() const;
+
+  // Appends the (filtered) `data` of `record` to the pending samples of the
+  // channel with index `channelIdx` and correlates the samples available for
+  // all channels
+  void feedChannel(std::size_t channelIdx, const Record *record,
+                   const DoubleArray &data);
+  // Correlates the time-aligned pending samples of the channels
+  void correlate(const Record *record);
+  // Filters the first `n` pending samples of the channel with index
+  // `channelIdx` (if the channels are filtered jointly)
+  void filterChannel(std::size_t channelIdx, std::size_t n);
+
+  // The channels (the primary component's channel is located at index 0)
+  std::vector<Channel> _channels;
+  filter::MultiChannelCrossCorrelation _multiChannelCrossCorrelation;
+  // The sampling frequency of the data correlated (`0` if not determined,
+  // yet)
+  double _samplingFrequency{0};
+
+  // The Butterworth filter shared by the channels (if any)
+  boost::optional<filter::iir::ButterworthConfig> _filterConfig;
+  // Filters the channels jointly (if the shared filter can be designed for
+  // the sampling frequency)
+  std::unique_ptr<filter::iir::FilterBank> _filterBank;
+
+  // The time window correlated
+  Core::TimeWindow _processed;
+  // The number of samples required to finish initialization
+  std::size_t _neededSamples{0};
+  // The number of samples correlated
+  std::size_t _receivedSamples{0};
+  // Buffer for the coefficients (reused in order to avoid allocations)
+  std::vector<double> _coefficients;
+};
+
+}  // namespace detector
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_DETECTOR_FUSEDTEMPLATEWAVEFORMPROCESSOR_H_
@@ -7,7 +7,6 @@
 #include <unordered_set>
 
 #include "../util/math.h"
-#include "../util/util.h"
 #include "detail.h"
 
 namespace Seiscomp {
@@ -70,6 +69,20 @@ size_t Linker::channelCount() const {
 
 size_t Linker::processorCount() const { return _processors.size(); }
 
+std::size_t Linker::memoryUsage() const {
+  std::size_t ret{0};
+  for (const auto &candidate : _queue) {
+    ret += candidate.memoryUsage();
+  }
+  for (const auto &candidate : _recycled) {
+    ret += candidate.memoryUsage();
+  }
+  ret += _candidatePOTData.offsets.capacity() * sizeof(double) +
+         _candidatePOTData.mask.capacity() / 8;
+  ret += _pot.size() * _pot.size() * sizeof(double);
+  return ret;
+}
+
 void Linker::add(const TemplateWaveformProcessor *proc, const Arrival &arrival,
                  const boost::optional<double> &mergingThreshold) {
   if (proc) {
@@ -84,28 +97,86 @@ void Linker::remove(const std::string &procId) {
 }
 
 void Linker::reset() {
-  _queue.clear();
+  while (!_queue.empty()) {
+    dropCandidate(_queue.begin());
+  }
   _potValid = false;
 }
 
 void Linker::flush() {
   // flush pending events
   while (!_queue.empty()) {
-    const auto event{_queue.front()};
+    const auto &event{_queue.front()};
     if (event.associatedProcessorCount() >=
             _minArrivals.value_or(processorCount()) &&
         (!_thresAssociation || event.association.score >= *_thresAssociation)) {
       emitResult(event.association);
     }
 
-    _queue.pop_front();
+    dropCandidate(_queue.begin());
   }
 }
 
+Linker::Checkpoint Linker::checkpoint() const {
+  const auto now{Core::Time::GMT()};
+
+  Checkpoint ret;
+  ret.candidates.reserve(_queue.size());
+  for (const auto &candidate : _queue) {
+    Checkpoint::Candidate candidateCheckpoint;
+    candidateCheckpoint.onHold =
+        std::max(Core::TimeSpan{0.0}, candidate.expired - now);
+    for (const auto &resultPair : candidate.association.results) {
+      const auto &templateResult{resultPair.second};
+      candidateCheckpoint.results.push_back(Checkpoint::Result{
+          resultPair.first, templateResult.arrival.pick.time,
+          templateResult.matchResult->timeWindow, *templateResult.resultIt});
+    }
+    ret.candidates.push_back(std::move(candidateCheckpoint));
+  }
+  return ret;
+}
+
+std::size_t Linker::restore(const Checkpoint &checkpoint) {
+  const auto now{Core::Time::GMT()};
+
+  std::size_t ret{0};
+  for (const auto &candidateCheckpoint : checkpoint.candidates) {
+    auto &candidate{pushCandidate(now + candidateCheckpoint.onHold)};
+    for (const auto &result : candidateCheckpoint.results) {
+      auto it{_processors.find(result.processorId)};
+      if (it == _processors.end()) {
+        continue;
+      }
+
+      // create a new arrival from a *template arrival*
+      auto arrival{it->second.arrival};
+      arrival.pick.time = result.pickTime;
+
+      auto matchResult{
+          std::make_shared<TemplateWaveformProcessor::MatchResult>()};
+      matchResult->localMaxima.push_back(result.value);
+      matchResult->timeWindow = result.timeWindow;
+
+      candidate.feed(result.processorId,
+                     linker::Association::TemplateResult{
+                         arrival, matchResult->localMaxima.cbegin(),
+                         matchResult});
+    }
+
+    if (candidate.associatedProcessorCount() == 0) {
+      dropCandidate(std::prev(_queue.end()));
+      continue;
+    }
+    ++ret;
+  }
+  return ret;
+}
+
 void Linker::feed(
     const TemplateWaveformProcessor *proc,
-    std::unique_ptr<const TemplateWaveformProcessor::MatchResult> matchResult) {
-  assert((proc && matchResult));
+    std::shared_ptr<const TemplateWaveformProcessor::MatchResult> result) {
+  assert((proc && result));
 
   auto it{_processors.find(proc->id())};
   if (it == _processors.end()) {
@@ -116,8 +187,6 @@ void Linker::feed(
   // create a new arrival from a *template arrival*
   auto newArrival{linkerProc.arrival};
 
-  std::shared_ptr<const TemplateWaveformProcessor::MatchResult> result{
-      std::move(matchResult)};
   // XXX(damb): recompute the pickOffset; the template proc might have
   // changed the underlying template waveform (due to resampling)
   const auto currentPickOffset{linkerProc.arrival.pick.time -
@@ -188,8 +257,8 @@ void Linker::process(const TemplateWaveformProcessor *proc,
       bool newPick{it == candidateTemplateResults.end()};
       if (newPick || resultIt->coefficient > it->second.resultIt->coefficient) {
         if (_thresArrivalOffset) {
-          auto candidatePOTData{
-              createCandidatePOTData(*candidateIt, procId, result)};
+          const auto &candidatePOTData{
+              computeCandidatePOTData(*candidateIt, procId, result)};
           if (!_pot.validateEnabledOffsets(procId, candidatePOTData.offsets,
                                            candidatePOTData.mask,
                                            *_thresArrivalOffset)) {
@@ -203,11 +272,10 @@ void Linker::process(const TemplateWaveformProcessor *proc,
 
   const auto now{Core::Time::GMT()};
   // create new candidate association
-  Candidate newCandidate{now + _onHold};
-  newCandidate.feed(procId, result);
-  _queue.emplace_back(newCandidate);
+  pushCandidate(now + _onHold).feed(procId, result);
 
-  std::vector<CandidateQueue::iterator> ready;
+  auto &ready{_ready};
+  ready.clear();
   for (auto it = std::begin(_queue); it != std::end(_queue); ++it) {
     const auto arrivalCount{it->associatedProcessorCount()};
     // emit results which are ready and surpass threshold
@@ -227,7 +295,7 @@ void Linker::process(const TemplateWaveformProcessor *proc,
 
   // clean up result queue
   for (auto &it : ready) {
-    _queue.erase(it);
+    dropCandidate(it);
   }
 }
 
@@ -248,44 +316,55 @@ void Linker::createPot() {
 
   // XXX(damb): the current implementation simply recreates the POT
   _pot = linker::POT(entries);
+  _potProcessorIds = _pot.processorIds();
   _potValid = true;
 }
 
-Linker::CandidatePOTData Linker::createCandidatePOTData(
+const Linker::CandidatePOTData &Linker::computeCandidatePOTData(
     const Candidate &candidate, const std::string &processorId,
     const linker::Association::TemplateResult &newResult) {
-  auto allProcessorIds{_pot.processorIds()};
   const auto &associatedCandidateTemplateResults{candidate.association.results};
 
-  auto associatedProcessorIds{
-      util::map_keys(associatedCandidateTemplateResults)};
-  std::set<detail::ProcessorIdType> enabledProcessorIds{
-      associatedProcessorIds.begin(), associatedProcessorIds.end()};
-  enabledProcessorIds.emplace(processorId);
-
-  CandidatePOTData ret(allProcessorIds.size());
-  for (std::size_t i{0}; i < allProcessorIds.size(); ++i) {
-    const auto &curProcessorId{allProcessorIds[i]};
-    bool disabled{enabledProcessorIds.find(curProcessorId) ==
-                  enabledProcessorIds.end()};
-    if (disabled) {
+  auto &ret{_candidatePOTData};
+  ret.offsets.assign(_potProcessorIds.size(), linker::POT::tableDefault);
+  ret.mask.assign(_potProcessorIds.size(), false);
+  for (std::size_t i{0}; i < _potProcessorIds.size(); ++i) {
+    const auto &curProcessorId{_potProcessorIds[i]};
+    if (curProcessorId == processorId) {
+      ret.offsets[i] = 0;
+      ret.mask[i] = true;
       continue;
     }
 
-    if (curProcessorId != processorId) {
-      ret.offsets[i] = std::abs(static_cast<double>(
-          associatedCandidateTemplateResults.at(curProcessorId)
-              .arrival.pick.time -
-          newResult.arrival.pick.time));
-    } else {
-      ret.offsets[i] = 0;
+    auto it{associatedCandidateTemplateResults.find(curProcessorId)};
+    if (it == associatedCandidateTemplateResults.end()) {
+      continue;
     }
+
+    ret.offsets[i] = std::abs(static_cast<double>(
+        it->second.arrival.pick.time - newResult.arrival.pick.time));
     ret.mask[i] = true;
   }
 
   return ret;
 }
 
+Linker::Candidate &Linker::pushCandidate(const Core::Time &expired) {
+  if (_recycled.empty()) {
+    _queue.emplace_back(expired);
+  } else {
+    _queue.splice(_queue.end(), _recycled, _recycled.begin());
+    _queue.back().expired = expired;
+  }
+  return _queue.back();
+}
+
+void Linker::dropCandidate(CandidateQueue::iterator it) {
+  // release the match results referenced
+  it->clear();
+  _recycled.splice(_recycled.end(), _queue, it);
+}
+
 /* ------------------------------------------------------------------------- */
 Linker::Candidate::Candidate(const Core::Time &expired) : expired{expired} {}
 
@@ -294,15 +373,20 @@ void Linker::Candidate::feed(const std::string &procId,
   auto &templateResults{association.results};
   templateResults.emplace(procId, res);
 
-  std::vector<double> scores;
+  _scores.clear();
   std::transform(std::begin(templateResults), std::end(templateResults),
-                 std::back_inserter(scores),
+                 std::back_inserter(_scores),
                  [](const linker::Association::TemplateResults::value_type &p) {
                    return p.second.resultIt->coefficient;
                  });
 
   // compute the overall event's score
-  association.score = util::cma(scores.data(), scores.size());
+  association.score = util::cma(_scores.data(), _scores.size());
+}
+
+void Linker::Candidate::clear() {
+  association.results.clear();
+  association.score = 0;
 }
 
 size_t Linker::Candidate::associatedProcessorCount() const {
@@ -313,6 +397,13 @@ bool Linker::Candidate::isExpired(const Core::Time &now) const {
   return now >= expired;
 }
 
+std::size_t Linker::Candidate::memoryUsage() const {
+  return sizeof(Candidate) +
+         association.results.capacity() *
+             sizeof(linker::Association::TemplateResults::value_type) +
+         _scores.capacity() * sizeof(double);
+}
+
 }  // namespace detector
 }  // namespace detect
 }  // namespace Seiscomp
@@ -5,9 +5,12 @@
 #include <seiscomp/core/timewindow.h>
 
 #include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "arrival.h"
 #include "detail.h"
@@ -56,6 +59,9 @@ class Linker {
   size_t channelCount() const;
   // Returns the number of associated processors
   size_t processorCount() const;
+  // Returns the approximate number of bytes allocated for both queued and
+  // recycled candidates and the linker's POT
+  std::size_t memoryUsage() const;
 
   // Register the template waveform processor `proc` associated with the
   // template arrival `arrival` for linking.
@@ -70,10 +76,40 @@ class Linker {
   // Flushes the linker
   void flush();
 
+  // The pending candidate associations
+  struct Checkpoint {
+    struct Result {
+      detail::ProcessorIdType processorId;
+      // The time of the arrival's pick
+      Core::Time pickTime;
+      // The time window of the original match result
+      Core::TimeWindow timeWindow;
+      // The match result value the arrival refers to
+      TemplateWaveformProcessor::MatchResult::Value value;
+    };
+
+    struct Candidate {
+      // The remaining *on hold* duration (w.r.t. the time the checkpoint was
+      // created)
+      Core::TimeSpan onHold;
+      std::vector<Result> results;
+    };
+
+    std::vector<Candidate> candidates;
+  };
+  // Returns the pending candidate associations
+  Checkpoint checkpoint() const;
+  // Restores the pending candidate associations from `checkpoint` (in
+  // addition to the candidates currently pending). The *on hold* duration of
+  // a candidate restored refers to the time of restoring. Results of
+  // processors not registered are discarded. Returns the number of candidates
+  // restored.
+  std::size_t restore(const Checkpoint &checkpoint);
+
   // Feeds the `proc`'s result `res` to the linker
   void feed(const TemplateWaveformProcessor *proc,
-            std::unique_ptr<const TemplateWaveformProcessor::MatchResult>
-                matchResult);
+            std::shared_ptr<const TemplateWaveformProcessor::MatchResult>
+                result);
 
   using PublishResultCallback =
       std::function<void(const linker::Association &)>;
@@ -100,7 +136,11 @@ class Linker {
     explicit CandidatePOTData(std::size_t n)
         : offsets(n, linker::POT::tableDefault), mask(n, false) {}
   };
-  CandidatePOTData createCandidatePOTData(
+  // Computes the POT data of `candidate` extended by `newResult` (from the
+  // processor identified by `processorId`)
+  //
+  // - the returned reference is valid until the next call
+  const CandidatePOTData &computeCandidatePOTData(
       const Candidate &candidate, const std::string &processorId,
       const linker::Association::TemplateResult &newResult);
 
@@ -127,18 +167,42 @@ class Linker {
     // Feeds the template result `res` to the event in order to be merged
     void feed(const std::string &procId,
               const linker::Association::TemplateResult &res);
+    // Clears the candidate (while keeping the capacity of the underlying
+    // containers)
+    void clear();
     // Returns the number of associated processors
     size_t associatedProcessorCount() const;
     // Returns `true` if the event must be considered as expired
     bool isExpired(const Core::Time &now) const;
+    // Returns the approximate number of bytes allocated by the candidate
+    std::size_t memoryUsage() const;
+
+   private:
+    // Scores buffer (reused in order to avoid allocations)
+    std::vector<double> _scores;
   };
 
   using CandidateQueue = std::list<Candidate>;
+  // Appends a candidate to the queue; previously dropped candidates are
+  // recycled
+  Candidate &pushCandidate(const Core::Time &expired);
+  // Drops the candidate referenced by `it` from the queue
+  void dropCandidate(CandidateQueue::iterator it);
+
   CandidateQueue _queue;
+  // Dropped candidates kept for recycling
+  CandidateQueue _recycled;
+  // Buffer for candidates ready to be dropped (reused in order to avoid
+  // allocations)
+  std::vector<CandidateQueue::iterator> _ready;
 
   // The linker's reference POT
   linker::POT _pot;
   bool _potValid{false};
+  // The processor identifiers based on the POT's internal sort order
+  std::vector<detail::ProcessorIdType> _potProcessorIds;
+  // Candidate POT data buffer (reused in order to avoid allocations)
+  CandidatePOTData _candidatePOTData;
 
   // The arrival offset threshold; if `boost::none` arrival offset threshold
   // validation is disabled; the default arrival offset corresponds to twice
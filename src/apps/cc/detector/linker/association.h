@@ -1,8 +1,8 @@
 #ifndef SCDETECT_APPS_CC_DETECTOR_LINKER_ASSOCIATION_H_
 #define SCDETECT_APPS_CC_DETECTOR_LINKER_ASSOCIATION_H_
 
+#include <boost/container/flat_map.hpp>
 #include <functional>
-#include <map>
 #include <memory>
 #include <string>
 
@@ -32,7 +32,11 @@ struct Association {
 
   // Associates `TemplateResult` with a processor (i.e. by means of the
   // processor's identifier)
-  using TemplateResults = std::map<detail::ProcessorIdType, TemplateResult>;
+  //
+  // - a flat map keeps its capacity when cleared which allows associations to
+  // be recycled without allocating
+  using TemplateResults =
+      boost::container::flat_map<detail::ProcessorIdType, TemplateResult>;
   TemplateResults results;
 
   // The association's score [-1,1]
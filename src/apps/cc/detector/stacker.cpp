@@ -0,0 +1,270 @@
+#include "stacker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace Seiscomp {
+namespace detect {
+namespace detector {
+
+Stacker::Stacker(const Core::TimeSpan &onHold) : _onHold{onHold} {}
+
+void Stacker::setThresAssociation(const boost::optional<double> &thres) {
+  _thresAssociation = thres;
+}
+
+boost::optional<double> Stacker::thresAssociation() const {
+  return _thresAssociation;
+}
+
+void Stacker::setMinArrivals(const boost::optional<std::size_t> &n) {
+  auto v{n};
+  if (v && 1 > *v) {
+    v = boost::none;
+  }
+
+  _minArrivals = v;
+}
+
+boost::optional<std::size_t> Stacker::minArrivals() const {
+  return _minArrivals;
+}
+
+void Stacker::setOnHold(const Core::TimeSpan &duration) { _onHold = duration; }
+
+Core::TimeSpan Stacker::onHold() const { return _onHold; }
+
+std::size_t Stacker::processorCount() const { return _processors.size(); }
+
+std::size_t Stacker::memoryUsage() const {
+  std::size_t ret{0};
+  for (const auto &procPair : _processors) {
+    ret += procPair.second.coefficients.size() * sizeof(double);
+  }
+  return ret;
+}
+
+void Stacker::add(const TemplateWaveformProcessor *proc,
+                  const Arrival &arrival) {
+  if (proc) {
+    _processors.emplace(proc->id(), Processor{proc, arrival, {}, _nextIdx});
+  }
+}
+
+void Stacker::remove(const std::string &procId) { _processors.erase(procId); }
+
+void Stacker::reset() {
+  for (auto &procPair : _processors) {
+    procPair.second.coefficients.clear();
+    procPair.second.firstIdx = 0;
+  }
+  _samplingFrequency = 0;
+  _nextIdx = 0;
+  _previous = -1;
+  _notDecreasing = false;
+}
+
+void Stacker::flush() {
+  std::int64_t endIdx{_nextIdx};
+  for (const auto &procPair : _processors) {
+    endIdx = std::max(endIdx, procPair.second.endIdx());
+  }
+  stack(endIdx);
+}
+
+void Stacker::feed(
+    const TemplateWaveformProcessor *proc,
+    std::shared_ptr<const TemplateWaveformProcessor::MatchResult> result) {
+  assert((proc && result));
+
+  auto it{_processors.find(proc->id())};
+  if (it == _processors.end()) {
+    return;
+  }
+
+  const auto &trace{result->coefficientTrace};
+  if (trace.coefficients.empty() || trace.samplingFrequency <= 0) {
+    return;
+  }
+
+  auto &stackerProc{it->second};
+  // recompute the pick offset w.r.t. the template waveform; the template proc
+  // might have changed the underlying template waveform (due to resampling)
+  const auto currentPickOffset{stackerProc.arrival.pick.time -
+                               proc->templateWaveform().startTime()};
+  // shift the coefficient trace by the template moveout
+  const auto originTime{trace.startTime + currentPickOffset -
+                        stackerProc.arrival.pick.offset};
+  if (_samplingFrequency <= 0) {
+    _samplingFrequency = trace.samplingFrequency;
+    _reference = originTime;
+    _nextIdx = 0;
+    for (auto &procPair : _processors) {
+      procPair.second.coefficients.clear();
+      procPair.second.firstIdx = 0;
+    }
+  }
+
+  // coefficient traces with a sampling frequency different from the network
+  // coefficient trace's sampling frequency are sampled by means of the nearest
+  // coefficient
+  const auto offset{static_cast<double>(originTime - _reference) *
+                    _samplingFrequency};
+  const auto ratio{_samplingFrequency / trace.samplingFrequency};
+  auto &coefficients{stackerProc.coefficients};
+  for (std::size_t i{0}; i < trace.coefficients.size(); ++i) {
+    const auto idx{static_cast<std::int64_t>(
+        std::llround(offset + static_cast<double>(i) * ratio))};
+    // drop coefficients stacked, already
+    if (idx < std::max(_nextIdx, stackerProc.endIdx())) {
+      continue;
+    }
+
+    if (coefficients.empty()) {
+      stackerProc.firstIdx = idx;
+    }
+    // gaps are padded
+    while (stackerProc.endIdx() < idx) {
+      coefficients.push_back(std::numeric_limits<double>::quiet_NaN());
+    }
+    coefficients.push_back(trace.coefficients[i]);
+  }
+
+  process();
+}
+
+void Stacker::setResultCallback(const PublishResultCallback &callback) {
+  _resultCallback = callback;
+}
+
+void Stacker::process() {
+  if (_processors.empty()) {
+    return;
+  }
+
+  auto minEndIdx{std::numeric_limits<std::int64_t>::max()};
+  auto maxEndIdx{_nextIdx};
+  for (const auto &procPair : _processors) {
+    const auto endIdx{procPair.second.coefficients.empty()
+                          ? _nextIdx
+                          : procPair.second.endIdx()};
+    minEndIdx = std::min(minEndIdx, endIdx);
+    maxEndIdx = std::max(maxEndIdx, endIdx);
+  }
+
+  stack(minEndIdx);
+  // do not wait for lagging processors longer than the *on hold* duration
+  // w.r.t. record time (i.e. the most recent coefficient fed), such that
+  // replayed data is stacked the same way as real-time data
+  const auto onHold{static_cast<std::int64_t>(
+      std::ceil(static_cast<double>(_onHold) * _samplingFrequency))};
+  stack(maxEndIdx - onHold);
+}
+
+void Stacker::stack(std::int64_t endIdx) {
+  const auto minArrivals{_minArrivals.value_or(processorCount())};
+  for (; _nextIdx < endIdx; ++_nextIdx) {
+    double sum{0};
+    std::size_t count{0};
+    for (const auto &procPair : _processors) {
+      const auto coefficient{procPair.second.coefficient(_nextIdx)};
+      if (std::isfinite(coefficient)) {
+        sum += coefficient;
+        ++count;
+      }
+    }
+
+    if (count > 0 && count >= minArrivals) {
+      const auto score{sum / static_cast<double>(count)};
+      if (score < _previous && _notDecreasing) {
+        emitResult(_nextIdx - 1, _previous);
+      }
+      _notDecreasing = score >= _previous;
+      _previous = score;
+    } else {
+      _previous = -1;
+      _notDecreasing = false;
+    }
+
+    // keep the coefficients of the previous stack index (required for
+    // emitting)
+    for (auto &procPair : _processors) {
+      procPair.second.dropBefore(_nextIdx);
+    }
+  }
+}
+
+void Stacker::emitResult(std::int64_t idx, double score) {
+  if (!_resultCallback ||
+      (_thresAssociation && score < *_thresAssociation)) {
+    return;
+  }
+
+  const auto originTime{
+      _reference +
+      Core::TimeSpan{static_cast<double>(idx) / _samplingFrequency}};
+
+  linker::Association association;
+  association.score = score;
+  for (const auto &procPair : _processors) {
+    const auto &stackerProc{procPair.second};
+    const auto coefficient{stackerProc.coefficient(idx)};
+    if (!std::isfinite(coefficient)) {
+      continue;
+    }
+
+    // create a new arrival from a *template arrival*
+    auto arrival{stackerProc.arrival};
+    arrival.pick.time = originTime + stackerProc.arrival.pick.offset;
+
+    const auto currentPickOffset{
+        stackerProc.arrival.pick.time -
+        stackerProc.proc->templateWaveform().startTime()};
+    const auto startTime{arrival.pick.time - currentPickOffset};
+
+    auto matchResult{
+        std::make_shared<TemplateWaveformProcessor::MatchResult>()};
+    matchResult->localMaxima.push_back(
+        TemplateWaveformProcessor::MatchResult::Value{Core::TimeSpan{0.0},
+                                                      coefficient});
+    matchResult->timeWindow = Core::TimeWindow{startTime, startTime};
+
+    association.results.emplace(
+        procPair.first,
+        linker::Association::TemplateResult{
+            arrival, matchResult->localMaxima.cbegin(), matchResult});
+  }
+
+  if (!association.results.empty()) {
+    _resultCallback.value()(association);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+std::int64_t Stacker::Processor::endIdx() const {
+  return firstIdx + static_cast<std::int64_t>(coefficients.size());
+}
+
+double Stacker::Processor::coefficient(std::int64_t idx) const {
+  if (idx < firstIdx || idx >= endIdx()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return coefficients[static_cast<std::size_t>(idx - firstIdx)];
+}
+
+void Stacker::Processor::dropBefore(std::int64_t idx) {
+  while (!coefficients.empty() && firstIdx < idx) {
+    coefficients.pop_front();
+    ++firstIdx;
+  }
+  if (coefficients.empty()) {
+    firstIdx = std::max(firstIdx, idx);
+  }
+}
+
+}  // namespace detector
+}  // namespace detect
+}  // namespace Seiscomp
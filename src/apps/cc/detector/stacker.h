@@ -0,0 +1,141 @@
+#ifndef SCDETECT_APPS_CC_DETECTOR_STACKER_H_
+#define SCDETECT_APPS_CC_DETECTOR_STACKER_H_
+
+#include <seiscomp/core/datetime.h>
+
+#include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "arrival.h"
+#include "detail.h"
+#include "linker/association.h"
+#include "template_waveform_processor.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace detector {
+
+// Stacks the coefficient traces of `TemplateWaveformProcessor` results
+//
+// - alternative to the `Linker`: the coefficient traces are shifted by the
+// template moveout (i.e. the template arrivals' origin-arrival offsets) and
+// averaged into a network coefficient trace referring to the origin time;
+// local maxima of the network coefficient trace are emitted as associations
+// - processors must provide coefficient traces (see
+// `TemplateWaveformProcessor::setCoefficientTrace()`)
+// - the costs are linear in the number of processors
+class Stacker {
+ public:
+  explicit Stacker(const Core::TimeSpan &onHold = Core::TimeSpan{0.0});
+
+  // Sets the association threshold
+  void setThresAssociation(const boost::optional<double> &thres);
+  // Returns the current association threshold
+  boost::optional<double> thresAssociation() const;
+  // Configures the stacker with a minimum number of processors contributing
+  // to a stacked coefficient
+  void setMinArrivals(const boost::optional<std::size_t> &n);
+  // Returns the minimum number of processors contributing to a stacked
+  // coefficient
+  boost::optional<std::size_t> minArrivals() const;
+  // Sets the *on hold* duration, i.e. the duration (w.r.t. record time)
+  // stacking waits for lagging processors
+  void setOnHold(const Core::TimeSpan &duration);
+  // Returns the current *on hold* duration
+  Core::TimeSpan onHold() const;
+
+  // Returns the number of registered processors
+  std::size_t processorCount() const;
+  // Returns the approximate number of bytes allocated for the coefficients
+  // buffered
+  std::size_t memoryUsage() const;
+
+  // Registers the template waveform processor `proc` associated with the
+  // template arrival `arrival` for stacking
+  void add(const TemplateWaveformProcessor *proc, const Arrival &arrival);
+  // Removes the processor identified by `procId`
+  void remove(const std::string &procId);
+  // Resets the stacker
+  //
+  // - drops all coefficients buffered
+  void reset();
+  // Flushes the stacker, i.e. stacks the coefficients buffered regardless of
+  // lagging processors
+  void flush();
+
+  // Feeds the `proc`'s result `result` to the stacker
+  void feed(const TemplateWaveformProcessor *proc,
+            std::shared_ptr<const TemplateWaveformProcessor::MatchResult>
+                result);
+
+  using PublishResultCallback =
+      std::function<void(const linker::Association &)>;
+  // Sets the publish callback function
+  void setResultCallback(const PublishResultCallback &callback);
+
+ private:
+  struct Processor {
+    const TemplateWaveformProcessor *proc;
+    // The template arrival associated
+    Arrival arrival;
+    // The coefficients not stacked, yet (the first coefficient refers to the
+    // stack index `firstIdx`)
+    std::deque<double> coefficients;
+    std::int64_t firstIdx;
+
+    // Returns the stack index following the last coefficient buffered
+    std::int64_t endIdx() const;
+    // Returns the coefficient referring to the stack index `idx` (NaN if not
+    // available)
+    double coefficient(std::int64_t idx) const;
+    // Drops the coefficients referring to stack indices less than `idx`
+    void dropBefore(std::int64_t idx);
+  };
+
+  // Stacks the coefficients referring to stack indices less than `endIdx`
+  void stack(std::int64_t endIdx);
+  // Stacks the coefficients available for all processors; lagging
+  // processors are waited for at most the *on hold* duration, i.e. the
+  // coefficients preceding the most recent coefficient fed by more than the
+  // *on hold* duration are stacked regardless of lagging processors
+  void process();
+  // Emits the association with regards to the stack index `idx`
+  void emitResult(std::int64_t idx, double score);
+
+  using Processors = std::unordered_map<detail::ProcessorIdType, Processor>;
+  Processors _processors;
+
+  // The sampling frequency of the network coefficient trace (determined by
+  // the first coefficient trace fed)
+  double _samplingFrequency{0};
+  // The origin time referring to the stack index zero
+  Core::Time _reference;
+  // The next stack index to be stacked
+  std::int64_t _nextIdx{0};
+
+  // Local maxima detection state
+  double _previous{-1};
+  bool _notDecreasing{false};
+
+  // The association threshold
+  boost::optional<double> _thresAssociation;
+  // The minimum number of processors contributing to a stacked coefficient
+  boost::optional<std::size_t> _minArrivals;
+  // The maximum time stacking waits for lagging processors
+  Core::TimeSpan _onHold{0.0};
+
+  // The result callback function
+  boost::optional<PublishResultCallback> _resultCallback;
+};
+
+}  // namespace detector
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_DETECTOR_STACKER_H_
@@ -1,11 +1,15 @@
 #include "template_waveform_processor.h"
 
+#include <seiscomp/core/genericrecord.h>
+
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "../log.h"
 #include "../operator/resample.h"
@@ -33,6 +37,12 @@ void LocalMaxima::feed(double coefficient, std::size_t lagIdx) {
   prevCoefficient = coefficient;
 }
 
+void LocalMaxima::clear() {
+  values.clear();
+  prevCoefficient = -1;
+  notDecreasing = false;
+}
+
 }  // namespace detail
 
 TemplateWaveformProcessor::TemplateWaveformProcessor(
@@ -42,6 +52,7 @@ TemplateWaveformProcessor::TemplateWaveformProcessor(
 void TemplateWaveformProcessor::setFilter(std::unique_ptr<Filter> filter,
                                           const Core::TimeSpan &initTime) {
   _streamState.filter = std::move(filter);
+  _filterInitTime = initTime;
   _initTime = std::max(initTime, templateWaveform().configuredEndTime() -
                                      templateWaveform().configuredStartTime());
 }
@@ -56,6 +67,12 @@ void TemplateWaveformProcessor::setResultCallback(
   _resultCallback = callback;
 }
 
+void TemplateWaveformProcessor::setMatchResultPool(
+    std::shared_ptr<MatchResultPool> pool) {
+  assert(pool);
+  _matchResultPool = std::move(pool);
+}
+
 const Core::TimeWindow &TemplateWaveformProcessor::processed() const {
   return _streamState.dataTimeWindow;
 }
@@ -63,6 +80,8 @@ const Core::TimeWindow &TemplateWaveformProcessor::processed() const {
 void TemplateWaveformProcessor::reset() {
   WaveformProcessor::reset(_streamState);
   _crossCorrelation.reset();
+  _filterInput.clear();
+  _pendingCheckpoint = boost::none;
   WaveformProcessor::reset();
 }
 
@@ -88,6 +107,161 @@ const TemplateWaveform &TemplateWaveformProcessor::templateWaveform() const {
   return _crossCorrelation.templateWaveform();
 }
 
+void TemplateWaveformProcessor::setCoarseSearch(std::size_t decimation,
+                                                double threshold) {
+  _crossCorrelation.setCoarseSearch(decimation, threshold);
+}
+
+void TemplateWaveformProcessor::setPrescreen(
+    const boost::optional<double> &threshold) {
+  _crossCorrelation.setPrescreen(threshold);
+}
+
+void TemplateWaveformProcessor::setSubspace(
+    std::vector<TemplateWaveform> members, std::size_t dimension) {
+  _crossCorrelation.setSubspace(std::move(members), dimension);
+}
+
+void TemplateWaveformProcessor::setPartitionedConvolution(
+    std::size_t blockSize) {
+  _crossCorrelation.setPartitionedConvolution(blockSize);
+}
+
+std::size_t TemplateWaveformProcessor::partitionBlockSize() const {
+  return _crossCorrelation.partitionBlockSize();
+}
+
+void TemplateWaveformProcessor::setCorrelationTuner(
+    std::shared_ptr<const CorrelationTuner> tuner) {
+  _correlationTuner = std::move(tuner);
+}
+
+bool TemplateWaveformProcessor::directCorrelation() const {
+  return !_correlationGroup &&
+         _crossCorrelation.coarseSearchDecimation() <= 1 &&
+         !_crossCorrelation.prescreenThreshold() &&
+         _crossCorrelation.subspaceDimension() == 0 &&
+         _crossCorrelation.partitionBlockSize() == 0;
+}
+
+void TemplateWaveformProcessor::setProcessingId(
+    const std::string &processingId) {
+  _processingId = processingId;
+}
+
+const std::string &TemplateWaveformProcessor::processingId() const {
+  return _processingId;
+}
+
+void TemplateWaveformProcessor::setDetectionThreshold(double threshold) {
+  _detectionThreshold = threshold;
+}
+
+double TemplateWaveformProcessor::detectionThreshold() const {
+  return _detectionThreshold;
+}
+
+void TemplateWaveformProcessor::setCorrelationGroup(
+    std::shared_ptr<CorrelationGroup> group, double threshold) {
+  _correlationGroup = std::move(group);
+  _correlationGroupThreshold = threshold;
+}
+
+const CorrelationGroup *TemplateWaveformProcessor::correlationGroup() const {
+  return _correlationGroup.get();
+}
+
+void TemplateWaveformProcessor::setCoefficientTrace(bool enable) {
+  _coefficientTrace = enable;
+}
+
+bool TemplateWaveformProcessor::coefficientTrace() const {
+  return _coefficientTrace;
+}
+
+std::vector<std::string> TemplateWaveformProcessor::componentStreamIds()
+    const {
+  return {};
+}
+
+void TemplateWaveformProcessor::setCheckpointing(bool enable) {
+  _checkpointing = enable;
+  if (!_checkpointing) {
+    _filterInput.set_capacity(0);
+  }
+}
+
+boost::optional<TemplateWaveformProcessor::Checkpoint>
+TemplateWaveformProcessor::checkpoint() const {
+  // a checkpoint not applied, yet, is still valid
+  if (_pendingCheckpoint) {
+    return _pendingCheckpoint->checkpoint;
+  }
+
+  if (!_streamState.initialized || finished()) {
+    return boost::none;
+  }
+
+  Checkpoint ret;
+  ret.samplingFrequency = _streamState.samplingFrequency;
+  ret.dataTimeWindow = _streamState.dataTimeWindow;
+  ret.lastSample = _streamState.lastSample;
+  ret.filterInput.assign(_filterInput.begin(), _filterInput.end());
+  ret.crossCorrelation = _crossCorrelation.state();
+  ret.partitionBlockSize = _crossCorrelation.partitionBlockSize();
+  return ret;
+}
+
+void TemplateWaveformProcessor::restore(Checkpoint checkpoint,
+                                        std::size_t tolerance) {
+  reset();
+  _pendingCheckpoint = PendingCheckpoint{std::move(checkpoint), tolerance};
+}
+
+util::MemoryUsage TemplateWaveformProcessor::memoryUsage() const {
+  util::MemoryUsage ret;
+
+  const auto &templateWaveform{_crossCorrelation.templateWaveform()};
+  const auto &raw{templateWaveform.raw()};
+  const auto &waveform{templateWaveform.waveform()};
+  ret.templateWaveforms = util::byteSize(raw.data());
+  if (&waveform != &raw) {
+    ret.templateWaveforms += util::byteSize(waveform.data());
+  }
+  for (const auto &member : _crossCorrelation.subspaceMembers()) {
+    ret.templateWaveforms += util::byteSize(member.raw().data());
+    if (&member.waveform() != &member.raw()) {
+      ret.templateWaveforms += util::byteSize(member.waveform().data());
+    }
+  }
+
+  ret.crossCorrelation = _crossCorrelation.memoryUsage();
+  ret.filters = _filterInput.capacity() * sizeof(double);
+  if (_pendingCheckpoint) {
+    const auto &checkpoint{_pendingCheckpoint->checkpoint};
+    ret.filters += checkpoint.filterInput.capacity() * sizeof(double);
+    ret.crossCorrelation +=
+        checkpoint.crossCorrelation.buffer.capacity() * sizeof(double);
+  }
+  return ret;
+}
+
+util::MemoryUsage TemplateWaveformProcessor::estimatedMemoryUsage() const {
+  auto ret{memoryUsage()};
+  // the data buffers are sized as soon as the sampling frequency is known
+  ret.crossCorrelation += _crossCorrelation.estimatedMemoryUsage() -
+                          _crossCorrelation.memoryUsage();
+  return ret;
+}
+
+bool TemplateWaveformProcessor::feed(const Record *record) {
+  if (_pendingCheckpoint && record->sampleCount() > 0) {
+    applyCheckpoint(record);
+  }
+
+  return WaveformProcessor::feed(record);
+}
+
 processing::WaveformProcessor::StreamState *
 TemplateWaveformProcessor::streamState(const Record *record) {
   return &_streamState;
@@ -111,22 +285,23 @@ void TemplateWaveformProcessor::process(StreamState &streamState,
         record->startTime() + Core::TimeSpan{record->timeWindow().length() * t};
   }
 
-  detail::LocalMaxima maxima;
+  _maxima.clear();
   for (auto i{static_cast<size_t>(startIdx)}; i < n; ++i) {
-    maxima.feed(filteredData[i], i);
+    _maxima.feed(filteredData[i], i);
   }
 
-  if (maxima.values.empty()) {
+  if (_maxima.values.empty() && !_coefficientTrace) {
     return;
   }
 
   const Core::TimeWindow tw{start, record->endTime()};
-  auto result{util::make_unique<MatchResult>()};
-  for (const auto &m : maxima.values) {
+  auto result{_matchResultPool->acquire()};
+  result->localMaxima.clear();
+  for (const auto &m : _maxima.values) {
     // take cross-correlation filter delay into account i.e. the template
     // processor's result is referring to a time window shifted to the past
-    const auto matchIdx{
-        static_cast<int>(m.lagIdx - templateWaveform().size() + 1)};
+    const auto matchIdx{static_cast<int>(m.lagIdx - templateWaveform().size() +
+                                         1 - _crossCorrelation.latency())};
     const auto t{static_cast<double>(matchIdx) / n};
 
     result->localMaxima.push_back(
@@ -135,6 +310,18 @@ void TemplateWaveformProcessor::process(StreamState &streamState,
 
   result->timeWindow = tw;
 
+  const auto f{_streamState.samplingFrequency};
+  assignCoefficientTrace(
+      *result, filteredData.typedData() + startIdx,
+      n - static_cast<std::size_t>(startIdx),
+      record->startTime() +
+          Core::TimeSpan{(static_cast<double>(startIdx) -
+                          static_cast<double>(templateWaveform().size() +
+                                              _crossCorrelation.latency()) +
+                          1) /
+                         f},
+      f);
+
   emitResult(record, std::move(result));
 }
 
@@ -147,9 +334,27 @@ bool TemplateWaveformProcessor::store(const Record *record) {
 bool TemplateWaveformProcessor::fill(processing::StreamState &streamState,
                                      const Record *record,
                                      DoubleArrayPtr &data) {
+  if (_filterInput.capacity() > 0) {
+    const auto *samples{data->typedData()};
+    for (int i = 0; i < data->size(); ++i) {
+      _filterInput.push_back(samples[i]);
+    }
+  }
+
   if (WaveformProcessor::fill(streamState, record, data)) {
     // cross-correlate filtered data
-    _crossCorrelation.apply(data->size(), data->typedData());
+    const double *screen{nullptr};
+    if (_correlationGroup) {
+      screen = _correlationGroup->screen(
+          _crossCorrelation, record->startTime(), data->typedData(),
+          static_cast<std::size_t>(data->size()));
+    }
+    if (screen) {
+      _crossCorrelation.apply(data->size(), data->typedData(), screen,
+                              _correlationGroupThreshold);
+    } else {
+      _crossCorrelation.apply(data->size(), data->typedData());
+    }
     return true;
   }
   return false;
@@ -161,6 +366,7 @@ void TemplateWaveformProcessor::setupStream(StreamState &streamState,
   const auto f{streamState.samplingFrequency};
   SCDETECT_LOG_DEBUG_PROCESSOR(this, "Initialize stream: sampling_frequency=%f",
                                f);
+
   if (_targetSamplingFrequency && *_targetSamplingFrequency != f) {
     SCDETECT_LOG_DEBUG_PROCESSOR(this,
                                  "Reinitialize stream: sampling_frequency=%f",
@@ -175,16 +381,132 @@ void TemplateWaveformProcessor::setupStream(StreamState &streamState,
     }
   }
 
-  _crossCorrelation.setSamplingFrequency(_targetSamplingFrequency.value_or(f));
+  const auto samplingFrequency{_targetSamplingFrequency.value_or(f)};
+  _crossCorrelation.setSamplingFrequency(samplingFrequency);
+  if (_correlationTuner) {
+    // the template waveform is resampled to the sampling frequency of the
+    // data correlated, already
+    const auto decision{_correlationTuner->lookup(
+        _crossCorrelation.templateWaveform().size(), samplingFrequency)};
+    if (!decision) {
+      SCDETECT_LOG_DEBUG_PROCESSOR(
+          this, "Cross-correlation kernel not tuned: sampling_frequency=%f",
+          samplingFrequency);
+    } else if (decision->blockSize != _crossCorrelation.partitionBlockSize()) {
+      SCDETECT_LOG_DEBUG_PROCESSOR(
+          this, "Tuned cross-correlation kernel: block_size=%zu",
+          decision->blockSize);
+      _crossCorrelation.setPartitionedConvolution(decision->blockSize);
+    }
+  }
+  // the coefficients of the partitioned convolution are delayed
+  streamState.neededSamples += _crossCorrelation.latency();
+
+  _filterInput.clear();
+  if (_checkpointing && streamState.filter) {
+    _filterInput.set_capacity(static_cast<std::size_t>(
+        std::lround(_filterInitTime * streamState.samplingFrequency)));
+  }
+}
+
+void TemplateWaveformProcessor::assignCoefficientTrace(
+    MatchResult &result, const double *coefficients, std::size_t n,
+    const Core::Time &startTime, double samplingFrequency) const {
+  auto &trace{result.coefficientTrace};
+  if (!_coefficientTrace) {
+    trace.coefficients.clear();
+    return;
+  }
+
+  trace.startTime = startTime;
+  trace.samplingFrequency = samplingFrequency;
+  trace.coefficients.assign(coefficients, coefficients + n);
 }
 
 void TemplateWaveformProcessor::emitResult(
-    const Record *record, std::unique_ptr<const MatchResult> result) {
+    const Record *record, std::shared_ptr<const MatchResult> result) {
   if (enabled() && _resultCallback) {
     _resultCallback(this, record, std::move(result));
   }
 }
 
+bool TemplateWaveformProcessor::applyCheckpoint(const Record *record) {
+  const auto pending{std::move(*_pendingCheckpoint)};
+  _pendingCheckpoint = boost::none;
+  const auto &checkpoint{pending.checkpoint};
+
+  // the gap in samples; allow for a jitter of half a sample
+  const auto gap{static_cast<double>(record->startTime() -
+                                     checkpoint.dataTimeWindow.endTime()) *
+                 record->samplingFrequency()};
+  if (gap < -0.5 || gap > static_cast<double>(pending.tolerance) + 0.5) {
+    SCDETECT_LOG_DEBUG_PROCESSOR(
+        this,
+        "%s: discarding checkpoint (data does not continue within tolerance: "
+        "gap=%.1f samples)",
+        record->streamID().c_str(), gap);
+    return false;
+  }
+
+  const auto f{_targetSamplingFrequency.value_or(record->samplingFrequency())};
+  if (f != checkpoint.samplingFrequency) {
+    SCDETECT_LOG_DEBUG_PROCESSOR(
+        this,
+        "%s: discarding checkpoint (sampling frequency changed: %f != %f)",
+        record->streamID().c_str(), f, checkpoint.samplingFrequency);
+    return false;
+  }
+
+  try {
+    setupStream(_streamState, record);
+    // the state refers to the kernel the checkpoint was written with (which
+    // may differ from the kernel tuned)
+    if (checkpoint.partitionBlockSize !=
+        _crossCorrelation.partitionBlockSize()) {
+      _streamState.neededSamples -= _crossCorrelation.latency();
+      _crossCorrelation.setPartitionedConvolution(
+          checkpoint.partitionBlockSize);
+      _streamState.neededSamples += _crossCorrelation.latency();
+    }
+
+    // re-prime the filter by means of replaying the unfiltered data
+    if (_streamState.filter && !checkpoint.filterInput.empty()) {
+      auto samples{checkpoint.filterInput};
+      _streamState.filter->apply(static_cast<int>(samples.size()),
+                                 samples.data());
+    }
+    for (const auto &sample : checkpoint.filterInput) {
+      _filterInput.push_back(sample);
+    }
+
+    _crossCorrelation.restore(checkpoint.crossCorrelation);
+  } catch (std::exception &e) {
+    SCDETECT_LOG_WARNING_PROCESSOR(this, "%s: failed to apply checkpoint: %s",
+                                   record->streamID().c_str(), e.what());
+    reset();
+    return false;
+  }
+
+  _streamState.dataTimeWindow = checkpoint.dataTimeWindow;
+  _streamState.lastSample = checkpoint.lastSample;
+  _streamState.receivedSamples = _streamState.neededSamples;
+  _streamState.initialized = true;
+
+  // the stream state requires a last record (e.g. for gap handling). Therefore,
+  // create a single sample record terminating the checkpointed data.
+  auto lastRecord{util::make_smart<GenericRecord>(
+      record->networkCode(), record->stationCode(), record->locationCode(),
+      record->channelCode(),
+      checkpoint.dataTimeWindow.endTime() - Core::TimeSpan{1. / f}, f)};
+  lastRecord->setData(1, &checkpoint.lastSample, Array::DOUBLE);
+  _streamState.lastRecord = lastRecord;
+
+  SCDETECT_LOG_DEBUG_PROCESSOR(
+      this, "%s: applied checkpoint (end=%s)", record->streamID().c_str(),
+      checkpoint.dataTimeWindow.endTime().iso().c_str());
+  return true;
+}
+
 }  // namespace detector
 }  // namespace detect
 }  // namespace Seiscomp
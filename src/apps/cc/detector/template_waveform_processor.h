@@ -4,6 +4,7 @@
 #include <seiscomp/core/datetime.h>
 #include <seiscomp/core/timewindow.h>
 
+#include <boost/circular_buffer.hpp>
 #include <boost/optional.hpp>
 #include <cstdlib>
 #include <memory>
@@ -11,9 +12,13 @@
 #include <string>
 #include <vector>
 
+#include "../correlation_tuner.h"
 #include "../filter/crosscorrelation.h"
+#include "correlation_group.h"
 #include "../processing/waveform_processor.h"
 #include "../template_waveform.h"
+#include "../util/memory_usage.h"
+#include "../util/object_pool.h"
 
 namespace Seiscomp {
 namespace detect {
@@ -34,6 +39,8 @@ struct LocalMaxima {
   bool notDecreasing{false};
 
   void feed(double coefficient, std::size_t lagIdx);
+  // Resets the state (while keeping the capacity of `values`)
+  void clear();
 };
 
 }  // namespace detail
@@ -59,22 +66,57 @@ class TemplateWaveformProcessor : public processing::WaveformProcessor {
 
     // Time window for w.r.t. the match results
     Core::TimeWindow timeWindow;
+
+    // The coefficient trace (only provided if enabled; see
+    // `setCoefficientTrace()`)
+    struct CoefficientTrace {
+      // The start time of the match the first coefficient refers to (i.e.
+      // w.r.t. the start of the template waveform)
+      Core::Time startTime;
+      double samplingFrequency{0};
+      std::vector<double> coefficients;
+    } coefficientTrace;
   };
   using PublishMatchResultCallback =
       std::function<void(const TemplateWaveformProcessor *, const Record *,
-                         std::unique_ptr<const MatchResult>)>;
+                         std::shared_ptr<const MatchResult>)>;
+  // Pool used for recycling match results
+  using MatchResultPool = util::ObjectPool<MatchResult>;
+
+  // The stream related state of an initialized processor
+  //
+  // - the state of the resampling operator (if any) is not included
+  struct Checkpoint {
+    // The sampling frequency of the data processed
+    double samplingFrequency{0};
+    // The time window processed
+    Core::TimeWindow dataTimeWindow;
+    // The most recent (unfiltered) sample processed
+    double lastSample{0};
+    // The most recent unfiltered samples (limited to the filter's
+    // initialization time) used to re-prime the filter
+    std::vector<double> filterInput;
+    // The state of the cross-correlation filter
+    filter::CrossCorrelation<double>::State crossCorrelation;
+    // The block size of the partitioned cross-correlation the state refers
+    // to (`0` refers to the direct cross-correlation)
+    std::size_t partitionBlockSize{0};
+  };
 
   // Sets `filter` with the corresponding filter `initTime`
   void setFilter(std::unique_ptr<Filter> filter,
                  const Core::TimeSpan &initTime = Core::TimeSpan{0.0});
   // Returns the configured filter or `nullptr` if no filter has been configured
-  const Filter *filter() const;
+  virtual const Filter *filter() const;
 
   // Sets the `callback` in order to publish detections
   void setResultCallback(const PublishMatchResultCallback &callback);
+  // Sets the `pool` match results are allocated from (e.g. in order to share
+  // the pool between the processors of a detector)
+  void setMatchResultPool(std::shared_ptr<MatchResultPool> pool);
 
   // Returns the time window processed and correlated
-  const Core::TimeWindow &processed() const;
+  virtual const Core::TimeWindow &processed() const;
 
   void reset() override;
 
@@ -87,6 +129,92 @@ class TemplateWaveformProcessor : public processing::WaveformProcessor {
   // Returns the underlying template waveform
   const TemplateWaveform &templateWaveform() const;
 
+  // Enables a coarse-to-fine search with regards to the cross-correlation (see
+  // `filter::CrossCorrelation::setCoarseSearch()`); a `decimation` less than
+  // or equal to 1 disables the coarse-to-fine search
+  void setCoarseSearch(std::size_t decimation, double threshold);
+  // Enables a quantized pre-screening with regards to the cross-correlation
+  // (see `filter::CrossCorrelation::setPrescreen()`); passing `boost::none`
+  // disables the pre-screening
+  void setPrescreen(const boost::optional<double> &threshold);
+  // Enables the subspace detector mode with regards to the cross-correlation
+  // (see `filter::CrossCorrelation::setSubspace()`); the processor's template
+  // waveform is the reference the `members` are aligned with
+  void setSubspace(std::vector<TemplateWaveform> members,
+                   std::size_t dimension);
+  // Enables the uniformly partitioned convolution mode with regards to the
+  // cross-correlation (see
+  // `filter::CrossCorrelation::setPartitionedConvolution()`); a `blockSize` of
+  // zero disables the partitioned convolution mode
+  void setPartitionedConvolution(std::size_t blockSize);
+  // Returns the block size of the partitioned convolution (`0` if disabled)
+  std::size_t partitionBlockSize() const;
+  // Sets the `tuner` the cross-correlation kernel is looked up from (see
+  // `CorrelationTuner::lookup()`) whenever the stream is set up, i.e. w.r.t.
+  // the actual sampling frequency of the data correlated (after resampling);
+  // passing `nullptr` disables tuning
+  //
+  // - the kernels are not benchmarked by the processor, i.e. the configured
+  // kernel is kept if the tuner did not decide, yet
+  // - when restoring, the kernel the checkpoint refers to takes precedence
+  void setCorrelationTuner(std::shared_ptr<const CorrelationTuner> tuner);
+  // Returns `true` if the processor computes the exact coefficients by means
+  // of the direct cross-correlation, i.e. neither an approximate search, the
+  // subspace detector mode, the partitioned convolution nor correlation
+  // sharing apply, else `false`
+  virtual bool directCorrelation() const;
+
+  // Sets the identifier of the processing configuration (i.e. processors
+  // with the same processing identifier process identical data)
+  void setProcessingId(const std::string &processingId);
+  // Returns the processing identifier (empty if not configured)
+  const std::string &processingId() const;
+  // Sets the lowest threshold the processor's coefficients are used with
+  void setDetectionThreshold(double threshold);
+  // Returns the detection threshold
+  double detectionThreshold() const;
+  // Shares the cross-correlation of `group`'s representative, i.e. only if
+  // the representative's coefficient is greater than or equal to `threshold`,
+  // the processor's exact coefficient is computed; passing `nullptr` disables
+  // sharing
+  void setCorrelationGroup(std::shared_ptr<CorrelationGroup> group,
+                           double threshold);
+  // Returns the correlation group (`nullptr` if not configured)
+  const CorrelationGroup *correlationGroup() const;
+  // Enables/disables providing the coefficient trace with match results (e.g.
+  // for stacking); if enabled, match results are emitted regardless of
+  // whether local maxima were found
+  void setCoefficientTrace(bool enable);
+  // Returns `true` if the coefficient trace is provided with match results,
+  // else `false`
+  bool coefficientTrace() const;
+
+  // Returns the waveform stream identifiers of additional streams the
+  // processor is fed with (i.e. excluding the waveform stream identifier the
+  // processor was registered for)
+  virtual std::vector<std::string> componentStreamIds() const;
+
+  // Enables/disables recording the unfiltered data required for checkpointing
+  // the filter state
+  void setCheckpointing(bool enable);
+  // Returns a checkpoint of the processor's stream related state or
+  // `boost::none` if the processor is not initialized, yet
+  virtual boost::optional<Checkpoint> checkpoint() const;
+  // Restores the processor from `checkpoint` with the next record fed. If the
+  // record does not continue the data processed (i.e. the record overlaps
+  // with the data processed or more than `tolerance` samples are missing) or
+  // the sampling frequency changed the checkpoint is discarded and the
+  // processor is initialized as usual.
+  virtual void restore(Checkpoint checkpoint, std::size_t tolerance);
+
+  // Returns the processor's approximate memory usage
+  virtual util::MemoryUsage memoryUsage() const;
+  // Returns the processor's approximate memory usage once the data buffers
+  // are sized (i.e. after the stream's sampling frequency is known)
+  virtual util::MemoryUsage estimatedMemoryUsage() const;
+
+  bool feed(const Record *record) override;
+
  protected:
   WaveformProcessor::StreamState *streamState(const Record *record) override;
 
@@ -101,9 +229,24 @@ class TemplateWaveformProcessor : public processing::WaveformProcessor {
   void setupStream(StreamState &streamState, const Record *record) override;
 
   void emitResult(const Record *record,
-                  std::unique_ptr<const MatchResult> result);
+                  std::shared_ptr<const MatchResult> result);
+  // Assigns the `n` `coefficients` (where the first coefficient refers to
+  // the match starting at `startTime`) to `result` if the coefficient trace
+  // is enabled
+  void assignCoefficientTrace(MatchResult &result, const double *coefficients,
+                              std::size_t n, const Core::Time &startTime,
+                              double samplingFrequency) const;
+
+  std::shared_ptr<MatchResultPool> _matchResultPool{
+      std::make_shared<MatchResultPool>()};
+  // Local maxima buffer (reused in order to avoid allocations)
+  detail::LocalMaxima _maxima;
 
  private:
+  // Applies the pending checkpoint with regards to `record`. Returns `true` if
+  // the checkpoint was applied, else `false`.
+  bool applyCheckpoint(const Record *record);
+
   StreamState _streamState;
 
   PublishMatchResultCallback _resultCallback;
@@ -112,6 +255,28 @@ class TemplateWaveformProcessor : public processing::WaveformProcessor {
   boost::optional<double> _targetSamplingFrequency;
   // The in-place cross-correlation filter
   filter::CrossCorrelation<double> _crossCorrelation;
+
+  std::string _processingId;
+  double _detectionThreshold{-1};
+  // The optional correlation group the cross-correlation is shared with
+  std::shared_ptr<CorrelationGroup> _correlationGroup;
+  double _correlationGroupThreshold{0};
+  bool _coefficientTrace{false};
+  // The optional tuner the cross-correlation kernel is selected with
+  std::shared_ptr<const CorrelationTuner> _correlationTuner;
+
+  // The filter initialization time
+  Core::TimeSpan _filterInitTime;
+  bool _checkpointing{false};
+  // The most recent unfiltered samples (used for checkpointing)
+  boost::circular_buffer<double> _filterInput;
+
+  struct PendingCheckpoint {
+    Checkpoint checkpoint;
+    // The maximum number of samples missing
+    std::size_t tolerance;
+  };
+  boost::optional<PendingCheckpoint> _pendingCheckpoint;
 };
 
 }  // namespace detector
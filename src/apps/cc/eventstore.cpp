@@ -1,16 +1,20 @@
 #include "eventstore.h"
 
+#include <seiscomp/datamodel/amplitude.h>
 #include <seiscomp/datamodel/databasequery.h>
 #include <seiscomp/datamodel/databasereader.h>
 #include <seiscomp/datamodel/event.h>
 #include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/magnitude.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/originreference.h>
+#include <seiscomp/datamodel/pick.h>
 #include <seiscomp/datamodel/publicobject.h>
+#include <seiscomp/datamodel/stationmagnitude.h>
 #include <seiscomp/io/archive/xmlarchive.h>
-#include <seiscomp/io/database.h>
 
 #include <vector>
 
-#include "datamodel/ddl.h"
 #include "log.h"
 #include "util/memory.h"
 
@@ -96,9 +100,9 @@ void EventStore::load(const boost::filesystem::path &path) {
 }
 
 void EventStore::load(DataModel::EventParameters *ep) {
-  auto db_query{
-      util::make_smart<DataModel::DatabaseQuery>(createInMemoryDb(ep).get())};
-  load(db_query.get());
+  reset();
+  _ep = ep;
+  index(ep);
 }
 
 void EventStore::load(DataModel::DatabaseQuery *db) {
@@ -108,12 +112,25 @@ void EventStore::load(DataModel::DatabaseQuery *db) {
 }
 
 void EventStore::reset() {
+  _publicObjectIdx.clear();
+  _eventIdx.clear();
+  _ep.reset();
+
   _cache.clear();
   _cache.setDatabaseArchive(nullptr);
   _dbQuery.reset();
 }
 
 DataModel::EventPtr EventStore::getEvent(const std::string &originId) const {
+  if (_ep) {
+    auto it{_eventIdx.find(originId)};
+    return it != std::end(_eventIdx) ? it->second : nullptr;
+  }
+
+  if (!_dbQuery) {
+    return nullptr;
+  }
+
   auto event{_dbQuery->getEvent(originId)};
   if (event) {
     _cache.feed(event);
@@ -122,9 +139,23 @@ DataModel::EventPtr EventStore::getEvent(const std::string &originId) const {
   return nullptr;
 }
 
+std::size_t EventStore::eventCount() const {
+  return _ep ? _ep->eventCount() : 0;
+}
+
 DataModel::PublicObject *EventStore::get(const Core::RTTI &classType,
                                          const std::string &publicId,
                                          bool loadChildren) const {
+  if (_ep) {
+    // objects loaded from SCML always include their children
+    auto it{_publicObjectIdx.find(publicId)};
+    if (it != std::end(_publicObjectIdx) &&
+        it->second->typeInfo().isTypeOf(classType)) {
+      return it->second;
+    }
+    return nullptr;
+  }
+
   auto retval{_cache.find(classType, publicId, loadChildren)};
   if (retval) {
     return retval;
@@ -146,23 +177,41 @@ DataModel::EventParametersPtr EventStore::loadXMLArchive(
   return ep;
 }
 
-IO::DatabaseInterfacePtr EventStore::createInMemoryDb(
-    DataModel::EventParameters *ep) {
-  IO::DatabaseInterfacePtr dbEngineWrite{
-      IO::DatabaseInterface::Open("sqlite3_://:memory:")};
-  if (!dbEngineWrite) {
-    throw EventStore::DatabaseException{
-        "failed to initialize SQLite in-memory DB"};
+void EventStore::index(DataModel::EventParameters *ep) {
+  if (!ep) {
+    return;
+  }
+
+  for (std::size_t i{0}; i < ep->pickCount(); ++i) {
+    index(ep->pick(i));
+  }
+  for (std::size_t i{0}; i < ep->amplitudeCount(); ++i) {
+    index(ep->amplitude(i));
+  }
+  for (std::size_t i{0}; i < ep->originCount(); ++i) {
+    auto origin{ep->origin(i)};
+    index(origin);
+    for (std::size_t j{0}; j < origin->magnitudeCount(); ++j) {
+      index(origin->magnitude(j));
+    }
+    for (std::size_t j{0}; j < origin->stationMagnitudeCount(); ++j) {
+      index(origin->stationMagnitude(j));
+    }
+  }
+  for (std::size_t i{0}; i < ep->eventCount(); ++i) {
+    auto event{ep->event(i)};
+    index(event);
+    for (std::size_t j{0}; j < event->originReferenceCount(); ++j) {
+      _eventIdx.emplace(event->originReference(j)->originID(), event);
+    }
+  }
+}
+
+void EventStore::index(DataModel::PublicObject *po) {
+  if (!_publicObjectIdx.emplace(po->publicID(), po).second) {
+    SCDETECT_LOG_WARNING("Duplicate public object identifier: %s",
+                         po->publicID().c_str());
   }
-  DataModel::createAll(dbEngineWrite.get());
-  DataModel::DatabaseArchive dbArchive{dbEngineWrite.get()};
-  DataModel::DatabaseObjectWriter writer{dbArchive};
-  writer(ep);
-
-  // XXX(damb): Create a separate interface - `dbEngineWrite` is going to be
-  // closed by the `dbArchive` instance when going out of scope.
-  IO::DatabaseInterfacePtr dbEngineRead{dbEngineWrite};
-  return dbEngineRead;
 }
 
 }  // namespace detect
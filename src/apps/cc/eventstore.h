@@ -13,6 +13,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "exception.h"
@@ -43,6 +44,8 @@ class PublicObjectBuffer : public DataModel::PublicObjectCache {
 
 // An utility interface to access event parameters
 // - implements the Singleton Design Pattern
+// - event parameters loaded from SCML are indexed in-memory; else objects are
+// loaded from the database on demand
 class EventStore {
  public:
   class BaseException : public Exception {
@@ -96,6 +99,12 @@ class EventStore {
   // Returns the event for a given `originId` if any
   DataModel::EventPtr getEvent(const std::string &originId) const;
 
+  // Returns the number of events loaded
+  //
+  // - events are loaded from a database on demand, i.e. they are not taken
+  // into account
+  std::size_t eventCount() const;
+
  protected:
   DataModel::PublicObject *get(const Core::RTTI &classType,
                                const std::string &publicId,
@@ -103,13 +112,21 @@ class EventStore {
 
   DataModel::EventParametersPtr loadXMLArchive(const std::string &path);
 
-  // Create an in-memory SQLite DB populated with `ep` and return the
-  // corresponding pointer to the database engine created
-  IO::DatabaseInterfacePtr createInMemoryDb(DataModel::EventParameters *ep);
+  // Indexes the public objects of `ep`
+  void index(DataModel::EventParameters *ep);
+  // Indexes `po` by means of its public identifier
+  void index(DataModel::PublicObject *po);
 
  private:
   EventStore() {}
 
+  // Event parameters loaded from SCML
+  DataModel::EventParametersPtr _ep;
+  // Public objects of `_ep` indexed by public identifier
+  std::unordered_map<std::string, DataModel::PublicObject *> _publicObjectIdx;
+  // Events of `_ep` indexed by the identifiers of the associated origins
+  std::unordered_map<std::string, DataModel::Event *> _eventIdx;
+
   DataModel::DatabaseQueryPtr _dbQuery;
   mutable detail::PublicObjectBuffer _cache;
 
@@ -7,9 +7,15 @@
 
 #include <boost/circular_buffer.hpp>
 #include <boost/optional/optional.hpp>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "../template_waveform.h"
+#include "fft.h"
+#include "subspace.h"
 
 namespace Seiscomp {
 namespace detect {
@@ -17,9 +23,15 @@ namespace filter {
 
 // Cross-correlation filter implementation
 //
-// - the filter delay corresponds to the length of the template waveform
+// - the filter delay corresponds to the length of the template waveform (plus
+// the `latency()`)
 // - automatically adopts to different sampling frequencies (i.e. implements
 // template waveform resampling facilities)
+// - optionally, implements a coarse-to-fine search (see `setCoarseSearch()`)
+// - optionally, implements a quantized pre-screening (see `setPrescreen()`)
+// - optionally, implements a subspace detector (see `setSubspace()`)
+// - optionally, implements a uniformly partitioned convolution (see
+// `setPartitionedConvolution()`)
 template <typename TData>
 class CrossCorrelation {
  public:
@@ -33,6 +45,17 @@ class CrossCorrelation {
 
   virtual ~CrossCorrelation() = default;
 
+  // The data related state of the filter
+  struct State {
+    // The buffered data samples (ordered from the oldest to the most recent
+    // sample)
+    std::vector<TData> buffer;
+    // The data samples summed
+    double sumData{0};
+    // The data samples squared summed
+    double sumSquaredData{0};
+  };
+
   // Apply the cross-correlation in place to the (previously filtered) data.
   // Before using the filter make sure the sam
   void apply(size_t nData, TData *data);
@@ -40,6 +63,13 @@ class CrossCorrelation {
   void apply(std::vector<TData> &data);
 
   void apply(TypedArray<TData> &data);
+  // Applies the cross-correlation in place to `data` screened by the `screen`
+  // coefficients (i.e. the coefficients of a similar template waveform
+  // correlated against the same data). Only if the screen coefficient is
+  // greater than or equal to `threshold`, the exact coefficient is computed.
+  // Else, the screen coefficient is returned.
+  void apply(size_t nData, TData *data, const double *screen,
+             double threshold);
   // Reset the cross-correlation filter
   virtual void reset();
 
@@ -49,19 +79,143 @@ class CrossCorrelation {
   // Returns the configured sampling frequency
   double samplingFrequency() const;
 
+  // Enables a coarse-to-fine search, i.e. every `decimation`th lag the data
+  // decimated by `decimation` is correlated against the template waveform
+  // decimated by `decimation`. Only if the coarse coefficient is greater
+  // than or equal to `threshold`, the exact coefficients are computed for the
+  // subsequent `2 * decimation` lags. Else, the coarse coefficient is
+  // returned.
+  //
+  // - a `decimation` less than or equal to 1 disables the coarse-to-fine
+  // search
+  // - `decimation` must be small compared to the width of the correlation
+  // peaks (i.e. the data must be oversampled w.r.t. the filter passband)
+  // - the coefficients returned for lags not refined are below `threshold`,
+  // i.e. `threshold` must not exceed the detection threshold
+  void setCoarseSearch(std::size_t decimation, double threshold);
+  // Returns the decimation factor of the coarse search (`1` if disabled)
+  std::size_t coarseSearchDecimation() const;
+
+  // Enables a quantized pre-screening, i.e. both the data and the template
+  // waveform are quantized to 16 bit integers and correlated by means of
+  // integer arithmetics. Only if the approximate coefficient is greater than or
+  // equal to `threshold`, the exact coefficient is computed. Else, the
+  // approximate coefficient is returned.
+  //
+  // - the template waveform is quantized with a single scale while the data is
+  // quantized with a scale per block of `util::kQuantizedBlockSize` samples
+  // - passing `boost::none` disables the pre-screening
+  void setPrescreen(const boost::optional<double> &threshold);
+  // Returns the pre-screening threshold (`boost::none` if disabled)
+  const boost::optional<double> &prescreenThreshold() const;
+
+  // Enables the subspace detector mode, i.e. the template waveform and the
+  // `members`' template waveforms are aligned and the singular value
+  // decomposition is used to compute a basis of dimension `dimension`. Instead
+  // of the correlation coefficient, the fraction of the data's energy
+  // projected onto the subspace (`[0, 1]`) is returned.
+  //
+  // - the basis is recomputed whenever the sampling frequency changes
+  // - both the coarse-to-fine search and the pre-screening do not apply in
+  // subspace detector mode
+  // - passing a `dimension` of zero disables the subspace detector mode
+  void setSubspace(std::vector<TemplateWaveform> members,
+                   std::size_t dimension);
+  // Returns the subspace basis (empty if the subspace detector mode is
+  // disabled)
+  const subspace::Basis &subspaceBasis() const;
+  // Returns the subspace members' template waveforms
+  const std::vector<TemplateWaveform> &subspaceMembers() const;
+  // Returns the configured subspace dimension (`0` if the subspace detector
+  // mode is disabled)
+  std::size_t subspaceDimension() const;
+
+  // Enables the uniformly partitioned convolution mode, i.e. the template
+  // waveform is split into partitions of `blockSize` samples and the data is
+  // correlated block-wise in the frequency domain (overlap-save). The
+  // coefficients are exact (up to round-off errors), but delayed by
+  // `blockSize` samples (see `latency()`), i.e. the latency is bounded by the
+  // block size instead of the length of the template waveform.
+  //
+  // - `blockSize` is rounded up to the next power of two
+  // - the coarse-to-fine search, the pre-screening and the shared screening do
+  // not apply in partitioned convolution mode; the subspace detector mode
+  // takes precedence
+  // - passing a `blockSize` of zero disables the partitioned convolution mode
+  void setPartitionedConvolution(std::size_t blockSize);
+  // Returns the block size of the partitioned convolution (`0` if disabled)
+  std::size_t partitionBlockSize() const;
+  // Returns the number of samples the coefficients are delayed by in addition
+  // to the filter delay
+  std::size_t latency() const;
+
   const TemplateWaveform &templateWaveform() const;
 
+  // Returns the filter's current data related state
+  State state() const;
+  // Restores the filter's data related state from `state`
+  //
+  // - throws `BaseException` if the size of the buffered data does not match
+  // the size of the (resampled) template waveform (plus the `latency()`)
+  void restore(const State &state);
+  // Returns `true` if the buffered data equals the buffered data of `state`,
+  // else `false`
+  bool matches(const State &state) const;
+  // Returns the revision of the data related state, i.e. a value changed
+  // whenever the state is modified
+  //
+  // - applying data increments the revision by one (regardless of the number
+  // of samples)
+  // - revisions are unique across filter instances (unless copied)
+  std::uint64_t revision() const;
+
+  // Returns the number of bytes allocated for buffering data (including the
+  // subspace members' waveforms)
+  std::size_t memoryUsage() const;
+  // Returns the number of bytes expected to be allocated for buffering data
+  // once the filter is initialized (i.e. `memoryUsage()` if initialized,
+  // already). If not initialized, the estimate refers to the template
+  // waveform's current sampling frequency.
+  std::size_t estimatedMemoryUsage() const;
+
  protected:
   // Compute the actual cross-correlation
   virtual void correlate(size_t nData, TData *data);
+  // Returns the coarse coefficient w.r.t. the buffered data
+  double correlateCoarse() const;
+  // Returns the approximate sum of the template waveform samples multiplied
+  // with the buffered data samples (computed from the quantized samples)
+  double correlateQuantized() const;
+  // Appends `sample` to the quantized data
+  void pushQuantized(TData sample);
+  // Quantizes the buffered data from scratch
+  void resetQuantized();
+  // Returns the sum of the squared projections of the buffered data onto the
+  // subspace basis vectors
+  double correlateSubspace() const;
+  // Computes the subspace basis w.r.t. `samplingFrequency`
+  void setupSubspace(double samplingFrequency);
+  // Appends `sample` to the current data block and returns the sum of the
+  // template waveform samples multiplied with the data samples `latency()`
+  // samples ago
+  double correlatePartitioned(TData sample);
+  // Computes the spectra of the template waveform partitions
+  void setupPartitioned();
+  // Resets the frequency-domain delay line and the pending sums
+  void resetPartitioned();
 
   virtual void setupFilter(double samplingFrequency);
 
  private:
+  // Returns the initial revision of a filter instance
+  static std::uint64_t initialRevision();
+
   // The template waveform
   TemplateWaveform _templateWaveform;
   // Buffer for data to be cross-correlated
   boost::circular_buffer<TData> _buffer;
+  // The revision of the data related state (see `revision()`)
+  std::uint64_t _revision{initialRevision()};
 
   // Template waveform samples squared summed
   double _sumSquaredTemplateWaveform{0};
@@ -75,6 +229,65 @@ class CrossCorrelation {
   // The data samples summed
   double _sumData{0};
 
+  // Coarse-to-fine search related configuration and state
+  std::size_t _coarseDecimation{1};
+  double _coarseThreshold{0};
+  // Decimated template waveform (aligned with the most recent sample) samples
+  // summed
+  double _coarseSumTemplateWaveform{0};
+  double _coarseDenominatorTemplateWaveform{0};
+  // The number of lags until the next coarse coefficient is computed
+  std::size_t _coarseCountdown{0};
+  // The number of lags to be computed at full rate
+  std::size_t _refineCount{0};
+  // The most recent coarse coefficient
+  double _coarseCoefficient{0};
+
+  // Pre-screening related configuration and state
+  boost::optional<double> _prescreenThreshold;
+  // The quantized template waveform
+  std::vector<std::int16_t> _quantizedTemplateWaveform;
+  double _quantizedTemplateWaveformScale{0};
+  // The quantized data (the most recent samples are located at the end)
+  std::vector<std::int16_t> _quantizedData;
+  // The inverse scales of the data blocks covering the buffered data (the
+  // most recent block is located at the end)
+  boost::circular_buffer<double> _quantizedDataInverseScales;
+  // The samples of the current (i.e. the most recent) data block
+  std::vector<TData> _quantizedDataBlock;
+  // The absolute maximum of the samples of the current data block
+  double _quantizedDataBlockAbsMax{0};
+  // The number of data samples quantized since the quantized data was reset
+  std::size_t _quantizedDataCount{0};
+
+  // The screen coefficients (only valid while applying the filter)
+  const double *_screen{nullptr};
+  double _screenThreshold{0};
+
+  // Subspace detector related configuration and state
+  std::vector<TemplateWaveform> _subspaceMembers;
+  std::size_t _subspaceDimension{0};
+  subspace::Basis _subspaceBasis;
+
+  // Uniformly partitioned convolution related configuration and state
+  std::size_t _partitionBlockSize{0};
+  fft::RealFFT _partitionFFT;
+  // The spectra of the (time reversed) template waveform partitions (`blockSize
+  // + 1` bins per partition)
+  std::vector<std::complex<double>> _partitionSpectra;
+  // The spectra of the most recent data blocks, i.e. the frequency-domain
+  // delay line (`_partitionPosition` refers to the most recent block)
+  std::vector<std::complex<double>> _partitionDelayLine;
+  std::size_t _partitionPosition{0};
+  // The previous and the current data block
+  std::vector<double> _partitionInput;
+  std::size_t _partitionInputCount{0};
+  // The accumulated spectrum and its inverse
+  std::vector<std::complex<double>> _partitionSpectrum;
+  std::vector<double> _partitionOutput;
+  // The sums computed, but not returned, yet
+  boost::circular_buffer<double> _partitionPending;
+
   bool _initialized{false};
 };
 
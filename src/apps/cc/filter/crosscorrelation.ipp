@@ -5,12 +5,15 @@
 #include <seiscomp/core/timewindow.h>
 
 #include <boost/algorithm/string/join.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cfenv>
 #include <cmath>
 
 #include "../filter.h"
 #include "../log.h"
 #include "../util/math.h"
+#include "../util/quantize.h"
 
 namespace Seiscomp {
 namespace detect {
@@ -45,8 +48,23 @@ void CrossCorrelation<TData>::apply(TypedArray<TData> &data) {
   apply(data.size(), data.typedData());
 }
 
+template <typename TData>
+void CrossCorrelation<TData>::apply(size_t nData, TData *data,
+                                    const double *screen, double threshold) {
+  _screen = screen;
+  _screenThreshold = threshold;
+  try {
+    correlate(nData, data);
+  } catch (...) {
+    _screen = nullptr;
+    throw;
+  }
+  _screen = nullptr;
+}
+
 template <typename TData>
 void CrossCorrelation<TData>::reset() {
+  ++_revision;
   _buffer.clear();
 
   _sumSquaredData = 0;
@@ -67,10 +85,42 @@ void CrossCorrelation<TData>::reset() {
       std::sqrt(n * _sumSquaredTemplateWaveform -
                 _sumTemplateWaveform * _sumTemplateWaveform);
 
-  _buffer.set_capacity(n);
+  _buffer.set_capacity(n + latency());
   while (!_buffer.full()) {
     _buffer.push_back(0);
   }
+
+  _coarseCountdown = 0;
+  _refineCount = 0;
+  _coarseCoefficient = 0;
+  _coarseSumTemplateWaveform = 0;
+  _coarseDenominatorTemplateWaveform = 0;
+  if (_coarseDecimation > 1) {
+    double sumSquared{0};
+    std::size_t nCoarse{0};
+    // the decimated samples are aligned with the most recent sample
+    for (auto k{static_cast<std::size_t>(n)}; k > 0;
+         k = k > _coarseDecimation ? k - _coarseDecimation : 0) {
+      _coarseSumTemplateWaveform += samples_template_wf[k - 1];
+      sumSquared += util::square(samples_template_wf[k - 1]);
+      ++nCoarse;
+    }
+    _coarseDenominatorTemplateWaveform =
+        std::sqrt(nCoarse * sumSquared -
+                  _coarseSumTemplateWaveform * _coarseSumTemplateWaveform);
+  }
+
+  _quantizedTemplateWaveform.clear();
+  _quantizedTemplateWaveformScale = 0;
+  if (_prescreenThreshold && latency() == 0) {
+    _quantizedTemplateWaveform.resize(n);
+    _quantizedTemplateWaveformScale = util::quantize(
+        samples_template_wf, n, _quantizedTemplateWaveform.data());
+  }
+  resetQuantized();
+
+  setupPartitioned();
+  resetPartitioned();
 }
 
 template <typename TData>
@@ -88,6 +138,199 @@ double CrossCorrelation<TData>::samplingFrequency() const {
   return _templateWaveform.samplingFrequency();
 }
 
+template <typename TData>
+void CrossCorrelation<TData>::setCoarseSearch(std::size_t decimation,
+                                              double threshold) {
+  _coarseDecimation = std::max(decimation, std::size_t{1});
+  _coarseThreshold = threshold;
+  if (_initialized) {
+    reset();
+  }
+}
+
+template <typename TData>
+std::size_t CrossCorrelation<TData>::coarseSearchDecimation() const {
+  return _coarseDecimation;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::setPrescreen(
+    const boost::optional<double> &threshold) {
+  _prescreenThreshold = threshold;
+  if (_initialized) {
+    reset();
+  }
+}
+
+template <typename TData>
+const boost::optional<double> &CrossCorrelation<TData>::prescreenThreshold()
+    const {
+  return _prescreenThreshold;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::setSubspace(std::vector<TemplateWaveform> members,
+                                          std::size_t dimension) {
+  _subspaceMembers = std::move(members);
+  _subspaceDimension = dimension;
+  _subspaceBasis = subspace::Basis{};
+  if (_initialized) {
+    // the subspace detector mode takes precedence over the partitioned
+    // convolution mode (which affects the buffer size)
+    if (_partitionBlockSize > 0) {
+      reset();
+    }
+    setupSubspace(samplingFrequency());
+  }
+}
+
+template <typename TData>
+const subspace::Basis &CrossCorrelation<TData>::subspaceBasis() const {
+  return _subspaceBasis;
+}
+
+template <typename TData>
+const std::vector<TemplateWaveform> &CrossCorrelation<TData>::subspaceMembers()
+    const {
+  return _subspaceMembers;
+}
+
+template <typename TData>
+std::size_t CrossCorrelation<TData>::subspaceDimension() const {
+  return _subspaceDimension;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::setPartitionedConvolution(std::size_t blockSize) {
+  // the real FFT requires sequences of at least 4 samples
+  _partitionBlockSize =
+      blockSize > 0 ? std::max(fft::nextPowerOfTwo(blockSize), std::size_t{2})
+                    : 0;
+  if (_initialized) {
+    reset();
+  }
+}
+
+template <typename TData>
+std::size_t CrossCorrelation<TData>::partitionBlockSize() const {
+  return _partitionBlockSize;
+}
+
+template <typename TData>
+std::size_t CrossCorrelation<TData>::latency() const {
+  return _subspaceDimension == 0 ? _partitionBlockSize : 0;
+}
+
+template <typename TData>
+typename CrossCorrelation<TData>::State CrossCorrelation<TData>::state() const {
+  State ret;
+  ret.buffer.assign(_buffer.begin(), _buffer.end());
+  ret.sumData = _sumData;
+  ret.sumSquaredData = _sumSquaredData;
+  return ret;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::restore(const State &state) {
+  if (!_initialized) {
+    throw BaseException{
+        "failed to restore cross-correlation filter: not initialized"};
+  }
+
+  if (state.buffer.size() != _buffer.capacity()) {
+    throw BaseException{
+        "failed to restore cross-correlation filter: buffer size mismatch "
+        "(expected=" +
+        std::to_string(_buffer.capacity()) +
+        ", got=" + std::to_string(state.buffer.size()) + ")"};
+  }
+
+  ++_revision;
+  _buffer.assign(state.buffer.begin(), state.buffer.end());
+  _sumData = state.sumData;
+  _sumSquaredData = state.sumSquaredData;
+
+  // the coarse search state is not part of the state; restart the coarse search
+  // with the next lag
+  _coarseCountdown = 0;
+  _refineCount = 0;
+
+  resetQuantized();
+
+  // the frequency-domain delay line is not part of the state; replay the
+  // buffered data (which covers the template waveform length plus the latency)
+  resetPartitioned();
+  if (latency() > 0) {
+    for (const auto &sample : _buffer) {
+      correlatePartitioned(sample);
+    }
+  }
+}
+
+template <typename TData>
+std::uint64_t CrossCorrelation<TData>::revision() const {
+  return _revision;
+}
+
+template <typename TData>
+std::uint64_t CrossCorrelation<TData>::initialRevision() {
+  static std::atomic<std::uint64_t> instances{0};
+  return ++instances << 32;
+}
+
+template <typename TData>
+bool CrossCorrelation<TData>::matches(const State &state) const {
+  return state.buffer.size() == _buffer.size() &&
+         std::equal(_buffer.begin(), _buffer.end(), state.buffer.begin());
+}
+
+template <typename TData>
+std::size_t CrossCorrelation<TData>::memoryUsage() const {
+  std::size_t subspaceMembers{0};
+  for (const auto &member : _subspaceMembers) {
+    subspaceMembers += member.memoryUsage();
+  }
+  return subspaceMembers + _buffer.capacity() * sizeof(TData) +
+         _quantizedData.capacity() * sizeof(std::int16_t) +
+         _quantizedTemplateWaveform.capacity() * sizeof(std::int16_t) +
+         _subspaceBasis.vectors.capacity() * sizeof(double) +
+         (_partitionSpectra.capacity() + _partitionDelayLine.capacity() +
+          _partitionSpectrum.capacity()) *
+             sizeof(std::complex<double>) +
+         (_partitionInput.capacity() + _partitionOutput.capacity() +
+          _partitionPending.capacity()) *
+             sizeof(double) +
+         _partitionFFT.memoryUsage();
+}
+
+template <typename TData>
+std::size_t CrossCorrelation<TData>::estimatedMemoryUsage() const {
+  if (_initialized) {
+    return memoryUsage();
+  }
+
+  const auto n{_templateWaveform.size()};
+  std::size_t ret{(n + _partitionBlockSize) * sizeof(TData)};
+  if (_subspaceDimension > 0) {
+    ret += _subspaceDimension * n * sizeof(double);
+  }
+  for (const auto &member : _subspaceMembers) {
+    ret += member.memoryUsage();
+  }
+  if (_partitionBlockSize > 0) {
+    const auto blockSize{_partitionBlockSize};
+    const auto partitions{
+        std::max((n + blockSize - 1) / blockSize, std::size_t{1})};
+    // spectra, delay line, accumulated spectrum and FFT
+    ret += (2 * partitions * (blockSize + 1) + 3 * blockSize + 1) *
+               sizeof(std::complex<double>) +
+           6 * blockSize * sizeof(double);
+  } else if (_prescreenThreshold) {
+    ret += 3 * n * sizeof(std::int16_t);
+  }
+  return ret;
+}
+
 template <typename TData>
 void CrossCorrelation<TData>::correlate(size_t nData, TData *data) {
   /*
@@ -142,31 +385,96 @@ void CrossCorrelation<TData>::correlate(size_t nData, TData *data) {
         "failed to apply cross-correlation filter: not initialized"};
   }
 
+  ++_revision;
   std::feclearexcept(FE_ALL_EXCEPT);
 
-  const auto n{_buffer.capacity()};
+  const auto partitioned{latency() > 0};
+  const auto n{_buffer.capacity() - latency()};
   const TData *samplesTemplateWf{
       TypedArray<TData>::ConstCast(_templateWaveform.waveform().data())
           ->typedData()};
   // cross-correlation loop
   for (size_t i = 0; i < nData; ++i) {
     const TData newSample{data[i]};
+    // in partitioned convolution mode, the data sums refer to the data
+    // `latency()` samples ago
+    const TData firstSample{partitioned ? _buffer[n] : newSample};
     const TData lastSample{_buffer.front()};
-    _sumData += newSample - lastSample;
-    _sumSquaredData += util::square(newSample) - util::square(lastSample);
+    _sumData += firstSample - lastSample;
+    _sumSquaredData += util::square(firstSample) - util::square(lastSample);
     const double denominatorData{
         std::sqrt(n * _sumSquaredData - _sumData * _sumData)};
 
     _buffer.push_back(newSample);
 
-    double sumTemplateData{0};
-    for (size_t k = 0; k < n; ++k) {
-      sumTemplateData += samplesTemplateWf[k] * _buffer[k];
+    if (partitioned) {
+      const double pearsonCoeff{
+          (n * correlatePartitioned(newSample) -
+           _sumTemplateWaveform * _sumData) /
+          (_denominatorTemplateWaveform * denominatorData)};
+      data[i] =
+          static_cast<TData>(std::isfinite(pearsonCoeff) ? pearsonCoeff : 0);
+      continue;
     }
 
-    const double pearsonCoeff{
-        (n * sumTemplateData - _sumTemplateWaveform * _sumData) /
-        (_denominatorTemplateWaveform * denominatorData)};
+    // subspace detector: the fraction of the (demeaned) data's energy
+    // projected onto the subspace
+    if (!_subspaceBasis.empty()) {
+      const double projectedEnergy{
+          n * correlateSubspace() / (denominatorData * denominatorData)};
+      data[i] = static_cast<TData>(
+          std::isfinite(projectedEnergy) ? projectedEnergy : 0);
+      continue;
+    }
+
+    if (_prescreenThreshold) {
+      pushQuantized(newSample);
+    }
+
+    // coarse-to-fine search: decide whether the exact coefficient is required
+    bool refine{true};
+    if (_coarseDecimation > 1) {
+      if (_coarseCountdown == 0) {
+        _coarseCoefficient = correlateCoarse();
+        _coarseCountdown = _coarseDecimation;
+        if (_coarseCoefficient >= _coarseThreshold) {
+          _refineCount = 2 * _coarseDecimation;
+        }
+      }
+      --_coarseCountdown;
+
+      refine = _refineCount > 0;
+      if (refine) {
+        --_refineCount;
+      }
+    }
+
+    double pearsonCoeff{_coarseCoefficient};
+    // shared screening: decide whether the exact coefficient is required
+    if (_screen) {
+      pearsonCoeff = _screen[i];
+      refine = !(pearsonCoeff < _screenThreshold);
+    }
+
+    // quantized pre-screening: decide whether the exact coefficient is
+    // required
+    if (refine && _prescreenThreshold) {
+      pearsonCoeff =
+          (n * correlateQuantized() - _sumTemplateWaveform * _sumData) /
+          (_denominatorTemplateWaveform * denominatorData);
+      // invalid approximate coefficients are refined, too
+      refine = !(pearsonCoeff < *_prescreenThreshold);
+    }
+
+    if (refine) {
+      double sumTemplateData{0};
+      for (size_t k = 0; k < n; ++k) {
+        sumTemplateData += samplesTemplateWf[k] * _buffer[k];
+      }
+
+      pearsonCoeff = (n * sumTemplateData - _sumTemplateWaveform * _sumData) /
+                     (_denominatorTemplateWaveform * denominatorData);
+    }
 
     int fe{std::fetestexcept(FE_ALL_EXCEPT)};
     if ((fe & ~FE_INEXACT) != 0)  // we don't care about FE_INEXACT
@@ -191,6 +499,295 @@ void CrossCorrelation<TData>::correlate(size_t nData, TData *data) {
   }
 }
 
+template <typename TData>
+double CrossCorrelation<TData>::correlateCoarse() const {
+  const auto n{_buffer.capacity()};
+  const TData *samplesTemplateWf{
+      TypedArray<TData>::ConstCast(_templateWaveform.waveform().data())
+          ->typedData()};
+
+  double sumTemplateData{0};
+  double sumData{0};
+  double sumSquaredData{0};
+  std::size_t nCoarse{0};
+  // the decimated samples are aligned with the most recent sample
+  for (auto k{n}; k > 0;
+       k = k > _coarseDecimation ? k - _coarseDecimation : 0) {
+    const auto sample{_buffer[k - 1]};
+    sumTemplateData += samplesTemplateWf[k - 1] * sample;
+    sumData += sample;
+    sumSquaredData += util::square(sample);
+    ++nCoarse;
+  }
+
+  const double denominatorData{
+      std::sqrt(nCoarse * sumSquaredData - sumData * sumData)};
+  return (nCoarse * sumTemplateData - _coarseSumTemplateWaveform * sumData) /
+         (_coarseDenominatorTemplateWaveform * denominatorData);
+}
+
+template <typename TData>
+double CrossCorrelation<TData>::correlateQuantized() const {
+  const auto n{_buffer.capacity()};
+  const auto blockSize{util::kQuantizedBlockSize};
+  const auto *samplesTemplateWf{_quantizedTemplateWaveform.data()};
+  const auto *samplesData{_quantizedData.data() + _quantizedData.size() - n};
+
+  // the index of the oldest buffered sample w.r.t. the quantized data count
+  auto idx{_quantizedDataCount - n};
+  const auto mostRecentBlock{(_quantizedDataCount - 1) / blockSize};
+  const auto numberOfBlocks{_quantizedDataInverseScales.size()};
+
+  double ret{0};
+  for (std::size_t k{0}; k < n;) {
+    // correlate block-wise, since the scale differs from block to block
+    const auto block{idx / blockSize};
+    const auto len{std::min(blockSize - idx % blockSize, n - k)};
+    const auto inverseScale{
+        _quantizedDataInverseScales[numberOfBlocks - 1 -
+                                    (mostRecentBlock - block)]};
+    ret += inverseScale * util::dot(samplesTemplateWf + k, samplesData + k, len);
+
+    k += len;
+    idx += len;
+  }
+
+  return _quantizedTemplateWaveformScale > 0
+             ? ret / _quantizedTemplateWaveformScale
+             : 0;
+}
+
+template <typename TData>
+double CrossCorrelation<TData>::correlateSubspace() const {
+  const auto n{_subspaceBasis.length};
+  // correlate the contiguous parts of the circular buffer separately, such that
+  // compilers vectorize the inner loops
+  const auto one{_buffer.array_one()};
+  const auto two{_buffer.array_two()};
+
+  double ret{0};
+  for (std::size_t j{0}; j < _subspaceBasis.dimension(); ++j) {
+    const auto *basisVector{_subspaceBasis.vectors.data() + j * n};
+    double projection{0};
+    for (std::size_t k{0}; k < one.second; ++k) {
+      projection += basisVector[k] * one.first[k];
+    }
+    basisVector += one.second;
+    for (std::size_t k{0}; k < two.second; ++k) {
+      projection += basisVector[k] * two.first[k];
+    }
+    ret += util::square(projection);
+  }
+  return ret;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::setupSubspace(double samplingFrequency) {
+  _subspaceBasis = subspace::Basis{};
+  if (_subspaceDimension == 0) {
+    return;
+  }
+
+  const auto n{_buffer.capacity()};
+  const auto toVector = [n](const TemplateWaveform &templateWaveform) {
+    const auto &data{*templateWaveform.waveform().data()};
+    const TData *samples{TypedArray<TData>::ConstCast(&data)->typedData()};
+    // truncate or zero pad to the length of the template waveform
+    std::vector<double> ret(n, 0);
+    std::copy(samples,
+              samples + std::min(n, static_cast<std::size_t>(data.size())),
+              ret.begin());
+    return ret;
+  };
+
+  std::vector<std::vector<double>> waveforms{toVector(_templateWaveform)};
+  for (auto &member : _subspaceMembers) {
+    member.setSamplingFrequency(samplingFrequency);
+    waveforms.push_back(toVector(member));
+  }
+
+  // allow for picking inaccuracies of up to 10% of the template waveform length
+  // when aligning the members
+  _subspaceBasis = subspace::design(waveforms, _subspaceDimension, n / 10);
+  SCDETECT_LOG_DEBUG(
+      "Designed subspace basis (dimension=%zu, members=%zu, "
+      "captured energy=%.3f)",
+      _subspaceBasis.dimension(), _subspaceMembers.size(),
+      _subspaceBasis.capturedEnergy);
+}
+
+template <typename TData>
+double CrossCorrelation<TData>::correlatePartitioned(TData sample) {
+  const auto blockSize{_partitionBlockSize};
+  _partitionInput[blockSize + _partitionInputCount] = sample;
+  if (++_partitionInputCount == blockSize) {
+    const auto bins{blockSize + 1};
+    const auto partitions{_partitionSpectra.size() / bins};
+    _partitionPosition = (_partitionPosition + 1) % partitions;
+    auto *spectrum{_partitionDelayLine.data() + _partitionPosition * bins};
+    _partitionFFT.forward(_partitionInput.data(), spectrum);
+
+    // multiply-accumulate the spectra of the template waveform partitions
+    // with the spectra of the correspondingly delayed data blocks
+    std::fill(_partitionSpectrum.begin(), _partitionSpectrum.end(),
+              std::complex<double>{0, 0});
+    for (std::size_t p{0}; p < partitions; ++p) {
+      const auto *h{_partitionSpectra.data() + p * bins};
+      const auto delayed{(_partitionPosition + partitions - p) % partitions};
+      const auto *x{_partitionDelayLine.data() + delayed * bins};
+      for (std::size_t k{0}; k < bins; ++k) {
+        // multiply explicitly, since `std::complex` multiplication handles
+        // special values (which prevents vectorization)
+        _partitionSpectrum[k] += std::complex<double>{
+            h[k].real() * x[k].real() - h[k].imag() * x[k].imag(),
+            h[k].real() * x[k].imag() + h[k].imag() * x[k].real()};
+      }
+    }
+    _partitionFFT.inverse(_partitionSpectrum.data(), _partitionOutput.data());
+
+    // the second half is free of circular convolution artifacts
+    for (std::size_t k{0}; k < blockSize; ++k) {
+      _partitionPending.push_back(_partitionOutput[blockSize + k]);
+    }
+
+    // the current block becomes the previous block
+    std::copy(_partitionInput.begin() + blockSize, _partitionInput.end(),
+              _partitionInput.begin());
+    _partitionInputCount = 0;
+  }
+
+  const auto ret{_partitionPending.front()};
+  _partitionPending.pop_front();
+  return ret;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::setupPartitioned() {
+  if (latency() == 0) {
+    _partitionFFT = fft::RealFFT{};
+    _partitionSpectra.clear();
+    _partitionSpectra.shrink_to_fit();
+    return;
+  }
+
+  const auto blockSize{_partitionBlockSize};
+  const auto n{_buffer.capacity() - blockSize};
+  const auto bins{blockSize + 1};
+  const auto partitions{std::max((n + blockSize - 1) / blockSize,
+                                 std::size_t{1})};
+  if (_partitionFFT.size() != 2 * blockSize) {
+    _partitionFFT = fft::RealFFT{2 * blockSize};
+  }
+
+  const TData *samplesTemplateWf{
+      TypedArray<TData>::ConstCast(_templateWaveform.waveform().data())
+          ->typedData()};
+  // the template waveform is time reversed, such that the convolution
+  // computes the correlation; the partitions are zero padded to the FFT size
+  std::vector<double> partition(2 * blockSize);
+  _partitionSpectra.assign(partitions * bins, std::complex<double>{0, 0});
+  for (std::size_t p{0}; p < partitions; ++p) {
+    std::fill(partition.begin(), partition.end(), 0);
+    for (std::size_t j{0}; j < blockSize && p * blockSize + j < n; ++j) {
+      partition[j] = samplesTemplateWf[n - 1 - (p * blockSize + j)];
+    }
+    _partitionFFT.forward(partition.data(),
+                          _partitionSpectra.data() + p * bins);
+  }
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::resetPartitioned() {
+  if (latency() == 0) {
+    _partitionDelayLine.clear();
+    _partitionDelayLine.shrink_to_fit();
+    _partitionInput.clear();
+    _partitionInput.shrink_to_fit();
+    _partitionSpectrum.clear();
+    _partitionSpectrum.shrink_to_fit();
+    _partitionOutput.clear();
+    _partitionOutput.shrink_to_fit();
+    _partitionPending.set_capacity(0);
+    return;
+  }
+
+  const auto blockSize{_partitionBlockSize};
+  _partitionDelayLine.assign(_partitionSpectra.size(),
+                             std::complex<double>{0, 0});
+  _partitionPosition = 0;
+  _partitionInput.assign(2 * blockSize, 0);
+  _partitionInputCount = 0;
+  _partitionSpectrum.assign(blockSize + 1, std::complex<double>{0, 0});
+  _partitionOutput.assign(2 * blockSize, 0);
+
+  // the coefficients are delayed by a single block
+  _partitionPending.set_capacity(2 * blockSize);
+  _partitionPending.clear();
+  for (std::size_t k{0}; k < blockSize; ++k) {
+    _partitionPending.push_back(0);
+  }
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::pushQuantized(TData sample) {
+  const auto blockSize{util::kQuantizedBlockSize};
+  if (_quantizedDataCount % blockSize == 0) {
+    _quantizedDataBlock.clear();
+    _quantizedDataBlockAbsMax = 0;
+    _quantizedDataInverseScales.push_back(0);
+  }
+
+  // keep the quantized samples required, only
+  const auto n{_buffer.capacity()};
+  if (_quantizedData.size() >= 2 * n) {
+    _quantizedData.erase(_quantizedData.begin(),
+                         _quantizedData.end() - (n - 1));
+  }
+
+  _quantizedDataBlock.push_back(sample);
+  const double absSample{std::abs(sample)};
+  if (absSample > _quantizedDataBlockAbsMax) {
+    // requantize the samples of the current block (which are still buffered)
+    // such that the block's samples share a common scale
+    _quantizedDataBlockAbsMax = absSample;
+    const auto scale{util::quantizationScale(_quantizedDataBlockAbsMax)};
+    const auto previous{_quantizedDataBlock.size() - 1};
+    const auto m{std::min(previous, _quantizedData.size())};
+    auto *out{_quantizedData.data() + _quantizedData.size() - m};
+    const auto *in{_quantizedDataBlock.data() + previous - m};
+    for (std::size_t i{0}; i < m; ++i) {
+      out[i] = util::quantize(in[i], scale);
+    }
+    _quantizedDataInverseScales.back() = 1 / scale;
+  }
+
+  _quantizedData.push_back(util::quantize(
+      sample, util::quantizationScale(_quantizedDataBlockAbsMax)));
+  ++_quantizedDataCount;
+}
+
+template <typename TData>
+void CrossCorrelation<TData>::resetQuantized() {
+  _quantizedData.clear();
+  _quantizedDataInverseScales.clear();
+  _quantizedDataBlock.clear();
+  _quantizedDataBlockAbsMax = 0;
+  _quantizedDataCount = 0;
+  if (!_prescreenThreshold || latency() > 0) {
+    _quantizedData.shrink_to_fit();
+    _quantizedDataInverseScales.set_capacity(0);
+    return;
+  }
+
+  const auto n{_buffer.capacity()};
+  _quantizedData.reserve(2 * n);
+  _quantizedDataInverseScales.set_capacity(n / util::kQuantizedBlockSize + 2);
+  _quantizedDataBlock.reserve(util::kQuantizedBlockSize);
+  for (const auto &sample : _buffer) {
+    pushQuantized(sample);
+  }
+}
+
 template <typename TData>
 void CrossCorrelation<TData>::setupFilter(double samplingFrequency) {
   assert((samplingFrequency > 0));
@@ -198,6 +795,7 @@ void CrossCorrelation<TData>::setupFilter(double samplingFrequency) {
   _initialized = false;
   _templateWaveform.setSamplingFrequency(samplingFrequency);
   reset();
+  setupSubspace(samplingFrequency);
   _initialized = true;
 }
 
@@ -0,0 +1,128 @@
+#include "fft.h"
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+namespace fft {
+
+std::size_t nextPowerOfTwo(std::size_t n) {
+  std::size_t ret{1};
+  while (ret < n) {
+    ret <<= 1;
+  }
+  return ret;
+}
+
+RealFFT::RealFFT(std::size_t n) : _n{n} {
+  assert((n >= 4 && nextPowerOfTwo(n) == n));
+
+  const auto h{n / 2};
+  const auto pi{std::acos(-1.0)};
+  _twiddles.resize(h / 2);
+  for (std::size_t k{0}; k < _twiddles.size(); ++k) {
+    _twiddles[k] = std::polar(1.0, -2 * pi * k / h);
+  }
+  _packingTwiddles.resize(h);
+  for (std::size_t k{0}; k < _packingTwiddles.size(); ++k) {
+    _packingTwiddles[k] = std::polar(1.0, -2 * pi * k / n);
+  }
+
+  _bitReversed.resize(h);
+  std::size_t bits{0};
+  while ((std::size_t{1} << bits) < h) {
+    ++bits;
+  }
+  for (std::size_t i{0}; i < h; ++i) {
+    std::size_t reversed{0};
+    for (std::size_t b{0}; b < bits; ++b) {
+      if (i & (std::size_t{1} << b)) {
+        reversed |= std::size_t{1} << (bits - 1 - b);
+      }
+    }
+    _bitReversed[i] = reversed;
+  }
+
+  _work.resize(h);
+}
+
+void RealFFT::forward(const double *in, std::complex<double> *out) {
+  const auto h{_n / 2};
+  for (std::size_t k{0}; k < h; ++k) {
+    _work[k] = std::complex<double>{in[2 * k], in[2 * k + 1]};
+  }
+
+  transform(false);
+
+  // unpack the spectra of the even and the odd samples
+  out[0] = std::complex<double>{_work[0].real() + _work[0].imag(), 0};
+  out[h] = std::complex<double>{_work[0].real() - _work[0].imag(), 0};
+  const std::complex<double> halfI{0, 0.5};
+  for (std::size_t k{1}; k < h; ++k) {
+    const auto z{_work[k]};
+    const auto zc{std::conj(_work[h - k])};
+    const auto even{0.5 * (z + zc)};
+    const auto odd{-halfI * (z - zc)};
+    out[k] = even + _packingTwiddles[k] * odd;
+  }
+}
+
+void RealFFT::inverse(const std::complex<double> *in, double *out) {
+  const auto h{_n / 2};
+  const std::complex<double> i{0, 1};
+  for (std::size_t k{0}; k < h; ++k) {
+    const auto x{in[k]};
+    const auto xc{std::conj(in[h - k])};
+    const auto even{0.5 * (x + xc)};
+    const auto odd{0.5 * (x - xc) * std::conj(_packingTwiddles[k])};
+    _work[k] = even + i * odd;
+  }
+
+  transform(true);
+
+  const auto scale{1.0 / h};
+  for (std::size_t k{0}; k < h; ++k) {
+    out[2 * k] = _work[k].real() * scale;
+    out[2 * k + 1] = _work[k].imag() * scale;
+  }
+}
+
+std::size_t RealFFT::size() const { return _n; }
+
+std::size_t RealFFT::memoryUsage() const {
+  return (_twiddles.size() + _packingTwiddles.size() + _work.size()) *
+             sizeof(std::complex<double>) +
+         _bitReversed.size() * sizeof(std::size_t);
+}
+
+void RealFFT::transform(bool inverse) {
+  const auto h{_work.size()};
+  for (std::size_t k{0}; k < h; ++k) {
+    if (k < _bitReversed[k]) {
+      std::swap(_work[k], _work[_bitReversed[k]]);
+    }
+  }
+
+  for (std::size_t len{2}; len <= h; len <<= 1) {
+    const auto half{len / 2};
+    const auto step{h / len};
+    for (std::size_t k{0}; k < h; k += len) {
+      for (std::size_t j{0}; j < half; ++j) {
+        const auto w{inverse ? std::conj(_twiddles[j * step])
+                             : _twiddles[j * step]};
+        const auto u{_work[k + j]};
+        const auto v{_work[k + j + half] * w};
+        _work[k + j] = u + v;
+        _work[k + j + half] = u - v;
+      }
+    }
+  }
+}
+
+}  // namespace fft
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
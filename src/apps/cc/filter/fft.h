@@ -0,0 +1,61 @@
+#ifndef SCDETECT_APPS_CC_FILTER_FFT_H_
+#define SCDETECT_APPS_CC_FILTER_FFT_H_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+namespace fft {
+
+// Returns the smallest power of two greater than or equal to `n`
+std::size_t nextPowerOfTwo(std::size_t n);
+
+// Radix-2 FFT of real sequences
+//
+// - the sequence of length `n` is transformed by means of a complex FFT of
+// length `n / 2` (i.e. the even and the odd samples are packed into the real
+// and the imaginary part, respectively)
+// - twiddle factors and buffers are allocated when constructing the plan,
+// only, i.e. transforming does not allocate
+class RealFFT {
+ public:
+  RealFFT() = default;
+  // Creates a plan for sequences of length `n`
+  //
+  // - `n` must be a power of two greater than or equal to 4
+  explicit RealFFT(std::size_t n);
+
+  // Computes the `size() / 2 + 1` non-redundant bins of the spectrum of the
+  // `size()` real samples `in`
+  void forward(const double *in, std::complex<double> *out);
+  // Computes the `size()` real samples from the `size() / 2 + 1` non-redundant
+  // bins `in` (i.e. the normalized inverse of `forward()`)
+  void inverse(const std::complex<double> *in, double *out);
+
+  // Returns the length of the sequences transformed
+  std::size_t size() const;
+  // Returns the number of bytes allocated
+  std::size_t memoryUsage() const;
+
+ private:
+  // Computes the in-place complex FFT (of length `size() / 2`) of `_work`
+  void transform(bool inverse);
+
+  std::size_t _n{0};
+  // Twiddle factors of the complex FFT
+  std::vector<std::complex<double>> _twiddles;
+  // Twiddle factors used for (un)packing the real sequence
+  std::vector<std::complex<double>> _packingTwiddles;
+  std::vector<std::size_t> _bitReversed;
+  std::vector<std::complex<double>> _work;
+};
+
+}  // namespace fft
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_FILTER_FFT_H_
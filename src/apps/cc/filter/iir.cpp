@@ -0,0 +1,401 @@
+#include "iir.h"
+
+#include <algorithm>
+#include <atomic>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "../log.h"
+#include "../util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+namespace iir {
+
+namespace {
+
+std::atomic<bool> useNativeFilters{false};
+
+// Appends the sections of a Butterworth lowpass (`highpass == false`) or
+// highpass (`highpass == true`) with corner frequency `f`
+void appendButterworth(Biquads &biquads, int order, double f,
+                       double samplingFrequency, bool highpass) {
+  // prewarped analog corner frequency
+  const auto k{std::tan(M_PI * f / samplingFrequency)};
+  const auto kk{k * k};
+
+  // conjugate complex pole pairs of the analog prototype
+  for (int i{0}; i < order / 2; ++i) {
+    const auto damping{2 * std::sin(M_PI * (2 * i + 1) / (2.0 * order))};
+    const auto norm{1 / (1 + damping * k + kk)};
+
+    Biquad biquad;
+    if (highpass) {
+      biquad.b0 = norm;
+      biquad.b1 = -2 * norm;
+      biquad.b2 = norm;
+    } else {
+      biquad.b0 = kk * norm;
+      biquad.b1 = 2 * kk * norm;
+      biquad.b2 = kk * norm;
+    }
+    biquad.a1 = 2 * (kk - 1) * norm;
+    biquad.a2 = (1 - damping * k + kk) * norm;
+    biquads.push_back(biquad);
+  }
+
+  // real pole of the analog prototype (odd order)
+  if (order % 2) {
+    const auto norm{1 / (1 + k)};
+
+    Biquad biquad;
+    if (highpass) {
+      biquad.b0 = norm;
+      biquad.b1 = -norm;
+    } else {
+      biquad.b0 = k * norm;
+      biquad.b1 = k * norm;
+    }
+    biquad.a1 = (k - 1) * norm;
+    biquads.push_back(biquad);
+  }
+}
+
+bool isValidCornerFrequency(double f, double samplingFrequency) {
+  return f > 0 && f < 0.5 * samplingFrequency;
+}
+
+BiquadsCPtr design(const ButterworthConfig &config, double samplingFrequency) {
+  if (config.order < 1 || samplingFrequency <= 0) {
+    return nullptr;
+  }
+
+  auto ret{std::make_shared<Biquads>()};
+  switch (config.type) {
+    case ButterworthConfig::Type::kLowpass:
+      if (!isValidCornerFrequency(config.fmax, samplingFrequency)) {
+        return nullptr;
+      }
+      appendButterworth(*ret, config.order, config.fmax, samplingFrequency,
+                        false);
+      break;
+    case ButterworthConfig::Type::kHighpass:
+      if (!isValidCornerFrequency(config.fmin, samplingFrequency)) {
+        return nullptr;
+      }
+      appendButterworth(*ret, config.order, config.fmin, samplingFrequency,
+                        true);
+      break;
+    case ButterworthConfig::Type::kBandpass:
+      if (!isValidCornerFrequency(config.fmin, samplingFrequency) ||
+          !isValidCornerFrequency(config.fmax, samplingFrequency) ||
+          config.fmin >= config.fmax) {
+        return nullptr;
+      }
+      appendButterworth(*ret, config.order, config.fmin, samplingFrequency,
+                        true);
+      appendButterworth(*ret, config.order, config.fmax, samplingFrequency,
+                        false);
+      break;
+  }
+  return ret;
+}
+
+}  // namespace
+
+bool operator==(const ButterworthConfig &lhs, const ButterworthConfig &rhs) {
+  return (lhs.type == rhs.type && lhs.order == rhs.order &&
+          lhs.fmin == rhs.fmin && lhs.fmax == rhs.fmax);
+}
+
+bool operator!=(const ButterworthConfig &lhs, const ButterworthConfig &rhs) {
+  return !(lhs == rhs);
+}
+
+boost::optional<ButterworthConfig> parseButterworth(
+    const std::string &filterId) {
+  const auto trimmed{boost::algorithm::trim_copy(filterId)};
+  const auto open{trimmed.find('(')};
+  if (open == std::string::npos || trimmed.back() != ')') {
+    return boost::none;
+  }
+
+  ButterworthConfig ret;
+  std::size_t numberOfParameters{0};
+  const auto name{boost::algorithm::trim_copy(trimmed.substr(0, open))};
+  if (name == "BW") {
+    ret.type = ButterworthConfig::Type::kBandpass;
+    numberOfParameters = 3;
+  } else if (name == "BW_HP") {
+    ret.type = ButterworthConfig::Type::kHighpass;
+    numberOfParameters = 2;
+  } else if (name == "BW_LP") {
+    ret.type = ButterworthConfig::Type::kLowpass;
+    numberOfParameters = 2;
+  } else {
+    return boost::none;
+  }
+
+  std::vector<std::string> tokens;
+  const auto parameters{
+      trimmed.substr(open + 1, trimmed.size() - open - 2)};
+  boost::algorithm::split(tokens, parameters, boost::is_any_of(","));
+  if (tokens.size() != numberOfParameters) {
+    return boost::none;
+  }
+
+  std::vector<double> values;
+  for (auto &token : tokens) {
+    boost::algorithm::trim(token);
+    try {
+      std::size_t pos{0};
+      values.push_back(std::stod(token, &pos));
+      if (pos != token.size()) {
+        return boost::none;
+      }
+    } catch (const std::logic_error &) {
+      return boost::none;
+    }
+  }
+
+  if (values[0] < 1 || std::floor(values[0]) != values[0]) {
+    return boost::none;
+  }
+  ret.order = static_cast<int>(values[0]);
+
+  switch (ret.type) {
+    case ButterworthConfig::Type::kLowpass:
+      ret.fmax = values[1];
+      break;
+    case ButterworthConfig::Type::kHighpass:
+      ret.fmin = values[1];
+      break;
+    case ButterworthConfig::Type::kBandpass:
+      ret.fmin = values[1];
+      ret.fmax = values[2];
+      break;
+  }
+  return ret;
+}
+
+BiquadsCPtr butterworth(const ButterworthConfig &config,
+                        double samplingFrequency) {
+  using Key = std::tuple<int, int, double, double, double>;
+  static std::mutex mutex;
+  static std::map<Key, BiquadsCPtr> cache;
+
+  const Key key{static_cast<int>(config.type), config.order, config.fmin,
+                config.fmax, samplingFrequency};
+  std::lock_guard<std::mutex> lock{mutex};
+  auto it{cache.find(key)};
+  if (it == cache.end()) {
+    it = cache.emplace(key, design(config, samplingFrequency)).first;
+  }
+  return it->second;
+}
+
+/* ------------------------------------------------------------------------- */
+FilterBank::FilterBank(BiquadsCPtr biquads, std::size_t channels)
+    : _biquads{std::move(biquads)}, _channels{channels} {
+  assert(_biquads);
+  assert(_channels > 0);
+  reset();
+}
+
+void FilterBank::apply(std::size_t n, double *const *data) {
+  if (_channels == 1) {
+    apply(0, n, data[0]);
+    return;
+  }
+
+  // interleave, i.e. sample `i` of channel `c` is located at
+  // `i * channels + c`
+  _interleaved.resize(n * _channels);
+  for (std::size_t c{0}; c < _channels; ++c) {
+    const auto *samples{data[c]};
+    for (std::size_t i{0}; i < n; ++i) {
+      _interleaved[i * _channels + c] = samples[i];
+    }
+  }
+
+  applyInterleaved(n, _interleaved.data(), _channels, _s1.data(), _s2.data(),
+                   _channels);
+
+  for (std::size_t c{0}; c < _channels; ++c) {
+    auto *samples{data[c]};
+    for (std::size_t i{0}; i < n; ++i) {
+      samples[i] = _interleaved[i * _channels + c];
+    }
+  }
+}
+
+void FilterBank::apply(std::size_t channel, std::size_t n, double *data) {
+  assert(channel < _channels);
+  applyInterleaved(n, data, 1, _s1.data() + channel, _s2.data() + channel,
+                   _channels);
+}
+
+void FilterBank::reset() {
+  _s1.assign(_biquads->size() * _channels, 0);
+  _s2.assign(_biquads->size() * _channels, 0);
+}
+
+void FilterBank::reset(std::size_t channel) {
+  assert(channel < _channels);
+  for (std::size_t i{0}; i < _biquads->size(); ++i) {
+    _s1[i * _channels + channel] = 0;
+    _s2[i * _channels + channel] = 0;
+  }
+}
+
+std::size_t FilterBank::channels() const { return _channels; }
+
+const BiquadsCPtr &FilterBank::biquads() const { return _biquads; }
+
+void FilterBank::applyInterleaved(std::size_t n, double *samples,
+                                  std::size_t lanes, double *s1, double *s2,
+                                  std::size_t stride) const {
+  // the sections are applied one after another to the entire block, i.e. the
+  // lanes are processed in the innermost loop (transposed direct form II)
+  for (std::size_t i{0}; i < _biquads->size(); ++i) {
+    const auto &biquad{(*_biquads)[i]};
+    auto *z1{s1 + i * stride};
+    auto *z2{s2 + i * stride};
+    for (std::size_t j{0}; j < n; ++j) {
+      auto *x{samples + j * lanes};
+      for (std::size_t c{0}; c < lanes; ++c) {
+        const auto in{x[c]};
+        const auto out{biquad.b0 * in + z1[c]};
+        z1[c] = biquad.b1 * in - biquad.a1 * out + z2[c];
+        z2[c] = biquad.b2 * in - biquad.a2 * out;
+        x[c] = out;
+      }
+    }
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+ButterworthFilter::ButterworthFilter(const ButterworthConfig &config)
+    : _config{config} {}
+
+void ButterworthFilter::setSamplingFrequency(double samplingFrequency) {
+  if (_samplingFrequency == samplingFrequency && (_bank || _fallback)) {
+    return;
+  }
+
+  _samplingFrequency = samplingFrequency;
+  _bank.reset();
+  _fallback.reset();
+
+  auto biquads{butterworth(_config, samplingFrequency)};
+  if (biquads) {
+    _bank = util::make_unique<FilterBank>(std::move(biquads), 1);
+    return;
+  }
+
+  SCDETECT_LOG_DEBUG(
+      "Failed to design filter (%s) for sampling frequency %f; falling back "
+      "to the generic implementation",
+      id().c_str(), samplingFrequency);
+  _fallback.reset(DoubleFilter::Create(id()));
+  if (_fallback) {
+    _fallback->setSamplingFrequency(samplingFrequency);
+  }
+}
+
+int ButterworthFilter::setParameters(int n, const double *params) {
+  const int required{_config.type == ButterworthConfig::Type::kBandpass ? 3
+                                                                        : 2};
+  if (n != required) {
+    return required;
+  }
+  if (params[0] < 1 || std::floor(params[0]) != params[0]) {
+    return -1;
+  }
+
+  _config.order = static_cast<int>(params[0]);
+  switch (_config.type) {
+    case ButterworthConfig::Type::kLowpass:
+      _config.fmax = params[1];
+      break;
+    case ButterworthConfig::Type::kHighpass:
+      _config.fmin = params[1];
+      break;
+    case ButterworthConfig::Type::kBandpass:
+      _config.fmin = params[1];
+      _config.fmax = params[2];
+      break;
+  }
+
+  _bank.reset();
+  _fallback.reset();
+  if (_samplingFrequency > 0) {
+    setSamplingFrequency(_samplingFrequency);
+  }
+  return n;
+}
+
+void ButterworthFilter::apply(int n, double *inout) {
+  if (_bank) {
+    _bank->apply(0, static_cast<std::size_t>(n), inout);
+  } else if (_fallback) {
+    _fallback->apply(n, inout);
+  }
+}
+
+DoubleFilter *ButterworthFilter::clone() const {
+  // the clone shares the coefficients, but not the filter state
+  auto *ret{new ButterworthFilter{_config}};
+  if (_samplingFrequency > 0) {
+    ret->setSamplingFrequency(_samplingFrequency);
+  }
+  return ret;
+}
+
+std::string ButterworthFilter::id() const {
+  std::ostringstream oss;
+  oss.precision(17);
+  switch (_config.type) {
+    case ButterworthConfig::Type::kLowpass:
+      oss << "BW_LP(" << _config.order << "," << _config.fmax << ")";
+      break;
+    case ButterworthConfig::Type::kHighpass:
+      oss << "BW_HP(" << _config.order << "," << _config.fmin << ")";
+      break;
+    case ButterworthConfig::Type::kBandpass:
+      oss << "BW(" << _config.order << "," << _config.fmin << ","
+          << _config.fmax << ")";
+      break;
+  }
+  return oss.str();
+}
+
+const ButterworthConfig &ButterworthFilter::config() const { return _config; }
+
+/* ------------------------------------------------------------------------- */
+std::unique_ptr<DoubleFilter> createFilter(const std::string &filterId) {
+  const auto config{parseButterworth(filterId)};
+  if (!config) {
+    return nullptr;
+  }
+  return util::make_unique<ButterworthFilter>(*config);
+}
+
+void setNativeFilters(bool enable) { useNativeFilters = enable; }
+
+bool nativeFilters() { return useNativeFilters; }
+
+}  // namespace iir
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
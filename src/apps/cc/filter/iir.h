@@ -0,0 +1,157 @@
+#ifndef SCDETECT_APPS_CC_FILTER_IIR_H_
+#define SCDETECT_APPS_CC_FILTER_IIR_H_
+
+#include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../def.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+namespace iir {
+
+// Normalized second-order section (i.e. `a0 == 1`)
+struct Biquad {
+  double b0{1};
+  double b1{0};
+  double b2{0};
+  double a1{0};
+  double a2{0};
+};
+using Biquads = std::vector<Biquad>;
+using BiquadsCPtr = std::shared_ptr<const Biquads>;
+
+struct ButterworthConfig {
+  enum class Type { kLowpass, kHighpass, kBandpass };
+
+  Type type{Type::kBandpass};
+  int order{0};
+  // The lower corner frequency in Hz (highpass and bandpass)
+  double fmin{0};
+  // The upper corner frequency in Hz (lowpass and bandpass)
+  double fmax{0};
+
+  friend bool operator==(const ButterworthConfig &lhs,
+                         const ButterworthConfig &rhs);
+  friend bool operator!=(const ButterworthConfig &lhs,
+                         const ButterworthConfig &rhs);
+};
+
+// Parses the Butterworth filter identifiers `BW(order,fmin,fmax)`,
+// `BW_HP(order,fmin)` and `BW_LP(order,fmax)`
+//
+// - returns `boost::none` if `filterId` is not a (single) Butterworth filter
+// (e.g. a filter chain)
+boost::optional<ButterworthConfig> parseButterworth(
+    const std::string &filterId);
+
+// Returns the second-order sections of the Butterworth filter described by
+// `config` for `samplingFrequency`
+//
+// - a bandpass is designed as a cascade of a highpass and a lowpass of the
+// configured order (bilinear transform with frequency prewarping)
+// - coefficient tables are designed once per configuration and sampling
+// frequency and shared afterwards (thread-safe)
+// - returns `nullptr` if the configuration is invalid for
+// `samplingFrequency`
+BiquadsCPtr butterworth(const ButterworthConfig &config,
+                        double samplingFrequency);
+
+// Applies the same cascade of second-order sections to several channels
+//
+// - the channels' samples are interleaved such that the channels are
+// processed in the innermost loop (i.e. in SIMD lanes)
+// - the output of a channel is identical to the output of a single-channel
+// bank fed with the same samples
+class FilterBank {
+ public:
+  FilterBank(BiquadsCPtr biquads, std::size_t channels);
+
+  // Filters `n` samples of each channel in place; `data` points to
+  // `channels()` arrays
+  void apply(std::size_t n, double *const *data);
+  // Filters `n` samples of the channel with index `channel` in place
+  void apply(std::size_t channel, std::size_t n, double *data);
+
+  // Resets the filter state of all channels
+  void reset();
+  // Resets the filter state of the channel with index `channel`
+  void reset(std::size_t channel);
+
+  // Returns the number of channels
+  std::size_t channels() const;
+  // Returns the second-order sections
+  const BiquadsCPtr &biquads() const;
+
+ private:
+  // Filters `n` interleaved samples of `lanes` channels; the state of a
+  // section is located at `s1 + i * stride` and `s2 + i * stride`,
+  // respectively (where `i` is the section index)
+  void applyInterleaved(std::size_t n, double *samples, std::size_t lanes,
+                        double *s1, double *s2, std::size_t stride) const;
+
+  BiquadsCPtr _biquads;
+  std::size_t _channels;
+
+  // Filter state (indexed by section and channel)
+  std::vector<double> _s1;
+  std::vector<double> _s2;
+
+  // Buffer for interleaved samples
+  std::vector<double> _interleaved;
+};
+
+// Butterworth filter implementing the `DoubleFilter` interface by means of a
+// single-channel `FilterBank`
+//
+// - falls back to the generic SeisComP implementation if the filter cannot be
+// designed for the sampling frequency (e.g. if a corner frequency exceeds the
+// Nyquist frequency)
+class ButterworthFilter : public DoubleFilter {
+ public:
+  explicit ButterworthFilter(const ButterworthConfig &config);
+
+  void setSamplingFrequency(double samplingFrequency) override;
+  int setParameters(int n, const double *params) override;
+
+  void apply(int n, double *inout) override;
+
+  DoubleFilter *clone() const override;
+
+  // Returns the filter identifier
+  std::string id() const;
+  // Returns the filter configuration
+  const ButterworthConfig &config() const;
+
+ private:
+  ButterworthConfig _config;
+  double _samplingFrequency{0};
+
+  std::unique_ptr<FilterBank> _bank;
+  std::unique_ptr<DoubleFilter> _fallback;
+};
+
+// Creates a natively implemented filter from `filterId`
+//
+// - returns `nullptr` if `filterId` is not implemented natively
+// - regardless of `nativeFilters()`
+std::unique_ptr<DoubleFilter> createFilter(const std::string &filterId);
+
+// Enables/disables creating natively implemented filters in place of the
+// generic SeisComP implementation whenever filters are created from their
+// identifier (see `processing::createFilter()` and `waveform::filter()`);
+// disabled by default
+void setNativeFilters(bool enable);
+// Returns `true` if natively implemented filters are enabled, else `false`
+bool nativeFilters();
+
+}  // namespace iir
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_FILTER_IIR_H_
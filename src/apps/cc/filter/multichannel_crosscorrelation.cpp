@@ -0,0 +1,155 @@
+#include "multichannel_crosscorrelation.h"
+
+#include <seiscomp/core/typedarray.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "../filter.h"
+#include "../util/math.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+
+MultiChannelCrossCorrelation::MultiChannelCrossCorrelation(
+    std::vector<TemplateWaveform> templateWaveforms)
+    : _templateWaveforms{std::move(templateWaveforms)} {
+  assert(!_templateWaveforms.empty());
+}
+
+void MultiChannelCrossCorrelation::apply(std::size_t n,
+                                         const double *const *data,
+                                         double *out) {
+  if (_size == 0) {
+    throw BaseException{
+        "failed to apply multichannel cross-correlation filter: not "
+        "initialized"};
+  }
+
+  const auto channels{_templateWaveforms.size()};
+  const auto size{_size};
+  const auto *templateSamples{_templateSamples.data()};
+  for (std::size_t i{0}; i < n; ++i) {
+    // replace the oldest sample of each channel
+    auto *oldest{_buffer.data() + _position * channels};
+    for (std::size_t c{0}; c < channels; ++c) {
+      const auto newSample{data[c][i]};
+      const auto lastSample{oldest[c]};
+      _sumData[c] += newSample - lastSample;
+      _sumSquaredData[c] += util::square(newSample) - util::square(lastSample);
+      oldest[c] = newSample;
+      oldest[size * channels + c] = newSample;
+    }
+    _position = _position + 1 < size ? _position + 1 : 0;
+
+    // correlate all channels in a single pass
+    const auto *window{_buffer.data() + _position * channels};
+    std::fill(_sumTemplateData.begin(), _sumTemplateData.end(), 0);
+    auto *sumTemplateData{_sumTemplateData.data()};
+    for (std::size_t k{0}; k < size; ++k) {
+      const auto *t{templateSamples + k * channels};
+      const auto *d{window + k * channels};
+      for (std::size_t c{0}; c < channels; ++c) {
+        sumTemplateData[c] += t[c] * d[c];
+      }
+    }
+
+    double sum{0};
+    for (std::size_t c{0}; c < channels; ++c) {
+      const auto denominatorData{
+          std::sqrt(size * _sumSquaredData[c] - _sumData[c] * _sumData[c])};
+      const auto coefficient{
+          (size * sumTemplateData[c] -
+           _sumTemplateWaveform[c] * _sumData[c]) /
+          (_denominatorTemplateWaveform[c] * denominatorData)};
+      sum += std::isfinite(coefficient) ? coefficient : 0;
+    }
+    out[i] = sum / channels;
+  }
+}
+
+void MultiChannelCrossCorrelation::reset() {
+  const auto channels{_templateWaveforms.size()};
+  _buffer.assign(2 * _size * channels, 0);
+  _position = 0;
+  _sumData.assign(channels, 0);
+  _sumSquaredData.assign(channels, 0);
+  _sumTemplateData.assign(channels, 0);
+}
+
+void MultiChannelCrossCorrelation::setSamplingFrequency(
+    double samplingFrequency) {
+  assert((samplingFrequency > 0));
+  if (_samplingFrequency == samplingFrequency && _size > 0) {
+    return;
+  }
+
+  _samplingFrequency = samplingFrequency;
+  _size = std::numeric_limits<std::size_t>::max();
+  for (auto &templateWaveform : _templateWaveforms) {
+    templateWaveform.setSamplingFrequency(samplingFrequency);
+    _size = std::min(_size, templateWaveform.size());
+  }
+
+  const auto channels{_templateWaveforms.size()};
+  _templateSamples.assign(_size * channels, 0);
+  _sumTemplateWaveform.assign(channels, 0);
+  _denominatorTemplateWaveform.assign(channels, 0);
+  for (std::size_t c{0}; c < channels; ++c) {
+    const auto *samples{
+        DoubleArray::ConstCast(_templateWaveforms[c].waveform().data())
+            ->typedData()};
+    double sumSquared{0};
+    for (std::size_t k{0}; k < _size; ++k) {
+      _templateSamples[k * channels + c] = samples[k];
+      _sumTemplateWaveform[c] += samples[k];
+      sumSquared += util::square(samples[k]);
+    }
+    _denominatorTemplateWaveform[c] =
+        std::sqrt(_size * sumSquared -
+                  _sumTemplateWaveform[c] * _sumTemplateWaveform[c]);
+  }
+
+  reset();
+}
+
+double MultiChannelCrossCorrelation::samplingFrequency() const {
+  return _samplingFrequency;
+}
+
+std::size_t MultiChannelCrossCorrelation::channels() const {
+  return _templateWaveforms.size();
+}
+
+std::size_t MultiChannelCrossCorrelation::size() const { return _size; }
+
+const std::vector<TemplateWaveform> &
+MultiChannelCrossCorrelation::templateWaveforms() const {
+  return _templateWaveforms;
+}
+
+std::size_t MultiChannelCrossCorrelation::memoryUsage() const {
+  return (_buffer.capacity() + _templateSamples.capacity()) * sizeof(double);
+}
+
+std::size_t MultiChannelCrossCorrelation::estimatedMemoryUsage() const {
+  if (_samplingFrequency > 0) {
+    return memoryUsage();
+  }
+
+  // the template waveforms are truncated to the shortest template waveform;
+  // the data samples are stored twice
+  std::size_t size{0};
+  for (const auto &templateWaveform : _templateWaveforms) {
+    size = size == 0 ? templateWaveform.size()
+                     : std::min(size, templateWaveform.size());
+  }
+  return 3 * channels() * size * sizeof(double);
+}
+
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
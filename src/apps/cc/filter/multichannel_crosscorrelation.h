@@ -0,0 +1,93 @@
+#ifndef SCDETECT_APPS_CC_FILTER_MULTICHANNELCROSSCORRELATION_H_
+#define SCDETECT_APPS_CC_FILTER_MULTICHANNELCROSSCORRELATION_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "../template_waveform.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+
+// Multichannel cross-correlation filter implementation
+//
+// - correlates the time-aligned data of several channels (e.g. the components
+// of a station) against a template waveform per channel in a single pass;
+// the channels' samples are interleaved such that the channels are processed
+// in the innermost loop (see also `iir::FilterBank`)
+// - the filter output is the mean of the channels' Pearson correlation
+// coefficients
+// - the filter delay corresponds to the length of the template waveforms
+// (the template waveforms are truncated to the length of the shortest
+// template waveform)
+class MultiChannelCrossCorrelation {
+ public:
+  // Creates a `MultiChannelCrossCorrelation` filter from
+  // `templateWaveforms` (one template waveform per channel)
+  //
+  // - `templateWaveforms` must not be empty; the template waveforms must
+  // refer to the same start time
+  explicit MultiChannelCrossCorrelation(
+      std::vector<TemplateWaveform> templateWaveforms);
+
+  // Correlates `n` samples of each channel, where `data` points to
+  // `channels()` arrays of time-aligned samples, and writes the mean
+  // coefficients to `out`
+  //
+  // - throws `BaseException` if the filter is not initialized
+  void apply(std::size_t n, const double *const *data, double *out);
+  // Resets the filter
+  void reset();
+
+  // Sets the sampling frequency in Hz (i.e. resamples the template waveforms
+  // if required)
+  void setSamplingFrequency(double samplingFrequency);
+  // Returns the configured sampling frequency (`0` if not initialized, yet)
+  double samplingFrequency() const;
+
+  // Returns the number of channels
+  std::size_t channels() const;
+  // Returns the number of template waveform samples per channel
+  std::size_t size() const;
+  // Returns the template waveforms
+  const std::vector<TemplateWaveform> &templateWaveforms() const;
+
+  // Returns the number of bytes allocated for buffering data and template
+  // waveform samples
+  std::size_t memoryUsage() const;
+  // Returns the number of bytes expected to be allocated once the filter is
+  // initialized (i.e. `memoryUsage()` if initialized, already)
+  std::size_t estimatedMemoryUsage() const;
+
+ private:
+  std::vector<TemplateWaveform> _templateWaveforms;
+  double _samplingFrequency{0};
+
+  // The number of template waveform samples per channel
+  std::size_t _size{0};
+  // The interleaved template waveform samples (i.e. sample `i` of channel `c`
+  // is located at `i * channels() + c`)
+  std::vector<double> _templateSamples;
+  // Per channel template waveform samples summed
+  std::vector<double> _sumTemplateWaveform;
+  std::vector<double> _denominatorTemplateWaveform;
+
+  // The interleaved data samples; each sample is stored twice (at position
+  // `i` and `i + size()`) such that the most recent `size()` samples are
+  // always contiguous starting at `_position`
+  std::vector<double> _buffer;
+  std::size_t _position{0};
+  // Per channel data samples (squared) summed
+  std::vector<double> _sumData;
+  std::vector<double> _sumSquaredData;
+  // Per channel sums of the template waveform samples multiplied with the
+  // data samples (reused in order to avoid allocations)
+  std::vector<double> _sumTemplateData;
+};
+
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_FILTER_MULTICHANNELCROSSCORRELATION_H_
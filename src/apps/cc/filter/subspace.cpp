@@ -0,0 +1,239 @@
+#include "subspace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+namespace subspace {
+
+namespace {
+
+// Demeans and normalizes `samples` in place
+void normalize(std::vector<double> &samples) {
+  if (samples.empty()) {
+    return;
+  }
+
+  const auto mean{std::accumulate(samples.begin(), samples.end(), 0.0) /
+                  samples.size()};
+  double energy{0};
+  for (auto &sample : samples) {
+    sample -= mean;
+    energy += sample * sample;
+  }
+
+  if (energy > 0) {
+    const auto norm{1 / std::sqrt(energy)};
+    for (auto &sample : samples) {
+      sample *= norm;
+    }
+  }
+}
+
+// Computes the eigen decomposition of the symmetric `m` x `m` matrix `a`
+// (row-major) by means of the cyclic Jacobi method. On return, the diagonal of
+// `a` contains the eigenvalues and the columns of `v` the corresponding
+// eigenvectors.
+void jacobi(std::vector<double> &a, std::size_t m, std::vector<double> &v) {
+  v.assign(m * m, 0);
+  for (std::size_t i{0}; i < m; ++i) {
+    v[i * m + i] = 1;
+  }
+
+  const auto norm{std::sqrt(std::inner_product(a.begin(), a.end(), a.begin(),
+                                               0.0))};
+  for (int sweep{0}; sweep < 100; ++sweep) {
+    double offDiagonal{0};
+    for (std::size_t p{0}; p < m; ++p) {
+      for (std::size_t q{p + 1}; q < m; ++q) {
+        offDiagonal += a[p * m + q] * a[p * m + q];
+      }
+    }
+    if (std::sqrt(offDiagonal) <= 1e-12 * norm) {
+      break;
+    }
+
+    for (std::size_t p{0}; p < m; ++p) {
+      for (std::size_t q{p + 1}; q < m; ++q) {
+        const auto apq{a[p * m + q]};
+        if (apq == 0) {
+          continue;
+        }
+
+        const auto theta{(a[q * m + q] - a[p * m + p]) / (2 * apq)};
+        const auto t{(theta >= 0 ? 1.0 : -1.0) /
+                     (std::abs(theta) + std::sqrt(theta * theta + 1))};
+        const auto c{1 / std::sqrt(t * t + 1)};
+        const auto s{t * c};
+
+        for (std::size_t k{0}; k < m; ++k) {
+          const auto akp{a[k * m + p]};
+          const auto akq{a[k * m + q]};
+          a[k * m + p] = c * akp - s * akq;
+          a[k * m + q] = s * akp + c * akq;
+        }
+        for (std::size_t k{0}; k < m; ++k) {
+          const auto apk{a[p * m + k]};
+          const auto aqk{a[q * m + k]};
+          a[p * m + k] = c * apk - s * aqk;
+          a[q * m + k] = s * apk + c * aqk;
+        }
+        for (std::size_t k{0}; k < m; ++k) {
+          const auto vkp{v[k * m + p]};
+          const auto vkq{v[k * m + q]};
+          v[k * m + p] = c * vkp - s * vkq;
+          v[k * m + q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+std::size_t Basis::dimension() const {
+  return length > 0 ? vectors.size() / length : 0;
+}
+
+bool Basis::empty() const { return vectors.empty(); }
+
+int align(const std::vector<double> &reference,
+          const std::vector<double> &waveform, std::size_t maxLag) {
+  const auto n{static_cast<int>(reference.size())};
+  const auto m{static_cast<int>(waveform.size())};
+  const auto l{static_cast<int>(maxLag)};
+
+  int ret{0};
+  double max{-1};
+  for (int lag{-l}; lag <= l; ++lag) {
+    double cc{0};
+    for (int i{std::max(0, -lag)}; i < std::min(n, m - lag); ++i) {
+      cc += reference[i] * waveform[i + lag];
+    }
+    if (std::abs(cc) > max) {
+      max = std::abs(cc);
+      ret = lag;
+    }
+  }
+  return ret;
+}
+
+Basis design(const std::vector<std::vector<double>> &waveforms,
+             std::size_t dimension, std::size_t maxLag) {
+  Basis ret;
+  if (waveforms.empty() || waveforms.front().empty() || dimension == 0) {
+    return ret;
+  }
+
+  // prepare the (column-major) `n` x `m` matrix of aligned waveforms
+  const auto n{waveforms.front().size()};
+  const auto m{waveforms.size()};
+  auto reference{waveforms.front()};
+  normalize(reference);
+
+  std::vector<double> matrix(n * m, 0);
+  std::copy(reference.begin(), reference.end(), matrix.begin());
+  for (std::size_t j{1}; j < m; ++j) {
+    auto waveform{waveforms[j]};
+    normalize(waveform);
+    const auto lag{align(reference, waveform, maxLag)};
+
+    std::vector<double> aligned(n, 0);
+    for (std::size_t i{0}; i < n; ++i) {
+      const auto k{static_cast<long>(i) + lag};
+      if (k >= 0 && k < static_cast<long>(waveform.size())) {
+        aligned[i] = waveform[k];
+      }
+    }
+    // renormalize, since truncating or zero padding alters both the mean and
+    // the energy
+    normalize(aligned);
+    std::copy(aligned.begin(), aligned.end(), matrix.begin() + j * n);
+  }
+
+  // singular value decomposition by means of the eigen decomposition of the
+  // (small) `m` x `m` Gram matrix
+  std::vector<double> gram(m * m);
+  for (std::size_t p{0}; p < m; ++p) {
+    for (std::size_t q{p}; q < m; ++q) {
+      const auto *a{matrix.data() + p * n};
+      const auto *b{matrix.data() + q * n};
+      gram[p * m + q] = gram[q * m + p] = std::inner_product(a, a + n, b, 0.0);
+    }
+  }
+
+  std::vector<double> v;
+  jacobi(gram, m, v);
+
+  std::vector<std::size_t> order(m);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&gram, m](std::size_t i, std::size_t j) {
+              return gram[i * m + i] > gram[j * m + j];
+            });
+
+  double totalEnergy{0};
+  for (std::size_t i{0}; i < m; ++i) {
+    totalEnergy += std::max(0.0, gram[i * m + i]);
+  }
+  if (totalEnergy <= 0) {
+    return ret;
+  }
+
+  ret.length = n;
+  const auto maxEigenvalue{gram[order.front() * m + order.front()]};
+  double capturedEnergy{0};
+  for (std::size_t j{0}; j < std::min(dimension, m); ++j) {
+    const auto idx{order[j]};
+    const auto eigenvalue{gram[idx * m + idx]};
+    // skip vectors beyond the rank of the matrix
+    if (eigenvalue <= 1e-10 * maxEigenvalue) {
+      break;
+    }
+
+    // left singular vector, i.e. u_j = A * v_j / sigma_j
+    std::vector<double> u(n, 0);
+    for (std::size_t k{0}; k < m; ++k) {
+      const auto weight{v[k * m + idx]};
+      const auto *a{matrix.data() + k * n};
+      for (std::size_t i{0}; i < n; ++i) {
+        u[i] += weight * a[i];
+      }
+    }
+
+    // reorthogonalize w.r.t. the vectors already computed in order to
+    // compensate for round-off errors
+    for (std::size_t l{0}; l < ret.dimension(); ++l) {
+      const auto *b{ret.vectors.data() + l * n};
+      const auto projection{std::inner_product(u.begin(), u.end(), b, 0.0)};
+      for (std::size_t i{0}; i < n; ++i) {
+        u[i] -= projection * b[i];
+      }
+    }
+    const auto norm{
+        std::sqrt(std::inner_product(u.begin(), u.end(), u.begin(), 0.0))};
+    if (norm <= 0) {
+      break;
+    }
+    for (auto &sample : u) {
+      sample /= norm;
+    }
+
+    ret.vectors.insert(ret.vectors.end(), u.begin(), u.end());
+    capturedEnergy += eigenvalue;
+  }
+
+  ret.capturedEnergy = capturedEnergy / totalEnergy;
+  if (ret.vectors.empty()) {
+    ret.length = 0;
+  }
+  return ret;
+}
+
+}  // namespace subspace
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,52 @@
+#ifndef SCDETECT_APPS_CC_FILTER_SUBSPACE_H_
+#define SCDETECT_APPS_CC_FILTER_SUBSPACE_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+namespace filter {
+namespace subspace {
+
+// Orthonormal basis of the subspace spanned by a group of (aligned) waveforms
+struct Basis {
+  // The number of samples of a basis vector
+  std::size_t length{0};
+  // The basis vectors (vector `j` is located at `j * length`); the vectors are
+  // demeaned and ordered by decreasing singular value
+  std::vector<double> vectors;
+  // The fraction of the (normalized) waveforms' energy captured by the basis
+  double capturedEnergy{0};
+
+  // Returns the number of basis vectors
+  std::size_t dimension() const;
+  // Returns `true` if the basis does not contain any vector, else `false`
+  bool empty() const;
+};
+
+// Returns the lag (in samples) which aligns `waveform` with `reference`, i.e.
+// the lag of the maximum absolute cross-correlation coefficient in the range
+// `[-maxLag, maxLag]`
+//
+// - a positive lag means `waveform` is delayed w.r.t. `reference`
+int align(const std::vector<double> &reference,
+          const std::vector<double> &waveform, std::size_t maxLag);
+
+// Designs the basis of dimension `dimension` by means of the singular value
+// decomposition of the matrix of `waveforms`
+//
+// - the waveforms are demeaned, normalized, and aligned with the first
+// waveform (see `align()`); besides, they are truncated or zero padded to
+// the length of the first waveform
+// - the dimension of the basis returned is limited by the rank of the matrix
+// - returns an empty basis if `waveforms` is empty or `dimension` is zero
+Basis design(const std::vector<std::vector<double>> &waveforms,
+             std::size_t dimension, std::size_t maxLag);
+
+}  // namespace subspace
+}  // namespace filter
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_FILTER_SUBSPACE_H_
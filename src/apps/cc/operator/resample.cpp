@@ -14,6 +14,11 @@ processing::WaveformProcessor::Status ResamplingOperator::feed(
     return processing::WaveformProcessor::Status::kWaitingForData;
   }
 
+  if (record->samplingFrequency() != _recordResampler->sourceFrequency()) {
+    _recordResampler = RecordResamplerStore::Instance().get(
+        record, _recordResampler->targetFrequency());
+  }
+
   auto *resampled{_recordResampler->feed(record)};
   if (static_cast<bool>(resampled)) {
     WaveformOperator::store(resampled);
@@ -21,16 +26,14 @@ processing::WaveformProcessor::Status ResamplingOperator::feed(
     return processing::WaveformProcessor::Status::kInProgress;
   }
 
-  return processing::WaveformProcessor::Status::kError;
+  // the record fed is buffered by the resampler (e.g. if not sufficient samples
+  // are available in order to compute a resampled sample)
+  return processing::WaveformProcessor::Status::kWaitingForData;
 }
 
 void ResamplingOperator::reset() {
   if (_recordResampler) {
-    // XXX(damb): Cloning is currently the only way in order to actually reset
-    // the record resampler
-    _recordResampler.reset(
-        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
-        static_cast<RecordResampler *>(_recordResampler->clone()));
+    _recordResampler->reset();
   }
 }
 
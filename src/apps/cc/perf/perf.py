@@ -10,7 +10,10 @@ import platform
 import subprocess
 import re
 import sys
+import tempfile
+import xml.etree.ElementTree as ET
 
+from datetime import datetime
 from pathlib import Path, PurePath
 from collections import defaultdict, namedtuple, Counter
 
@@ -55,6 +58,40 @@ def get_cpu_info():
         return platform.platform()
 
 
+def read_origin_times(path_ep):
+    """
+    Read the origin times from the SCML formatted event parameters located at
+    `path_ep`.
+    """
+
+    def local_name(tag):
+        return tag.rsplit("}", 1)[-1]
+
+    def child(element, name):
+        for c in element:
+            if local_name(c.tag) == name:
+                return c
+        return None
+
+    ret = []
+    for element in ET.parse(path_ep).getroot().iter():
+        if local_name(element.tag) != "origin":
+            continue
+
+        time = child(element, "time")
+        value = child(time, "value") if time is not None else None
+        if value is None or not value.text:
+            continue
+
+        # parse the fraction of seconds separately since the number of digits
+        # varies
+        base, _, fraction = value.text.strip().rstrip("Z").partition(".")
+        t = datetime.strptime(base, "%Y-%m-%dT%H:%M:%S").timestamp()
+        ret.append(t + (float(f"0.{fraction}") if fraction else 0))
+
+    return sorted(ret)
+
+
 def build_parser():
     parser = argparse.ArgumentParser(
         description="Benchmark scdetect-cc",
@@ -88,6 +125,16 @@ def build_parser():
         action="store_true",
         help="estimate scdetect-cc's real-time overload capacity",
     )
+    parser.add_argument(
+        "--prescreen-margin",
+        dest="prescreen_margin",
+        metavar="MARGIN",
+        type=float,
+        default=None,
+        help="run benchmark with the quantized pre-screening enabled (using "
+        "the margin MARGIN) and report the false negative rate with regards "
+        "to the detections based on the exact cross-correlation",
+    )
     parser.add_argument(
         "binary",
         type=file_path,
@@ -160,10 +207,16 @@ def run_benchmark(
     waveform_data_size,
     estimate_overload_capacity=True,
     debug_mode=False,
+    prescreen_margin=None,
 ):
     report = ThreeStreamDetectorReport(
         waveform_data_size, estimate_overload_capacity
     )
+    prescreen_report = (
+        PrescreenReport(prescreen_margin)
+        if prescreen_margin is not None
+        else None
+    )
 
     sampling_frequencies = [50, 100, 200]
     num_detectors = [1, 2, 4, 8]
@@ -175,7 +228,7 @@ def run_benchmark(
     fname_waveform_data = f"data.{waveform_data_size}.mseed"
     fname_config = "scdetect-cc.cfg"
 
-    def create_cmd(path_sample_cfg, debug_mode):
+    def create_cmd(path_sample_cfg, debug_mode, extra_flags=()):
         flags = [
             FlagOffline(),
             FlagPlayback(),
@@ -187,11 +240,53 @@ def run_benchmark(
             FlagEventDB(path_sample_cfg / fname_catalog),
             FlagRecordStreamURL(path_sample_cfg / fname_waveform_data),
         ]
+        flags.extend(extra_flags)
         if debug_mode:
             flags.append(FlagDebug())
 
         return (f"{flag}" for flag in flags)
 
+    def count_false_negatives(path_sample_cfg, sampling_frequency):
+        # compare the detections of a single trial with and without the
+        # pre-screening enabled
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            path_reference = Path(tmp_dir) / "reference.scml"
+            path_screened = Path(tmp_dir) / "screened.scml"
+            run_perf_app_process(
+                path_binary,
+                1,
+                create_cmd(
+                    path_sample_cfg,
+                    debug_mode,
+                    [FlagPrescreenForce(-1), FlagEp(path_reference)],
+                ),
+            )
+            run_perf_app_process(
+                path_binary,
+                1,
+                create_cmd(
+                    path_sample_cfg,
+                    debug_mode,
+                    [
+                        FlagPrescreenForce(prescreen_margin),
+                        FlagEp(path_screened),
+                    ],
+                ),
+            )
+
+            reference = read_origin_times(path_reference)
+            screened = read_origin_times(path_screened)
+
+        tolerance = PrescreenReport.MATCHING_TOLERANCE_SAMPLES / (
+            sampling_frequency
+        )
+        missed = sum(
+            1
+            for t in reference
+            if not any(abs(t - other) <= tolerance for other in screened)
+        )
+        return len(reference), missed
+
     for sample_cfg in itertools.product(sampling_frequencies, num_detectors):
         for sample in samples:
             path_sample_cfg = (
@@ -203,18 +298,30 @@ def run_benchmark(
             try:
                 if not path_sample_cfg.resolve().is_dir():
                     logging.error(f"invalid path: {str(path_sample_cfg)}")
-                    return report
+                    return report, prescreen_report
             except OSError as err:
                 logging.error(f"invalid path: {str(path_sample_cfg)}")
                 continue
 
+            extra_flags = []
+            if prescreen_margin is not None:
+                extra_flags.append(FlagPrescreenForce(prescreen_margin))
+
             sample = run_perf_app_process(
-                path_binary, trials, create_cmd(path_sample_cfg, debug_mode)
+                path_binary,
+                trials,
+                create_cmd(path_sample_cfg, debug_mode, extra_flags),
             )
 
             report.add(sample)
 
-    return report
+            if prescreen_report is not None:
+                detections, missed = count_false_negatives(
+                    path_sample_cfg, sample.sampling_frequency
+                )
+                prescreen_report.add(sample, detections, missed)
+
+    return report, prescreen_report
 
 
 Sample = namedtuple(
@@ -430,6 +537,55 @@ class ThreeStreamDetectorReport:
         return np.linalg.lstsq(A, B, rcond=None)
 
 
+class PrescreenReport:
+    # the maximum offset (in samples) of detections to be considered equal
+    MATCHING_TOLERANCE_SAMPLES = 2
+
+    def __init__(self, margin):
+        self._margin = margin
+        self._samples = []
+
+    def add(self, sample, detections, missed):
+        self._samples.append((sample, detections, missed))
+
+    @staticmethod
+    def _rate(detections, missed):
+        return f"{missed / detections:.4f}" if detections else "nan"
+
+    def __str__(self):
+        if not self._samples:
+            return ""
+
+        ret = (
+            "=== Station detector report - quantized pre-screening "
+            f"(margin={self._margin}) ===\n"
+        )
+        ret += (
+            "sampling_frequency (Hz),num_detectors,"
+            "length_template_waveform (s),detections_reference,"
+            "detections_missed,false_negative_rate\n"
+        )
+
+        total_detections = 0
+        total_missed = 0
+        for sample, detections, missed in self._samples:
+            ret += (
+                f"{sample.sampling_frequency},"
+                f"{len(sample.detector_config)},"
+                f"{sample.template_waveform_length},"
+                f"{detections},{missed},{self._rate(detections, missed)}"
+                "\n"
+            )
+            total_detections += detections
+            total_missed += missed
+
+        ret += (
+            f"total,,,{total_detections},{total_missed},"
+            f"{self._rate(total_detections, total_missed)}\n"
+        )
+        return ret
+
+
 class Flag:
     _SEP = "="
     _FLAG = None
@@ -509,6 +665,19 @@ class FlagTemplatesReload(Flag):
     _FLAG = "--templates-reload"
 
 
+class FlagEp(Flag):
+    _FLAG = "--ep"
+
+    def __init__(self, path):
+        if isinstance(path, PurePath):
+            path = path.resolve()
+        super().__init__(path)
+
+
+class FlagPrescreenForce(Flag):
+    _FLAG = "--prescreen-force"
+
+
 class FlagAmplitudesForce(Flag):
     _FLAG = "--amplitudes-force"
 
@@ -520,13 +689,14 @@ def main(argv=None):
     parser = build_parser()
     args = parser.parse_args()
 
-    report = run_benchmark(
+    report, prescreen_report = run_benchmark(
         args.binary,
         args.trials,
         args.data,
         args.data_size,
         args.estimate_overload_capacity,
         args.debug,
+        args.prescreen_margin,
     )
 
     if args.plot:
@@ -534,6 +704,8 @@ def main(argv=None):
         plt.show()
 
     print(report)
+    if prescreen_report is not None:
+        print(prescreen_report)
 
 
 if __name__ == "__main__":
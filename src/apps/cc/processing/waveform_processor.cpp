@@ -4,6 +4,7 @@
 #include <cmath>
 #include <exception>
 
+#include "../filter/iir.h"
 #include "waveform_operator.h"
 
 namespace Seiscomp {
@@ -248,6 +249,13 @@ void WaveformProcessor::setStatus(Status status, double value) {
 
 std::unique_ptr<WaveformProcessor::Filter> createFilter(
     const std::string &filter) {
+  if (detect::filter::iir::nativeFilters()) {
+    auto native{detect::filter::iir::createFilter(filter)};
+    if (native) {
+      return native;
+    }
+  }
+
   std::string err;
   std::unique_ptr<WaveformProcessor::Filter> ret{
       WaveformProcessor::Filter::Create(filter, &err)};
@@ -207,6 +207,8 @@ class WaveformProcessor : public Processor, public detail::InterpolateGaps {
   double _statusValue{0};
 };
 
+// Creates a filter from its identifier (natively implemented filters are used
+// if enabled; see `filter::iir::setNativeFilters()`)
 std::unique_ptr<WaveformProcessor::Filter> createFilter(
     const std::string &filter);
 
@@ -0,0 +1,279 @@
+#include "resampler.h"
+
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/typedarray.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Seiscomp {
+namespace detect {
+namespace resampler {
+
+namespace {
+
+// Zeroth-order modified Bessel function of the first kind
+double besselI0(double x) {
+  double ret{1};
+  double term{1};
+  const auto xx{0.25 * x * x};
+  for (int k{1}; k < 64; ++k) {
+    term *= xx / (static_cast<double>(k) * k);
+    ret += term;
+    if (term < 1e-16 * ret) {
+      break;
+    }
+  }
+  return ret;
+}
+
+double kaiserBeta(double attenuation) {
+  if (attenuation > 50) {
+    return 0.1102 * (attenuation - 8.7);
+  } else if (attenuation >= 21) {
+    return 0.5842 * std::pow(attenuation - 21, 0.4) +
+           0.07886 * (attenuation - 21);
+  }
+  return 0;
+}
+
+double sinc(double x) {
+  if (x == 0) {
+    return 1;
+  }
+  return std::sin(M_PI * x) / (M_PI * x);
+}
+
+}  // namespace
+
+Core::TimeSpan RecordResampler::latency() const { return Core::TimeSpan{0.0}; }
+
+boost::optional<std::pair<std::size_t, std::size_t>> rationalize(
+    double sourceFrequency, double targetFrequency, std::size_t maxFactor) {
+  if (sourceFrequency <= 0 || targetFrequency <= 0) {
+    return boost::none;
+  }
+
+  // the smallest upsampling factor results in the reduced ratio
+  for (std::size_t upsampling{1}; upsampling <= maxFactor; ++upsampling) {
+    const auto downsampling{
+        std::round(upsampling * sourceFrequency / targetFrequency)};
+    if (downsampling < 1 || downsampling > maxFactor) {
+      continue;
+    }
+
+    if (std::abs(upsampling * sourceFrequency -
+                 downsampling * targetFrequency) <=
+        1e-9 * upsampling * sourceFrequency) {
+      return std::make_pair(upsampling,
+                            static_cast<std::size_t>(downsampling));
+    }
+  }
+  return boost::none;
+}
+
+PolyphaseCoefficientsCPtr designPolyphase(double sourceFrequency,
+                                          double targetFrequency, double fp,
+                                          double fs, double attenuation) {
+  assert((0 < fp && fp < fs && fs <= 1));
+
+  const auto factors{rationalize(sourceFrequency, targetFrequency, 128)};
+  if (!factors) {
+    return nullptr;
+  }
+
+  auto ret{std::make_shared<PolyphaseCoefficients>()};
+  ret->sourceFrequency = sourceFrequency;
+  ret->targetFrequency = targetFrequency;
+  ret->upsampling = factors->first;
+  ret->downsampling = factors->second;
+
+  const auto l{ret->upsampling};
+  const auto upsampledFrequency{static_cast<double>(l) * sourceFrequency};
+  const auto nyquist{0.5 * std::min(sourceFrequency, targetFrequency)};
+  // cutoff and transition width normalized to the upsampled sampling
+  // frequency
+  const auto cutoff{0.5 * (fp + fs) * nyquist / upsampledFrequency};
+  const auto transitionWidth{(fs - fp) * nyquist / upsampledFrequency};
+
+  // Kaiser's estimate for the filter length
+  const auto n{static_cast<std::size_t>(std::ceil(
+                   (attenuation - 8) / (2.285 * 2 * M_PI * transitionWidth))) +
+               1};
+  ret->tapsPerPhase = (n + l - 1) / l;
+  const auto numberOfTaps{ret->tapsPerPhase * l};
+
+  const auto center{0.5 * static_cast<double>(numberOfTaps - 1)};
+  const auto beta{kaiserBeta(attenuation)};
+  const auto normalization{besselI0(beta)};
+
+  std::vector<double> prototype(numberOfTaps);
+  for (std::size_t i{0}; i < numberOfTaps; ++i) {
+    const auto x{static_cast<double>(i) - center};
+    const auto r{center > 0 ? x / center : 0};
+    const auto window{
+        besselI0(beta * std::sqrt(std::max(0.0, 1 - r * r))) / normalization};
+    // the gain compensates the zeros inserted when upsampling
+    prototype[i] =
+        static_cast<double>(l) * 2 * cutoff * sinc(2 * cutoff * x) * window;
+  }
+
+  // polyphase decomposition; the taps of a phase are reversed such that
+  // computing a sample is a dot product with contiguous input samples
+  const auto k{ret->tapsPerPhase};
+  ret->taps.resize(numberOfTaps);
+  for (std::size_t phase{0}; phase < l; ++phase) {
+    for (std::size_t j{0}; j < k; ++j) {
+      ret->taps[phase * k + j] = prototype[phase + (k - 1 - j) * l];
+    }
+  }
+
+  ret->delay = Core::TimeSpan{center / upsampledFrequency};
+  return ret;
+}
+
+/* ------------------------------------------------------------------------- */
+PolyphaseRecordResampler::PolyphaseRecordResampler(
+    PolyphaseCoefficientsCPtr coefficients)
+    : _coefficients{std::move(coefficients)} {
+  assert(_coefficients);
+}
+
+Record *PolyphaseRecordResampler::feed(const Record *record) {
+  if (!record || !record->data() || record->sampleCount() == 0 ||
+      record->samplingFrequency() != _coefficients->sourceFrequency) {
+    return nullptr;
+  }
+
+  DoubleArrayPtr data{
+      dynamic_cast<DoubleArray *>(record->data()->copy(Array::DOUBLE))};
+  if (!data) {
+    return nullptr;
+  }
+
+  const auto sourceFrequency{_coefficients->sourceFrequency};
+  if (_initialized) {
+    const auto expected{_startTime +
+                        Core::TimeSpan{static_cast<double>(_inputCount) /
+                                       sourceFrequency}};
+    // restart the stream in case of gaps and overlaps
+    if (record->streamID() != _streamId ||
+        std::abs(static_cast<double>(record->startTime() - expected)) >
+            0.5 / sourceFrequency) {
+      _initialized = false;
+    }
+  }
+  if (!_initialized) {
+    initStream(record, (*data)[0]);
+  }
+
+  const auto l{static_cast<std::int64_t>(_coefficients->upsampling)};
+  const auto m{static_cast<std::int64_t>(_coefficients->downsampling)};
+  const auto k{_coefficients->tapsPerPhase};
+  const auto numberOfSamples{static_cast<std::int64_t>(data->size())};
+
+  _buffer.insert(std::end(_buffer), data->typedData(),
+                 data->typedData() + data->size());
+
+  std::vector<double> resampled;
+  resampled.reserve(static_cast<std::size_t>(numberOfSamples * l / m + 1));
+  const auto *taps{_coefficients->taps.data()};
+  while (_offset / l < numberOfSamples) {
+    const auto *phaseTaps{taps + (_offset % l) * k};
+    const auto *samples{_buffer.data() + _offset / l};
+
+    double sample{0};
+    for (std::size_t j{0}; j < k; ++j) {
+      sample += phaseTaps[j] * samples[j];
+    }
+    resampled.push_back(sample);
+    _offset += m;
+  }
+  _offset -= l * numberOfSamples;
+
+  // keep the filter history, only
+  _buffer.erase(std::begin(_buffer), std::end(_buffer) - (k - 1));
+
+  const auto outputCount{_outputCount};
+  _inputCount += numberOfSamples;
+  _outputCount += static_cast<std::int64_t>(resampled.size());
+  if (resampled.empty()) {
+    return nullptr;
+  }
+
+  const auto targetFrequency{_coefficients->targetFrequency};
+  auto *ret{new GenericRecord{
+      record->networkCode(), record->stationCode(), record->locationCode(),
+      record->channelCode(),
+      _startTime +
+          Core::TimeSpan{static_cast<double>(outputCount) / targetFrequency} -
+          _coefficients->delay,
+      targetFrequency}};
+  ret->setData(static_cast<int>(resampled.size()), resampled.data(),
+               Array::DOUBLE);
+  return ret;
+}
+
+void PolyphaseRecordResampler::reset() {
+  _initialized = false;
+  _streamId.clear();
+  _buffer.clear();
+}
+
+double PolyphaseRecordResampler::sourceFrequency() const {
+  return _coefficients->sourceFrequency;
+}
+
+double PolyphaseRecordResampler::targetFrequency() const {
+  return _coefficients->targetFrequency;
+}
+
+Core::TimeSpan PolyphaseRecordResampler::latency() const {
+  return _coefficients->delay;
+}
+
+void PolyphaseRecordResampler::initStream(const Record *record,
+                                          double firstSample) {
+  _streamId = record->streamID();
+  _startTime = record->startTime();
+  _inputCount = 0;
+  _outputCount = 0;
+  _offset = 0;
+  // extend the first sample backwards in time rather than assuming zeros in
+  // order to reduce the filter's transient response
+  _buffer.assign(_coefficients->tapsPerPhase - 1, firstSample);
+
+  _initialized = true;
+}
+
+/* ------------------------------------------------------------------------- */
+LanczosRecordResampler::LanczosRecordResampler(
+    double sourceFrequency, double targetFrequency,
+    std::shared_ptr<const Resampler> prototype)
+    : _sourceFrequency{sourceFrequency},
+      _targetFrequency{targetFrequency},
+      _prototype{std::move(prototype)} {
+  assert(_prototype);
+  reset();
+}
+
+Record *LanczosRecordResampler::feed(const Record *record) {
+  return _resampler->feed(record);
+}
+
+void LanczosRecordResampler::reset() {
+  _resampler.reset(dynamic_cast<Resampler *>(_prototype->clone()));
+}
+
+double LanczosRecordResampler::sourceFrequency() const {
+  return _sourceFrequency;
+}
+
+double LanczosRecordResampler::targetFrequency() const {
+  return _targetFrequency;
+}
+
+}  // namespace resampler
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,148 @@
+#ifndef SCDETECT_APPS_CC_RESAMPLER_H_
+#define SCDETECT_APPS_CC_RESAMPLER_H_
+
+#include <seiscomp/core/record.h>
+#include <seiscomp/core/timewindow.h>
+#include <seiscomp/io/recordfilter/resample.h>
+
+#include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+namespace resampler {
+
+// Interface of a streaming record resampler
+class RecordResampler {
+ public:
+  virtual ~RecordResampler() = default;
+
+  // Feeds `record` to the resampler. Returns the resampled record or `nullptr`
+  // if no samples could be computed, yet. The caller takes ownership of the
+  // record returned.
+  virtual Record *feed(const Record *record) = 0;
+
+  // Resets the streaming state
+  virtual void reset() = 0;
+
+  // Returns the sampling frequency of the records accepted
+  virtual double sourceFrequency() const = 0;
+  // Returns the sampling frequency of the records returned
+  virtual double targetFrequency() const = 0;
+  // Returns the latency, i.e. the time span of the data fed which is not yet
+  // covered by the records returned
+  virtual Core::TimeSpan latency() const;
+};
+
+// Polyphase decomposition of a FIR lowpass filter used for rational
+// resampling (i.e. upsampling by `upsampling`, filtering and downsampling by
+// `downsampling`)
+struct PolyphaseCoefficients {
+  double sourceFrequency;
+  double targetFrequency;
+
+  std::size_t upsampling;
+  std::size_t downsampling;
+
+  // The number of taps per phase
+  std::size_t tapsPerPhase;
+  // The filter taps (phase-major); the taps of a phase are stored in reversed
+  // order
+  std::vector<double> taps;
+
+  // The group delay of the filter
+  Core::TimeSpan delay;
+};
+using PolyphaseCoefficientsCPtr = std::shared_ptr<const PolyphaseCoefficients>;
+
+// Returns the rational factors `(upsampling, downsampling)` resampling from
+// `sourceFrequency` to `targetFrequency`
+//
+// - returns `boost::none` if there is no exact ratio with both factors not
+// exceeding `maxFactor`
+boost::optional<std::pair<std::size_t, std::size_t>> rationalize(
+    double sourceFrequency, double targetFrequency, std::size_t maxFactor);
+
+// Designs the Kaiser windowed polyphase lowpass filter resampling from
+// `sourceFrequency` to `targetFrequency`
+//
+// - `fp` and `fs` are the passband and the stopband edge, respectively, as a
+// fraction of the lower Nyquist frequency
+// - `attenuation` is the stopband attenuation in dB
+// - returns `nullptr` if the frequencies are not related by a rational ratio
+PolyphaseCoefficientsCPtr designPolyphase(double sourceFrequency,
+                                          double targetFrequency, double fp,
+                                          double fs, double attenuation);
+
+// Streaming polyphase resampler for rational resampling ratios
+//
+// - the coefficients are shared, the streaming state is not
+// - the resampled records' start time compensates the filter's group delay
+// - the streaming state is reset if a gap is detected
+class PolyphaseRecordResampler : public RecordResampler {
+ public:
+  explicit PolyphaseRecordResampler(PolyphaseCoefficientsCPtr coefficients);
+
+  Record *feed(const Record *record) override;
+
+  void reset() override;
+
+  double sourceFrequency() const override;
+  double targetFrequency() const override;
+  Core::TimeSpan latency() const override;
+
+ private:
+  void initStream(const Record *record, double firstSample);
+
+  PolyphaseCoefficientsCPtr _coefficients;
+
+  bool _initialized{false};
+  std::string _streamId;
+  // The time of the first sample fed after the stream was initialized
+  Core::Time _startTime;
+  // The number of samples fed since the stream was initialized
+  std::int64_t _inputCount{0};
+  // The number of samples computed since the stream was initialized
+  std::int64_t _outputCount{0};
+  // The position of the next sample to be computed relative to the next
+  // sample fed (in units of the upsampled sampling interval)
+  std::int64_t _offset{0};
+  // Input samples (i.e. the filter history followed by the samples fed)
+  std::vector<double> _buffer;
+};
+
+// Adapts `IO::RecordResampler<double>` (i.e. a Lanczos-windowed resampler)
+// to the `RecordResampler` interface
+class LanczosRecordResampler : public RecordResampler {
+ public:
+  using Resampler = IO::RecordResampler<double>;
+
+  LanczosRecordResampler(double sourceFrequency, double targetFrequency,
+                         std::shared_ptr<const Resampler> prototype);
+
+  Record *feed(const Record *record) override;
+
+  // cloning is currently the only way in order to actually reset the underlying
+  // record resampler
+  void reset() override;
+
+  double sourceFrequency() const override;
+  double targetFrequency() const override;
+
+ private:
+  double _sourceFrequency;
+  double _targetFrequency;
+  std::shared_ptr<const Resampler> _prototype;
+  std::unique_ptr<Resampler> _resampler;
+};
+
+}  // namespace resampler
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_RESAMPLER_H_
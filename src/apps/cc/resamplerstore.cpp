@@ -41,7 +41,10 @@ RecordResamplerStore &RecordResamplerStore::Instance() {
   return instance;
 }
 
-void RecordResamplerStore::reset() { _cache.clear(); }
+void RecordResamplerStore::reset() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _cache.clear();
+}
 
 std::unique_ptr<RecordResamplerStore::RecordResampler>
 RecordResamplerStore::get(const Record *rec, double targetFrequency) {
@@ -50,19 +53,48 @@ RecordResamplerStore::get(const Record *rec, double targetFrequency) {
 
 std::unique_ptr<RecordResamplerStore::RecordResampler>
 RecordResamplerStore::get(double currentFrequency, double targetFrequency) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto &value{cacheValue(currentFrequency, targetFrequency)};
+  if (value.coefficients) {
+    return util::make_unique<resampler::PolyphaseRecordResampler>(
+        value.coefficients);
+  }
+  return util::make_unique<resampler::LanczosRecordResampler>(
+      currentFrequency, targetFrequency, prototype(targetFrequency, value));
+}
+
+std::unique_ptr<RecordResamplerStore::RecordResampler>
+RecordResamplerStore::getTraceResampler(double currentFrequency,
+                                        double targetFrequency) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto &value{cacheValue(currentFrequency, targetFrequency)};
+  return util::make_unique<resampler::LanczosRecordResampler>(
+      currentFrequency, targetFrequency, prototype(targetFrequency, value));
+}
+
+RecordResamplerStore::CacheValue &RecordResamplerStore::cacheValue(
+    double currentFrequency, double targetFrequency) {
   record_resampler_store_detail::CacheKey key{currentFrequency,
                                               targetFrequency};
-
-  if (_cache.find(key) == _cache.end()) {
-    _cache.emplace(
-        key,
-        util::make_unique<RecordResamplerStore::RecordResampler>(
-            targetFrequency, _fp, _fs, _coefficientScale, _lanczosKernelWidth));
+  auto it{_cache.find(key)};
+  if (it == _cache.end()) {
+    CacheValue value;
+    value.coefficients = resampler::designPolyphase(
+        currentFrequency, targetFrequency, _fp, _fs, _attenuation);
+    it = _cache.emplace(key, std::move(value)).first;
   }
+  return it->second;
+}
 
-  return std::unique_ptr<RecordResamplerStore::RecordResampler>(
-      dynamic_cast<RecordResamplerStore::RecordResampler *>(
-          _cache.at(key)->clone()));
+std::shared_ptr<const resampler::LanczosRecordResampler::Resampler>
+RecordResamplerStore::prototype(double targetFrequency,
+                                CacheValue &value) const {
+  if (!value.prototype) {
+    value.prototype =
+        std::make_shared<resampler::LanczosRecordResampler::Resampler>(
+            targetFrequency, _fp, _fs, _coefficientScale, _lanczosKernelWidth);
+  }
+  return value.prototype;
 }
 
 }  // namespace detect
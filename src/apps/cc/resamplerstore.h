@@ -1,12 +1,15 @@
 #ifndef SCDETECT_APPS_CC_RESAMPLERSTORE_H_
 #define SCDETECT_APPS_CC_RESAMPLERSTORE_H_
 
-#include <seiscomp/io/recordfilter/resample.h>
+#include <seiscomp/core/record.h>
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
+#include "resampler.h"
+
 namespace Seiscomp {
 namespace detect {
 namespace record_resampler_store_detail {
@@ -38,9 +41,13 @@ namespace detect {
 
 // A global store for resamplers
 // - implements the Singleton Design Pattern
+// - thread-safe (detectors may be created in the background)
+// - rational resampling ratios are handled by polyphase resamplers sharing the
+// coefficients per pair of sampling frequencies; otherwise, a
+// Lanczos-windowed resampler is used
 class RecordResamplerStore {
  public:
-  using RecordResampler = IO::RecordResampler<double>;
+  using RecordResampler = resampler::RecordResampler;
   static RecordResamplerStore &Instance();
 
   RecordResamplerStore(const RecordResamplerStore &) = delete;
@@ -55,23 +62,44 @@ class RecordResamplerStore {
   std::unique_ptr<RecordResampler> get(double currentFrequency,
                                        double targetFrequency);
 
+  // Returns a resampler for finite traces (e.g. template waveforms)
+  //
+  // - finite traces are resampled by means of the Lanczos-windowed resampler
+  // regardless of the resampling ratio (the output of polyphase resamplers is
+  // delayed by the filter's group delay, i.e. the trace would be shortened)
+  std::unique_ptr<RecordResampler> getTraceResampler(double currentFrequency,
+                                                     double targetFrequency);
+
  private:
   RecordResamplerStore() = default;
 
-  struct CacheKey {
-    double sourceFrequency;
-    double targetFrequency;
+  struct CacheValue {
+    resampler::PolyphaseCoefficientsCPtr coefficients;
+    std::shared_ptr<const resampler::LanczosRecordResampler::Resampler>
+        prototype;
   };
 
-  using Cache = std::unordered_map<record_resampler_store_detail::CacheKey,
-                                   std::unique_ptr<RecordResampler>>;
+  using Cache =
+      std::unordered_map<record_resampler_store_detail::CacheKey, CacheValue>;
+
+  // Returns the cached value for the pair of sampling frequencies (i.e. the
+  // polyphase coefficients are designed on first use); the caller must hold
+  // the lock
+  CacheValue &cacheValue(double currentFrequency, double targetFrequency);
+  // Returns the Lanczos-windowed resampler prototype of `value` (created on
+  // first use); the caller must hold the lock
+  std::shared_ptr<const resampler::LanczosRecordResampler::Resampler>
+  prototype(double targetFrequency, CacheValue &value) const;
 
   Cache _cache;
+  std::mutex _mutex;
 
   double _fp{0.7};
   double _fs{0.9};
   double _coefficientScale{10};
   int _lanczosKernelWidth{3};
+  // stopband attenuation of polyphase resamplers in dB
+  double _attenuation{60};
 };
 
 }  // namespace detect
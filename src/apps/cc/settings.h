@@ -1,6 +1,7 @@
 #ifndef SCDETECT_APPS_CC_SETTINGS_H_
 #define SCDETECT_APPS_CC_SETTINGS_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -41,6 +42,14 @@ constexpr bool kCacheRawWaveforms{true};
 constexpr double kTemplateWaveformResampleMargin{2};
 
 constexpr int kObjectThroughputAverageTimeSpan{10};
+// Interval in seconds for checking the memory budget
+constexpr double kMemoryBudgetCheckInterval{10};
+// Maximum number of entries of the amplitude preprocessing cache
+constexpr std::size_t kAmplitudePreprocessingCacheCapacity{64};
+// Maximum number of entries of the transfer function cache
+constexpr std::size_t kTransferFunctionCacheCapacity{128};
+// Maximum number of entries of the response spectrum cache
+constexpr std::size_t kResponseSpectrumCacheCapacity{64};
 
 }  // namespace settings
 }  // namespace detect
@@ -4,6 +4,7 @@
 
 #include <boost/variant2/variant.hpp>
 #include <cassert>
+#include <cstddef>
 #include <exception>
 #include <string>
 #include <type_traits>
@@ -242,6 +243,17 @@ Core::TimeSpan TemplateWaveform::length() const {
   return Core::TimeSpan{templateWaveform().timeWindow().length()};
 }
 
+std::size_t TemplateWaveform::memoryUsage() const {
+  std::size_t ret{0};
+  for (const auto *record : {_raw.get(), _templateWaveform.get()}) {
+    if (record && record->data()) {
+      ret += static_cast<std::size_t>(record->data()->size()) *
+             static_cast<std::size_t>(record->data()->elementSize());
+    }
+  }
+  return ret;
+}
+
 Core::Time TemplateWaveform::startTime() const {
   return templateWaveform().startTime();
 }
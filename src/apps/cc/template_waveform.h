@@ -6,6 +6,7 @@
 
 #include <boost/optional/optional.hpp>
 #include <boost/variant2/variant.hpp>
+#include <cstddef>
 #include <functional>
 #include <string>
 
@@ -103,6 +104,11 @@ class TemplateWaveform {
   std::size_t size() const;
   // Returns the template waveform duration
   Core::TimeSpan length() const;
+  // Returns the memory used by both the raw and the template waveform samples
+  // (in bytes)
+  //
+  // - does not force the template waveform to be created
+  std::size_t memoryUsage() const;
 
   // Returns the actual template waveform starttime which might be different
   // from the starttime configured (due to both sampling rate accuracy and
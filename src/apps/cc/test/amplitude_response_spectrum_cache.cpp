@@ -0,0 +1,155 @@
+#define SEISCOMP_TEST_MODULE test_amplitude_response_spectrum_cache
+#include <seiscomp/math/restitution/transferfunction.h>
+#include <seiscomp/processing/response.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "../amplitude/response_spectrum_cache.h"
+#include "../amplitude/transfer_function_cache.h"
+#include "../util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+// A flat transfer function counting the number of times it is evaluated
+class CountingTransferFunction
+    : public Math::Restitution::FFT::TransferFunction {
+ public:
+  explicit CountingTransferFunction(std::size_t &evaluations)
+      : _evaluations(evaluations) {}
+
+ protected:
+  void evaluate_(Math::Complex *out, int n, const double *x) const override {
+    ++_evaluations;
+    for (int i{0}; i < n; ++i) {
+      out[i] = 1;
+    }
+  }
+
+ private:
+  std::size_t &_evaluations;
+};
+
+class CountingResponse : public Processing::Response {
+ public:
+  Math::Restitution::FFT::TransferFunction *getTransferFunction(
+      int numberOfIntegrations) override {
+    return new CountingTransferFunction{evaluations};
+  }
+
+  std::size_t evaluations{0};
+};
+
+using TaperConfig = amplitude::ResponseSpectrumCache::TaperConfig;
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(hit_miss) {
+  auto &cache{amplitude::ResponseSpectrumCache::Instance()};
+  cache.reset();
+  amplitude::TransferFunctionCache::Instance().reset();
+
+  auto response{util::make_smart<CountingResponse>()};
+  const TaperConfig taper{5, 0.00833333, 0};
+
+  const auto first{cache.get(response.get(), 0, 1000, 100, taper)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(first));
+  BOOST_TEST_CHECK(first->size() == 1000);
+  BOOST_TEST_CHECK(response->evaluations == 1);
+  BOOST_TEST_CHECK(cache.statistics().hits == 0);
+  BOOST_TEST_CHECK(cache.statistics().misses == 1);
+
+  // a second amplitude with the same key skips the evaluation
+  const auto second{cache.get(response.get(), 0, 1000, 100, taper)};
+  BOOST_TEST_CHECK(second == first);
+  BOOST_TEST_CHECK(response->evaluations == 1);
+  BOOST_TEST_CHECK(cache.statistics().hits == 1);
+  BOOST_TEST_CHECK(cache.statistics().misses == 1);
+
+  // the operators are specific to the number of samples, the sampling
+  // frequency and the taper configuration
+  BOOST_TEST_CHECK(cache.get(response.get(), 0, 1001, 100, taper) != first);
+  BOOST_TEST_CHECK(cache.get(response.get(), 0, 1000, 50, taper) != first);
+  BOOST_TEST_CHECK(cache.get(response.get(), 0, 1000, 100,
+                             TaperConfig{10, 0.00833333, 0}) != first);
+  BOOST_TEST_CHECK(response->evaluations == 4);
+  BOOST_TEST_CHECK(cache.statistics().misses == 4);
+  BOOST_TEST_CHECK(cache.size() == 4);
+
+  // the transfer function is shared between the operators
+  BOOST_TEST_CHECK(amplitude::TransferFunctionCache::Instance().size() == 1);
+
+  cache.reset();
+  BOOST_TEST_CHECK(cache.size() == 0);
+  BOOST_TEST_CHECK(cache.statistics().hits == 0);
+  BOOST_TEST_CHECK(cache.statistics().misses == 0);
+  amplitude::TransferFunctionCache::Instance().reset();
+}
+
+BOOST_AUTO_TEST_CASE(invalid) {
+  auto &cache{amplitude::ResponseSpectrumCache::Instance()};
+  cache.reset();
+
+  auto response{util::make_smart<CountingResponse>()};
+  const TaperConfig taper{5, 0, 0};
+  BOOST_TEST_CHECK(!cache.get(nullptr, 0, 1000, 100, taper));
+  BOOST_TEST_CHECK(!cache.get(response.get(), 0, 0, 100, taper));
+  BOOST_TEST_CHECK(!cache.get(response.get(), 0, 1000, 0, taper));
+  BOOST_TEST_CHECK(response->evaluations == 0);
+  BOOST_TEST_CHECK(cache.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(apply) {
+  auto &cache{amplitude::ResponseSpectrumCache::Instance()};
+  cache.reset();
+  amplitude::TransferFunctionCache::Instance().reset();
+
+  // deconvolving by means of a flat response without tapers is the identity
+  // (including zero padding the data)
+  auto response{util::make_smart<CountingResponse>()};
+  for (const auto n : {4, 100, 1000, 1024}) {
+    const auto deconvolution{
+        cache.get(response.get(), 0, n, 100, TaperConfig{0, 0, 0})};
+    BOOST_TEST_REQUIRE(static_cast<bool>(deconvolution));
+
+    std::vector<double> data(n);
+    for (int i{0}; i < n; ++i) {
+      data[i] = std::sin(0.1 * i) + 0.5 * std::cos(0.37 * i) + 1;
+    }
+    auto deconvolved{data};
+    deconvolution->apply(deconvolved.data());
+    for (int i{0}; i < n; ++i) {
+      BOOST_TEST_CHECK(std::abs(deconvolved[i] - data[i]) < 1e-9);
+    }
+
+    // applying the operator again yields the same result
+    auto again{data};
+    deconvolution->apply(again.data());
+    BOOST_TEST_CHECK(again == deconvolved);
+  }
+
+  // the taper applied to both ends of the data
+  const auto tapered{
+      cache.get(response.get(), 0, 1000, 100, TaperConfig{1, 0, 0})};
+  BOOST_TEST_REQUIRE(static_cast<bool>(tapered));
+  std::vector<double> ones(1000, 1);
+  tapered->apply(ones.data());
+  BOOST_TEST_CHECK(std::abs(ones.front()) < 1e-9);
+  BOOST_TEST_CHECK(std::abs(ones.back()) < 1e-9);
+  BOOST_TEST_CHECK(std::abs(ones[1] - 0.5 * (1 - std::cos(M_PI / 100))) <
+                   1e-9);
+  BOOST_TEST_CHECK(std::abs(ones[500] - 1) < 1e-9);
+
+  cache.reset();
+  amplitude::TransferFunctionCache::Instance().reset();
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,139 @@
+#define SEISCOMP_TEST_MODULE test_checkpoint
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/timewindow.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <sstream>
+#include <string>
+
+#include "../checkpoint.h"
+#include "../detector/linker.h"
+#include "../detector/template_waveform_processor.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+detector::TemplateWaveformProcessor::Checkpoint makeCheckpoint(
+    std::size_t partitionBlockSize) {
+  detector::TemplateWaveformProcessor::Checkpoint ret;
+  ret.samplingFrequency = 100;
+  const Core::Time startTime{2020, 10, 25, 19, 30};
+  ret.dataTimeWindow =
+      Core::TimeWindow{startTime, startTime + Core::TimeSpan{60.0}};
+  ret.lastSample = 0.5;
+  ret.filterInput = {1, 2, 3};
+  ret.crossCorrelation.buffer = {0.25, -0.5, 1, 2};
+  ret.crossCorrelation.sumData = 3.75;
+  ret.crossCorrelation.sumSquaredData = 5.3125;
+  ret.partitionBlockSize = partitionBlockSize;
+  return ret;
+}
+
+detector::Linker::Checkpoint makeLinkerCheckpoint() {
+  const Core::Time startTime{2020, 10, 25, 19, 30, 30};
+  detector::Linker::Checkpoint::Candidate candidate;
+  candidate.onHold = Core::TimeSpan{12.5};
+  candidate.results.push_back(detector::Linker::Checkpoint::Result{
+      "direct", startTime + Core::TimeSpan{1.0},
+      Core::TimeWindow{startTime, startTime + Core::TimeSpan{10.0}},
+      detector::TemplateWaveformProcessor::MatchResult::Value{
+          Core::TimeSpan{0.25}, 0.875}});
+  candidate.results.push_back(detector::Linker::Checkpoint::Result{
+      "partitioned", startTime + Core::TimeSpan{2.5},
+      Core::TimeWindow{startTime, startTime + Core::TimeSpan{10.0}},
+      detector::TemplateWaveformProcessor::MatchResult::Value{
+          Core::TimeSpan{1.75}, 0.5}});
+
+  detector::Linker::Checkpoint ret;
+  ret.candidates.push_back(candidate);
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(round_trip) {
+  Checkpoint checkpoint;
+  checkpoint.set("detector", {{{"direct", makeCheckpoint(0)},
+                               {"partitioned", makeCheckpoint(64)}},
+                              makeLinkerCheckpoint()});
+
+  std::stringstream ss;
+  checkpoint.write(ss);
+
+  Checkpoint restored;
+  restored.read(ss);
+  BOOST_TEST_REQUIRE(restored.size() == 1);
+  const auto *detectorCheckpoint{restored.get("detector")};
+  BOOST_TEST_REQUIRE(detectorCheckpoint);
+  BOOST_TEST_CHECK(!restored.get("unknown"));
+
+  const auto &processorCheckpoints{detectorCheckpoint->processors};
+  BOOST_TEST_REQUIRE(processorCheckpoints.size() == 2);
+  for (const auto &processorCheckpointPair : processorCheckpoints) {
+    const auto &actual{processorCheckpointPair.second};
+    const auto expected{
+        makeCheckpoint(processorCheckpointPair.first == "direct" ? 0 : 64)};
+    BOOST_TEST_CHECK(actual.samplingFrequency == expected.samplingFrequency);
+    BOOST_TEST_CHECK(actual.dataTimeWindow.startTime() ==
+                     expected.dataTimeWindow.startTime());
+    BOOST_TEST_CHECK(actual.dataTimeWindow.endTime() ==
+                     expected.dataTimeWindow.endTime());
+    BOOST_TEST_CHECK(actual.lastSample == expected.lastSample);
+    BOOST_TEST_CHECK(actual.filterInput == expected.filterInput,
+                     boost::test_tools::per_element());
+    BOOST_TEST_CHECK(actual.crossCorrelation.buffer ==
+                         expected.crossCorrelation.buffer,
+                     boost::test_tools::per_element());
+    BOOST_TEST_CHECK(actual.crossCorrelation.sumData ==
+                     expected.crossCorrelation.sumData);
+    BOOST_TEST_CHECK(actual.crossCorrelation.sumSquaredData ==
+                     expected.crossCorrelation.sumSquaredData);
+    // the kernel the state refers to is restored
+    BOOST_TEST_CHECK(actual.partitionBlockSize == expected.partitionBlockSize);
+  }
+
+  // the linker's pending candidates
+  const auto &candidates{detectorCheckpoint->linker.candidates};
+  const auto expectedCandidates{makeLinkerCheckpoint().candidates};
+  BOOST_TEST_REQUIRE(candidates.size() == expectedCandidates.size());
+  BOOST_TEST_CHECK(candidates[0].onHold == expectedCandidates[0].onHold);
+  BOOST_TEST_REQUIRE(candidates[0].results.size() ==
+                     expectedCandidates[0].results.size());
+  for (std::size_t i{0}; i < candidates[0].results.size(); ++i) {
+    const auto &actual{candidates[0].results[i]};
+    const auto &expected{expectedCandidates[0].results[i]};
+    BOOST_TEST_CHECK(actual.processorId == expected.processorId);
+    BOOST_TEST_CHECK(actual.pickTime == expected.pickTime);
+    BOOST_TEST_CHECK(actual.timeWindow.startTime() ==
+                     expected.timeWindow.startTime());
+    BOOST_TEST_CHECK(actual.timeWindow.endTime() ==
+                     expected.timeWindow.endTime());
+    BOOST_TEST_CHECK(actual.value.lag == expected.value.lag);
+    BOOST_TEST_CHECK(actual.value.coefficient == expected.value.coefficient);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(invalid) {
+  Checkpoint checkpoint;
+  checkpoint.set("detector",
+                 {{{"processor", makeCheckpoint(16)}}, makeLinkerCheckpoint()});
+  std::stringstream ss;
+  checkpoint.write(ss);
+  const auto serialized{ss.str()};
+
+  // truncated input
+  std::stringstream truncated{serialized.substr(0, serialized.size() - 1)};
+  Checkpoint restored;
+  BOOST_CHECK_THROW(restored.read(truncated), Checkpoint::BaseException);
+  BOOST_TEST_CHECK(restored.empty());
+
+  std::stringstream invalid{"invalid checkpoint"};
+  BOOST_CHECK_THROW(restored.read(invalid), Checkpoint::BaseException);
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,222 @@
+#define SEISCOMP_TEST_MODULE test_config_template_config_reader
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <boost/property_tree/ptree.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../config/exception.h"
+#include "../config/template_config_reader.h"
+
+namespace Seiscomp {
+namespace detect {
+
+BOOST_AUTO_TEST_CASE(read_entries) {
+  std::istringstream iss{R"([
+    {"originId": "origin-0", "streams": [{"waveformId": "CH.A..HHZ"}]},
+    {"originId": "origin-1 \"}]", "streams": [{"waveformId": "CH.B..HHZ"}]}
+  ])"};
+
+  config::TemplateConfigReader reader{iss};
+  boost::property_tree::ptree pt;
+  std::vector<std::string> originIds;
+  while (reader.next(pt)) {
+    originIds.push_back(pt.get<std::string>("originId"));
+  }
+
+  BOOST_TEST_CHECK(reader.count() == 2);
+  BOOST_TEST_CHECK(originIds == (std::vector<std::string>{
+                                    "origin-0", "origin-1 \"}]"}),
+                   boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(skip_invalid_entries) {
+  std::istringstream iss{R"([
+    {"originId": "origin-0", "streams": []},
+    {"streams": [{"waveformId": "CH.A..HHZ"}]},
+    {"originId": "origin-2", "triggerOnThreshold": 2,
+     "streams": [{"waveformId": "CH.A..HHZ"}]},
+    {"originId": "origin-3", "streams": [{"waveformId": "CH.A..HHZ"}]}
+  ])"};
+
+  config::TemplateConfigReader reader{iss};
+  boost::property_tree::ptree pt;
+  std::vector<std::string> originIds;
+  std::size_t invalid{0};
+  while (true) {
+    try {
+      if (!reader.next(pt)) {
+        break;
+      }
+      originIds.push_back(pt.get<std::string>("originId"));
+    } catch (config::ValidationError &) {
+      ++invalid;
+    }
+  }
+
+  BOOST_TEST_CHECK(invalid == 3);
+  BOOST_TEST_CHECK(originIds == std::vector<std::string>{"origin-3"},
+                   boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(reject_invalid_entries) {
+  // each entry violates a single constraint of the JSON schema
+  const std::vector<std::string> entries{
+      // required properties
+      R"({"streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "", "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": {"id": "origin-0"},
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0"})",
+      R"({"originId": "origin-0", "streams": []})",
+      R"({"originId": "origin-0", "streams": {"waveformId": "CH.A..HHZ"}})",
+      R"({"originId": "origin-0", "streams": [{"templateId": "template-0"}]})",
+      // strings
+      R"({"originId": "origin-0", "detectorId": ["detector-0"],
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "mergingStrategy": "any",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "streams": [{"waveformId": "CH.A..HHZ",
+          "templateId": {"id": "template-0"}}]})",
+      // numbers
+      R"({"originId": "origin-0", "triggerOnThreshold": 1.1,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "triggerOffThreshold": -1.1,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "triggerDuration": "long",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "gapThreshold": -1,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "maximumLatency": -1,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0",
+          "streams": [{"waveformId": "CH.A..HHZ", "initTime": -1}]})",
+      R"({"originId": "origin-0",
+          "streams": [{"waveformId": "CH.A..HHZ", "mergingThreshold": 2}]})",
+      R"({"originId": "origin-0", "streams": [{"waveformId": "CH.A..HHZ",
+          "targetSamplingFrequency": 0}]})",
+      R"({"originId": "origin-0", "streams": [{"waveformId": "CH.A..HHZ",
+          "templateWaveformStart": "early"}]})",
+      // integers
+      R"({"originId": "origin-0", "minimumArrivals": 1.5,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "minimumArrivals": 0,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // booleans
+      R"({"originId": "origin-0", "gapInterpolation": "no",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "createAmplitudes": {},
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // coarse search
+      R"({"originId": "origin-0", "coarseSearchDecimation": 0,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "coarseSearchDecimation": 2.5,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "coarseSearchThreshold": 2,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // pre-screening
+      R"({"originId": "origin-0", "prescreenMargin": [0.1],
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "prescreenMargin": "0.1",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // subspace detection
+      R"({"originId": "origin-0", "subspaceDimension": 0,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "subspaceDimension": "two",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "subspaceOriginIds": "origin-1",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "subspaceOriginIds": [["origin-1"]],
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "subspaceOriginIds": ["origin-1", 2],
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // component fusion
+      R"({"originId": "origin-0", "fuseComponents": "yes",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "fuseComponents": "true",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // stacking
+      R"({"originId": "origin-0", "stacking": 1,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // partitioned cross-correlation
+      R"({"originId": "origin-0", "correlationBlockSize": -1,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "correlationBlockSize": 64.5,
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      // JSON types (in contrast to their string representation)
+      R"({"originId": 1, "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "triggerOnThreshold": "0.5",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "minimumArrivals": "2",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "createArrivals": "true",
+          "streams": [{"waveformId": "CH.A..HHZ"}]})",
+      R"({"originId": "origin-0", "streams": ["CH.A..HHZ"]})",
+      R"({"originId": "origin-0", "streams": [{"waveformId": true}]})"};
+
+  for (const auto &entry : entries) {
+    BOOST_TEST_CONTEXT("entry: " << entry) {
+      std::istringstream iss{"[" + entry + "]"};
+      config::TemplateConfigReader reader{iss};
+      boost::property_tree::ptree pt;
+      BOOST_CHECK_THROW(reader.next(pt), config::ValidationError);
+      BOOST_TEST_CHECK(!reader.next(pt));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(accept_valid_entry) {
+  std::istringstream iss{R"([
+    {"originId": "origin-0", "detectorId": "detector-0",
+     "minimumArrivals": 2, "gapInterpolation": true,
+     "createAmplitudes": false, "triggerOnThreshold": 0.7,
+     "correlationBlockSize": 0,
+     "stacking": false,
+     "fuseComponents": false,
+     "subspaceDimension": 2, "subspaceOriginIds": ["origin-1", "origin-2"],
+     "prescreenMargin": 0.1,
+     "coarseSearchDecimation": 2, "coarseSearchThreshold": 0.3,
+     "triggerDuration": -1, "mergingStrategy": "all",
+     "streams": [{"waveformId": "CH.A..HHZ", "templateId": "template-0",
+                  "initTime": 60, "targetSamplingFrequency": 100}]}
+  ])"};
+
+  config::TemplateConfigReader reader{iss};
+  boost::property_tree::ptree pt;
+  BOOST_TEST_CHECK(reader.next(pt));
+  BOOST_TEST_CHECK(!reader.next(pt));
+}
+
+BOOST_AUTO_TEST_CASE(accept_empty_document) {
+  std::istringstream iss{"[ ]"};
+  config::TemplateConfigReader reader{iss};
+  boost::property_tree::ptree pt;
+  BOOST_TEST_CHECK(!reader.next(pt));
+  BOOST_TEST_CHECK(!reader.next(pt));
+  BOOST_TEST_CHECK(reader.count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(malformed) {
+  const std::vector<std::string> documents{
+      R"({"originId": "origin-0"})",
+      R"([{"originId": "origin-0"} {"originId": "origin-1"}])",
+      R"([{"originId": "origin-0", "streams": [)",
+      R"([{"originId": "origin-0" "streams": []}])",
+      R"([] [])"};
+
+  for (const auto &document : documents) {
+    std::istringstream iss{document};
+    config::TemplateConfigReader reader{iss};
+    const auto readAll = [&reader]() {
+      boost::property_tree::ptree pt;
+      while (reader.next(pt)) {
+      }
+    };
+    BOOST_CHECK_THROW(readAll(), config::TemplateConfigReader::SyntaxError);
+  }
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,121 @@
+#define SEISCOMP_TEST_MODULE test_correlation_tuner
+#include <seiscomp/unittest/unittests.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../correlation_tuner.h"
+#include "../filter/fft.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+BOOST_AUTO_TEST_CASE(tune) {
+  CorrelationTuner tuner;
+  // the partitioned cross-correlation is not benchmarked without latency
+  tuner.setMaxLatency(0);
+  BOOST_TEST_CHECK(tuner.tune(100, 100).blockSize == 0);
+  BOOST_TEST_CHECK(tuner.benchmarked() == 1);
+
+  // decisions are benchmarked once per template waveform length and sampling
+  // frequency
+  BOOST_TEST_CHECK(tuner.tune(100, 100).blockSize == 0);
+  BOOST_TEST_CHECK(tuner.benchmarked() == 1);
+  BOOST_TEST_CHECK(tuner.tune(100, 50).blockSize == 0);
+  BOOST_TEST_CHECK(tuner.benchmarked() == 2);
+  BOOST_TEST_CHECK(tuner.size() == 2);
+
+  // the block size is bounded by both the maximum latency and the template
+  // waveform length
+  tuner.setMaxLatency(5);
+  const std::size_t size{1500};
+  const double samplingFrequency{100};
+  const auto decision{tuner.tune(size, samplingFrequency)};
+  BOOST_TEST_CHECK(decision.costPerSample > 0);
+  if (decision.blockSize > 0) {
+    BOOST_TEST_CHECK(filter::fft::nextPowerOfTwo(decision.blockSize) ==
+                     decision.blockSize);
+    BOOST_TEST_CHECK(decision.blockSize <= 5 * samplingFrequency);
+    BOOST_TEST_CHECK(decision.blockSize <= filter::fft::nextPowerOfTwo(size));
+  }
+
+  // decisions exceeding a lowered maximum latency are benchmarked again
+  const auto benchmarked{tuner.benchmarked()};
+  tuner.setMaxLatency(0);
+  BOOST_TEST_CHECK(tuner.tune(size, samplingFrequency).blockSize == 0);
+  BOOST_TEST_CHECK(tuner.benchmarked() ==
+                   benchmarked + (decision.blockSize > 0 ? 1 : 0));
+}
+
+BOOST_AUTO_TEST_CASE(lookup) {
+  CorrelationTuner tuner;
+  tuner.setMaxLatency(0);
+  // looking up does not benchmark
+  BOOST_TEST_CHECK(!tuner.lookup(100, 100));
+  BOOST_TEST_CHECK(tuner.benchmarked() == 0);
+  BOOST_TEST_CHECK(tuner.size() == 0);
+
+  const auto decision{tuner.tune(100, 100)};
+  const auto lookedUp{tuner.lookup(100, 100)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(lookedUp));
+  BOOST_TEST_CHECK(lookedUp->blockSize == decision.blockSize);
+  BOOST_TEST_CHECK(lookedUp->costPerSample == decision.costPerSample);
+  BOOST_TEST_CHECK(!tuner.lookup(100, 50));
+  BOOST_TEST_CHECK(tuner.benchmarked() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(block_sizes) {
+  CorrelationTuner tuner;
+  tuner.setMaxLatency(0);
+  BOOST_TEST_CHECK(tuner.blockSizes(1500, 100) ==
+                   std::vector<std::size_t>{0});
+
+  // all powers of two are swept up to the maximum latency
+  tuner.setMaxLatency(5);
+  BOOST_TEST_CHECK(tuner.blockSizes(1500, 100) ==
+                   (std::vector<std::size_t>{0, 16, 32, 64, 128, 256}));
+  // ... and the template waveform length
+  BOOST_TEST_CHECK(tuner.blockSizes(50, 100) ==
+                   (std::vector<std::size_t>{0, 16, 32, 64}));
+}
+
+BOOST_AUTO_TEST_CASE(persistence) {
+  CorrelationTuner tuner;
+  tuner.setMaxLatency(0);
+  tuner.tune(100, 100);
+  tuner.tune(200, 40);
+
+  std::stringstream ss;
+  tuner.write(ss);
+
+  // read decisions are not benchmarked again
+  CorrelationTuner restored;
+  restored.setMaxLatency(0);
+  restored.read(ss);
+  BOOST_TEST_CHECK(restored.size() == 2);
+  BOOST_TEST_CHECK(restored.benchmarked() == 0);
+  BOOST_TEST_CHECK(restored.tune(100, 100).costPerSample ==
+                   tuner.tune(100, 100).costPerSample);
+  BOOST_TEST_CHECK(restored.tune(200, 40).costPerSample ==
+                   tuner.tune(200, 40).costPerSample);
+  BOOST_TEST_CHECK(restored.benchmarked() == 0);
+
+  // decisions are host specific
+  std::stringstream foreign{"scdetect-cc-correlation-tuning 1\nhost " +
+                            CorrelationTuner::hostname() + "-other\n"};
+  BOOST_CHECK_THROW(restored.read(foreign), CorrelationTuner::BaseException);
+  std::stringstream malformed{"scdetect-cc-correlation-tuning 1\nhost " +
+                              CorrelationTuner::hostname() + "\n100 100 x\n"};
+  BOOST_CHECK_THROW(restored.read(malformed), CorrelationTuner::BaseException);
+  std::stringstream invalid{"invalid"};
+  BOOST_CHECK_THROW(restored.read(invalid), CorrelationTuner::BaseException);
+  // failing to read keeps the decisions
+  BOOST_TEST_CHECK(restored.size() == 2);
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,224 @@
+#define SEISCOMP_TEST_MODULE test_detector_correlation_group
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../detector/correlation_group.h"
+#include "../filter/crosscorrelation.h"
+#include "../template_waveform.h"
+#include "../util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+constexpr double kSamplingFrequency{100};
+constexpr std::size_t kTemplateLength{50};
+constexpr std::size_t kChunkSize{64};
+
+// Returns `n` samples of white noise (deterministic)
+std::vector<double> makeNoise(std::size_t n, unsigned seed) {
+  std::mt19937 generator{seed};
+  std::normal_distribution<double> noise{0, 1};
+  std::vector<double> ret(n);
+  for (auto &sample : ret) {
+    sample = noise(generator);
+  }
+  return ret;
+}
+
+GenericRecordPtr makeRecord(const std::vector<double> &samples) {
+  auto ret{util::make_smart<GenericRecord>("NET", "STA", "LOC", "CHA",
+                                           Core::Time{2020, 10, 25, 19, 30},
+                                           kSamplingFrequency)};
+  ret->setData(static_cast<int>(samples.size()), samples.data(),
+               Array::DOUBLE);
+  return ret;
+}
+
+// Returns the zero-lag Pearson correlation coefficient of `x` and `y`
+double similarity(const std::vector<double> &x, const std::vector<double> &y) {
+  const auto n{static_cast<double>(x.size())};
+  double sumX{0}, sumY{0}, sumXX{0}, sumYY{0}, sumXY{0};
+  for (std::size_t i{0}; i < x.size(); ++i) {
+    sumX += x[i];
+    sumY += y[i];
+    sumXX += x[i] * x[i];
+    sumYY += y[i] * y[i];
+    sumXY += x[i] * y[i];
+  }
+  return (n * sumXY - sumX * sumY) / (std::sqrt(n * sumXX - sumX * sumX) *
+                                      std::sqrt(n * sumYY - sumY * sumY));
+}
+
+// The representative's and a similar member's template waveform
+struct Templates {
+  Templates() : representative{makeNoise(kTemplateLength, 1)} {
+    const auto perturbation{makeNoise(kTemplateLength, 2)};
+    for (std::size_t i{0}; i < kTemplateLength; ++i) {
+      member.push_back(representative[i] + 0.3 * perturbation[i]);
+    }
+  }
+
+  std::vector<double> representative;
+  std::vector<double> member;
+};
+
+// Returns noise superimposed with the member's template waveform at several
+// offsets
+std::vector<double> makeData(const Templates &templates) {
+  auto ret{makeNoise(40 * kChunkSize, 3)};
+  for (const auto offset : {300, 900, 1700}) {
+    for (std::size_t i{0}; i < kTemplateLength; ++i) {
+      ret[offset + i] = 0.2 * ret[offset + i] + 2 * templates.member[i];
+    }
+  }
+  return ret;
+}
+
+// Applies `data` chunk-wise to the `member` filter, i.e. the exact
+// coefficients are computed where the group's screen coefficients exceed
+// `threshold`
+std::vector<double> applyShared(detector::CorrelationGroup &group,
+                                filter::CrossCorrelation<double> &member,
+                                const std::vector<double> &data,
+                                double threshold) {
+  std::vector<double> ret;
+  for (std::size_t i{0}; i < data.size(); i += kChunkSize) {
+    std::vector<double> chunk(data.begin() + i, data.begin() + i + kChunkSize);
+    const auto startTime{Core::Time{} +
+                         Core::TimeSpan{static_cast<double>(i)}};
+    const auto *screen{
+        group.screen(member, startTime, chunk.data(), chunk.size())};
+    BOOST_TEST_REQUIRE(screen);
+    member.apply(chunk.size(), chunk.data(), screen, threshold);
+    ret.insert(ret.end(), chunk.begin(), chunk.end());
+  }
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(bound) {
+  const Templates templates;
+  const auto data{makeData(templates)};
+  const auto s{similarity(templates.representative, templates.member)};
+  const auto bound{std::sqrt(2 * (1 - s))};
+  BOOST_TEST_REQUIRE(s > 0.9);
+
+  // exact coefficients
+  filter::CrossCorrelation<double> exactRepresentative{
+      makeRecord(templates.representative)};
+  auto expectedRepresentative{data};
+  exactRepresentative.apply(expectedRepresentative);
+  filter::CrossCorrelation<double> exactMember{makeRecord(templates.member)};
+  auto expectedMember{data};
+  exactMember.apply(expectedMember);
+
+  // the coefficients of similar template waveforms differ by at most
+  // `sqrt(2 * (1 - s))`
+  double maxDeviation{0};
+  for (std::size_t i{0}; i < data.size(); ++i) {
+    maxDeviation = std::max(
+        maxDeviation, std::fabs(expectedRepresentative[i] - expectedMember[i]));
+  }
+  BOOST_TEST_CHECK(maxDeviation <= bound);
+
+  // both the representative and the member share the group's coefficients
+  const double threshold{0.7};
+  detector::CorrelationGroup group{
+      TemplateWaveform{makeRecord(templates.representative)}};
+  filter::CrossCorrelation<double> representative{
+      makeRecord(templates.representative)};
+  filter::CrossCorrelation<double> member{makeRecord(templates.member)};
+  std::vector<double> actualRepresentative;
+  std::vector<double> actualMember;
+  for (std::size_t i{0}; i < data.size(); i += kChunkSize) {
+    const auto startTime{Core::Time{} +
+                         Core::TimeSpan{static_cast<double>(i)}};
+    std::vector<double> chunk(data.begin() + i, data.begin() + i + kChunkSize);
+
+    auto representativeChunk{chunk};
+    const auto *screen{group.screen(representative, startTime,
+                                    representativeChunk.data(),
+                                    representativeChunk.size())};
+    BOOST_TEST_REQUIRE(screen);
+    representative.apply(representativeChunk.size(),
+                         representativeChunk.data(), screen,
+                         std::numeric_limits<double>::infinity());
+    actualRepresentative.insert(actualRepresentative.end(),
+                                representativeChunk.begin(),
+                                representativeChunk.end());
+
+    auto memberChunk{chunk};
+    screen = group.screen(member, startTime, memberChunk.data(),
+                          memberChunk.size());
+    BOOST_TEST_REQUIRE(screen);
+    member.apply(memberChunk.size(), memberChunk.data(), screen,
+                 threshold - bound);
+    actualMember.insert(actualMember.end(), memberChunk.begin(),
+                        memberChunk.end());
+  }
+
+  BOOST_TEST_CHECK(group.correlatedCount() == data.size() / kChunkSize);
+  BOOST_TEST_CHECK(group.sharedCount() == data.size() / kChunkSize);
+  // the buffered data is compared when the members join the group, only
+  BOOST_TEST_CHECK(group.comparedCount() == 2);
+
+  BOOST_TEST_CHECK(actualRepresentative == expectedRepresentative,
+                   boost::test_tools::per_element());
+  // coefficients greater than or equal to the threshold are exact
+  std::size_t detections{0};
+  for (std::size_t i{0}; i < data.size(); ++i) {
+    if (expectedMember[i] >= threshold || actualMember[i] >= threshold) {
+      BOOST_TEST_CHECK(actualMember[i] == expectedMember[i]);
+      ++detections;
+    }
+  }
+  BOOST_TEST_CHECK(detections >= 3);
+}
+
+BOOST_AUTO_TEST_CASE(resynchronize) {
+  const Templates templates;
+  const auto data{makeData(templates)};
+  const std::vector<double> first(data.begin(), data.begin() + 10 * kChunkSize);
+  const std::vector<double> second(data.begin() + 10 * kChunkSize, data.end());
+
+  filter::CrossCorrelation<double> exact{makeRecord(templates.member)};
+  auto expected{first};
+  exact.apply(expected);
+
+  detector::CorrelationGroup group{
+      TemplateWaveform{makeRecord(templates.representative)}};
+  filter::CrossCorrelation<double> member{makeRecord(templates.member)};
+  // screened by exact coefficients, only
+  const auto actual{applyShared(group, member, first, -1)};
+  BOOST_TEST_CHECK(actual == expected, boost::test_tools::per_element());
+  BOOST_TEST_CHECK(group.comparedCount() == 1);
+
+  // modifying the member's state outside the group (e.g. after a gap) forces
+  // the buffered data to be compared; the representative adopts the member's
+  // state
+  exact.reset();
+  member.reset();
+  expected = second;
+  exact.apply(expected);
+  BOOST_TEST_CHECK(applyShared(group, member, second, -1) == expected,
+                   boost::test_tools::per_element());
+  BOOST_TEST_CHECK(group.comparedCount() == 2);
+  BOOST_TEST_CHECK(group.correlatedCount() == data.size() / kChunkSize);
+  BOOST_TEST_CHECK(group.sharedCount() == 0);
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
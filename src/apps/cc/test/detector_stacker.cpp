@@ -0,0 +1,180 @@
+#define SEISCOMP_TEST_MODULE test_detector_stacker
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../detector/arrival.h"
+#include "../detector/linker/association.h"
+#include "../detector/stacker.h"
+#include "../detector/template_waveform_processor.h"
+#include "../template_waveform.h"
+#include "../util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+constexpr double kSamplingFrequency{10};
+constexpr double kTolerance{1e-12};
+
+const Core::Time kOriginTime{2020, 10, 25, 19, 30};
+// The origin time the first coefficient of the coefficient traces refers to
+const Core::Time kStartTime{kOriginTime + Core::TimeSpan{10.0}};
+// The pick offset w.r.t. the template waveform's start time
+const Core::TimeSpan kPickOffset{1.0};
+
+// The template arrivals' offsets w.r.t. the origin time (i.e. the template
+// moveout)
+const std::vector<double> kMoveout{2, 3, 5};
+// The coefficient traces (time-aligned w.r.t. the origin time)
+const std::vector<std::vector<double>> kCoefficients{
+    {0.1, 0.2, 0.4, 0.8, 0.5, 0.2, 0.1},
+    {0.0, 0.3, 0.5, 0.6, 0.7, 0.3, 0.0},
+    {0.2, 0.2, 0.3, 0.7, 0.3, 0.1, 0.0}};
+// The index of the stacked coefficient traces' maximum
+constexpr std::size_t kPeakIdx{3};
+
+// Returns the template arrival with regards to the template moveout `offset`
+detector::Arrival makeArrival(double offset) {
+  const Core::TimeSpan pickOffset{offset};
+  return detector::Arrival{
+      detector::Pick{kOriginTime + pickOffset, "NET.STA.LOC.CHA", boost::none,
+                     pickOffset},
+      "P"};
+}
+
+// Returns a template waveform processor with regards to the template arrival
+// `arrival`
+std::unique_ptr<detector::TemplateWaveformProcessor> makeProcessor(
+    const std::string &id, const detector::Arrival &arrival) {
+  const std::vector<double> samples(20, 0);
+  auto record{util::make_smart<GenericRecord>(
+      "NET", "STA", "LOC", "CHA", arrival.pick.time - kPickOffset,
+      kSamplingFrequency)};
+  record->setData(static_cast<int>(samples.size()), samples.data(),
+                  Array::DOUBLE);
+
+  auto ret{util::make_unique<detector::TemplateWaveformProcessor>(
+      TemplateWaveform{record})};
+  ret->setId(id);
+  return ret;
+}
+
+// Returns a match result providing the `coefficients` where the first
+// coefficient refers to the origin time `originTime` (w.r.t. the template
+// arrival `arrival`)
+std::shared_ptr<const detector::TemplateWaveformProcessor::MatchResult>
+makeResult(const detector::Arrival &arrival, const Core::Time &originTime,
+           const std::vector<double> &coefficients) {
+  auto ret{
+      std::make_shared<detector::TemplateWaveformProcessor::MatchResult>()};
+  auto &trace{ret->coefficientTrace};
+  trace.startTime = originTime + arrival.pick.offset - kPickOffset;
+  trace.samplingFrequency = kSamplingFrequency;
+  trace.coefficients = coefficients;
+  return ret;
+}
+
+struct Fixture {
+  Fixture() {
+    for (std::size_t i{0}; i < kMoveout.size(); ++i) {
+      arrivals.push_back(makeArrival(kMoveout[i]));
+      processors.push_back(
+          makeProcessor("proc" + std::to_string(i), arrivals.back()));
+      stacker.add(processors.back().get(), arrivals.back());
+    }
+    stacker.setThresAssociation(0.5);
+    stacker.setResultCallback(
+        [this](const detector::linker::Association &association) {
+          associations.push_back(association);
+        });
+  }
+
+  std::vector<detector::Arrival> arrivals;
+  std::vector<std::unique_ptr<detector::TemplateWaveformProcessor>>
+      processors;
+  // wait for lagging processors (w.r.t. record time)
+  detector::Stacker stacker{Core::TimeSpan{10.0}};
+  std::vector<detector::linker::Association> associations;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(mean, Fixture) {
+  for (std::size_t i{0}; i < processors.size(); ++i) {
+    stacker.feed(processors[i].get(),
+                 makeResult(arrivals[i], kStartTime, kCoefficients[i]));
+  }
+
+  BOOST_TEST_REQUIRE(associations.size() == 1);
+  const auto &association{associations.front()};
+  // (0.8 + 0.6 + 0.7) / 3
+  BOOST_TEST_CHECK(std::fabs(association.score - 0.7) < kTolerance);
+  BOOST_TEST_REQUIRE(association.results.size() == processors.size());
+
+  const auto originTime{kStartTime +
+                        Core::TimeSpan{kPeakIdx / kSamplingFrequency}};
+  for (std::size_t i{0}; i < processors.size(); ++i) {
+    const auto it{association.results.find(processors[i]->id())};
+    BOOST_TEST_REQUIRE((it != association.results.end()));
+    const auto &templateResult{it->second};
+    BOOST_TEST_CHECK(templateResult.resultIt->coefficient ==
+                     kCoefficients[i][kPeakIdx]);
+    // the arrivals are shifted by the template moveout
+    BOOST_TEST_CHECK(
+        std::fabs(static_cast<double>(templateResult.arrival.pick.time -
+                                      (originTime + arrivals[i].pick.offset))) <
+        0.5 / kSamplingFrequency);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(on_hold, Fixture) {
+  // wait for lagging processors 5 samples (w.r.t. record time)
+  stacker.setOnHold(Core::TimeSpan{5 / kSamplingFrequency});
+  stacker.setMinArrivals(2);
+
+  // the third processor is lagging
+  for (std::size_t i{0}; i < 2; ++i) {
+    stacker.feed(processors[i].get(),
+                 makeResult(arrivals[i], kStartTime, kCoefficients[i]));
+  }
+  BOOST_TEST_CHECK(associations.empty());
+
+  // more recent coefficients exceed the *on hold* duration, i.e. the
+  // coefficients are stacked regardless of the lagging processor
+  const std::vector<double> zeros(kCoefficients.front().size(), 0);
+  const auto startTime{
+      kStartTime +
+      Core::TimeSpan{kCoefficients.front().size() / kSamplingFrequency}};
+  for (std::size_t i{0}; i < 2; ++i) {
+    stacker.feed(processors[i].get(),
+                 makeResult(arrivals[i], startTime, zeros));
+  }
+
+  BOOST_TEST_REQUIRE(associations.size() == 1);
+  const auto &association{associations.front()};
+  // (0.8 + 0.6) / 2
+  BOOST_TEST_CHECK(std::fabs(association.score - 0.7) < kTolerance);
+  BOOST_TEST_CHECK(association.results.size() == 2);
+  BOOST_TEST_CHECK((association.results.find(processors[2]->id()) ==
+                    association.results.end()));
+
+  // coefficients of the lagging processor which were stacked, already, are
+  // dropped
+  stacker.feed(processors[2].get(),
+               makeResult(arrivals[2], kStartTime, kCoefficients[2]));
+  stacker.flush();
+  BOOST_TEST_CHECK(associations.size() == 1);
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,158 @@
+#define SEISCOMP_TEST_MODULE test_eventstore
+#include <seiscomp/datamodel/event.h>
+#include <seiscomp/datamodel/eventparameters.h>
+#include <seiscomp/datamodel/magnitude.h>
+#include <seiscomp/datamodel/origin.h>
+#include <seiscomp/datamodel/originreference.h>
+#include <seiscomp/datamodel/pick.h>
+#include <seiscomp/io/archive/xmlarchive.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../eventstore.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+const std::string kPathCatalog{
+    "data/integration/processing/resample/single-detector-single-stream-0000/"
+    "catalog.scml"};
+
+DataModel::EventParametersPtr loadCatalog(const std::string &path) {
+  DataModel::EventParametersPtr ret;
+  IO::XMLArchive ar;
+  if (!ar.open(path.c_str())) {
+    return nullptr;
+  }
+  ar >> ret;
+  ar.close();
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(indexed_lookup) {
+  auto ep{loadCatalog(kPathCatalog)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(ep));
+  BOOST_TEST_REQUIRE(ep->eventCount() > 0);
+  BOOST_TEST_REQUIRE(ep->originCount() > 0);
+
+  auto &store{EventStore::Instance()};
+  store.load(ep.get());
+  BOOST_TEST_CHECK(store.eventCount() == ep->eventCount());
+
+  // the lookups return the objects of the catalog loaded
+  std::size_t magnitudes{0};
+  for (std::size_t i{0}; i < ep->originCount(); ++i) {
+    auto *origin{ep->origin(i)};
+    BOOST_TEST_CHECK(store.get<DataModel::Origin>(origin->publicID()).get() ==
+                     origin);
+    BOOST_TEST_CHECK(
+        store.getWithChildren<DataModel::Origin>(origin->publicID()).get() ==
+        origin);
+
+    for (std::size_t j{0}; j < origin->magnitudeCount(); ++j) {
+      auto *magnitude{origin->magnitude(j)};
+      BOOST_TEST_CHECK(
+          store.get<DataModel::Magnitude>(magnitude->publicID()).get() ==
+          magnitude);
+      ++magnitudes;
+    }
+  }
+  BOOST_TEST_CHECK(magnitudes > 0);
+
+  for (std::size_t i{0}; i < ep->pickCount(); ++i) {
+    auto *pick{ep->pick(i)};
+    BOOST_TEST_CHECK(store.get<DataModel::Pick>(pick->publicID()).get() ==
+                     pick);
+  }
+
+  for (std::size_t i{0}; i < ep->eventCount(); ++i) {
+    auto *event{ep->event(i)};
+    BOOST_TEST_CHECK(store.get<DataModel::Event>(event->publicID()).get() ==
+                     event);
+    // events are looked up by means of the identifiers of their origins
+    for (std::size_t j{0}; j < event->originReferenceCount(); ++j) {
+      const auto &originId{event->originReference(j)->originID()};
+      BOOST_TEST_CHECK(store.getEvent(originId).get() == event);
+    }
+  }
+
+  // the type is taken into account
+  const auto &originId{ep->origin(0)->publicID()};
+  BOOST_TEST_CHECK(!store.get<DataModel::Event>(originId));
+  BOOST_TEST_CHECK(!store.get<DataModel::Magnitude>(originId));
+  // unknown identifiers
+  BOOST_TEST_CHECK(!store.get<DataModel::Origin>("unknown"));
+  BOOST_TEST_CHECK(!store.getEvent("unknown"));
+
+  store.reset();
+  BOOST_TEST_CHECK(store.eventCount() == 0);
+  BOOST_TEST_CHECK(!store.get<DataModel::Origin>(originId));
+  BOOST_TEST_CHECK(!store.getEvent(originId));
+}
+
+BOOST_AUTO_TEST_CASE(load_scml) {
+  struct Origin {
+    std::string publicId;
+    std::size_t arrivalCount;
+    std::size_t magnitudeCount;
+  };
+  std::vector<Origin> expectedOrigins;
+  // maps origin identifiers to event identifiers
+  std::vector<std::pair<std::string, std::string>> expectedEvents;
+  std::size_t expectedEventCount{0};
+  {
+    // the catalog is released before loading it again (i.e. public object
+    // identifiers are unique)
+    auto ep{loadCatalog(kPathCatalog)};
+    BOOST_TEST_REQUIRE(static_cast<bool>(ep));
+    for (std::size_t i{0}; i < ep->originCount(); ++i) {
+      const auto *origin{ep->origin(i)};
+      expectedOrigins.push_back({origin->publicID(), origin->arrivalCount(),
+                                 origin->magnitudeCount()});
+    }
+    for (std::size_t i{0}; i < ep->eventCount(); ++i) {
+      const auto *event{ep->event(i)};
+      for (std::size_t j{0}; j < event->originReferenceCount(); ++j) {
+        expectedEvents.emplace_back(event->originReference(j)->originID(),
+                                    event->publicID());
+      }
+    }
+    expectedEventCount = ep->eventCount();
+  }
+
+  auto &store{EventStore::Instance()};
+  store.load(kPathCatalog);
+  BOOST_TEST_CHECK(store.eventCount() == expectedEventCount);
+
+  for (const auto &expected : expectedOrigins) {
+    const auto actual{store.get<DataModel::Origin>(expected.publicId)};
+    BOOST_TEST_REQUIRE(static_cast<bool>(actual));
+    // objects loaded from SCML include their children
+    BOOST_TEST_CHECK(actual->arrivalCount() == expected.arrivalCount);
+    BOOST_TEST_CHECK(actual->magnitudeCount() == expected.magnitudeCount);
+  }
+
+  for (const auto &expected : expectedEvents) {
+    const auto actual{store.getEvent(expected.first)};
+    BOOST_TEST_REQUIRE(static_cast<bool>(actual));
+    BOOST_TEST_CHECK(actual->publicID() == expected.second);
+  }
+
+  store.reset();
+  BOOST_CHECK_THROW(store.load(std::string{"data/non-existent.scml"}),
+                    EventStore::SCMLException);
+  store.reset();
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
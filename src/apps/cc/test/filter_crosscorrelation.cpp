@@ -3,14 +3,21 @@
 #include <seiscomp/core/genericrecord.h>
 #include <seiscomp/unittest/unittests.h>
 
+#include <algorithm>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/test/data/dataset.hpp>
 #include <boost/test/data/test_case.hpp>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <iterator>
+#include <random>
 #include <string>
 #include <vector>
 
 #include "../filter/crosscorrelation.h"
+#include "../filter/fft.h"
 #include "../util/memory.h"
 
 namespace utf = boost::unit_test;
@@ -72,8 +79,42 @@ R1<T, A2...> Join(R1<R2<T, A2...>, A1...> const &outer) {
   return joined;
 }
 
+// Partitioned convolution related sample
+struct PartitionedSample {
+  // The block size configured
+  std::size_t blockSize;
+  // The block size expected to be used (i.e. rounded up to the next power of
+  // two and clamped to at least 2 samples)
+  std::size_t expectedBlockSize;
+  std::size_t templateLength;
+  // The number of samples applied at once
+  std::size_t chunkSize;
+
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const PartitionedSample &sample) {
+    return os << "blockSize=" << sample.blockSize
+              << ", templateLength=" << sample.templateLength
+              << ", chunkSize=" << sample.chunkSize;
+  }
+};
+
 }  // namespace ds
 
+namespace {
+
+// Returns `n` samples of white noise (deterministic)
+std::vector<double> makeNoise(std::size_t n, unsigned seed) {
+  std::mt19937 generator{seed};
+  std::normal_distribution<double> noise{0, 1};
+  std::vector<double> ret(n);
+  for (auto &sample : ret) {
+    sample = noise(generator);
+  }
+  return ret;
+}
+
+}  // namespace
+
 using Samples = std::vector<ds::Sample>;
 const Samples dataset{
     {/*templateData=*/{1, 2, 1}, /*data=*/{{1, 1}},
@@ -116,6 +157,164 @@ BOOST_DATA_TEST_CASE(crosscorrelation, utf_data::make(dataset)) {
   BOOST_TEST(joined == sample.expected, utf_tt::per_element());
 }
 
+BOOST_TEST_DECORATOR(*utf::tolerance(testUnitTolerance))
+BOOST_DATA_TEST_CASE(crosscorrelation_restore, utf_data::make(dataset)) {
+  // create dummy record
+  auto templateTrace{util::make_smart<GenericRecord>("NET", "STA", "LOC", "CHA",
+                                                     Core::Time::GMT(), 1.0)};
+  templateTrace->setData(static_cast<int>(sample.templateData.size()),
+                         sample.templateData.data(), Array::DOUBLE);
+
+  filter::CrossCorrelation<double> xcorr{templateTrace};
+
+  std::vector<ds::Sample::TimeSeries> filtered;
+  auto first{sample.data.front()};
+  xcorr.apply(first);
+  filtered.push_back(first);
+
+  // continue filtering with a restored filter
+  filter::CrossCorrelation<double> restored{templateTrace};
+  restored.restore(xcorr.state());
+  for (auto it{std::next(sample.data.begin())}; it != sample.data.end();
+       ++it) {
+    auto data{*it};
+    restored.apply(data);
+    filtered.push_back(data);
+  }
+
+  const auto joined{ds::Join(filtered)};
+  BOOST_TEST_REQUIRE(joined.size() == sample.expected.size());
+  BOOST_TEST(joined == sample.expected, utf_tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(fft) {
+  BOOST_TEST_CHECK(filter::fft::nextPowerOfTwo(1) == 1);
+  BOOST_TEST_CHECK(filter::fft::nextPowerOfTwo(2) == 2);
+  BOOST_TEST_CHECK(filter::fft::nextPowerOfTwo(3) == 4);
+  BOOST_TEST_CHECK(filter::fft::nextPowerOfTwo(100) == 128);
+
+  for (const std::size_t n : {4, 8, 16, 256}) {
+    const auto samples{makeNoise(n, static_cast<unsigned>(n))};
+    filter::fft::RealFFT fft{n};
+    BOOST_TEST_REQUIRE(fft.size() == n);
+
+    std::vector<std::complex<double>> spectrum(n / 2 + 1);
+    fft.forward(samples.data(), spectrum.data());
+    // compare with the discrete Fourier transform
+    double deviation{0};
+    for (std::size_t k{0}; k <= n / 2; ++k) {
+      std::complex<double> expected{0, 0};
+      for (std::size_t i{0}; i < n; ++i) {
+        expected += samples[i] * std::polar(1.0, -2 * M_PI * k * i / n);
+      }
+      deviation = std::max(deviation, std::abs(spectrum[k] - expected));
+    }
+    BOOST_TEST_CHECK(deviation < 1e-9);
+
+    // the inverse transform restores the samples
+    std::vector<double> restored(n);
+    fft.inverse(spectrum.data(), restored.data());
+    deviation = 0;
+    for (std::size_t i{0}; i < n; ++i) {
+      deviation = std::max(deviation, std::fabs(restored[i] - samples[i]));
+    }
+    BOOST_TEST_CHECK(deviation < 1e-9);
+  }
+}
+
+const std::vector<ds::PartitionedSample> partitionedDataset{
+    // the block size is clamped to 2 samples
+    {1, 2, 20, 7},
+    {2, 2, 20, 1},
+    {3, 4, 50, 64},
+    {16, 16, 50, 10},
+    {64, 64, 101, 100},
+    // the template waveform is shorter than a single block
+    {100, 128, 50, 33}};
+
+BOOST_DATA_TEST_CASE(crosscorrelation_partitioned,
+                     utf_data::make(partitionedDataset)) {
+  const std::size_t n{1000};
+  const auto templateSamples{makeNoise(sample.templateLength, 1)};
+  auto templateTrace{util::make_smart<GenericRecord>("NET", "STA", "LOC", "CHA",
+                                                     Core::Time::GMT(), 1.0)};
+  templateTrace->setData(static_cast<int>(templateSamples.size()),
+                         templateSamples.data(), Array::DOUBLE);
+
+  // superimpose the template waveform at several offsets
+  auto data{makeNoise(n, 2)};
+  for (const auto offset : {150, 600}) {
+    for (std::size_t i{0}; i < sample.templateLength; ++i) {
+      data[offset + i] += 3 * templateSamples[i];
+    }
+  }
+
+  filter::CrossCorrelation<double> direct{templateTrace};
+  auto expected{data};
+  direct.apply(expected);
+
+  filter::CrossCorrelation<double> partitioned{templateTrace};
+  partitioned.setPartitionedConvolution(sample.blockSize);
+  BOOST_TEST_CHECK(partitioned.partitionBlockSize() ==
+                   sample.expectedBlockSize);
+  BOOST_TEST_CHECK(partitioned.latency() == sample.expectedBlockSize);
+
+  auto actual{data};
+  for (std::size_t i{0}; i < n; i += sample.chunkSize) {
+    partitioned.apply(std::min(sample.chunkSize, n - i), actual.data() + i);
+  }
+
+  // the partitioned coefficients are delayed by the latency, only
+  const auto latency{partitioned.latency()};
+  double deviation{0};
+  for (std::size_t i{0}; i + latency < n; ++i) {
+    deviation =
+        std::max(deviation, std::fabs(actual[i + latency] - expected[i]));
+  }
+  BOOST_TEST_CHECK(deviation < 1e-9);
+  BOOST_TEST_CHECK(*std::max_element(actual.begin(), actual.end()) > 0.9);
+}
+
+BOOST_DATA_TEST_CASE(crosscorrelation_partitioned_restore,
+                     utf_data::make(partitionedDataset)) {
+  const std::size_t n{1000};
+  const auto templateSamples{makeNoise(sample.templateLength, 3)};
+  auto templateTrace{util::make_smart<GenericRecord>("NET", "STA", "LOC", "CHA",
+                                                     Core::Time::GMT(), 1.0)};
+  templateTrace->setData(static_cast<int>(templateSamples.size()),
+                         templateSamples.data(), Array::DOUBLE);
+  const auto data{makeNoise(n, 4)};
+
+  filter::CrossCorrelation<double> xcorr{templateTrace};
+  xcorr.setPartitionedConvolution(sample.blockSize);
+  auto expected{data};
+  xcorr.apply(expected);
+
+  // continue filtering with a restored filter
+  filter::CrossCorrelation<double> first{templateTrace};
+  first.setPartitionedConvolution(sample.blockSize);
+  auto actual{data};
+  const auto split{n / 2 + 1};
+  first.apply(split, actual.data());
+
+  filter::CrossCorrelation<double> restored{templateTrace};
+  restored.setPartitionedConvolution(sample.blockSize);
+  restored.restore(first.state());
+  restored.apply(n - split, actual.data() + split);
+
+  double deviation{0};
+  for (std::size_t i{0}; i < n; ++i) {
+    deviation = std::max(deviation, std::fabs(actual[i] - expected[i]));
+  }
+  BOOST_TEST_CHECK(deviation < 1e-9);
+
+  // the state refers to the kernel, i.e. it cannot be restored by means of a
+  // different kernel
+  filter::CrossCorrelation<double> direct{templateTrace};
+  BOOST_CHECK_THROW(direct.restore(first.state()),
+                    filter::BaseException);
+}
+
 }  // namespace test
 }  // namespace detect
 }  // namespace Seiscomp
@@ -0,0 +1,232 @@
+#define SEISCOMP_TEST_MODULE test_filter_iir
+#include <seiscomp/math/filter/butterworth.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <algorithm>
+#include <boost/test/data/dataset.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../def.h"
+#include "../filter/iir.h"
+
+namespace utf = boost::unit_test;
+namespace utf_data = utf::data;
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+// The maximum deviation from the SeisComP implementation (relative to the
+// maximum absolute output amplitude)
+constexpr double kTolerance{1e-9};
+
+// Returns `n` samples of white noise superimposed with a sine (deterministic)
+std::vector<double> makeData(std::size_t n, unsigned seed) {
+  std::mt19937 generator{seed};
+  std::normal_distribution<double> noise{0, 1};
+  std::vector<double> ret(n);
+  for (std::size_t i{0}; i < n; ++i) {
+    ret[i] = 10 * std::sin(0.05 * static_cast<double>(i)) + noise(generator);
+  }
+  return ret;
+}
+
+// Filters `data` in chunks of `chunkSize` samples
+std::vector<double> apply(DoubleFilter &filter, std::vector<double> data,
+                          std::size_t chunkSize) {
+  for (std::size_t i{0}; i < data.size(); i += chunkSize) {
+    const auto n{std::min(chunkSize, data.size() - i)};
+    filter.apply(static_cast<int>(n), data.data() + i);
+  }
+  return data;
+}
+
+// Returns the maximum absolute deviation of `lhs` from `rhs` relative to the
+// maximum absolute value of `rhs`
+double relativeDeviation(const std::vector<double> &lhs,
+                         const std::vector<double> &rhs) {
+  double deviation{0};
+  double amplitude{0};
+  for (std::size_t i{0}; i < rhs.size(); ++i) {
+    deviation = std::max(deviation, std::fabs(lhs[i] - rhs[i]));
+    amplitude = std::max(amplitude, std::fabs(rhs[i]));
+  }
+  return deviation / amplitude;
+}
+
+}  // namespace
+
+namespace ds {
+
+struct Sample {
+  std::string filterId;
+  double samplingFrequency;
+  // Creates the corresponding SeisComP Butterworth filter
+  std::shared_ptr<DoubleFilter> (*reference)();
+
+  friend std::ostream &operator<<(std::ostream &os, const Sample &sample) {
+    return os << sample.filterId << " (" << sample.samplingFrequency << "Hz)";
+  }
+};
+
+}  // namespace ds
+
+using Samples = std::vector<ds::Sample>;
+const Samples dataset{
+    {"BW(3,0.5,8)", 100,
+     []() -> std::shared_ptr<DoubleFilter> {
+       return std::make_shared<
+           Math::Filtering::IIR::ButterworthHighLowpass<double>>(3, 0.5, 8,
+                                                                 100);
+     }},
+    {"BW(4,1,10)", 40,
+     []() -> std::shared_ptr<DoubleFilter> {
+       return std::make_shared<
+           Math::Filtering::IIR::ButterworthHighLowpass<double>>(4, 1, 10,
+                                                                 40);
+     }},
+    {"BW_HP(3,1)", 100,
+     []() -> std::shared_ptr<DoubleFilter> {
+       return std::make_shared<
+           Math::Filtering::IIR::ButterworthHighpass<double>>(3, 1, 100);
+     }},
+    {"BW_HP(2,0.2)", 20,
+     []() -> std::shared_ptr<DoubleFilter> {
+       return std::make_shared<
+           Math::Filtering::IIR::ButterworthHighpass<double>>(2, 0.2, 20);
+     }},
+    {"BW_LP(3,5)", 100,
+     []() -> std::shared_ptr<DoubleFilter> {
+       return std::make_shared<
+           Math::Filtering::IIR::ButterworthLowpass<double>>(3, 5, 100);
+     }},
+    {"BW_LP(6,12.5)", 50,
+     []() -> std::shared_ptr<DoubleFilter> {
+       return std::make_shared<
+           Math::Filtering::IIR::ButterworthLowpass<double>>(6, 12.5, 50);
+     }},
+};
+
+BOOST_DATA_TEST_CASE(butterworth, utf_data::make(dataset)) {
+  const auto data{makeData(2000, 42)};
+
+  auto native{filter::iir::createFilter(sample.filterId)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(native));
+  native->setSamplingFrequency(sample.samplingFrequency);
+  const auto actual{apply(*native, data, 128)};
+
+  // compare sample by sample with the SeisComP Butterworth filter
+  auto reference{sample.reference()};
+  reference->setSamplingFrequency(sample.samplingFrequency);
+  const auto expected{apply(*reference, data, 128)};
+  BOOST_TEST_CHECK(relativeDeviation(actual, expected) <= kTolerance);
+
+  // compare sample by sample with the filter created from the identifier
+  std::unique_ptr<DoubleFilter> generic{DoubleFilter::Create(sample.filterId)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(generic));
+  generic->setSamplingFrequency(sample.samplingFrequency);
+  BOOST_TEST_CHECK(relativeDeviation(actual, apply(*generic, data, 128)) <=
+                   kTolerance);
+
+  // the output does not depend on the chunk size
+  std::unique_ptr<DoubleFilter> clone{native->clone()};
+  BOOST_TEST_CHECK(apply(*clone, data, 7) == actual,
+                   boost::test_tools::per_element());
+}
+
+BOOST_DATA_TEST_CASE(filter_bank, utf_data::make(dataset)) {
+  const auto config{filter::iir::parseButterworth(sample.filterId)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(config));
+  auto biquads{filter::iir::butterworth(*config, sample.samplingFrequency)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(biquads));
+
+  const std::size_t channels{3};
+  std::vector<std::vector<double>> data;
+  for (std::size_t c{0}; c < channels; ++c) {
+    data.push_back(makeData(1000, static_cast<unsigned>(c)));
+  }
+
+  // filter the channels jointly
+  filter::iir::FilterBank bank{biquads, channels};
+  auto actual{data};
+  const std::size_t chunkSize{100};
+  for (std::size_t i{0}; i < 1000; i += chunkSize) {
+    std::vector<double *> chunk;
+    for (auto &samples : actual) {
+      chunk.push_back(samples.data() + i);
+    }
+    bank.apply(chunkSize, chunk.data());
+  }
+
+  // each channel's output is identical to filtering the channel on its own
+  for (std::size_t c{0}; c < channels; ++c) {
+    filter::iir::ButterworthFilter single{*config};
+    single.setSamplingFrequency(sample.samplingFrequency);
+    BOOST_TEST_CHECK(apply(single, data[c], chunkSize) == actual[c],
+                     boost::test_tools::per_element());
+  }
+
+  // resetting a channel does not affect the other channels
+  auto restarted{data};
+  filter::iir::FilterBank restartedBank{biquads, channels};
+  for (std::size_t i{0}; i < 1000; i += chunkSize) {
+    if (i == 500) {
+      restartedBank.reset(0);
+    }
+    std::vector<double *> chunk;
+    for (auto &samples : restarted) {
+      chunk.push_back(samples.data() + i);
+    }
+    restartedBank.apply(chunkSize, chunk.data());
+  }
+  filter::iir::ButterworthFilter single{*config};
+  single.setSamplingFrequency(sample.samplingFrequency);
+  const std::vector<double> tail(data[0].begin() + 500, data[0].end());
+  BOOST_TEST_CHECK(apply(single, tail, chunkSize) ==
+                       std::vector<double>(restarted[0].begin() + 500,
+                                           restarted[0].end()),
+                   boost::test_tools::per_element());
+  for (std::size_t c{1}; c < channels; ++c) {
+    BOOST_TEST_CHECK(restarted[c] == actual[c],
+                     boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parse_butterworth) {
+  BOOST_TEST_CHECK(!filter::iir::parseButterworth("BW(3,0.5)"));
+  BOOST_TEST_CHECK(!filter::iir::parseButterworth("BW_HP(0,1)"));
+  BOOST_TEST_CHECK(!filter::iir::parseButterworth("BW(3,1,10)>>ITAPER(10)"));
+  BOOST_TEST_CHECK(!filter::iir::parseButterworth("RMHP(10)"));
+
+  const auto config{filter::iir::parseButterworth(" BW ( 4, 1 , 10 ) ")};
+  BOOST_TEST_REQUIRE(static_cast<bool>(config));
+  BOOST_TEST_CHECK(config->order == 4);
+  BOOST_TEST_CHECK(config->fmin == 1);
+  BOOST_TEST_CHECK(config->fmax == 10);
+
+  // the design is invalid if a corner frequency exceeds the Nyquist frequency
+  BOOST_TEST_CHECK(!filter::iir::butterworth(*config, 15));
+}
+
+BOOST_AUTO_TEST_CASE(native_filters) {
+  // the generic SeisComP implementation is used by default
+  BOOST_TEST_CHECK(!filter::iir::nativeFilters());
+
+  filter::iir::setNativeFilters(true);
+  BOOST_TEST_CHECK(filter::iir::nativeFilters());
+  filter::iir::setNativeFilters(false);
+  BOOST_TEST_CHECK(!filter::iir::nativeFilters());
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,141 @@
+#define SEISCOMP_TEST_MODULE test_filter_multichannel_crosscorrelation
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <algorithm>
+#include <boost/test/data/dataset.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "../filter/crosscorrelation.h"
+#include "../filter/multichannel_crosscorrelation.h"
+#include "../template_waveform.h"
+#include "../util/memory.h"
+
+namespace utf = boost::unit_test;
+namespace utf_data = utf::data;
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+constexpr double kSamplingFrequency{100};
+constexpr double kTolerance{1e-9};
+
+// Returns `n` samples of white noise (deterministic)
+std::vector<double> makeNoise(std::size_t n, unsigned seed) {
+  std::mt19937 generator{seed};
+  std::normal_distribution<double> noise{0, 1};
+  std::vector<double> ret(n);
+  for (auto &sample : ret) {
+    sample = noise(generator);
+  }
+  return ret;
+}
+
+GenericRecordPtr makeRecord(const std::vector<double> &samples) {
+  auto ret{util::make_smart<GenericRecord>("NET", "STA", "LOC", "CHA",
+                                           Core::Time{2020, 10, 25, 19, 30},
+                                           kSamplingFrequency)};
+  ret->setData(static_cast<int>(samples.size()), samples.data(),
+               Array::DOUBLE);
+  return ret;
+}
+
+}  // namespace
+
+namespace ds {
+
+struct Sample {
+  std::size_t channels;
+  std::size_t templateLength;
+  std::size_t chunkSize;
+
+  friend std::ostream &operator<<(std::ostream &os, const Sample &sample) {
+    return os << "channels=" << sample.channels
+              << ", templateLength=" << sample.templateLength
+              << ", chunkSize=" << sample.chunkSize;
+  }
+};
+
+}  // namespace ds
+
+const std::vector<ds::Sample> dataset{
+    {1, 20, 7}, {2, 50, 64}, {3, 50, 1}, {3, 101, 100}};
+
+BOOST_DATA_TEST_CASE(mean, utf_data::make(dataset)) {
+  const std::size_t n{1000};
+
+  std::vector<TemplateWaveform> templateWaveforms;
+  std::vector<std::vector<double>> data;
+  for (std::size_t c{0}; c < sample.channels; ++c) {
+    const auto templateSamples{
+        makeNoise(sample.templateLength, static_cast<unsigned>(c))};
+    templateWaveforms.emplace_back(makeRecord(templateSamples));
+
+    // superimpose the template waveform at several offsets
+    auto samples{makeNoise(n, static_cast<unsigned>(100 + c))};
+    for (const auto offset : {150, 600}) {
+      for (std::size_t i{0}; i < sample.templateLength; ++i) {
+        samples[offset + i] += 3 * templateSamples[i];
+      }
+    }
+    data.push_back(samples);
+  }
+
+  // the mean of the single channel cross-correlations
+  std::vector<double> expected(n, 0);
+  for (std::size_t c{0}; c < sample.channels; ++c) {
+    filter::CrossCorrelation<double> xcorr{templateWaveforms[c]};
+    xcorr.setSamplingFrequency(kSamplingFrequency);
+    auto coefficients{data[c]};
+    xcorr.apply(coefficients);
+    for (std::size_t i{0}; i < n; ++i) {
+      expected[i] += coefficients[i] / sample.channels;
+    }
+  }
+
+  filter::MultiChannelCrossCorrelation xcorr{templateWaveforms};
+  xcorr.setSamplingFrequency(kSamplingFrequency);
+  BOOST_TEST_CHECK(xcorr.channels() == sample.channels);
+  BOOST_TEST_CHECK(xcorr.size() == sample.templateLength);
+
+  std::vector<double> actual(n);
+  for (std::size_t i{0}; i < n; i += sample.chunkSize) {
+    const auto m{std::min(sample.chunkSize, n - i)};
+    std::vector<const double *> chunk;
+    for (const auto &samples : data) {
+      chunk.push_back(samples.data() + i);
+    }
+    xcorr.apply(m, chunk.data(), actual.data() + i);
+  }
+
+  double deviation{0};
+  for (std::size_t i{0}; i < n; ++i) {
+    deviation = std::max(deviation, std::fabs(actual[i] - expected[i]));
+  }
+  BOOST_TEST_CHECK(deviation < kTolerance);
+  // the template waveforms are detected
+  BOOST_TEST_CHECK(*std::max_element(actual.begin(), actual.end()) > 0.9);
+
+  // resetting restarts the filter
+  xcorr.reset();
+  std::vector<const double *> chunk;
+  for (const auto &samples : data) {
+    chunk.push_back(samples.data());
+  }
+  std::vector<double> restarted(n);
+  xcorr.apply(n, chunk.data(), restarted.data());
+  BOOST_TEST_CHECK(restarted == actual, boost::test_tools::per_element());
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,171 @@
+#define SEISCOMP_TEST_MODULE test_filter_subspace
+#include <seiscomp/unittest/unittests.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../filter/subspace.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+constexpr double kTolerance{1e-9};
+
+// Returns `n` samples of white noise (deterministic)
+std::vector<double> makeNoise(std::size_t n, unsigned seed) {
+  std::mt19937 generator{seed};
+  std::normal_distribution<double> noise{0, 1};
+  std::vector<double> ret(n);
+  for (auto &sample : ret) {
+    sample = noise(generator);
+  }
+  return ret;
+}
+
+// Returns `waveform` delayed by `lag` samples (zero padded)
+std::vector<double> delay(const std::vector<double> &waveform, int lag) {
+  std::vector<double> ret(waveform.size(), 0);
+  for (std::size_t i{0}; i < waveform.size(); ++i) {
+    const auto k{static_cast<long>(i) - lag};
+    if (k >= 0 && k < static_cast<long>(waveform.size())) {
+      ret[i] = waveform[k];
+    }
+  }
+  return ret;
+}
+
+// Returns the demeaned and normalized `samples`
+std::vector<double> normalized(std::vector<double> samples) {
+  const auto mean{std::accumulate(samples.begin(), samples.end(), 0.0) /
+                  samples.size()};
+  for (auto &sample : samples) {
+    sample -= mean;
+  }
+  const auto norm{std::sqrt(std::inner_product(samples.begin(), samples.end(),
+                                               samples.begin(), 0.0))};
+  for (auto &sample : samples) {
+    sample /= norm;
+  }
+  return samples;
+}
+
+// Returns the fraction of the energy of `waveform` projected onto `basis`
+double energyFraction(const filter::subspace::Basis &basis,
+                      const std::vector<double> &waveform) {
+  const auto x{normalized(waveform)};
+  double ret{0};
+  for (std::size_t j{0}; j < basis.dimension(); ++j) {
+    const auto *u{basis.vectors.data() + j * basis.length};
+    const auto projection{std::inner_product(x.begin(), x.end(), u, 0.0)};
+    ret += projection * projection;
+  }
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(align) {
+  const auto reference{makeNoise(200, 0)};
+
+  BOOST_TEST_CHECK(filter::subspace::align(reference, reference, 10) == 0);
+  for (const auto lag : {-7, -1, 1, 5}) {
+    BOOST_TEST_CHECK(
+        filter::subspace::align(reference, delay(reference, lag), 10) == lag);
+  }
+  // the sign is ignored
+  std::vector<double> inverted(reference.size());
+  std::transform(reference.begin(), reference.end(), inverted.begin(),
+                 [](double sample) { return -sample; });
+  BOOST_TEST_CHECK(filter::subspace::align(reference, delay(inverted, 3), 10) ==
+                   3);
+  // lags exceeding the maximum lag are not found
+  BOOST_TEST_CHECK(
+      filter::subspace::align(reference, delay(reference, 20), 10) != 20);
+}
+
+BOOST_AUTO_TEST_CASE(design) {
+  const std::size_t n{300};
+  const auto reference{makeNoise(n, 1)};
+  auto similar{delay(reference, 4)};
+  const auto perturbation{makeNoise(n, 2)};
+  for (std::size_t i{0}; i < n; ++i) {
+    similar[i] += 0.5 * perturbation[i];
+  }
+  const std::vector<std::vector<double>> waveforms{reference, similar,
+                                                   makeNoise(n, 3)};
+
+  // full dimension
+  const auto basis{filter::subspace::design(waveforms, waveforms.size(), 10)};
+  BOOST_TEST_REQUIRE(basis.dimension() == waveforms.size());
+  BOOST_TEST_CHECK(basis.length == n);
+  BOOST_TEST_CHECK(std::fabs(basis.capturedEnergy - 1) < kTolerance);
+
+  // the basis is orthonormal
+  for (std::size_t j{0}; j < basis.dimension(); ++j) {
+    const auto *u{basis.vectors.data() + j * n};
+    BOOST_TEST_CHECK(std::fabs(std::accumulate(u, u + n, 0.0)) < kTolerance);
+    for (std::size_t k{0}; k < basis.dimension(); ++k) {
+      const auto *v{basis.vectors.data() + k * n};
+      const auto product{std::inner_product(u, u + n, v, 0.0)};
+      BOOST_TEST_CHECK(std::fabs(product - (j == k ? 1 : 0)) < kTolerance);
+    }
+  }
+
+  // the entire energy of a member is captured (provided that the member is
+  // aligned the same way as by the subspace design)
+  for (const auto &waveform : waveforms) {
+    const auto member{normalized(waveform)};
+    const auto lag{filter::subspace::align(normalized(reference), member, 10)};
+    BOOST_TEST_CHECK(std::fabs(energyFraction(basis, delay(member, -lag)) - 1) <
+                     kTolerance);
+  }
+  // in contrast to a waveform not being a member
+  BOOST_TEST_CHECK(energyFraction(basis, makeNoise(n, 4)) < 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(design_dimension) {
+  const std::size_t n{300};
+  const auto reference{makeNoise(n, 5)};
+  auto similar{reference};
+  const auto perturbation{makeNoise(n, 6)};
+  for (std::size_t i{0}; i < n; ++i) {
+    similar[i] += perturbation[i];
+  }
+
+  // the eigenvalues of the Gram matrix of two normalized waveforms with the
+  // correlation coefficient `c` are `1 + |c|` and `1 - |c|`
+  const auto x{normalized(reference)};
+  const auto y{normalized(similar)};
+  const auto c{std::inner_product(x.begin(), x.end(), y.begin(), 0.0)};
+
+  const auto basis{filter::subspace::design({reference, similar}, 1, 0)};
+  BOOST_TEST_REQUIRE(basis.dimension() == 1);
+  BOOST_TEST_CHECK(std::fabs(basis.capturedEnergy - (1 + std::fabs(c)) / 2) <
+                   kTolerance);
+  // the dominant singular vector is the normalized mean of the waveforms
+  std::vector<double> mean(n);
+  std::transform(x.begin(), x.end(), y.begin(), mean.begin(),
+                 [](double lhs, double rhs) { return lhs + rhs; });
+  BOOST_TEST_CHECK(std::fabs(energyFraction(basis, mean) - 1) < kTolerance);
+
+  // the dimension is limited by the rank of the matrix
+  const auto degenerate{
+      filter::subspace::design({reference, reference, reference}, 3, 0)};
+  BOOST_TEST_CHECK(degenerate.dimension() == 1);
+  BOOST_TEST_CHECK(std::fabs(degenerate.capturedEnergy - 1) < kTolerance);
+
+  // invalid input
+  BOOST_TEST_CHECK(filter::subspace::design({}, 1, 0).empty());
+  BOOST_TEST_CHECK(filter::subspace::design({reference}, 0, 0).empty());
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
@@ -11,13 +11,17 @@ namespace detect {
 namespace test {
 
 bool CLIParserFixture::keepTempdir{false};
+boost::optional<double> CLIParserFixture::minRecall;
 
 void CLIParserFixture::setup() {
   try {
     po::options_description desc;
     desc.add_options()("keep-tempfiles",
                        po::value<bool>(&keepTempdir)->default_value(false),
-                       "Keep temporary files from tests");
+                       "Keep temporary files from tests")(
+        "min-recall", po::value<double>(),
+        "Check the recall of the detected origins with regards to the "
+        "expected origins (instead of comparing the results element-wise)");
 
     po::variables_map vm;
     po::store(po::command_line_parser(utf::framework::master_test_suite().argc,
@@ -27,6 +31,10 @@ void CLIParserFixture::setup() {
                   .run(),
               vm);
     po::notify(vm);
+
+    if (vm.count("min-recall")) {
+      minRecall = vm["min-recall"].as<double>();
+    }
   } catch (std::exception &e) {
     BOOST_TEST_FAIL(e.what());
   }
@@ -1,6 +1,8 @@
 #ifndef SCDETECT_APPS_CC_TEST_FIXTURE_H_
 #define SCDETECT_APPS_CC_TEST_FIXTURE_H_
 
+#include <boost/optional/optional.hpp>
+
 namespace Seiscomp {
 namespace detect {
 namespace test {
@@ -14,6 +16,9 @@ struct CLIParserFixture {
   void teardown();
 
   static bool keepTempdir;
+  // If set, the integration tests check the recall of the detected origins
+  // (instead of comparing the results element-wise)
+  static boost::optional<double> minRecall;
 };
 
 }  // namespace test
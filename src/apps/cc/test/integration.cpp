@@ -34,6 +34,9 @@ namespace fs = boost::filesystem;
 namespace po = boost::program_options;
 
 constexpr double testUnitTolerance{0.000001};
+// Maximum origin time offset of a detected origin matching an expected origin
+// when checking the recall
+constexpr double recallTolerance{0.1};
 
 namespace Seiscomp {
 namespace detect {
@@ -73,6 +76,7 @@ class FileBasedDataSet {
 
               .options(desc)
               .positional(pdesc)
+              .allow_unregistered()
               .run(),
           vm);
       po::notify(vm);
@@ -132,7 +136,12 @@ class FileBasedDataSet {
       }
 
       if (customFlags) {
-        ret.emplace_back(*customFlags);
+        // multiple custom flags are separated by whitespace
+        std::istringstream iss{*customFlags};
+        std::string flag;
+        while (iss >> flag) {
+          ret.emplace_back(flag);
+        }
       }
 
       return ret;
@@ -329,6 +338,17 @@ BOOST_DATA_TEST_CASE(
   readEventParameters(pathEpExpectedSCML, epExpected);
   BOOST_TEST_REQUIRE(epExpected, "Failed to read file: " << pathEpExpectedSCML);
 
+  if (CLIParserFixture::minRecall) {
+    const auto recall{originRecall(epResult, epExpected,
+                                   Core::TimeSpan{recallTolerance})};
+    BOOST_TEST_MESSAGE("Recall: " << recall << " (" << epExpected->originCount()
+                                  << " origins expected, "
+                                  << epResult->originCount()
+                                  << " origins detected)");
+    BOOST_TEST_CHECK(recall >= *CLIParserFixture::minRecall);
+    return;
+  }
+
   eventParametersCmp(epResult, epExpected);
 }
 
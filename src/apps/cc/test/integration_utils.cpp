@@ -9,6 +9,8 @@
 #include <boost/optional/optional.hpp>
 #include <boost/test/tools/interface.hpp>
 #include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstddef>
 #include <ostream>
 #include <sstream>
 #include <vector>
@@ -279,6 +281,35 @@ void eventParametersCmp(const DataModel::EventParametersCPtr &lhs,
   }
 }
 
+double originRecall(const DataModel::EventParametersCPtr &result,
+                    const DataModel::EventParametersCPtr &expected,
+                    const Core::TimeSpan &tolerance) {
+  if (expected->originCount() == 0) {
+    return 1;
+  }
+
+  // match each result origin at most once
+  std::vector<bool> matched(result->originCount(), false);
+  std::size_t found{0};
+  for (std::size_t i = 0; i < expected->originCount(); ++i) {
+    const auto originTime{expected->origin(i)->time().value()};
+    for (std::size_t j = 0; j < result->originCount(); ++j) {
+      if (matched[j]) {
+        continue;
+      }
+      const auto offset{static_cast<double>(
+          result->origin(j)->time().value() - originTime)};
+      if (std::fabs(offset) <= static_cast<double>(tolerance)) {
+        matched[j] = true;
+        ++found;
+        break;
+      }
+    }
+  }
+  return static_cast<double>(found) /
+         static_cast<double>(expected->originCount());
+}
+
 void pickCmp(const DataModel::PickCPtr &lhs, const DataModel::PickCPtr &rhs) {
   // compare attributes since the `creationInfo` attribute differs, anyway
   BOOST_TEST_CHECK(static_cast<double>(lhs->time().value()) ==
@@ -1,6 +1,7 @@
 #ifndef SCDETECT_APPS_CC_TEST_INTEGRATION_UTILS_H_
 #define SCDETECT_APPS_CC_TEST_INTEGRATION_UTILS_H_
 
+#include <seiscomp/core/datetime.h>
 #include <seiscomp/datamodel/amplitude.h>
 #include <seiscomp/datamodel/arrival.h>
 #include <seiscomp/datamodel/comment.h>
@@ -204,6 +205,12 @@ class FlagTemplatesFamilyJSON : public ArgFlag {
 void eventParametersCmp(const DataModel::EventParametersCPtr &lhs,
                         const DataModel::EventParametersCPtr &rhs);
 
+// Returns the fraction of the `expected` origins matched by an origin of
+// `result`, i.e. by an origin with an origin time within `tolerance`
+double originRecall(const DataModel::EventParametersCPtr &result,
+                    const DataModel::EventParametersCPtr &expected,
+                    const Core::TimeSpan &tolerance);
+
 // Compare `DataModel::Pick` element-wise
 void pickCmp(const DataModel::PickCPtr &lhs, const DataModel::PickCPtr &rhs);
 
@@ -0,0 +1,249 @@
+#define SEISCOMP_TEST_MODULE test_resampler
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <algorithm>
+#include <boost/optional/optional.hpp>
+#include <boost/test/data/dataset.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "../resampler.h"
+#include "../util/memory.h"
+
+namespace utf = boost::unit_test;
+namespace utf_data = utf::data;
+
+namespace Seiscomp {
+namespace detect {
+namespace test {
+
+namespace {
+
+const Core::Time kStartTime{2020, 10, 25, 19, 30};
+
+// The store's passband and stopband edges as well as the stopband attenuation
+constexpr double kPassband{0.7};
+constexpr double kStopband{0.9};
+constexpr double kAttenuation{60};
+
+// Returns a record with `n` samples of a sine with frequency `f` (the phase
+// refers to `kStartTime`)
+GenericRecordPtr makeSine(const Core::Time &startTime, double samplingFrequency,
+                          std::size_t n, double f) {
+  std::vector<double> samples(n);
+  const auto offset{static_cast<double>(startTime - kStartTime)};
+  for (std::size_t i{0}; i < n; ++i) {
+    const auto t{offset + static_cast<double>(i) / samplingFrequency};
+    samples[i] = std::sin(2 * M_PI * f * t);
+  }
+  auto ret{util::make_smart<GenericRecord>("NET", "STA", "LOC", "CHA",
+                                           startTime, samplingFrequency)};
+  ret->setData(static_cast<int>(n), samples.data(), Array::DOUBLE);
+  return ret;
+}
+
+// Returns a record with the samples `[first, first + n)` of `record`
+GenericRecordPtr slice(const Record &record, std::size_t first,
+                       std::size_t n) {
+  const auto *data{DoubleArray::ConstCast(record.data())};
+  auto ret{util::make_smart<GenericRecord>(
+      "NET", "STA", "LOC", "CHA",
+      record.startTime() + Core::TimeSpan{static_cast<double>(first) /
+                                          record.samplingFrequency()},
+      record.samplingFrequency())};
+  ret->setData(static_cast<int>(n), data->typedData() + first, Array::DOUBLE);
+  return ret;
+}
+
+std::vector<double> samples(const Record &record) {
+  const auto *data{DoubleArray::ConstCast(record.data())};
+  return std::vector<double>(data->typedData(),
+                             data->typedData() + data->size());
+}
+
+}  // namespace
+
+namespace ds {
+
+struct Sample {
+  double sourceFrequency;
+  double targetFrequency;
+
+  friend std::ostream &operator<<(std::ostream &os, const Sample &sample) {
+    return os << sample.sourceFrequency << "Hz -> " << sample.targetFrequency
+              << "Hz";
+  }
+};
+
+}  // namespace ds
+
+const std::vector<ds::Sample> dataset{
+    {200, 100}, {250, 100}, {40, 100}, {100, 40}};
+
+BOOST_AUTO_TEST_CASE(rationalize) {
+  auto factors{resampler::rationalize(200, 100, 128)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(factors));
+  BOOST_TEST_CHECK(factors->first == 1);
+  BOOST_TEST_CHECK(factors->second == 2);
+
+  factors = resampler::rationalize(40, 100, 128);
+  BOOST_TEST_REQUIRE(static_cast<bool>(factors));
+  BOOST_TEST_CHECK(factors->first == 5);
+  BOOST_TEST_CHECK(factors->second == 2);
+
+  BOOST_TEST_CHECK(!resampler::rationalize(100, 100 * M_SQRT1_2, 128));
+  BOOST_TEST_CHECK(!resampler::rationalize(100, 0, 128));
+  BOOST_TEST_CHECK(!resampler::designPolyphase(
+      100, 100 * M_SQRT1_2, kPassband, kStopband, kAttenuation));
+}
+
+BOOST_DATA_TEST_CASE(delay_compensation, utf_data::make(dataset)) {
+  auto coefficients{resampler::designPolyphase(
+      sample.sourceFrequency, sample.targetFrequency, kPassband, kStopband,
+      kAttenuation)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(coefficients));
+  resampler::PolyphaseRecordResampler resampler{coefficients};
+  BOOST_TEST_CHECK(resampler.latency() == coefficients->delay);
+
+  // a sine well within the passband
+  const auto f{0.1 * std::min(sample.sourceFrequency, sample.targetFrequency)};
+  const auto n{static_cast<std::size_t>(sample.sourceFrequency)};
+  std::vector<std::unique_ptr<Record>> resampled;
+  for (int i{0}; i < 20; ++i) {
+    auto record{makeSine(kStartTime + Core::TimeSpan{static_cast<double>(i)},
+                         sample.sourceFrequency, n, f)};
+    resampled.emplace_back(resampler.feed(record.get()));
+    BOOST_TEST_REQUIRE(static_cast<bool>(resampled.back()));
+  }
+
+  // the records start time compensates the group delay
+  BOOST_TEST_CHECK(resampled.front()->startTime() ==
+                   kStartTime - coefficients->delay);
+  for (std::size_t i{1}; i < resampled.size(); ++i) {
+    const auto &previous{resampled[i - 1]};
+    BOOST_TEST_CHECK(resampled[i]->samplingFrequency() ==
+                     sample.targetFrequency);
+    BOOST_TEST_CHECK(std::fabs(static_cast<double>(
+                         resampled[i]->startTime() - previous->endTime())) <
+                     0.5 / sample.targetFrequency);
+  }
+
+  // the resampled samples are aligned with the input (except of the filter's
+  // transient response)
+  const auto transient{kStartTime + coefficients->delay +
+                       coefficients->delay};
+  double deviation{0};
+  for (const auto &record : resampled) {
+    const auto values{samples(*record)};
+    for (std::size_t i{0}; i < values.size(); ++i) {
+      const auto t{record->startTime() +
+                   Core::TimeSpan{static_cast<double>(i) /
+                                  sample.targetFrequency}};
+      if (t < transient) {
+        continue;
+      }
+      const auto expected{
+          std::sin(2 * M_PI * f * static_cast<double>(t - kStartTime))};
+      deviation = std::max(deviation, std::fabs(values[i] - expected));
+    }
+  }
+  BOOST_TEST_CHECK(deviation < 0.01);
+}
+
+BOOST_DATA_TEST_CASE(streaming, utf_data::make(dataset)) {
+  auto coefficients{resampler::designPolyphase(
+      sample.sourceFrequency, sample.targetFrequency, kPassband, kStopband,
+      kAttenuation)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(coefficients));
+
+  const auto f{0.1 * std::min(sample.sourceFrequency, sample.targetFrequency)};
+  const auto n{static_cast<std::size_t>(sample.sourceFrequency)};
+
+  // a single record
+  auto record{makeSine(kStartTime, sample.sourceFrequency, 10 * n, f)};
+  resampler::PolyphaseRecordResampler single{coefficients};
+  std::unique_ptr<Record> expected{single.feed(record.get())};
+  BOOST_TEST_REQUIRE(static_cast<bool>(expected));
+
+  // contiguous records of varying length
+  resampler::PolyphaseRecordResampler chunked{coefficients};
+  std::vector<double> actual;
+  boost::optional<Core::Time> startTime;
+  std::size_t fed{0};
+  for (std::size_t length{1}; fed < 10 * n; ++length) {
+    const auto m{std::min(length, 10 * n - fed)};
+    std::unique_ptr<Record> resampled{
+        chunked.feed(slice(*record, fed, m).get())};
+    if (resampled) {
+      if (!startTime) {
+        startTime = resampled->startTime();
+      }
+      const auto values{samples(*resampled)};
+      actual.insert(actual.end(), values.begin(), values.end());
+    }
+    fed += m;
+  }
+
+  BOOST_TEST_REQUIRE(static_cast<bool>(startTime));
+  BOOST_TEST_CHECK(*startTime == expected->startTime());
+  BOOST_TEST_CHECK(actual == samples(*expected),
+                   boost::test_tools::per_element());
+}
+
+BOOST_DATA_TEST_CASE(restart_on_gap, utf_data::make(dataset)) {
+  auto coefficients{resampler::designPolyphase(
+      sample.sourceFrequency, sample.targetFrequency, kPassband, kStopband,
+      kAttenuation)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(coefficients));
+
+  const auto f{0.1 * std::min(sample.sourceFrequency, sample.targetFrequency)};
+  const auto n{static_cast<std::size_t>(5 * sample.sourceFrequency)};
+  auto first{makeSine(kStartTime, sample.sourceFrequency, n, f)};
+  // 2 seconds of data missing
+  auto second{makeSine(first->endTime() + Core::TimeSpan{2.0},
+                       sample.sourceFrequency, n, f)};
+  // overlapping data
+  auto third{makeSine(second->endTime() - Core::TimeSpan{1.0},
+                      sample.sourceFrequency, n, f)};
+
+  resampler::PolyphaseRecordResampler resampler{coefficients};
+  std::unique_ptr<Record> resampled{resampler.feed(first.get())};
+  BOOST_TEST_REQUIRE(static_cast<bool>(resampled));
+
+  // the stream is restarted, i.e. the output corresponds to the output of a
+  // resampler fed with the record after the gap, only
+  for (const auto *record : {second.get(), third.get()}) {
+    resampled.reset(resampler.feed(record));
+    BOOST_TEST_REQUIRE(static_cast<bool>(resampled));
+
+    resampler::PolyphaseRecordResampler restarted{coefficients};
+    std::unique_ptr<Record> expected{restarted.feed(record)};
+    BOOST_TEST_REQUIRE(static_cast<bool>(expected));
+    BOOST_TEST_CHECK(resampled->startTime() == expected->startTime());
+    BOOST_TEST_CHECK(resampled->startTime() ==
+                     record->startTime() - coefficients->delay);
+    BOOST_TEST_CHECK(samples(*resampled) == samples(*expected),
+                     boost::test_tools::per_element());
+  }
+
+  // resetting restarts the stream, as well
+  resampler.reset();
+  resampled.reset(resampler.feed(first.get()));
+  resampler::PolyphaseRecordResampler fresh{coefficients};
+  std::unique_ptr<Record> expected{fresh.feed(first.get())};
+  BOOST_TEST_REQUIRE(static_cast<bool>(resampled));
+  BOOST_TEST_REQUIRE(static_cast<bool>(expected));
+  BOOST_TEST_CHECK(resampled->startTime() == expected->startTime());
+  BOOST_TEST_CHECK(samples(*resampled) == samples(*expected),
+                   boost::test_tools::per_element());
+}
+
+}  // namespace test
+}  // namespace detect
+}  // namespace Seiscomp
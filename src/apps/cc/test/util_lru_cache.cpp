@@ -0,0 +1,115 @@
+#define SEISCOMP_TEST_MODULE test_util_lru_cache
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../util/lru_cache.h"
+
+namespace Seiscomp {
+namespace detect {
+
+namespace {
+
+using Cache = util::LRUCache<int, std::string>;
+
+// Returns the keys ordered from the most recently to the least recently used
+// entry
+std::vector<int> keys(const Cache &cache) {
+  std::vector<int> ret;
+  for (const auto &entry : cache) {
+    ret.push_back(entry.first);
+  }
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(get_put) {
+  Cache cache{3};
+  BOOST_TEST_CHECK(cache.size() == 0);
+  BOOST_TEST_CHECK(!cache.get(0));
+
+  cache.put(0, "0");
+  cache.put(1, "1");
+  BOOST_TEST_CHECK(cache.size() == 2);
+  BOOST_TEST_REQUIRE(cache.get(0));
+  BOOST_TEST_CHECK(*cache.get(0) == "0");
+  BOOST_TEST_REQUIRE(cache.get(1));
+  BOOST_TEST_CHECK(*cache.get(1) == "1");
+
+  // replace
+  cache.put(0, "00");
+  BOOST_TEST_CHECK(cache.size() == 2);
+  BOOST_TEST_REQUIRE(cache.get(0));
+  BOOST_TEST_CHECK(*cache.get(0) == "00");
+
+  cache.clear();
+  BOOST_TEST_CHECK(cache.size() == 0);
+  BOOST_TEST_CHECK(!cache.get(0));
+}
+
+BOOST_AUTO_TEST_CASE(eviction_order) {
+  Cache cache{3};
+  cache.put(0, "0");
+  cache.put(1, "1");
+  cache.put(2, "2");
+  BOOST_TEST_CHECK(keys(cache) == (std::vector<int>{2, 1, 0}),
+                   boost::test_tools::per_element());
+
+  // both looking up and replacing an entry mark it as the most recently used
+  BOOST_TEST_CHECK(cache.get(0));
+  BOOST_TEST_CHECK(keys(cache) == (std::vector<int>{0, 2, 1}),
+                   boost::test_tools::per_element());
+  cache.put(2, "22");
+  BOOST_TEST_CHECK(keys(cache) == (std::vector<int>{2, 0, 1}),
+                   boost::test_tools::per_element());
+
+  // the least recently used entry is evicted
+  cache.put(3, "3");
+  BOOST_TEST_CHECK(cache.size() == 3);
+  BOOST_TEST_CHECK(!cache.get(1));
+  BOOST_TEST_CHECK(keys(cache) == (std::vector<int>{3, 2, 0}),
+                   boost::test_tools::per_element());
+
+  // a failed look up does not change the order
+  BOOST_TEST_CHECK(!cache.get(42));
+  cache.put(4, "4");
+  BOOST_TEST_CHECK(!cache.get(0));
+  BOOST_TEST_CHECK(keys(cache) == (std::vector<int>{4, 3, 2}),
+                   boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(capacity) {
+  Cache cache{4};
+  BOOST_TEST_CHECK(cache.capacity() == 4);
+  for (int i{0}; i < 4; ++i) {
+    cache.put(i, std::to_string(i));
+  }
+  BOOST_TEST_CHECK(cache.size() == 4);
+
+  // shrinking evicts the least recently used entries
+  cache.setCapacity(2);
+  BOOST_TEST_CHECK(cache.capacity() == 2);
+  BOOST_TEST_CHECK(cache.size() == 2);
+  BOOST_TEST_CHECK(keys(cache) == (std::vector<int>{3, 2}),
+                   boost::test_tools::per_element());
+
+  // growing keeps the entries
+  cache.setCapacity(3);
+  BOOST_TEST_CHECK(cache.size() == 2);
+  cache.put(4, "4");
+  BOOST_TEST_CHECK(cache.size() == 3);
+
+  // a capacity of zero disables caching
+  cache.setCapacity(0);
+  BOOST_TEST_CHECK(cache.size() == 0);
+  cache.put(5, "5");
+  BOOST_TEST_CHECK(cache.size() == 0);
+  BOOST_TEST_CHECK(!cache.get(5));
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,155 @@
+#define SEISCOMP_TEST_MODULE test_util_worker_pool
+
+#include <seiscomp/unittest/unittests.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../util/worker_pool.h"
+
+namespace Seiscomp {
+namespace detect {
+
+namespace {
+
+// Returns a task which sleeps for `ms` milliseconds; its continuation appends
+// `id` to `order`
+util::WorkerPool::Task makeTask(int id, int ms, std::vector<int> *order) {
+  return [id, ms, order]() -> util::WorkerPool::Continuation {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    return [id, order]() { order->push_back(id); };
+  };
+}
+
+// A gate blocking tasks until opened
+class Gate {
+ public:
+  void open() {
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      _open = true;
+    }
+    _cv.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _cv.wait(lock, [this]() { return _open; });
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _open{false};
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ordering) {
+  util::WorkerPool pool{4};
+  BOOST_TEST_CHECK(pool.size() == 4);
+
+  // tasks submitted first finish last
+  std::vector<int> order;
+  const std::vector<int> expected{0, 1, 2, 3, 4, 5, 6, 7};
+  for (const auto id : expected) {
+    pool.submit(makeTask(id, 5 * (8 - id), &order));
+  }
+
+  BOOST_TEST_CHECK(pool.wait() == expected.size());
+  BOOST_TEST_CHECK(pool.pending() == 0);
+  BOOST_TEST_CHECK(order == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(poll) {
+  util::WorkerPool pool{2};
+
+  auto gate{std::make_shared<Gate>()};
+  std::vector<int> order;
+  pool.submit([gate, &order]() -> util::WorkerPool::Continuation {
+    gate->wait();
+    return [&order]() { order.push_back(0); };
+  });
+  pool.submit(makeTask(1, 0, &order));
+
+  // the second task's continuation must not overtake the first one's
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  BOOST_TEST_CHECK(pool.poll() == 0);
+  BOOST_TEST_CHECK(pool.pending() == 2);
+  BOOST_TEST_CHECK(order.empty());
+
+  gate->open();
+  BOOST_TEST_CHECK(pool.wait() == 2);
+  BOOST_TEST_CHECK(order == std::vector<int>({0, 1}),
+                   boost::test_tools::per_element());
+  BOOST_TEST_CHECK(pool.poll() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(exception) {
+  util::WorkerPool pool{2};
+
+  std::vector<int> order;
+  pool.submit(makeTask(0, 0, &order));
+  pool.submit([]() -> util::WorkerPool::Continuation {
+    throw std::runtime_error{"task failed"};
+  });
+  pool.submit(makeTask(2, 0, &order));
+  pool.submit([&order]() -> util::WorkerPool::Continuation {
+    return []() { throw std::runtime_error{"continuation failed"}; };
+  });
+  pool.submit(makeTask(4, 0, &order));
+
+  // errors are handled per task, i.e. the remaining tasks are not affected
+  std::size_t finished{0};
+  BOOST_CHECK_NO_THROW(finished = pool.wait());
+  BOOST_TEST_CHECK(finished == 5);
+  BOOST_TEST_CHECK(pool.pending() == 0);
+  BOOST_TEST_CHECK(order == std::vector<int>({0, 2, 4}),
+                   boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(shutdown) {
+  auto gate{std::make_shared<Gate>()};
+  std::atomic<int> started{0};
+  std::vector<int> order;
+  {
+    util::WorkerPool pool{1};
+    pool.submit([gate, &started, &order]() -> util::WorkerPool::Continuation {
+      ++started;
+      gate->wait();
+      return [&order]() { order.push_back(0); };
+    });
+    for (int i{1}; i < 4; ++i) {
+      pool.submit([i, &started, &order]() -> util::WorkerPool::Continuation {
+        ++started;
+        return [i, &order]() { order.push_back(i); };
+      });
+    }
+    BOOST_TEST_CHECK(pool.pending() == 4);
+
+    while (started == 0) {
+      std::this_thread::yield();
+    }
+    // release the running task while the pool is being destroyed
+    std::thread opener{[gate]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      gate->open();
+    }};
+    opener.detach();
+  }
+
+  // the running task is finished, tasks not started are discarded and no
+  // continuations are executed
+  BOOST_TEST_CHECK(started == 1);
+  BOOST_TEST_CHECK(order.empty());
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
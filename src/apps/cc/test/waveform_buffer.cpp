@@ -0,0 +1,220 @@
+#define SEISCOMP_TEST_MODULE test_waveform_buffer
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/timewindow.h>
+#include <seiscomp/unittest/unittests.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "../util/memory.h"
+#include "../waveform_buffer.h"
+
+namespace Seiscomp {
+namespace detect {
+
+namespace {
+
+const Core::Time kStartTime{2020, 10, 25, 19, 30};
+
+// Returns a record with the samples `first`, `first + 1`, ..., `first + n -
+// 1` (sampled at 1Hz) starting `offset` seconds after `kStartTime`
+GenericRecordPtr makeRecord(double offset, int first, int n) {
+  std::vector<double> samples;
+  for (int i{0}; i < n; ++i) {
+    samples.push_back(first + i);
+  }
+  auto ret{util::make_smart<GenericRecord>(
+      "NET", "STA", "LOC", "CHA", kStartTime + Core::TimeSpan{offset}, 1.0)};
+  ret->setData(n, samples.data(), Array::DOUBLE);
+  return ret;
+}
+
+std::vector<double> samples(const WaveformBuffer::Span &span) {
+  std::vector<double> ret(span.size());
+  span.copy(ret.data());
+  return ret;
+}
+
+std::vector<double> range(int first, int n) {
+  std::vector<double> ret;
+  for (int i{0}; i < n; ++i) {
+    ret.push_back(first + i);
+  }
+  return ret;
+}
+
+const std::string kStreamId{"NET.STA.LOC.CHA"};
+
+Core::TimeWindow timeWindow(double start, double end) {
+  return Core::TimeWindow{kStartTime + Core::TimeSpan{start},
+                          kStartTime + Core::TimeSpan{end}};
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(feed) {
+  WaveformBuffer buffer;
+  buffer.setTimeSpan(Core::TimeSpan{100.0});
+
+  BOOST_TEST_CHECK(buffer.feed(makeRecord(0, 0, 10).get()));
+  // duplicate
+  BOOST_TEST_CHECK(!buffer.feed(makeRecord(0, 0, 10).get()));
+  // overlap
+  BOOST_TEST_CHECK(buffer.feed(makeRecord(5, 5, 10).get()));
+
+  BOOST_TEST_CHECK(buffer.sampleCount() == 15);
+  const auto tw{buffer.timeWindow(kStreamId)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(tw));
+  BOOST_TEST_CHECK(tw->startTime() == kStartTime);
+  BOOST_TEST_CHECK(tw->endTime() == kStartTime + Core::TimeSpan{15.0});
+
+  const auto spans{buffer.read(kStreamId, timeWindow(0, 15))};
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(samples(spans[0]) == range(0, 15),
+                   boost::test_tools::per_element());
+
+  BOOST_TEST_CHECK(!buffer.timeWindow("NET.STA.LOC.XXX"));
+  BOOST_TEST_CHECK(buffer.read("NET.STA.LOC.XXX", timeWindow(0, 15)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(read) {
+  WaveformBuffer buffer;
+  buffer.setTimeSpan(Core::TimeSpan{100.0});
+  buffer.feed(makeRecord(0, 0, 20).get());
+
+  auto spans{buffer.read(kStreamId, timeWindow(5, 10))};
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(spans[0].startTime == kStartTime + Core::TimeSpan{5.0});
+  BOOST_TEST_CHECK(samples(spans[0]) == range(5, 5),
+                   boost::test_tools::per_element());
+
+  // the time window exceeds the data buffered
+  spans = buffer.read(kStreamId, timeWindow(-10, 30));
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(samples(spans[0]) == range(0, 20),
+                   boost::test_tools::per_element());
+
+  // the time window does not overlap with the data buffered
+  BOOST_TEST_CHECK(buffer.read(kStreamId, timeWindow(20, 30)).empty());
+  BOOST_TEST_CHECK(buffer.read(kStreamId, timeWindow(-10, 0)).empty());
+
+  const auto records{buffer.records(kStreamId, timeWindow(5, 10))};
+  BOOST_TEST_REQUIRE(records.size() == 1);
+  BOOST_TEST_CHECK(records[0]->startTime() ==
+                   kStartTime + Core::TimeSpan{5.0});
+  BOOST_TEST_CHECK(records[0]->data()->size() == 5);
+}
+
+BOOST_AUTO_TEST_CASE(zero_copy) {
+  WaveformBuffer buffer;
+  buffer.setTimeSpan(Core::TimeSpan{100.0});
+  buffer.feed(makeRecord(0, 0, 20).get());
+
+  // the spans reference the samples buffered, i.e. reading does not copy
+  const auto all{buffer.read(kStreamId, timeWindow(0, 20))};
+  BOOST_TEST_REQUIRE(all.size() == 1);
+  const auto again{buffer.read(kStreamId, timeWindow(0, 20))};
+  BOOST_TEST_REQUIRE(again.size() == 1);
+  BOOST_TEST_CHECK(again[0].first.data == all[0].first.data);
+
+  const auto part{buffer.read(kStreamId, timeWindow(5, 10))};
+  BOOST_TEST_REQUIRE(part.size() == 1);
+  BOOST_TEST_CHECK(part[0].first.data == all[0].first.data + 5);
+  BOOST_TEST_CHECK(part[0].first.size == 5);
+  BOOST_TEST_CHECK(part[0].second.size == 0);
+}
+
+BOOST_AUTO_TEST_CASE(wraparound) {
+  WaveformBuffer buffer;
+  // a capacity of 11 samples
+  buffer.setTimeSpan(Core::TimeSpan{10.0});
+  for (int i{0}; i < 5; ++i) {
+    buffer.feed(makeRecord(i * 7, i * 7, 7).get());
+  }
+
+  BOOST_TEST_CHECK(buffer.sampleCount() == 11);
+  const auto tw{buffer.timeWindow(kStreamId)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(tw));
+  BOOST_TEST_CHECK(tw->startTime() == kStartTime + Core::TimeSpan{24.0});
+  BOOST_TEST_CHECK(tw->endTime() == kStartTime + Core::TimeSpan{35.0});
+
+  // the samples span the end of the ring buffer's storage
+  const auto spans{buffer.read(kStreamId, timeWindow(0, 35))};
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(spans[0].second.size > 0);
+  BOOST_TEST_CHECK(spans[0].startTime == kStartTime + Core::TimeSpan{24.0});
+  BOOST_TEST_CHECK(samples(spans[0]) == range(24, 11),
+                   boost::test_tools::per_element());
+
+  // a record exceeding the capacity
+  buffer.feed(makeRecord(35, 35, 20).get());
+  BOOST_TEST_CHECK(buffer.sampleCount() == 11);
+  const auto last{buffer.read(kStreamId, timeWindow(0, 55))};
+  BOOST_TEST_REQUIRE(last.size() == 1);
+  BOOST_TEST_CHECK(samples(last[0]) == range(44, 11),
+                   boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(gaps) {
+  WaveformBuffer buffer;
+  buffer.setTimeSpan(Core::TimeSpan{30.0});
+  buffer.feed(makeRecord(0, 0, 10).get());
+  buffer.feed(makeRecord(15, 15, 5).get());
+  buffer.feed(makeRecord(20, 20, 5).get());
+
+  // data is kept across the gap
+  BOOST_TEST_CHECK(buffer.sampleCount() == 20);
+  const auto tw{buffer.timeWindow(kStreamId)};
+  BOOST_TEST_REQUIRE(static_cast<bool>(tw));
+  BOOST_TEST_CHECK(tw->startTime() == kStartTime);
+  BOOST_TEST_CHECK(tw->endTime() == kStartTime + Core::TimeSpan{25.0});
+
+  auto spans{buffer.read(kStreamId, timeWindow(5, 18))};
+  BOOST_TEST_REQUIRE(spans.size() == 2);
+  BOOST_TEST_CHECK(spans[0].startTime == kStartTime + Core::TimeSpan{5.0});
+  BOOST_TEST_CHECK(samples(spans[0]) == range(5, 5),
+                   boost::test_tools::per_element());
+  BOOST_TEST_CHECK(spans[1].startTime == kStartTime + Core::TimeSpan{15.0});
+  BOOST_TEST_CHECK(samples(spans[1]) == range(15, 3),
+                   boost::test_tools::per_element());
+
+  // the time window falls into the gap
+  BOOST_TEST_CHECK(buffer.read(kStreamId, timeWindow(11, 14)).empty());
+
+  // the oldest segment is dropped as soon as its samples are overwritten
+  buffer.feed(makeRecord(25, 25, 21).get());
+  spans = buffer.read(kStreamId, timeWindow(0, 50));
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(spans[0].startTime == kStartTime + Core::TimeSpan{15.0});
+  BOOST_TEST_CHECK(samples(spans[0]) == range(15, 31),
+                   boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(set_time_span) {
+  WaveformBuffer buffer;
+  buffer.setTimeSpan(Core::TimeSpan{10.0});
+  buffer.feed(makeRecord(0, 0, 10).get());
+
+  // growing the time span keeps the data buffered
+  buffer.setTimeSpan(Core::TimeSpan{20.0});
+  BOOST_TEST_CHECK(buffer.sampleCount() == 10);
+  buffer.feed(makeRecord(10, 10, 10).get());
+  auto spans{buffer.read(kStreamId, timeWindow(0, 20))};
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(samples(spans[0]) == range(0, 20),
+                   boost::test_tools::per_element());
+
+  // shrinking the time span drops the oldest samples
+  buffer.setTimeSpan(Core::TimeSpan{4.0});
+  BOOST_TEST_CHECK(buffer.sampleCount() == 5);
+  spans = buffer.read(kStreamId, timeWindow(0, 20));
+  BOOST_TEST_REQUIRE(spans.size() == 1);
+  BOOST_TEST_CHECK(spans[0].startTime == kStartTime + Core::TimeSpan{15.0});
+  BOOST_TEST_CHECK(samples(spans[0]) == range(15, 5),
+                   boost::test_tools::per_element());
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
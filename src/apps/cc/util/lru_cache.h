@@ -0,0 +1,94 @@
+#ifndef SCDETECT_APPS_CC_UTIL_LRUCACHE_H_
+#define SCDETECT_APPS_CC_UTIL_LRUCACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+// Cache mapping keys of type `Key` to values of type `Value`
+//
+// - the least recently used entries are evicted if the capacity is exceeded
+// - not thread-safe
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache {
+  using Entries = std::list<std::pair<Key, Value>>;
+
+ public:
+  using const_iterator = typename Entries::const_iterator;
+
+  explicit LRUCache(std::size_t capacity) : _capacity{capacity} {}
+
+  // Sets the maximum number of entries
+  void setCapacity(std::size_t capacity) {
+    _capacity = capacity;
+    evict();
+  }
+  std::size_t capacity() const { return _capacity; }
+
+  // Returns a pointer to the value cached for `key` and marks the entry as the
+  // most recently used one. Returns `nullptr` if there is no such entry.
+  Value *get(const Key &key) {
+    auto it{_idx.find(key)};
+    if (it == _idx.end()) {
+      return nullptr;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return &it->second->second;
+  }
+
+  // Caches `value` for `key`
+  void put(const Key &key, Value value) {
+    if (_capacity == 0) {
+      return;
+    }
+
+    auto it{_idx.find(key)};
+    if (it != _idx.end()) {
+      it->second->second = std::move(value);
+      _entries.splice(_entries.begin(), _entries, it->second);
+      return;
+    }
+
+    _entries.emplace_front(key, std::move(value));
+    _idx.emplace(key, _entries.begin());
+    evict();
+  }
+
+  // Returns the number of entries
+  std::size_t size() const { return _entries.size(); }
+
+  void clear() {
+    _idx.clear();
+    _entries.clear();
+  }
+
+  // Iterates over the entries (most recently used first)
+  const_iterator begin() const { return _entries.begin(); }
+  const_iterator end() const { return _entries.end(); }
+
+ private:
+  void evict() {
+    while (_entries.size() > _capacity) {
+      _idx.erase(_entries.back().first);
+      _entries.pop_back();
+    }
+  }
+
+  Entries _entries;
+  std::unordered_map<Key, typename Entries::iterator, Hash> _idx;
+
+  std::size_t _capacity;
+};
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_UTIL_LRUCACHE_H_
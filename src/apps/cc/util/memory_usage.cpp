@@ -0,0 +1,61 @@
+#include "memory_usage.h"
+
+#include <cstdio>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+std::size_t MemoryUsage::total() const {
+  return templateWaveforms + crossCorrelation + filters + linker + amplitudes;
+}
+
+MemoryUsage &MemoryUsage::operator+=(const MemoryUsage &other) {
+  templateWaveforms += other.templateWaveforms;
+  crossCorrelation += other.crossCorrelation;
+  filters += other.filters;
+  linker += other.linker;
+  amplitudes += other.amplitudes;
+  return *this;
+}
+
+MemoryUsage operator+(MemoryUsage lhs, const MemoryUsage &rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+std::size_t byteSize(const Array *array) {
+  if (!array || array->size() <= 0) {
+    return 0;
+  }
+  return static_cast<std::size_t>(array->size()) *
+         static_cast<std::size_t>(array->elementSize());
+}
+
+std::string formatBytes(std::size_t bytes) {
+  static const char *units[]{"B", "KiB", "MiB", "GiB", "TiB"};
+
+  double value{static_cast<double>(bytes)};
+  std::size_t unit{0};
+  while (value >= 1024 && unit < sizeof(units) / sizeof(units[0]) - 1) {
+    value /= 1024;
+    ++unit;
+  }
+
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.2f %s", value, units[unit]);
+  return buf;
+}
+
+std::string to_string(const MemoryUsage &usage) {
+  return formatBytes(usage.total()) +
+         " (templates: " + formatBytes(usage.templateWaveforms) +
+         ", cross-correlation: " + formatBytes(usage.crossCorrelation) +
+         ", filters: " + formatBytes(usage.filters) +
+         ", linker: " + formatBytes(usage.linker) +
+         ", amplitudes: " + formatBytes(usage.amplitudes) + ")";
+}
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
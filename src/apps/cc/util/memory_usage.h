@@ -0,0 +1,53 @@
+#ifndef SCDETECT_APPS_CC_UTIL_MEMORYUSAGE_H_
+#define SCDETECT_APPS_CC_UTIL_MEMORYUSAGE_H_
+
+#include <seiscomp/core/array.h>
+
+#include <cstddef>
+#include <string>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+// Approximate memory usage in bytes broken down by subsystem
+//
+// - only the dominant allocations (i.e. sample buffers and queued objects)
+// are taken into account
+// - data shared between subsystems (e.g. raw template waveforms served from
+// the same cache entry) may be counted more than once
+struct MemoryUsage {
+  // Template waveforms (both raw and processed)
+  std::size_t templateWaveforms{0};
+  // Cross-correlation data buffers
+  std::size_t crossCorrelation{0};
+  // Filter related buffers
+  std::size_t filters{0};
+  // Linker candidates and match results
+  std::size_t linker{0};
+  // Amplitude processor buffers
+  std::size_t amplitudes{0};
+
+  // Returns the total number of bytes
+  std::size_t total() const;
+
+  MemoryUsage &operator+=(const MemoryUsage &other);
+};
+
+MemoryUsage operator+(MemoryUsage lhs, const MemoryUsage &rhs);
+
+// Returns the number of bytes occupied by the samples of `array`
+//
+// - returns `0` if `array` is `nullptr`
+std::size_t byteSize(const Array *array);
+
+// Returns a human readable representation of `bytes` (e.g. `"1.50 MiB"`)
+std::string formatBytes(std::size_t bytes);
+// Returns a human readable representation of `usage`
+std::string to_string(const MemoryUsage &usage);
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_UTIL_MEMORYUSAGE_H_
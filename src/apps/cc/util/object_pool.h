@@ -0,0 +1,101 @@
+#ifndef SCDETECT_APPS_CC_UTIL_OBJECTPOOL_H_
+#define SCDETECT_APPS_CC_UTIL_OBJECTPOOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+// Pool of reference counted objects of type `T`
+//
+// - objects are handed out by means of `std::shared_ptr`s; as soon as the last
+// reference is dropped, the object is returned to the pool's free list
+// - the free list is bounded by the capacity (see `setCapacity()`). Objects
+// returned to a full free list are destroyed.
+// - recycled objects are not reset, i.e. containers keep both their content
+// and their capacity. Resetting the object is up to the user.
+// - objects may outlive the pool
+// - not thread-safe
+template <typename T>
+class ObjectPool {
+ public:
+  // The default maximum number of objects kept in the free list
+  static constexpr std::size_t kDefaultCapacity{256};
+
+  // Returns an object which is currently not in use. If there is no such
+  // object, a new one is allocated.
+  std::shared_ptr<T> acquire() {
+    std::unique_ptr<T> object;
+    if (_state->free.empty()) {
+      object.reset(new T{});
+    } else {
+      object = std::move(_state->free.back());
+      _state->free.pop_back();
+    }
+
+    ++_state->inUse;
+    return std::shared_ptr<T>{object.release(), Recycler{_state}};
+  }
+
+  // Sets the maximum number of objects kept in the free list (surplus objects
+  // are destroyed)
+  void setCapacity(std::size_t capacity) {
+    _state->capacity = capacity;
+    trim(capacity);
+  }
+  // Returns the maximum number of objects kept in the free list
+  std::size_t capacity() const { return _state->capacity; }
+
+  // Returns the total number of objects allocated (i.e. both in use and not
+  // in use)
+  std::size_t size() const { return _state->inUse + _state->free.size(); }
+  // Returns the number of objects currently not in use
+  std::size_t available() const { return _state->free.size(); }
+
+  // Destroys objects not in use until at most `n` objects are kept in the
+  // free list
+  void trim(std::size_t n = 0) {
+    if (_state->free.size() > n) {
+      _state->free.resize(n);
+    }
+  }
+
+  // Destroys the objects not in use (objects currently in use are kept alive
+  // by their users and returned to the pool afterwards)
+  void clear() { trim(); }
+
+ private:
+  struct State {
+    std::vector<std::unique_ptr<T>> free;
+    std::size_t inUse{0};
+    std::size_t capacity{kDefaultCapacity};
+  };
+
+  // Returns an object to the free list (the pool's state is shared with the
+  // objects in use)
+  struct Recycler {
+    void operator()(T *ptr) const {
+      std::unique_ptr<T> object{ptr};
+      --state->inUse;
+      if (state->free.size() < state->capacity) {
+        state->free.push_back(std::move(object));
+      }
+    }
+
+    std::shared_ptr<State> state;
+  };
+
+  std::shared_ptr<State> _state{std::make_shared<State>()};
+};
+
+template <typename T>
+constexpr std::size_t ObjectPool<T>::kDefaultCapacity;
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_UTIL_OBJECTPOOL_H_
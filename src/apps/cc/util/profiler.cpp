@@ -0,0 +1,139 @@
+#include "profiler.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <utility>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+namespace {
+
+// Writes `str` as JSON string literal to `os`
+void writeJsonString(std::ostream &os, const std::string &str) {
+  os << '"';
+  for (const auto c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[7];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          os << buf;
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+}  // namespace
+
+Profiler::Scope::Scope(Profiler *profiler, std::string name,
+                       std::string category)
+    : _profiler{profiler},
+      _wallStart{std::chrono::steady_clock::now()},
+      _cpuStart{std::clock()} {
+  _measurement.name = std::move(name);
+  _measurement.category = std::move(category);
+}
+
+Profiler::Scope::~Scope() { stop(); }
+
+Profiler::Scope::Scope(Scope &&other) noexcept
+    : _profiler{other._profiler},
+      _measurement{std::move(other._measurement)},
+      _wallStart{other._wallStart},
+      _cpuStart{other._cpuStart} {
+  other._profiler = nullptr;
+}
+
+void Profiler::Scope::setCount(std::size_t count) {
+  _measurement.count = count;
+}
+
+void Profiler::Scope::setCacheStatistics(std::size_t hits,
+                                         std::size_t misses) {
+  _measurement.cacheHits = hits;
+  _measurement.cacheMisses = misses;
+}
+
+void Profiler::Scope::stop() {
+  if (!_profiler) {
+    return;
+  }
+
+  _measurement.wallTime = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - _wallStart)
+                              .count();
+  _measurement.cpuTime =
+      static_cast<double>(std::clock() - _cpuStart) / CLOCKS_PER_SEC;
+
+  _profiler->store(std::move(_measurement));
+  _profiler = nullptr;
+}
+
+void Profiler::Scope::cancel() { _profiler = nullptr; }
+
+Profiler::Scope Profiler::measure(const std::string &name,
+                                  const std::string &category) {
+  return Scope{this, name, category};
+}
+
+const std::vector<Profiler::Measurement> &Profiler::measurements() const {
+  return _measurements;
+}
+
+void Profiler::write(std::ostream &os) const {
+  const auto flags{os.flags()};
+  os << std::fixed << std::setprecision(6);
+
+  os << "{\n  \"measurements\": [";
+  for (auto it{_measurements.cbegin()}; it != _measurements.cend(); ++it) {
+    if (it != _measurements.cbegin()) {
+      os << ",";
+    }
+    os << "\n    {\"name\": ";
+    writeJsonString(os, it->name);
+    os << ", \"category\": ";
+    writeJsonString(os, it->category);
+    os << ", \"wallTime\": " << it->wallTime
+       << ", \"cpuTime\": " << it->cpuTime << ", \"count\": " << it->count
+       << ", \"cacheHits\": " << it->cacheHits
+       << ", \"cacheMisses\": " << it->cacheMisses << ", \"cacheHitRate\": ";
+
+    const auto cacheRequests{it->cacheHits + it->cacheMisses};
+    if (cacheRequests > 0) {
+      os << static_cast<double>(it->cacheHits) / cacheRequests;
+    } else {
+      os << "null";
+    }
+    os << "}";
+  }
+  os << "\n  ]\n}\n";
+
+  os.flags(flags);
+}
+
+void Profiler::reset() { _measurements.clear(); }
+
+void Profiler::store(Measurement measurement) {
+  _measurements.emplace_back(std::move(measurement));
+}
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,90 @@
+#ifndef SCDETECT_APPS_CC_UTIL_PROFILER_H_
+#define SCDETECT_APPS_CC_UTIL_PROFILER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+// Collects wall and CPU time measurements for named sections (e.g.
+// initialization phases) and serializes them as JSON
+class Profiler {
+ public:
+  struct Measurement {
+    std::string name;
+    // The section's category (e.g. `"phase"` or `"detector"`)
+    std::string category;
+
+    // Wall time in seconds
+    double wallTime{0};
+    // Process CPU time in seconds
+    double cpuTime{0};
+
+    // The number of items processed within the section
+    std::size_t count{0};
+
+    // Cache statistics (if applicable)
+    std::size_t cacheHits{0};
+    std::size_t cacheMisses{0};
+  };
+
+  // RAII scope measuring the wall and CPU time until either destroyed or
+  // stopped explicitly
+  class Scope {
+   public:
+    Scope(Profiler *profiler, std::string name, std::string category);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+    Scope(Scope &&other) noexcept;
+    Scope &operator=(Scope &&other) = delete;
+
+    // Sets the number of items processed within the scope
+    void setCount(std::size_t count);
+    // Sets the cache statistics of the scope
+    void setCacheStatistics(std::size_t hits, std::size_t misses);
+
+    // Stops the measurement and stores the result
+    void stop();
+    // Stops the measurement and discards the result
+    void cancel();
+
+   private:
+    Profiler *_profiler;
+
+    Measurement _measurement;
+
+    std::chrono::steady_clock::time_point _wallStart;
+    std::clock_t _cpuStart;
+  };
+
+  // Starts measuring the section identified by `name`
+  Scope measure(const std::string &name,
+                const std::string &category = "phase");
+
+  // Returns the measurements in the order of completion
+  const std::vector<Measurement> &measurements() const;
+
+  // Writes the measurements JSON formatted to `os`
+  void write(std::ostream &os) const;
+
+  void reset();
+
+ private:
+  void store(Measurement measurement);
+
+  std::vector<Measurement> _measurements;
+};
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_UTIL_PROFILER_H_
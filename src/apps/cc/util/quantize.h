@@ -0,0 +1,68 @@
+#ifndef SCDETECT_APPS_CC_UTIL_QUANTIZE_H_
+#define SCDETECT_APPS_CC_UTIL_QUANTIZE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+// The maximum magnitude of quantized samples
+//
+// - 12 bits, only. This allows to accumulate up to `kQuantizedBlockSize`
+// products of quantized samples in 32 bit integers without overflowing.
+constexpr std::int16_t kQuantizedMax{2047};
+// The maximum number of products accumulated by `dot()`
+constexpr std::size_t kQuantizedBlockSize{256};
+
+// Returns the scale which quantizes samples with an absolute maximum of
+// `absMax` (`0` if `absMax` is zero)
+inline double quantizationScale(double absMax) {
+  return absMax > 0 ? kQuantizedMax / absMax : 0;
+}
+
+// Quantizes `sample` w.r.t. `scale`
+inline std::int16_t quantize(double sample, double scale) {
+  const auto ret{std::lround(sample * scale)};
+  return static_cast<std::int16_t>(std::max<long>(
+      -kQuantizedMax, std::min<long>(kQuantizedMax, ret)));
+}
+
+// Quantizes the `n` `samples` with a common scale and writes the result to
+// `out`. Returns the scale applied.
+inline double quantize(const double *samples, std::size_t n,
+                       std::int16_t *out) {
+  double absMax{0};
+  for (std::size_t i{0}; i < n; ++i) {
+    absMax = std::max(absMax, std::abs(samples[i]));
+  }
+
+  const auto scale{quantizationScale(absMax)};
+  for (std::size_t i{0}; i < n; ++i) {
+    out[i] = quantize(samples[i], scale);
+  }
+  return scale;
+}
+
+// Computes the dot product of the quantized samples `a` and `b`
+//
+// - `n` must not exceed `kQuantizedBlockSize`
+// - the loop is kept trivial such that compilers vectorize it (i.e. making use
+// of `pmaddwd` and friends)
+inline std::int32_t dot(const std::int16_t *a, const std::int16_t *b,
+                        std::size_t n) {
+  std::int32_t ret{0};
+  for (std::size_t i{0}; i < n; ++i) {
+    ret += static_cast<std::int32_t>(a[i]) * b[i];
+  }
+  return ret;
+}
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_UTIL_QUANTIZE_H_
@@ -0,0 +1,129 @@
+#include "worker_pool.h"
+
+#include <exception>
+#include <utility>
+
+#include "../log.h"
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+WorkerPool::WorkerPool(std::size_t numberOfWorkers) {
+  for (std::size_t i{0}; i < numberOfWorkers; ++i) {
+    _workers.emplace_back([this]() { work(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _stopped = true;
+    _queue.clear();
+  }
+  _queued.notify_all();
+
+  for (auto &worker : _workers) {
+    worker.join();
+  }
+}
+
+void WorkerPool::submit(Task task) {
+  auto job{std::make_shared<Job>()};
+  job->task = std::move(task);
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _jobs.push_back(job);
+    _queue.push_back(job);
+  }
+  _queued.notify_one();
+}
+
+std::size_t WorkerPool::poll() { return executeContinuations(false); }
+
+std::size_t WorkerPool::wait() { return executeContinuations(true); }
+
+std::size_t WorkerPool::pending() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _jobs.size();
+}
+
+std::size_t WorkerPool::size() const { return _workers.size(); }
+
+void WorkerPool::work() {
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock{_mutex};
+      _queued.wait(lock, [this]() { return _stopped || !_queue.empty(); });
+      if (_stopped) {
+        return;
+      }
+
+      job = std::move(_queue.front());
+      _queue.pop_front();
+    }
+
+    Continuation continuation;
+    std::string error;
+    bool failed{false};
+    try {
+      continuation = job->task();
+    } catch (const std::exception &e) {
+      error = e.what();
+      failed = true;
+    } catch (...) {
+      error = "unknown error";
+      failed = true;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      job->continuation = std::move(continuation);
+      job->error = std::move(error);
+      job->failed = failed;
+      job->finished = true;
+      // release the job while holding the lock, i.e. the job (including the
+      // task's captures) is destroyed by the owning thread
+      job.reset();
+    }
+    _finished.notify_all();
+  }
+}
+
+std::size_t WorkerPool::executeContinuations(bool block) {
+  std::size_t ret{0};
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock{_mutex};
+      if (_jobs.empty()) {
+        break;
+      }
+      if (block) {
+        _finished.wait(lock, [this]() { return _jobs.front()->finished; });
+      } else if (!_jobs.front()->finished) {
+        break;
+      }
+
+      job = std::move(_jobs.front());
+      _jobs.pop_front();
+    }
+
+    if (job->failed) {
+      SCDETECT_LOG_ERROR("Worker task failed: %s", job->error.c_str());
+    } else if (job->continuation) {
+      try {
+        job->continuation();
+      } catch (const std::exception &e) {
+        SCDETECT_LOG_ERROR("Worker task continuation failed: %s", e.what());
+      }
+    }
+    ++ret;
+  }
+  return ret;
+}
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,92 @@
+#ifndef SCDETECT_APPS_CC_UTIL_WORKERPOOL_H_
+#define SCDETECT_APPS_CC_UTIL_WORKERPOOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+namespace util {
+
+// Pool of worker threads executing tasks asynchronously
+//
+// - a task is executed by one of the workers and returns a *continuation*
+// which is executed by the thread owning the pool (i.e. the thread calling
+// `poll()` or `wait()`)
+// - continuations are executed strictly in the order the tasks were
+// submitted, i.e. a finished task's continuation is delayed until the
+// continuations of all previously submitted tasks were executed
+// - tasks and continuations are destroyed by the thread owning the pool, i.e.
+// objects captured must not be released by the workers
+// - errors are handled per task, i.e. an exception escaping a task is logged
+// (by the thread owning the pool) and the task's continuation is skipped.
+// Exceptions escaping a continuation are logged, as well.
+// - the pool's member functions must be called by the thread owning the pool
+class WorkerPool {
+ public:
+  using Continuation = std::function<void()>;
+  using Task = std::function<Continuation()>;
+
+  // Creates a pool with `numberOfWorkers` worker threads
+  explicit WorkerPool(std::size_t numberOfWorkers);
+  // Stops the workers; tasks not started, yet, are discarded (their
+  // continuations are not executed)
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // Submits `task` for asynchronous execution
+  void submit(Task task);
+
+  // Executes the continuations of the finished tasks in submission order
+  // without blocking. Returns the number of tasks finished.
+  std::size_t poll();
+  // Blocks until all submitted tasks are finished and executes their
+  // continuations. Returns the number of tasks finished.
+  std::size_t wait();
+
+  // Returns the number of tasks whose continuation was not executed, yet
+  std::size_t pending() const;
+  // Returns the number of worker threads
+  std::size_t size() const;
+
+ private:
+  struct Job {
+    Task task;
+    Continuation continuation;
+    // The error message if the task failed
+    std::string error;
+    bool failed{false};
+    bool finished{false};
+  };
+
+  void work();
+
+  std::size_t executeContinuations(bool block);
+
+  // Jobs in submission order
+  std::deque<std::shared_ptr<Job>> _jobs;
+  // Jobs not started, yet
+  std::deque<std::shared_ptr<Job>> _queue;
+
+  mutable std::mutex _mutex;
+  std::condition_variable _queued;
+  std::condition_variable _finished;
+  bool _stopped{false};
+
+  std::vector<std::thread> _workers;
+};
+
+}  // namespace util
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_UTIL_WORKERPOOL_H_
@@ -12,9 +12,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/functional/hash.hpp>
 #include <cassert>
+#include <cmath>
 #include <fstream>
 #include <memory>
 
+#include "filter/iir.h"
 #include "log.h"
 #include "resamplerstore.h"
 #include "util/math.h"
@@ -111,6 +113,13 @@ bool filter(DoubleArray &data, const std::string &filterId,
     return false;
   }
 
+  if (detect::filter::iir::nativeFilters()) {
+    auto native{detect::filter::iir::createFilter(filterId)};
+    if (native) {
+      return waveform::filter(data, native.get(), samplingFrequency);
+    }
+  }
+
   std::string filterError;
   std::unique_ptr<DoubleFilter> filter{
       DoubleFilter::Create(filterId, &filterError)};
@@ -144,7 +153,8 @@ bool resample(GenericRecord &trace, double targetFrequency) {
     return true;
   }
 
-  auto resampler{RecordResamplerStore::Instance().get(&trace, targetFrequency)};
+  auto resampler{RecordResamplerStore::Instance().getTraceResampler(
+      trace.samplingFrequency(), targetFrequency)};
   std::unique_ptr<Record> resampled;
   resampled.reset(resampler->feed(&trace));
   if (!resampled) {
@@ -420,6 +430,7 @@ GenericRecordCPtr Cached::get(
   GenericRecordCPtr trace{get(cache_key)};
   if (!trace) {
     cached = false;
+    ++_statistics.misses;
 
     ProcessingConfig disabled{config};
     disabled.filterId = "";
@@ -434,6 +445,8 @@ GenericRecordCPtr Cached::get(
     }
     trace = _waveformHandler->get(netCode, staCode, locCode, chaCode, corrected,
                                   disabled);
+  } else {
+    ++_statistics.hits;
   }
 
   // cache the raw data
@@ -457,6 +470,8 @@ GenericRecordCPtr Cached::get(
   return trace;
 }
 
+const Cached::Statistics &Cached::statistics() const { return _statistics; }
+
 void Cached::makeCacheKey(const std::string &netCode,
                           const std::string &staCode,
                           const std::string &locCode,
@@ -128,6 +128,12 @@ class WaveformHandler : public WaveformHandlerIface {
 DEFINE_SMARTPOINTER(Cached);
 class Cached : public WaveformHandlerIface {
  public:
+  // Cache access statistics
+  struct Statistics {
+    std::size_t hits{0};
+    std::size_t misses{0};
+  };
+
   GenericRecordCPtr get(
       const DataModel::WaveformStreamID &id, const Core::TimeWindow &tw,
       const WaveformHandlerIface::ProcessingConfig &config) override;
@@ -149,6 +155,9 @@ class Cached : public WaveformHandlerIface {
       const Core::Time &start, const Core::Time &end,
       const WaveformHandlerIface::ProcessingConfig &config) override;
 
+  // Returns the cache access statistics
+  const Statistics &statistics() const;
+
  protected:
   explicit Cached(WaveformHandlerIfacePtr waveformHandler, bool raw = false);
 
@@ -173,6 +182,8 @@ class Cached : public WaveformHandlerIface {
   // cached
   bool _raw;
 
+  Statistics _statistics;
+
   static const std::string _cacheKeySep;
 };
 
@@ -0,0 +1,263 @@
+#include "waveform_buffer.h"
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/typedarray.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "util/memory.h"
+
+namespace Seiscomp {
+namespace detect {
+
+std::size_t WaveformBuffer::Span::size() const {
+  return first.size + second.size;
+}
+
+Core::TimeWindow WaveformBuffer::Span::timeWindow() const {
+  return Core::TimeWindow{
+      startTime, startTime + Core::TimeSpan{static_cast<double>(size()) /
+                                            samplingFrequency}};
+}
+
+void WaveformBuffer::Span::copy(double *out) const {
+  out = std::copy(first.data, first.data + first.size, out);
+  std::copy(second.data, second.data + second.size, out);
+}
+
+void WaveformBuffer::setTimeSpan(const Core::TimeSpan &timeSpan) {
+  _timeSpan = timeSpan;
+  // the capacity depends on the time span; keep the most recent samples
+  for (auto &streamPair : _streams) {
+    auto &stream{streamPair.second};
+    stream.samples.rset_capacity(capacity(stream.samplingFrequency));
+    stream.trim();
+  }
+}
+
+const Core::TimeSpan &WaveformBuffer::timeSpan() const { return _timeSpan; }
+
+bool WaveformBuffer::feed(const Record *record) {
+  if (!record || !record->data()) {
+    return false;
+  }
+
+  const auto samplingFrequency{record->samplingFrequency()};
+  if (samplingFrequency <= 0 || record->data()->size() <= 0) {
+    return false;
+  }
+
+  FloatArrayPtr data{
+      dynamic_cast<FloatArray *>(record->data()->copy(Array::FLOAT))};
+  if (!data) {
+    return false;
+  }
+
+  const Sample *begin{data->typedData()};
+  const Sample *end{begin + data->size()};
+
+  auto it{_streams.find(record->streamID())};
+  if (it == _streams.end()) {
+    it = _streams.emplace(record->streamID(), Stream{}).first;
+    setupStream(it->second, record);
+  } else {
+    auto &stream{it->second};
+    // allow for a jitter of half a sample
+    const auto tolerance{0.5 / samplingFrequency};
+    if (samplingFrequency != stream.samplingFrequency) {
+      setupStream(stream, record);
+    } else if (static_cast<double>(record->endTime() - stream.endTime) <=
+               tolerance) {
+      // duplicate or data from the past
+      return false;
+    } else {
+      const auto offset{
+          static_cast<double>(record->startTime() - stream.endTime)};
+      if (offset > tolerance) {
+        // gap: start a new segment
+        stream.segments.push_back(Segment{record->startTime(), stream.count});
+      } else if (offset < -tolerance) {
+        // overlap: skip samples already buffered
+        const auto overlap{static_cast<std::ptrdiff_t>(
+            std::lround(-offset * samplingFrequency))};
+        begin += std::min(overlap, end - begin);
+      }
+    }
+  }
+
+  auto &stream{it->second};
+  stream.samples.insert(stream.samples.end(), begin, end);
+  stream.count += static_cast<std::uint64_t>(end - begin);
+  stream.endTime = record->endTime();
+  stream.trim();
+  return true;
+}
+
+boost::optional<Core::TimeWindow> WaveformBuffer::timeWindow(
+    const std::string &waveformStreamId) const {
+  auto it{_streams.find(waveformStreamId)};
+  if (it == _streams.end() || it->second.samples.empty()) {
+    return boost::none;
+  }
+  return Core::TimeWindow{it->second.startTime(), it->second.endTime};
+}
+
+std::vector<WaveformBuffer::Span> WaveformBuffer::read(
+    const std::string &waveformStreamId, const Core::TimeWindow &tw) const {
+  std::vector<Span> ret;
+  auto it{_streams.find(waveformStreamId)};
+  if (it == _streams.end() || it->second.samples.empty()) {
+    return ret;
+  }
+
+  const auto &stream{it->second};
+  if (tw.endTime() <= stream.startTime() || tw.startTime() >= stream.endTime) {
+    return ret;
+  }
+
+  const auto samplingFrequency{stream.samplingFrequency};
+  const auto arrayOne{stream.samples.array_one()};
+  const auto arrayTwo{stream.samples.array_two()};
+  for (std::size_t i{0}; i < stream.segments.size(); ++i) {
+    const auto &segment{stream.segments[i]};
+    const auto size{
+        static_cast<std::ptrdiff_t>(stream.end(i) - segment.first)};
+
+    std::ptrdiff_t first{0};
+    if (tw.startTime() > segment.startTime) {
+      first = static_cast<std::ptrdiff_t>(
+          std::floor(static_cast<double>(tw.startTime() - segment.startTime) *
+                     samplingFrequency));
+    }
+    const auto segmentEndTime{
+        segment.startTime +
+        Core::TimeSpan{static_cast<double>(size) / samplingFrequency}};
+    std::ptrdiff_t last{size};
+    if (tw.endTime() < segmentEndTime) {
+      last = static_cast<std::ptrdiff_t>(
+          std::ceil(static_cast<double>(tw.endTime() - segment.startTime) *
+                    samplingFrequency));
+    }
+    first = std::max(std::ptrdiff_t{0}, std::min(first, size));
+    last = std::max(first, std::min(last, size));
+    if (first == last) {
+      continue;
+    }
+
+    // map the samples to the ring buffer's underlying arrays
+    auto pos{static_cast<std::size_t>(segment.first - stream.begin()) +
+             static_cast<std::size_t>(first)};
+    auto count{static_cast<std::size_t>(last - first)};
+    Span span;
+    if (pos < arrayOne.second) {
+      span.first.data = arrayOne.first + pos;
+      span.first.size = std::min(count, arrayOne.second - pos);
+      count -= span.first.size;
+      pos = 0;
+    } else {
+      pos -= arrayOne.second;
+    }
+    if (count > 0) {
+      auto &part{span.first.size > 0 ? span.second : span.first};
+      part.data = arrayTwo.first + pos;
+      part.size = count;
+    }
+    span.startTime = segment.startTime +
+                     Core::TimeSpan{static_cast<double>(first) /
+                                    samplingFrequency};
+    span.samplingFrequency = samplingFrequency;
+    ret.push_back(span);
+  }
+  return ret;
+}
+
+std::vector<GenericRecordPtr> WaveformBuffer::records(
+    const std::string &waveformStreamId, const Core::TimeWindow &tw) const {
+  std::vector<GenericRecordPtr> ret;
+  const auto spans{read(waveformStreamId, tw)};
+  if (spans.empty()) {
+    return ret;
+  }
+
+  const auto &stream{_streams.at(waveformStreamId)};
+  for (const auto &span : spans) {
+    auto data{util::make_smart<DoubleArray>(static_cast<int>(span.size()))};
+    span.copy(data->typedData());
+
+    auto record{util::make_smart<GenericRecord>(
+        stream.networkCode, stream.stationCode, stream.locationCode,
+        stream.channelCode, span.startTime, span.samplingFrequency)};
+    record->setData(data.get());
+    ret.push_back(record);
+  }
+  return ret;
+}
+
+std::size_t WaveformBuffer::sampleCount() const {
+  std::size_t ret{0};
+  for (const auto &streamPair : _streams) {
+    ret += streamPair.second.samples.size();
+  }
+  return ret;
+}
+
+std::size_t WaveformBuffer::memoryUsage() const {
+  std::size_t ret{0};
+  for (const auto &streamPair : _streams) {
+    ret += streamPair.second.samples.capacity() * sizeof(Sample) +
+           streamPair.second.segments.size() * sizeof(Segment);
+  }
+  return ret;
+}
+
+void WaveformBuffer::clear() { _streams.clear(); }
+
+std::uint64_t WaveformBuffer::Stream::begin() const {
+  return count - samples.size();
+}
+
+Core::Time WaveformBuffer::Stream::startTime() const {
+  return segments.front().startTime;
+}
+
+std::uint64_t WaveformBuffer::Stream::end(std::size_t idx) const {
+  return idx + 1 < segments.size() ? segments[idx + 1].first : count;
+}
+
+void WaveformBuffer::Stream::trim() {
+  const auto first{begin()};
+  while (segments.size() > 1 && segments[1].first <= first) {
+    segments.pop_front();
+  }
+  if (!segments.empty() && segments.front().first < first) {
+    auto &segment{segments.front()};
+    segment.startTime += Core::TimeSpan{
+        static_cast<double>(first - segment.first) / samplingFrequency};
+    segment.first = first;
+  }
+}
+
+void WaveformBuffer::setupStream(Stream &stream, const Record *record) const {
+  stream.networkCode = record->networkCode();
+  stream.stationCode = record->stationCode();
+  stream.locationCode = record->locationCode();
+  stream.channelCode = record->channelCode();
+  stream.samplingFrequency = record->samplingFrequency();
+  stream.endTime = record->endTime();
+
+  stream.samples.clear();
+  stream.samples.set_capacity(capacity(stream.samplingFrequency));
+  stream.count = 0;
+  stream.segments.clear();
+  stream.segments.push_back(Segment{record->startTime(), 0});
+}
+
+std::size_t WaveformBuffer::capacity(double samplingFrequency) const {
+  return static_cast<std::size_t>(
+      std::ceil(static_cast<double>(_timeSpan) * samplingFrequency) + 1);
+}
+
+}  // namespace detect
+}  // namespace Seiscomp
@@ -0,0 +1,159 @@
+#ifndef SCDETECT_APPS_CC_WAVEFORMBUFFER_H_
+#define SCDETECT_APPS_CC_WAVEFORMBUFFER_H_
+
+#include <seiscomp/core/datetime.h>
+#include <seiscomp/core/genericrecord.h>
+#include <seiscomp/core/record.h>
+#include <seiscomp/core/timewindow.h>
+
+#include <boost/circular_buffer.hpp>
+#include <boost/optional/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Seiscomp {
+namespace detect {
+
+// Buffers the most recent samples of waveform streams
+//
+// - samples are stored converted to single precision (i.e. as `float`) in a
+// per-stream ring buffer; record objects are not kept. Integer samples are
+// represented exactly up to 24 bits.
+// - the ring buffer is sized with regards to the time span buffered. Gaps do
+// not reset the buffer, instead, the samples buffered are organized in
+// contiguous segments.
+class WaveformBuffer {
+ public:
+  using Sample = float;
+
+  // A contiguous sequence of samples
+  //
+  // - since the samples are stored in a ring buffer, the sequence may consist
+  // of up to two parts (i.e. `first` followed by `second`)
+  struct Span {
+    struct Part {
+      const Sample *data{nullptr};
+      std::size_t size{0};
+    };
+
+    Part first;
+    Part second;
+
+    // The time of the first sample
+    Core::Time startTime;
+    double samplingFrequency{0};
+
+    // Returns the total number of samples
+    std::size_t size() const;
+    // Returns the time window covered by the samples
+    Core::TimeWindow timeWindow() const;
+    // Copies the samples to `out` (which must provide space for at least
+    // `size()` samples)
+    void copy(double *out) const;
+  };
+
+  // Sets the time span to be buffered per stream
+  //
+  // - data already buffered is kept; if the time span shrinks, the oldest
+  // samples are dropped
+  void setTimeSpan(const Core::TimeSpan &timeSpan);
+  // Returns the time span buffered per stream
+  const Core::TimeSpan &timeSpan() const;
+
+  // Feeds `record` to the buffer. Returns `false` if the record was not
+  // buffered (i.e. records without data, duplicates and records from the
+  // past), else `true`.
+  bool feed(const Record *record);
+
+  // Returns the time window buffered for the stream identified by
+  // `waveformStreamId`, i.e. the time window ranging from the oldest to the
+  // most recent sample buffered (the time window may contain gaps)
+  //
+  // - returns `boost::none` if there is no data buffered for the stream
+  boost::optional<Core::TimeWindow> timeWindow(
+      const std::string &waveformStreamId) const;
+
+  // Returns the samples buffered for the stream identified by
+  // `waveformStreamId` within `tw`, i.e. a span per contiguous segment
+  // (ordered from the oldest to the most recent segment)
+  //
+  // - returns an empty list if there are no samples buffered within `tw`
+  // - the spans are valid until the buffer is modified
+  std::vector<Span> read(const std::string &waveformStreamId,
+                         const Core::TimeWindow &tw) const;
+  // Returns the samples buffered for the stream identified by
+  // `waveformStreamId` within `tw` as records, i.e. a record per contiguous
+  // segment (ordered from the oldest to the most recent segment)
+  //
+  // - returns an empty list if there are no samples buffered within `tw`
+  // - in contrast to `read()` the samples are copied
+  std::vector<GenericRecordPtr> records(const std::string &waveformStreamId,
+                                        const Core::TimeWindow &tw) const;
+
+  // Returns the number of samples buffered (with regards to all streams)
+  std::size_t sampleCount() const;
+  // Returns the number of bytes allocated for buffering samples
+  std::size_t memoryUsage() const;
+
+  // Removes all buffered data
+  void clear();
+
+ private:
+  // A contiguous sequence of samples buffered
+  struct Segment {
+    // The time of the first sample
+    Core::Time startTime;
+    // The index of the first sample (with regards to all samples ever
+    // buffered for the stream)
+    std::uint64_t first;
+  };
+
+  struct Stream {
+    std::string networkCode;
+    std::string stationCode;
+    std::string locationCode;
+    std::string channelCode;
+
+    double samplingFrequency{0};
+    // The time of the sample following the most recent sample buffered
+    Core::Time endTime;
+
+    boost::circular_buffer<Sample> samples;
+    // The total number of samples ever buffered (i.e. the index of the sample
+    // following the most recent sample buffered)
+    std::uint64_t count{0};
+    // The segments buffered (ordered from the oldest to the most recent
+    // segment)
+    std::deque<Segment> segments;
+
+    // Returns the index of the oldest sample buffered
+    std::uint64_t begin() const;
+    // Returns the time of the oldest sample buffered
+    Core::Time startTime() const;
+    // Returns the index of the sample following the last sample of the
+    // segment at position `idx`
+    std::uint64_t end(std::size_t idx) const;
+    // Drops segments which are no longer buffered (and adjusts the oldest
+    // segment if its first samples were dropped)
+    void trim();
+  };
+
+  // (Re-)initializes `stream` with regards to `record`
+  void setupStream(Stream &stream, const Record *record) const;
+  // Returns the ring buffer capacity with regards to `samplingFrequency`
+  std::size_t capacity(double samplingFrequency) const;
+
+  using Streams = std::unordered_map<std::string, Stream>;
+  Streams _streams;
+
+  Core::TimeSpan _timeSpan{0.0};
+};
+
+}  // namespace detect
+}  // namespace Seiscomp
+
+#endif  // SCDETECT_APPS_CC_WAVEFORMBUFFER_H_